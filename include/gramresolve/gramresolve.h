@@ -0,0 +1,172 @@
+// ===============================================================
+// File: gramresolve/gramresolve.h
+// Description: In-process API of libgramresolve (make lib). Load a
+//              grammar from a buffer, analyze it, compile an LR
+//              parser and parse token sequences; nothing is printed
+//              and no file is read or written.
+//
+//              Grammar and Parser are cheap handles to immutable,
+//              shared objects: copies share the data, and every
+//              const method may be called from several threads at
+//              once. Failures are reported through a bool return and
+//              an optional error string.
+//
+//              The header depends on the standard library only; the
+//              library's internal classes are not part of the API
+//              and are not exported from libgramresolve.so.
+// ===============================================================
+
+#ifndef GRAMRESOLVE_API_H
+#define GRAMRESOLVE_API_H
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+// The library is built with -fvisibility=hidden; only what carries
+// this is exported
+#if defined(__GNUC__) || defined(__clang__)
+#define GRAMRESOLVE_API __attribute__((visibility("default")))
+#else
+#define GRAMRESOLVE_API
+#endif
+
+namespace gramresolve {
+
+// What collided in a conflicting cell
+enum class ConflictKind {
+    LL1_MULTIPLE,                           // several alternatives in one LL(1) cell
+    SHIFT_REDUCE,
+    REDUCE_REDUCE,
+    SHIFT_SHIFT,
+    OTHER                                   // e.g. accept vs reduce
+};
+
+// ===============================================================
+// Struct: ConflictInfo
+// ===============================================================
+struct ConflictInfo {
+    ConflictKind kind = ConflictKind::OTHER;
+    std::string description;                // the report's wording: "LL(1) MULTIPLE ENTRIES",
+                                            // "Shift/Reduce Conflict", "Reduce/Reduce Conflict",
+                                            // "Shift/Shift Conflict" or "Multiple Actions"
+    std::string location;                   // (NonTerminal, Terminal) or (State, Symbol)
+    std::vector<std::string> details;       // the competing rules / actions
+};
+
+// ===============================================================
+// Struct: Analysis
+// FIRST/FOLLOW, the LL(1) table and the SLR(1) automaton of a grammar
+// ===============================================================
+struct Analysis {
+    std::size_t terminals = 0;
+    std::size_t nonTerminals = 0;
+    std::size_t alternatives = 0;
+
+    std::map<std::string, std::set<std::string>> first;    // per non-terminal
+    std::map<std::string, std::set<std::string>> follow;
+    std::set<std::string> nullable;
+
+    std::vector<ConflictInfo> ll1Conflicts;
+    std::size_t lr0States = 0;
+    std::vector<ConflictInfo> slrConflicts;
+
+    bool isLL1() const { return ll1Conflicts.empty(); }
+    bool isSLR1() const { return slrConflicts.empty(); }
+};
+
+// Strongest table the compiler may escalate to
+enum class Algorithm {
+    SLR1,
+    LALR1,
+    LR1
+};
+
+// ===============================================================
+// Struct: CompileOptions
+// ===============================================================
+struct CompileOptions {
+    Algorithm strongest = Algorithm::LR1;
+    std::size_t maxLR1States = 200000;      // canonical LR(1) budget
+};
+
+// ===============================================================
+// Struct: ParseResult
+// ===============================================================
+struct ParseResult {
+    bool accepted = false;
+    std::size_t stoppedAt = 0;              // rejected: index of the offending token
+};
+
+class GRAMRESOLVE_API Grammar;
+
+// ===============================================================
+// Class: Parser
+// A compiled LR table; immutable once returned by Grammar::compile
+// ===============================================================
+class GRAMRESOLVE_API Parser {
+public:
+    Parser() = default;                     // invalid until compiled
+
+    bool valid() const { return impl != nullptr; }
+
+    // Tokens are terminal names; a trailing "$" is optional. A
+    // conflicted cell takes its first action.
+    ParseResult parse(const std::vector<std::string> &tokens) const;
+
+    // Same, on whitespace-separated tokens
+    ParseResult parse(const std::string &tokens) const;
+
+    Algorithm algorithm() const;
+    std::string algorithmName() const;
+    bool conflictFree() const;
+    std::size_t stateCount() const;
+    std::size_t memoryBytes() const;        // the action and goto tables
+
+private:
+    struct Impl;
+    std::shared_ptr<const Impl> impl;
+
+    friend class Grammar;
+};
+
+// ===============================================================
+// Class: Grammar
+// A loaded grammar (same text format as the grammar files)
+// ===============================================================
+class GRAMRESOLVE_API Grammar {
+public:
+    Grammar() = default;                    // invalid until loaded
+
+    // False (and `error`, when given) if the text holds no
+    // production; skipped lines show up in warnings()
+    static bool fromText(const std::string &text, Grammar &out, std::string *error = nullptr);
+
+    bool valid() const { return impl != nullptr; }
+
+    const std::vector<std::string> &warnings() const;
+    std::string startSymbol() const;
+    std::set<std::string> terminals() const;
+    std::set<std::string> nonTerminals() const;
+    std::size_t alternativeCount() const;
+
+    // Computed on every call; keep the result if it is needed twice
+    Analysis analyze() const;
+
+    // Cheapest LR table without conflicts (SLR(1) → LALR(1) →
+    // LR(1)), or the strongest one tried. False only when the
+    // grammar is not valid.
+    bool compile(Parser &out, const CompileOptions &options = CompileOptions(),
+                 std::string *error = nullptr) const;
+
+private:
+    struct Impl;
+    std::shared_ptr<const Impl> impl;
+};
+
+} // namespace gramresolve
+
+#endif
@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+# ===============================================================
+# File: bench_compare.py
+# Description: Compare two benchmark JSON files written by
+#              text.exe --bench (make bench). Cases are matched by
+#              name and source; every phase shows the old and new
+#              median and the change in percent.
+#
+#   python3 scripts/bench_compare.py build/bench-abc123.json build/bench-def456.json
+# ===============================================================
+
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return data, {(c["name"], c["source"]): c for c in data["cases"]}
+
+
+def main():
+    if len(sys.argv) != 3:
+        print("usage: bench_compare.py OLD.json NEW.json", file=sys.stderr)
+        return 2
+
+    old_data, old = load(sys.argv[1])
+    new_data, new = load(sys.argv[2])
+    threshold = 5.0  # percent; smaller changes are shown without a marker
+
+    print(f"\n===== {old_data.get('label') or sys.argv[1]} → {new_data.get('label') or sys.argv[2]} =====")
+    print(f"{'Case':<14}{'Source':<52}{'Phase':<16}{'Old ms':>11}{'New ms':>11}{'Change':>10}")
+
+    for key, case in new.items():
+        before = old.get(key)
+        if before is None:
+            continue
+        for phase, timing in case["phases"].items():
+            if phase not in before["phases"]:
+                continue
+            a = before["phases"][phase]["median_ms"]
+            b = timing["median_ms"]
+            change = (b - a) / a * 100.0 if a > 0 else 0.0
+            mark = ""
+            if change <= -threshold:
+                mark = " ✅"
+            elif change >= threshold:
+                mark = " ⚠️"
+            print(f"{key[0]:<14}{key[1]:<52}{phase:<16}{a:>11.3f}{b:>11.3f}{change:>+9.1f}%{mark}")
+
+    missing = sorted(set(old) ^ set(new))
+    for name, source in missing:
+        print(f"  (only in one file: {name} {source})")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+# ===============================================================
+# File: loadtest.py
+# Description: Load test for the parse server (text.exe --serve).
+#              Every client connection loads the grammar once, then
+#              sends PARSE requests one at a time for sentences of
+#              the corpus and records each round trip. Prints
+#              p50/p90/p99/max latency and the overall request rate.
+#
+#   make && python3 scripts/loadtest.py --start
+#   python3 scripts/loadtest.py --socket /tmp/gramresolve.sock -c 16 -n 5000
+# ===============================================================
+
+import argparse
+import os
+import socket
+import subprocess
+import sys
+import threading
+import time
+
+
+def percentile(sorted_values, p):
+    if not sorted_values:
+        return 0.0
+    k = min(len(sorted_values) - 1, int(round(p / 100.0 * (len(sorted_values) - 1))))
+    return sorted_values[k]
+
+
+class Client:
+    def __init__(self, path):
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sock.connect(path)
+        self.reader = self.sock.makefile("rb")
+        self.next_id = 0
+
+    def request(self, command, payload=b""):
+        self.next_id += 1
+        self.sock.sendall(f"{self.next_id} {command}\n".encode() + payload)
+        reply = self.reader.readline().decode().rstrip("\n")
+        rid, _, rest = reply.partition(" ")
+        if rid != str(self.next_id):
+            raise RuntimeError(f"reply out of order: {reply!r}")
+        return rest
+
+    def close(self):
+        self.sock.close()
+
+
+def run_client(args, grammar, sentences, offset, latencies, errors):
+    client = Client(args.socket)
+    reply = client.request(f"GRAMMAR {len(grammar)}", grammar)
+    if not reply.startswith("OK "):
+        errors.append(reply)
+        return
+    grammar_hash = reply.split()[1]
+
+    mine = []
+    for k in range(args.requests):
+        sentence = sentences[(offset + k) % len(sentences)]
+        t0 = time.perf_counter()
+        reply = client.request(f"PARSE {grammar_hash} {sentence}")
+        mine.append((time.perf_counter() - t0) * 1000.0)
+        if not reply.startswith("OK"):
+            errors.append(reply)
+    client.close()
+    latencies.extend(mine)
+
+
+def wait_for_socket(path, seconds=5.0):
+    deadline = time.time() + seconds
+    while time.time() < deadline:
+        try:
+            Client(path).close()
+            return True
+        except OSError:
+            time.sleep(0.05)
+    return False
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Load test for text.exe --serve")
+    parser.add_argument("--socket", default="/tmp/gramresolve.sock")
+    parser.add_argument("--grammar", default="data/expr_grammar.txt")
+    parser.add_argument("--corpus", default="data/expr_corpus.txt")
+    parser.add_argument("-c", "--clients", type=int, default=8, help="concurrent connections")
+    parser.add_argument("-n", "--requests", type=int, default=2000, help="PARSE requests per client")
+    parser.add_argument("--start", action="store_true", help="start ./text.exe --serve first")
+    parser.add_argument("--workers", type=int, default=0, help="server workers with --start")
+    args = parser.parse_args()
+
+    with open(args.grammar, "rb") as f:
+        grammar = f.read()
+    with open(args.corpus) as f:
+        sentences = [line.strip() for line in f if line.strip()]
+
+    server = None
+    if args.start:
+        server = subprocess.Popen(["./text.exe", "--serve", args.socket, "-j", str(args.workers)])
+        if not wait_for_socket(args.socket):
+            print("❌ server did not come up", file=sys.stderr)
+            server.kill()
+            return 1
+
+    latencies, errors = [], []
+    threads = [threading.Thread(target=run_client,
+                                args=(args, grammar, sentences, i, latencies, errors))
+               for i in range(args.clients)]
+    t0 = time.perf_counter()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    elapsed = time.perf_counter() - t0
+
+    if server:
+        Client(args.socket).request("SHUTDOWN")
+        server.wait()
+
+    latencies.sort()
+    total = len(latencies)
+    print(f"\n===== Parse server load test =====")
+    print(f"Clients          : {args.clients}")
+    print(f"Requests         : {total} ({len(errors)} errors)")
+    print(f"Throughput       : {total / elapsed:.0f} req/s")
+    print(f"Latency p50      : {percentile(latencies, 50):.3f} ms")
+    print(f"Latency p90      : {percentile(latencies, 90):.3f} ms")
+    print(f"Latency p99      : {percentile(latencies, 99):.3f} ms")
+    print(f"Latency max      : {latencies[-1] if latencies else 0.0:.3f} ms")
+    for e in errors[:5]:
+        print(f"  error: {e}")
+    return 1 if errors else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+# ===============================================================
+# File: regress.py
+# Description: Golden-output regression tests (make test). Every
+#              directory under tests/regress holds one case:
+#                cmd        shell line run inside a scratch copy of
+#                           the directory; $GRAMRESOLVE is a copy of
+#                           the executable under test
+#                expected   its stdout + stderr, then "exit: <code>"
+#              Every other file of the directory (grammars, inputs)
+#              is copied next to the command. The reports go next to
+#              the executable, so they land in the scratch copy. A
+#              case fails when the output differs or the command runs
+#              past the timeout.
+#
+#   make test
+#   python3 scripts/regress.py ./text.exe glr_epsilon_cycle
+#   python3 scripts/regress.py ./text.exe --update
+# ===============================================================
+
+import argparse
+import difflib
+import os
+import shutil
+import signal
+import subprocess
+import sys
+import tempfile
+
+CASES_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "tests", "regress")
+
+
+def run_case(exe, case_dir, timeout):
+    with open(os.path.join(case_dir, "cmd")) as f:
+        command = f.read().strip()
+
+    with tempfile.TemporaryDirectory(prefix="gramresolve-regress-") as scratch:
+        for name in os.listdir(case_dir):
+            if name not in ("cmd", "expected"):
+                shutil.copy(os.path.join(case_dir, name), scratch)
+        os.makedirs(os.path.join(scratch, "src", "report"))
+        copy = os.path.join(scratch, os.path.basename(exe))
+        shutil.copy(exe, copy)
+
+        # Own process group, so a hung pipeline is killed as a whole
+        env = dict(os.environ, GRAMRESOLVE=copy)
+        proc = subprocess.Popen(command, shell=True, cwd=scratch, env=env, start_new_session=True,
+                                stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+        try:
+            output, _ = proc.communicate(timeout=timeout)
+        except subprocess.TimeoutExpired:
+            os.killpg(proc.pid, signal.SIGKILL)
+            proc.communicate()
+            return None
+        return output.decode("utf-8", "replace") + "exit: %d\n" % proc.returncode
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Run the golden-output regression tests")
+    ap.add_argument("exe", help="text.exe to test")
+    ap.add_argument("cases", nargs="*", help="case names (default: all)")
+    ap.add_argument("--timeout", type=float, default=20.0, help="seconds per case")
+    ap.add_argument("--update", action="store_true", help="rewrite expected from the actual output")
+    args = ap.parse_args()
+
+    exe = os.path.abspath(args.exe)
+    names = args.cases or sorted(n for n in os.listdir(CASES_DIR)
+                                 if os.path.isdir(os.path.join(CASES_DIR, n)))
+
+    failed = []
+    for name in names:
+        case_dir = os.path.join(CASES_DIR, name)
+        actual = run_case(exe, case_dir, args.timeout)
+        expected_path = os.path.join(case_dir, "expected")
+
+        if actual is None:
+            print("❌ %-32s timed out after %.0f s" % (name, args.timeout))
+            failed.append(name)
+            continue
+        if args.update:
+            with open(expected_path, "w") as f:
+                f.write(actual)
+            print("📝 %-32s updated" % name)
+            continue
+
+        expected = open(expected_path).read() if os.path.exists(expected_path) else ""
+        if actual == expected:
+            print("✅ %s" % name)
+            continue
+        print("❌ %s" % name)
+        sys.stdout.writelines(difflib.unified_diff(expected.splitlines(True), actual.splitlines(True),
+                                                   "expected", "actual"))
+        failed.append(name)
+
+    print("\n%d/%d regression cases passed" % (len(names) - len(failed), len(names)))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,36 @@
+// ===============================================================
+// File: ConflictRecord.h
+// Description: Compact conflict records written by the table
+//              builders the moment a second entry lands in a cell.
+//              ConflictDetector turns them into readable reports.
+// ===============================================================
+
+#ifndef CONFLICT_RECORD_H
+#define CONFLICT_RECORD_H
+
+#include <cstdint>
+
+using namespace std;
+
+enum class ConflictKind : uint8_t {
+    SHIFT_REDUCE,
+    REDUCE_REDUCE,
+    SHIFT_SHIFT,
+    LL1_MULTIPLE,      // two alternatives predicted by one LL(1) cell
+    OTHER              // e.g. accept vs reduce
+};
+
+// ===============================================================
+// Struct: ConflictRecord
+// One record per extra entry: a cell holding k entries yields
+// k - 1 records, all with the cell's first entry in `first`.
+// ===============================================================
+struct ConflictRecord {
+    int32_t row;           // LR state, or LL(1) non-terminal id
+    int32_t column;        // terminal id
+    uint32_t first;        // LR action word, or LL(1) alternative id
+    uint32_t second;       // the entry that caused the conflict
+    ConflictKind kind;
+};
+
+#endif
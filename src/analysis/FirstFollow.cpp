@@ -1,119 +1,281 @@
 #include "FirstFollow.h"
 #include "../report/reportWriter.h"
+#include "../report/ReportPolicy.h"
+#include "../util/Instrumentation.h"
 #include <sstream>
 #include <iostream>
 #include <queue>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
 #include <algorithm>
 
 using namespace std;
 
+// ======================================================
+// 🔢 Bit-set helpers
+// The fixed points run on dense bit sets over a sorted
+// symbol list; results are copied back into the string
+// maps at the end. Large grammars are re-analyzed after
+// every edit, so the old set<string> sweeps were too slow.
+// ======================================================
+namespace {
+
+typedef vector<uint64_t> Bits;
+
+struct SymbolBits {
+    vector<string> names;               // sorted, so copies append in order
+    unordered_map<string, int> id;
+    size_t words = 0;
+
+    explicit SymbolBits(const set<string> &symbols) : names(symbols.begin(), symbols.end()) {
+        for (size_t k = 0; k < names.size(); ++k)
+            id[names[k]] = static_cast<int>(k);
+        words = (names.size() + 63) / 64;
+    }
+
+    Bits empty() const { return Bits(words, 0); }
+
+    set<string> toSet(const Bits &bits) const {
+        set<string> out;
+        for (size_t w = 0; w < words; ++w)
+            for (uint64_t rest = bits[w]; rest; rest &= rest - 1)
+                out.insert(out.end(), names[w * 64 + __builtin_ctzll(rest)]);
+        return out;
+    }
+};
+
+bool testBit(const Bits &bits, int k) {
+    return (bits[k / 64] >> (k % 64)) & 1;
+}
+
+bool setBit(Bits &bits, int k) {
+    uint64_t mask = uint64_t(1) << (k % 64);
+    if (bits[k / 64] & mask) return false;
+    bits[k / 64] |= mask;
+    return true;
+}
+
+// dst ∪= src, leaving out bit `skip` (-1 = none)
+bool unionInto(Bits &dst, const Bits &src, int skip) {
+    bool changed = false;
+    for (size_t w = 0; w < dst.size(); ++w) {
+        uint64_t add = src[w];
+        if (skip >= 0 && static_cast<size_t>(skip / 64) == w)
+            add &= ~(uint64_t(1) << (skip % 64));
+        if (add & ~dst[w]) {
+            dst[w] |= add;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// Right-hand side symbol: non-terminal, terminal, ε or unknown
+struct RhsSymbol {
+    enum Kind { NT, TERM, EPS, OTHER } kind;
+    int index;
+};
+
+} // namespace
+
 // ======================================================
 // 🧩 Compute FIRST sets for all grammar symbols
 // ======================================================
 void FirstFollowEngine::computeFIRST(const Grammar &grammar) {
+    PhaseTimer timer("first");
     FIRST.clear();
     NULLABLE.clear();
 
-    // Initialize FIRST sets for terminals and nonterminals
-    for (const auto &t : grammar.getTerminals()) {
-        FIRST[t] = {t}; // FIRST(a) = {a} for terminals
-        NULLABLE[t] = false;
-    }
-    for (const auto &nt : grammar.getNonTerminals()) {
-        FIRST[nt] = {};
-        NULLABLE[nt] = false;
+    set<string> valueSet = grammar.getTerminals();
+    valueSet.insert("ε");
+    SymbolBits values(valueSet);
+    SymbolBits nts(grammar.getNonTerminals());
+    const int eps = values.id.at("ε");
+
+    auto encode = [&](const string &symbol) -> RhsSymbol {
+        auto n = nts.id.find(symbol);
+        if (n != nts.id.end()) return {RhsSymbol::NT, n->second};
+        if (symbol == "ε") return {RhsSymbol::EPS, -1};
+        if (grammar.getTerminals().count(symbol)) return {RhsSymbol::TERM, values.id.at(symbol)};
+        FIRST[symbol];                  // unknown symbols keep an empty FIRST
+        return {RhsSymbol::OTHER, -1};
+    };
+
+    // Alternatives, and which alternatives read each non-terminal
+    vector<pair<int, vector<RhsSymbol>>> alternatives;
+    vector<vector<size_t>> usedBy(nts.names.size());
+
+    for (const auto &prod : grammar.getProductions()) {
+        int A = nts.id.at(prod.getLHS());
+        for (const auto &rhs : prod.getRHS()) {
+            vector<RhsSymbol> encoded;
+            for (const string &symbol : rhs) {
+                encoded.push_back(encode(symbol));
+                if (encoded.back().kind == RhsSymbol::NT)
+                    usedBy[encoded.back().index].push_back(alternatives.size());
+            }
+            alternatives.push_back({A, encoded});
+        }
     }
-    FIRST["ε"] = {"ε"};
-    NULLABLE["ε"] = true;
 
-    bool changed = true;
-    while (changed) {
-        changed = false;
+    vector<Bits> first(nts.names.size(), values.empty());
 
-        for (const auto &prod : grammar.getProductions()) {
-            const string &A = prod.getLHS();
+    // Every alternative once, then again only when the FIRST set
+    // of a non-terminal on its right-hand side grows
+    deque<size_t> work;
+    vector<char> queued(alternatives.size(), 1);
+    for (size_t k = 0; k < alternatives.size(); ++k)
+        work.push_back(k);
 
-            for (const auto &rhs : prod.getRHS()) {
-                bool allNullable = true;
+    size_t steps = 0, inserts = 0;
+    CountOnExit countSteps(Counter::FIXPOINT_ITERATIONS, steps);
+    CountOnExit countInserts(Counter::SET_INSERTS, inserts);
 
-                for (const string &symbol : rhs) {
-                    const auto &firstSym = FIRST[symbol];
+    while (!work.empty()) {
+        size_t k = work.front();
+        work.pop_front();
+        queued[k] = 0;
+        steps++;
 
-                    // Add FIRST(symbol) \ {ε} to FIRST(A)
-                    for (const auto &f : firstSym) {
-                        if (f != "ε" && FIRST[A].insert(f).second)
-                            changed = true;
-                    }
+        int A = alternatives[k].first;
+        bool changed = false;
+        bool allNullable = true;
 
-                    // If ε not in FIRST(symbol), stop
-                    if (firstSym.find("ε") == firstSym.end()) {
-                        allNullable = false;
-                        break;
-                    }
-                }
+        for (const RhsSymbol &sym : alternatives[k].second) {
+            if (sym.kind == RhsSymbol::EPS)
+                continue;
+            if (sym.kind == RhsSymbol::TERM)
+                changed |= setBit(first[A], sym.index);
 
-                // If all symbols in RHS can produce ε → ε ∈ FIRST(A)
-                if (allNullable) {
-                    if (FIRST[A].insert("ε").second)
-                        changed = true;
-                    NULLABLE[A] = true;
-                }
+            // Add FIRST(symbol) \ {ε} to FIRST(A); stop unless ε ∈ FIRST(symbol)
+            if (sym.kind == RhsSymbol::NT) {
+                changed |= unionInto(first[A], first[sym.index], eps);
+                if (testBit(first[sym.index], eps))
+                    continue;
             }
+            allNullable = false;
+            break;
         }
+
+        // If all symbols in RHS can produce ε → ε ∈ FIRST(A)
+        if (allNullable)
+            changed |= setBit(first[A], eps);
+
+        if (!changed) continue;
+        inserts++;
+        for (size_t u : usedBy[A])
+            if (!queued[u]) {
+                queued[u] = 1;
+                work.push_back(u);
+            }
+    }
+
+    // Initialize FIRST sets for terminals and copy the rest back
+    for (const auto &t : grammar.getTerminals()) {
+        FIRST[t] = {t}; // FIRST(a) = {a} for terminals
+        NULLABLE[t] = false;
+    }
+    for (size_t A = 0; A < nts.names.size(); ++A) {
+        FIRST[nts.names[A]] = values.toSet(first[A]);
+        NULLABLE[nts.names[A]] = testBit(first[A], eps);
     }
+    FIRST["ε"] = {"ε"};
+    NULLABLE["ε"] = true;
 }
 
 // ======================================================
 // 🧭 Compute FOLLOW sets for all nonterminals
 // ======================================================
 void FirstFollowEngine::computeFOLLOW(const Grammar &grammar) {
+    PhaseTimer timer("follow");
     FOLLOW.clear();
 
-    // Initialize empty sets
-    for (const auto &nt : grammar.getNonTerminals())
-        FOLLOW[nt] = {};
+    set<string> valueSet = grammar.getTerminals();
+    valueSet.insert("$");
+    SymbolBits values(valueSet);
+    SymbolBits nts(grammar.getNonTerminals());
+    size_t N = nts.names.size();
+
+    // FIRST(X) \ {ε} as bits, from the computed FIRST sets
+    vector<Bits> first(N, values.empty());
+    for (size_t A = 0; A < N; ++A)
+        for (const auto &f : getFIRST(nts.names[A])) {
+            auto v = values.id.find(f);
+            if (v != values.id.end()) setBit(first[A], v->second);
+        }
+
+    vector<Bits> follow(N, values.empty());
+    vector<vector<int>> edges(N);
 
     // Start symbol gets $
-    FOLLOW[grammar.getStartSymbol()].insert("$");
+    auto start = nts.id.find(grammar.getStartSymbol());
+    if (start != nts.id.end())
+        setBit(follow[start->second], values.id.at("$"));
 
-    bool changed = true;
-    while (changed) {
-        changed = false;
-
-        for (const auto &prod : grammar.getProductions()) {
-            const string &A = prod.getLHS();
-
-            for (const auto &rhs : prod.getRHS()) {
-                for (size_t i = 0; i < rhs.size(); ++i) {
-                    const string &B = rhs[i];
-                    if (!grammar.isNonTerminal(B))
-                        continue;
-
-                    // Everything in FIRST(β) except ε → FOLLOW(B)
-                    bool epsilonInAll = true;
-                    for (size_t j = i + 1; j < rhs.size(); ++j) {
-                        const string &beta = rhs[j];
-                        for (const auto &f : FIRST[beta]) {
-                            if (f != "ε" && FOLLOW[B].insert(f).second)
-                                changed = true;
-                        }
-                        if (FIRST[beta].find("ε") == FIRST[beta].end()) {
-                            epsilonInAll = false;
-                            break;
-                        }
-                    }
+    // FIRST(β) parts are fixed once FIRST is known: add them in
+    // one pass and keep FOLLOW(A) ⊆ FOLLOW(B) as edges A → B
+    for (const auto &prod : grammar.getProductions()) {
+        int A = nts.id.at(prod.getLHS());
 
-                    // If β ⇒ ε or B is last in RHS → FOLLOW(A) ⊆ FOLLOW(B)
-                    if (i == rhs.size() - 1 || epsilonInAll) {
-                        for (const auto &f : FOLLOW[A]) {
-                            if (FOLLOW[B].insert(f).second)
-                                changed = true;
-                        }
+        for (const auto &rhs : prod.getRHS()) {
+            for (size_t i = 0; i < rhs.size(); ++i) {
+                auto b = nts.id.find(rhs[i]);
+                if (b == nts.id.end())
+                    continue;
+                int B = b->second;
+
+                // Everything in FIRST(β) except ε → FOLLOW(B)
+                bool epsilonInAll = true;
+                for (size_t j = i + 1; j < rhs.size() && epsilonInAll; ++j) {
+                    const string &beta = rhs[j];
+                    auto n = nts.id.find(beta);
+                    if (n != nts.id.end()) {
+                        unionInto(follow[B], first[n->second], -1);
+                        epsilonInAll = isNullable(beta);
+                    } else if (beta != "ε") {
+                        auto v = values.id.find(beta);
+                        if (v != values.id.end()) setBit(follow[B], v->second);
+                        epsilonInAll = false;
                     }
                 }
+
+                // If β ⇒ ε or B is last in RHS → FOLLOW(A) ⊆ FOLLOW(B)
+                if (epsilonInAll && A != B)
+                    edges[A].push_back(B);
             }
         }
     }
+
+    // Propagate along the edges until nothing grows
+    deque<int> work;
+    vector<char> queued(N, 1);
+    for (size_t A = 0; A < N; ++A)
+        work.push_back(static_cast<int>(A));
+
+    size_t steps = 0, inserts = 0;
+    CountOnExit countSteps(Counter::FIXPOINT_ITERATIONS, steps);
+    CountOnExit countInserts(Counter::SET_INSERTS, inserts);
+
+    while (!work.empty()) {
+        int A = work.front();
+        work.pop_front();
+        queued[A] = 0;
+        steps++;
+
+        for (int B : edges[A])
+            if (unionInto(follow[B], follow[A], -1)) {
+                inserts++;
+                if (queued[B]) continue;
+                queued[B] = 1;
+                work.push_back(B);
+            }
+    }
+
+    for (size_t A = 0; A < N; ++A)
+        FOLLOW[nts.names[A]] = values.toSet(follow[A]);
+    FOLLOW[grammar.getStartSymbol()].insert("$");
 }
 
 // ======================================================
@@ -140,42 +302,23 @@ bool FirstFollowEngine::isNullable(const std::string &symbol) const {
 // 🖨️ Display FIRST and FOLLOW sets
 // ======================================================
 
+template <typename Log>
 void FirstFollowEngine::display() const {
-    std::ostringstream out;
-
-    out << "\n===== FIRST & FOLLOW Sets =====\n";
-
-    // FIRST sets
-    out << "\nFIRST sets:\n";
-    for (const auto &p : FIRST) {
-        out << "FIRST(" << p.first << ") = { ";
-        bool first = true;
-        for (const auto &sym : p.second) {
-            if (!first) out << ", ";
-            out << sym;
-            first = false;
-        }
-        out << " }\n";
-    }
-
-    // FOLLOW sets
-    out << "\nFOLLOW sets:\n";
-    for (const auto &p : FOLLOW) {
-        out << "FOLLOW(" << p.first << ") = { ";
-        bool first = true;
-        for (const auto &sym : p.second) {
-            if (!first) out << ", ";
-            out << sym;
-            first = false;
-        }
-        out << " }\n";
-    }
-
-    out << "===============================\n";
-
-    // Print to terminal
-    cout << out.str();
-
-    // Save to report file
-    ReportWriter::get() << out.str();
+    reportAt<Log>(Verbosity::DETAIL, [&](ReportStream &report) {
+        report.emit(ReportEvent("first_follow"));
+        for (const auto &p : FIRST)
+            report.emit(ReportEvent("first")
+                            .add("symbol", p.first)
+                            .add("set", vector<string>(p.second.begin(), p.second.end())));
+        for (const auto &p : FOLLOW)
+            report.emit(ReportEvent("follow")
+                            .add("symbol", p.first)
+                            .add("set", vector<string>(p.second.begin(), p.second.end())));
+        report.emit(ReportEvent("end").add("of", "first_follow"));
+    });
 }
+
+#ifndef GRAMRESOLVE_NO_REPORT
+template void FirstFollowEngine::display<ReportLog>() const;
+#endif
+template void FirstFollowEngine::display<SilentLog>() const;
@@ -31,6 +31,7 @@ public:
     bool isNullable(const string &symbol) const;
 
     // 🖨️ Display results
+    template <typename Log = DefaultLog>
     void display() const;
 };
 
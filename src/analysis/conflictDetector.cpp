@@ -1,114 +1,93 @@
 #include "conflictDetector.h"
 #include "../report/reportWriter.h"
+#include "../report/ReportPolicy.h"
+#include "../util/Instrumentation.h"
 #include <sstream>
 #include <set>
-#include <regex>
+#include <map>
 using namespace std;
 
-// helper to split strings by '|'
-static vector<string> splitActions(const string &s) {
-    vector<string> parts;
-    stringstream ss(s);
-    string part;
-    while (getline(ss, part, '|')) {
-        if (!part.empty())
-            parts.push_back(part);
-    }
-    return parts;
-}
-
 // ---------------------------------------------------------------
-// LL(1) Conflict Detection  (CLEAN VERSION — no unused params)
+// LL(1) Conflict Detection
+// One report per cell: the first alternative plus every one that
+// collided with it, in the order the builder placed them
 // ---------------------------------------------------------------
-vector<Conflict> ConflictDetector::detectLL1Conflicts(
-    const map<string, map<string, string>> &table
-) {
-    vector<Conflict> conflicts;
-
-    for (const auto &ntPair : table) {
-        const string &nonTerminal = ntPair.first;
-
-        for (const auto &tPair : ntPair.second) {
-            const string &terminal = tPair.first;
-            const string &entry = tPair.second;
-
-            auto parts = splitActions(entry);
-
-            if (parts.size() > 1) {
-                Conflict c;
-                c.type = "LL(1) MULTIPLE ENTRIES";
-                c.location = "(" + nonTerminal + ", " + terminal + ")";
-                c.details = parts;
-                conflicts.push_back(c);
-            }
+vector<Conflict> ConflictDetector::detectLL1Conflicts(const LL1Parser &parser) {
+    PhaseTimer timer("conflicts");
+    map<pair<string, string>, Conflict> cells;
+
+    for (const auto &r : parser.getConflicts()) {
+        const string &nonTerminal = parser.nonTerminalName(r.row);
+        const string &terminal = parser.terminalName(r.column);
+
+        Conflict &c = cells[{nonTerminal, terminal}];
+        if (c.details.empty()) {
+            c.type = "LL(1) MULTIPLE ENTRIES";
+            c.kind = ConflictKind::LL1_MULTIPLE;
+            c.location = "(" + nonTerminal + ", " + terminal + ")";
+            c.nonTerminal = nonTerminal;
+            c.symbol = terminal;
+            c.details.push_back(parser.alternativeText(r.first));
         }
+        c.details.push_back(parser.alternativeText(r.second));
     }
 
+    vector<Conflict> conflicts;
+    for (auto &cell : cells)
+        conflicts.push_back(move(cell.second));
     return conflicts;
 }
 
 // ---------------------------------------------------------------
 // LR(0)/SLR Conflict Detection
 // ---------------------------------------------------------------
-vector<Conflict> ConflictDetector::detectLRConflicts(
-    const map<int, map<string, string>> &ACTION
-) {
-    vector<Conflict> conflicts;
-    regex shift("^s\\d+$"), reduce("^r\\d+$");
-
-    for (const auto &statePair : ACTION) {
-        int state = statePair.first;
-
-        for (const auto &symPair : statePair.second) {
-            const string &symbol = symPair.first;
+vector<Conflict> ConflictDetector::detectLRConflicts(const LRTable &table) {
+    PhaseTimer timer("conflicts");
+    map<pair<int, string>, vector<uint32_t>> cells;
+
+    for (const auto &r : table.getConflicts()) {
+        auto &actions = cells[{r.row, table.terminalName(r.column)}];
+        if (actions.empty())
+            actions.push_back(r.first);
+        actions.push_back(r.second);
+    }
 
-            auto parts = splitActions(symPair.second);
+    vector<Conflict> conflicts;
 
-            bool hasShift = false, hasReduce = false;
-            int shiftCount = 0, reduceCount = 0;
+    for (const auto &cell : cells) {
+        int shiftCount = 0, reduceCount = 0;
+        vector<string> parts;
 
-            for (const string &p : parts) {
-                if (regex_match(p, shift)) { 
-                    hasShift = true; 
-                    shiftCount++; 
-                }
-                else if (regex_match(p, reduce)) { 
-                    hasReduce = true; 
-                    reduceCount++; 
-                }
-            }
+        for (uint32_t a : cell.second) {
+            if (actionTag(a) == ACT_SHIFT) shiftCount++;
+            else if (actionTag(a) == ACT_REDUCE) reduceCount++;
+            parts.push_back(table.actionToString(a));
+        }
 
-            if (parts.size() > 1) {
-                if (hasShift && hasReduce) {
-                    conflicts.push_back({
-                        "Shift/Reduce Conflict",
-                        "(State " + to_string(state) + ", " + symbol + ")",
-                        parts
-                    });
-                }
-                else if (shiftCount > 1) {
-                    conflicts.push_back({
-                        "Shift/Shift Conflict",
-                        "(State " + to_string(state) + ", " + symbol + ")",
-                        parts
-                    });
-                }
-                else if (reduceCount > 1) {
-                    conflicts.push_back({
-                        "Reduce/Reduce Conflict",
-                        "(State " + to_string(state) + ", " + symbol + ")",
-                        parts
-                    });
-                }
-                else {
-                    conflicts.push_back({
-                        "Multiple Actions",
-                        "(State " + to_string(state) + ", " + symbol + ")",
-                        parts
-                    });
-                }
-            }
+        string type;
+        ConflictKind kind;
+        if (shiftCount && reduceCount) {
+            type = "Shift/Reduce Conflict";
+            kind = ConflictKind::SHIFT_REDUCE;
+        } else if (shiftCount > 1) {
+            type = "Shift/Shift Conflict";
+            kind = ConflictKind::SHIFT_SHIFT;
+        } else if (reduceCount > 1) {
+            type = "Reduce/Reduce Conflict";
+            kind = ConflictKind::REDUCE_REDUCE;
+        } else {
+            type = "Multiple Actions";
+            kind = ConflictKind::OTHER;
         }
+
+        Conflict c;
+        c.type = type;
+        c.kind = kind;
+        c.location = "(State " + to_string(cell.first.first) + ", " + cell.first.second + ")";
+        c.details = parts;
+        c.state = cell.first.first;
+        c.symbol = cell.first.second;
+        conflicts.push_back(c);
     }
 
     return conflicts;
@@ -117,37 +96,23 @@ vector<Conflict> ConflictDetector::detectLRConflicts(
 // ---------------------------------------------------------------
 // Display detected conflicts
 // ---------------------------------------------------------------
+template <typename Log>
 void ConflictDetector::displayConflicts(const vector<Conflict> &conflicts) {
-    std::ostringstream out;
-
-    if (conflicts.empty()) {
-        out << "✅ No conflicts detected!\n";
-        cout << out.str();
-        ReportWriter::get() << out.str();
-        return;
-    }
-
-    out << "\n⚠️  Conflicts detected:\n";
-    out << left << setw(30) << "Type"
-        << setw(25) << "Location"
-        << "Details\n";
-    out << string(80, '-') << "\n";
-
-    for (const auto &c : conflicts) {
-        out << left << setw(30) << c.type
-            << setw(25) << c.location;
-
-        if (!c.details.empty())
-            out << c.details[0];
-        out << "\n";
-
-        for (size_t i = 1; i < c.details.size(); ++i)
-            out << setw(55) << " " << c.details[i] << "\n";
-    }
-
-    out << string(80, '-') << "\n";
-    out << "Total Conflicts: " << conflicts.size() << "\n";
-
-    cout << out.str();
-    ReportWriter::get() << out.str();
+    reportAt<Log>(Verbosity::DETAIL, [&](ReportStream &report) {
+        report.emit(ReportEvent("conflicts").add("count", conflicts.size()));
+        for (const auto &c : conflicts) {
+            ReportEvent event("conflict");
+            event.add("kind", c.type).add("location", c.location).add("details", c.details);
+            if (c.state >= 0) event.add("state", c.state);
+            else event.add("nonterminal", c.nonTerminal);
+            event.add("symbol", c.symbol);
+            report.emit(event);
+        }
+        report.emit(ReportEvent("end").add("of", "conflicts"));
+    });
 }
+
+#ifndef GRAMRESOLVE_NO_REPORT
+template void ConflictDetector::displayConflicts<ReportLog>(const vector<Conflict> &);
+#endif
+template void ConflictDetector::displayConflicts<SilentLog>(const vector<Conflict> &);
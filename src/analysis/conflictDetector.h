@@ -1,6 +1,7 @@
 // ===============================================================
 // File: ConflictDetector.h
-// Description: Detects conflicts in LL(1) and LR(0)/SLR parsing tables
+// Description: Reports conflicts in LL(1) and LR(0)/SLR parsing
+//              tables from the records the table builders write
 // ===============================================================
 
 #ifndef CONFLICT_DETECTOR_H
@@ -13,30 +14,33 @@
 #include <iomanip>
 #include "../grammar/Grammar.h"
 #include "../analysis/FirstFollow.h"
+#include "../parser/LL1Parser.h"
+#include "../parser/LRTable.h"
+#include "../report/ReportPolicy.h"
 
 using namespace std;
 
 struct Conflict {
     string type;               // conflict type
+    ConflictKind kind = ConflictKind::OTHER;
     string location;           // (NonTerminal, Terminal) or (State, Symbol)
     vector<string> details;    // conflicting rules/actions
+    int state = -1;            // LR state (-1 for LL(1))
+    string nonTerminal;        // LL(1) row
+    string symbol;             // terminal column
 };
 
 class ConflictDetector {
 public:
 
-    // Detect LL(1) conflicts (multiple productions in same cell)
-    // ⚠️ Clean version: removed unused Grammar & FirstFollowEngine parameters
-    static vector<Conflict> detectLL1Conflicts(
-        const map<string, map<string, string>> &table
-    );
+    // LL(1) conflicts recorded by LL1Parser::buildTable
+    static vector<Conflict> detectLL1Conflicts(const LL1Parser &parser);
 
-    // Detect LR(0)/SLR conflicts from ACTION table
-    static vector<Conflict> detectLRConflicts(
-        const map<int, map<string, string>> &ACTION
-    );
+    // LR(0)/SLR conflicts recorded by LRTable::addAction
+    static vector<Conflict> detectLRConflicts(const LRTable &table);
 
     // Nicely print detected conflicts
+    template <typename Log = DefaultLog>
     static void displayConflicts(const vector<Conflict> &conflicts);
 };
 
@@ -0,0 +1,191 @@
+// ===============================================================
+// File: GramResolve.cpp
+// Description: libgramresolve API (include/gramresolve/gramresolve.h)
+//              over the analyzer's own classes. Only silent paths are
+//              used: SilentLog builds, warnings collected instead of
+//              echoed, no display() call.
+// ===============================================================
+
+#include <gramresolve/gramresolve.h>
+#include "../grammar/Grammar.h"
+#include "../analysis/FirstFollow.h"
+#include "../analysis/conflictDetector.h"
+#include "../parser/LL1Parser.h"
+#include "../parser/LRParser.h"
+#include "../parser/ParserBuilder.h"
+#include <sstream>
+
+namespace gramresolve {
+
+struct Grammar::Impl {
+    ::Grammar grammar;
+    size_t alternatives = 0;
+};
+
+struct Parser::Impl {
+    ParserBuild build;
+};
+
+static ConflictKind toConflictKind(::ConflictKind kind) {
+    switch (kind) {
+    case ::ConflictKind::LL1_MULTIPLE:  return ConflictKind::LL1_MULTIPLE;
+    case ::ConflictKind::SHIFT_REDUCE:  return ConflictKind::SHIFT_REDUCE;
+    case ::ConflictKind::REDUCE_REDUCE: return ConflictKind::REDUCE_REDUCE;
+    case ::ConflictKind::SHIFT_SHIFT:   return ConflictKind::SHIFT_SHIFT;
+    default:                            return ConflictKind::OTHER;
+    }
+}
+
+static std::vector<ConflictInfo> toConflictInfo(const std::vector<Conflict> &conflicts) {
+    std::vector<ConflictInfo> out;
+    out.reserve(conflicts.size());
+    for (const auto &c : conflicts)
+        out.push_back({toConflictKind(c.kind), c.type, c.location, c.details});
+    return out;
+}
+
+static LRAlgorithm toLRAlgorithm(Algorithm algorithm) {
+    switch (algorithm) {
+    case Algorithm::SLR1:  return LRAlgorithm::SLR1;
+    case Algorithm::LALR1: return LRAlgorithm::LALR1;
+    default:               return LRAlgorithm::LR1;
+    }
+}
+
+static Algorithm fromLRAlgorithm(LRAlgorithm algorithm) {
+    switch (algorithm) {
+    case LRAlgorithm::SLR1:  return Algorithm::SLR1;
+    case LRAlgorithm::LALR1: return Algorithm::LALR1;
+    default:                 return Algorithm::LR1;
+    }
+}
+
+// ===================================================
+// 🔹 Grammar
+// ===================================================
+bool Grammar::fromText(const std::string &text, Grammar &out, std::string *error) {
+    auto impl = std::make_shared<Impl>();
+    impl->grammar.setWarningEcho(false);
+    impl->grammar.loadFromText(text);
+
+    if (impl->grammar.getProductions().empty()) {
+        if (error) {
+            *error = "no productions";
+            if (!impl->grammar.getWarnings().empty())
+                *error += " (" + impl->grammar.getWarnings().front() + ")";
+        }
+        return false;
+    }
+
+    for (const auto &p : impl->grammar.getProductions())
+        impl->alternatives += p.getRHS().size();
+    out.impl = std::move(impl);
+    return true;
+}
+
+const std::vector<std::string> &Grammar::warnings() const {
+    static const std::vector<std::string> none;
+    return impl ? impl->grammar.getWarnings() : none;
+}
+
+std::string Grammar::startSymbol() const {
+    return impl ? impl->grammar.getStartSymbol() : std::string();
+}
+
+std::set<std::string> Grammar::terminals() const {
+    return impl ? impl->grammar.getTerminals() : std::set<std::string>();
+}
+
+std::set<std::string> Grammar::nonTerminals() const {
+    return impl ? impl->grammar.getNonTerminals() : std::set<std::string>();
+}
+
+size_t Grammar::alternativeCount() const {
+    return impl ? impl->alternatives : 0;
+}
+
+Analysis Grammar::analyze() const {
+    Analysis analysis;
+    if (!impl) return analysis;
+    const ::Grammar &g = impl->grammar;
+
+    analysis.terminals = g.getTerminals().size();
+    analysis.nonTerminals = g.getNonTerminals().size();
+    analysis.alternatives = impl->alternatives;
+
+    FirstFollowEngine ff;
+    ff.computeFIRST(g);
+    ff.computeFOLLOW(g);
+    for (const auto &nt : g.getNonTerminals()) {
+        analysis.first[nt] = ff.getFIRST(nt);
+        analysis.follow[nt] = ff.getFOLLOW(nt);
+        if (ff.isNullable(nt)) analysis.nullable.insert(nt);
+    }
+
+    LL1Parser ll1(g, ff);
+    ll1.buildTable<SilentLog>();
+    analysis.ll1Conflicts = toConflictInfo(ConflictDetector::detectLL1Conflicts(ll1));
+
+    LR0Parser lr0(g);
+    lr0.buildAutomaton<SilentLog>();
+    analysis.lr0States = lr0.getStateCount();
+    analysis.slrConflicts = toConflictInfo(ConflictDetector::detectLRConflicts(lr0.getTable()));
+    return analysis;
+}
+
+bool Grammar::compile(Parser &out, const CompileOptions &options, std::string *error) const {
+    if (!impl) {
+        if (error) *error = "grammar not loaded";
+        return false;
+    }
+
+    ParserBuildOptions buildOptions;
+    buildOptions.strongest = toLRAlgorithm(options.strongest);
+    buildOptions.maxLR1States = options.maxLR1States;
+
+    auto parser = std::make_shared<Parser::Impl>();
+    parser->build = ParserBuilder::build(impl->grammar, buildOptions);
+    out.impl = std::move(parser);
+    return true;
+}
+
+// ===================================================
+// 🔹 Parser
+// ===================================================
+ParseResult Parser::parse(const std::vector<std::string> &tokens) const {
+    ParseResult result;
+    if (!impl) return result;
+    result.accepted = ParserBuilder::recognize(impl->build, tokens, &result.stoppedAt);
+    if (result.accepted) result.stoppedAt = tokens.size();
+    return result;
+}
+
+ParseResult Parser::parse(const std::string &tokens) const {
+    std::istringstream in(tokens);
+    std::vector<std::string> split;
+    for (std::string token; in >> token; )
+        split.push_back(token);
+    return parse(split);
+}
+
+Algorithm Parser::algorithm() const {
+    return impl ? fromLRAlgorithm(impl->build.algorithm) : Algorithm::SLR1;
+}
+
+std::string Parser::algorithmName() const {
+    return impl ? ::algorithmName(impl->build.algorithm) : std::string();
+}
+
+bool Parser::conflictFree() const {
+    return impl && impl->build.conflictFree;
+}
+
+size_t Parser::stateCount() const {
+    return impl ? static_cast<size_t>(impl->build.table.stateCount()) : 0;
+}
+
+size_t Parser::memoryBytes() const {
+    return impl ? impl->build.table.memoryBytes() : 0;
+}
+
+} // namespace gramresolve
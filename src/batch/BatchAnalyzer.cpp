@@ -0,0 +1,261 @@
+#include "BatchAnalyzer.h"
+#include "../grammar/Grammar.h"
+#include "../analysis/FirstFollow.h"
+#include "../analysis/conflictDetector.h"
+#include "../parser/LL1Parser.h"
+#include "../parser/LRParser.h"
+#include "../report/reportWriter.h"
+#include "../report/ReportEvent.h"
+#include "../util/Parallel.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <filesystem>
+#include <algorithm>
+#include <functional>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// A file counts as a grammar when one of its first lines is a
+// production; corpora and notes next to the grammars are skipped
+static bool looksLikeGrammar(const fs::path &path) {
+    ifstream in(path);
+    string line;
+    for (int scanned = 0; scanned < 200 && getline(in, line); ) {
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == string::npos) continue;
+        if (line.find("->") != string::npos || line.find("→") != string::npos) return true;
+        scanned++;
+    }
+    return false;
+}
+
+vector<string> BatchAnalyzer::findGrammars(const string &directory) {
+    vector<string> paths;
+    error_code ec;
+    fs::recursive_directory_iterator it(directory, fs::directory_options::skip_permission_denied, ec);
+    if (ec) {
+        cerr << "❌ Cannot read directory " << directory << ": " << ec.message() << "\n";
+        return paths;
+    }
+
+    for (; it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (ec) break;
+        const fs::path &p = it->path();
+        if (!it->is_regular_file(ec) || p.filename().string()[0] == '.') continue;
+        if (looksLikeGrammar(p)) paths.push_back(p.string());
+    }
+    sort(paths.begin(), paths.end());
+    return paths;
+}
+
+// ===================================================
+// One grammar, every phase, no console output
+// ===================================================
+GrammarSummary BatchAnalyzer::analyze(const string &path) {
+    using Clock = chrono::steady_clock;
+    GrammarSummary summary;
+    summary.path = path;
+
+    auto timed = [&](const string &name, const function<void()> &fn) {
+        auto t0 = Clock::now();
+        fn();
+        double ms = chrono::duration<double, milli>(Clock::now() - t0).count();
+        summary.phases.push_back({name, ms});
+        summary.totalMs += ms;
+    };
+
+    std::ostringstream out;
+    out << "\n===== Batch Analysis: " << path << " =====\n";
+
+    Grammar grammar;
+    bool loaded = false;
+    timed("load", [&] { loaded = grammar.loadFromFile(path); });
+    if (!loaded || grammar.getProductions().empty()) {
+        summary.error = loaded ? "no productions" : "cannot open";
+        out << "❌ " << summary.error << "\n";
+        summary.text = out.str();
+        return summary;
+    }
+
+    summary.terminals = grammar.getTerminals().size();
+    summary.nonTerminals = grammar.getNonTerminals().size();
+    for (const auto &p : grammar.getProductions())
+        summary.alternatives += p.getRHS().size();
+
+    FirstFollowEngine ff;
+    timed("first_follow", [&] {
+        ff.computeFIRST(grammar);
+        ff.computeFOLLOW(grammar);
+    });
+
+    LL1Parser ll1(grammar, ff);
+    timed("ll1_table", [&] { ll1.buildTable<SilentLog>(); });
+
+    // One worker per grammar already; no threads inside
+    LR0Parser lr0(grammar);
+    lr0.setThreadCount(1);
+    timed("lr0_automaton", [&] { lr0.buildAutomaton<SilentLog>(); });
+    summary.lrStates = lr0.getStateCount();
+
+    vector<Conflict> ll1Conflicts, lrConflicts;
+    timed("conflicts", [&] {
+        ll1Conflicts = ConflictDetector::detectLL1Conflicts(ll1);
+        lrConflicts = ConflictDetector::detectLRConflicts(lr0.getTable());
+    });
+    summary.ll1Conflicts = ll1Conflicts.size();
+    summary.slrConflicts = lrConflicts.size();
+
+    out << "Terminals        : " << summary.terminals << "\n";
+    out << "Non-terminals    : " << summary.nonTerminals << "\n";
+    out << "Alternatives     : " << summary.alternatives << "\n";
+    out << "LR(0) states     : " << summary.lrStates << "\n";
+    out << "LL(1)            : "
+        << (ll1Conflicts.empty() ? "✅ conflict-free" : "❌ " + to_string(ll1Conflicts.size()) + " conflicts")
+        << "\n";
+    out << "SLR(1)           : "
+        << (lrConflicts.empty() ? "✅ conflict-free" : "❌ " + to_string(lrConflicts.size()) + " conflicts")
+        << "\n";
+    out << "Phase times (ms) :";
+    for (const auto &phase : summary.phases)
+        out << " " << phase.first << " " << fixed << setprecision(3) << phase.second;
+    out << "\n";
+
+    auto listConflicts = [&](const string &title, const vector<Conflict> &conflicts) {
+        if (conflicts.empty()) return;
+        out << "\n" << title << ":\n";
+        for (const auto &c : conflicts) {
+            out << "  " << c.type << " at " << c.location << ":";
+            for (size_t k = 0; k < c.details.size(); ++k)
+                out << (k ? " | " : " ") << c.details[k];
+            out << "\n";
+        }
+    };
+    listConflicts("LL(1) conflicts", ll1Conflicts);
+    listConflicts("SLR(1) conflicts", lrConflicts);
+
+    summary.text = out.str();
+    return summary;
+}
+
+// ===================================================
+// Whole directory
+// ===================================================
+static string summaryFileName(const string &directory, const string &path) {
+    string name = fs::path(path).lexically_relative(directory).string();
+    if (name.empty() || name == ".") name = fs::path(path).filename().string();
+    replace(name.begin(), name.end(), '/', '_');
+    return name + ".summary.txt";
+}
+
+int BatchAnalyzer::run(const BatchOptions &options) {
+    vector<string> paths = findGrammars(options.directory);
+    if (paths.empty()) {
+        cerr << "❌ No grammar files under " << options.directory << "\n";
+        return 1;
+    }
+
+    error_code ec;
+    fs::create_directories(options.outputDir, ec);
+    if (ec) {
+        cerr << "❌ Cannot create " << options.outputDir << ": " << ec.message() << "\n";
+        return 1;
+    }
+
+    // Largest files first, so one big grammar does not start last
+    vector<size_t> order(paths.size());
+    vector<uintmax_t> sizes(paths.size());
+    for (size_t k = 0; k < paths.size(); ++k) {
+        order[k] = k;
+        sizes[k] = fs::file_size(paths[k], ec);
+    }
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+    const unsigned workers = min<unsigned>(resolveThreadCount(options.threads), paths.size());
+    vector<GrammarSummary> summaries(paths.size());
+
+    auto t0 = chrono::steady_clock::now();
+    parallelFor(paths.size(), workers, [&](size_t k) {
+        GrammarSummary &summary = summaries[order[k]];
+        summary = analyze(paths[order[k]]);
+
+        ofstream file(fs::path(options.outputDir) / summaryFileName(options.directory, summary.path));
+        file << summary.text;
+
+        ReportWriter &report = ReportWriter::get();
+        report.beginSection();
+        report << summary.text;
+        report.endSection();
+    });
+    double wallMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+    display(summaries, wallMs, workers, options.outputDir);
+
+    size_t failed = 0;
+    for (const auto &s : summaries) failed += !s.error.empty();
+    return failed ? 1 : 0;
+}
+
+// ===================================================
+// Aggregate table
+// ===================================================
+void BatchAnalyzer::display(const vector<GrammarSummary> &summaries, double wallMs, unsigned workers,
+                            const string &outputDir) {
+    ReportStream &report = ReportStream::get();
+    size_t width = 8;
+    for (const auto &s : summaries) width = max(width, s.path.size() + 2);
+
+    std::ostringstream out;
+    out << "\n===== Batch Analysis (" << summaries.size() << " grammars, " << workers
+        << " workers) =====\n";
+    out << left << setw(width) << "Grammar" << right << setw(6) << "T" << setw(6) << "NT" << setw(7)
+        << "Alts" << setw(8) << "States" << setw(8) << "LL(1)" << setw(8) << "SLR(1)" << setw(12)
+        << "Time (ms)" << "\n";
+
+    size_t ll1Free = 0, slrFree = 0, failed = 0;
+    double cpuMs = 0.0;
+    for (const auto &s : summaries) {
+        ReportEvent event("batch_grammar");
+        event.add("path", s.path);
+        if (!s.error.empty()) {
+            event.add("error", s.error);
+        } else {
+            event.add("terminals", s.terminals).add("nonterminals", s.nonTerminals)
+                .add("alternatives", s.alternatives).add("states", s.lrStates)
+                .add("ll1_conflicts", s.ll1Conflicts).add("slr_conflicts", s.slrConflicts);
+        }
+        event.add("micros", static_cast<int64_t>(s.totalMs * 1000));
+        report.emit(event);
+
+        cpuMs += s.totalMs;
+        out << left << setw(width) << s.path << right;
+        if (!s.error.empty()) {
+            failed++;
+            out << "  ❌ " << s.error << "\n";
+            continue;
+        }
+        ll1Free += s.ll1Conflicts == 0;
+        slrFree += s.slrConflicts == 0;
+        out << setw(6) << s.terminals << setw(6) << s.nonTerminals << setw(7) << s.alternatives
+            << setw(8) << s.lrStates << setw(8) << s.ll1Conflicts << setw(8) << s.slrConflicts
+            << setw(12) << fixed << setprecision(3) << s.totalMs << "\n";
+    }
+
+    const size_t analyzed = summaries.size() - failed;
+    out << "\nConflict-free: " << ll1Free << "/" << analyzed << " LL(1), " << slrFree << "/"
+        << analyzed << " SLR(1)";
+    if (failed) out << "; " << failed << " not analyzed";
+    out << "\nTime: " << fixed << setprecision(1) << wallMs << " ms wall, " << cpuMs
+        << " ms summed over grammars (" << setprecision(2) << (wallMs > 0 ? cpuMs / wallMs : 0.0)
+        << "x)\n";
+    out << "Summaries: " << outputDir << "/\n";
+    out << "==========================================\n";
+
+    report.emit(ReportEvent("message").add("text", out.str()), Verbosity::SUMMARY);
+
+    ofstream file(fs::path(outputDir) / "summary.txt");
+    file << out.str();
+}
@@ -0,0 +1,68 @@
+// ===============================================================
+// File: BatchAnalyzer.h
+// Description: Analyzes every grammar under a directory (load,
+//              FIRST/FOLLOW, LL(1) table, LR(0)/SLR automaton and
+//              conflicts), one grammar per worker at a time. Each
+//              grammar gets its own summary file; an aggregate table
+//              goes to the terminal, the report and summary.txt.
+//              Analyses run silently, so workers only share the
+//              report writer, and each summary reaches the report
+//              as one section.
+// ===============================================================
+
+#ifndef BATCH_ANALYZER_H
+#define BATCH_ANALYZER_H
+
+#include <string>
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+// ===============================================================
+// Struct: BatchOptions
+// ===============================================================
+struct BatchOptions {
+    string directory;
+    string outputDir = "build/batch-summaries";     // per-grammar summaries + summary.txt
+    unsigned threads = 0;               // 0 = all hardware threads
+};
+
+// ===============================================================
+// Struct: GrammarSummary
+// ===============================================================
+struct GrammarSummary {
+    string path;
+    string error;                       // empty when every phase ran
+    size_t terminals = 0;
+    size_t nonTerminals = 0;
+    size_t alternatives = 0;
+    size_t ll1Conflicts = 0;
+    size_t lrStates = 0;
+    size_t slrConflicts = 0;
+    vector<pair<string, double>> phases;    // name → ms, in run order
+    double totalMs = 0.0;
+    string text;                        // the per-grammar summary
+};
+
+// ===============================================================
+// Class: BatchAnalyzer
+// ===============================================================
+class BatchAnalyzer {
+public:
+    // Files under `directory` (recursively) that hold at least one
+    // production line; sorted by path
+    static vector<string> findGrammars(const string &directory);
+
+    // All phases on one grammar; safe to call from several threads
+    static GrammarSummary analyze(const string &path);
+
+    // Analyze the directory and write the summaries; returns the
+    // exit code (1 when some grammar could not be analyzed)
+    static int run(const BatchOptions &options);
+
+    static void display(const vector<GrammarSummary> &summaries, double wallMs, unsigned workers,
+                        const string &outputDir);
+};
+
+#endif
@@ -0,0 +1,247 @@
+#include "Benchmark.h"
+#include "../grammar/Grammar.h"
+#include "../analysis/FirstFollow.h"
+#include "../analysis/conflictDetector.h"
+#include "../parser/LL1Parser.h"
+#include "../parser/LRParser.h"
+#include "../parser/ParserBuilder.h"
+#include "../parser/EarleyParser.h"
+#include "../generator/SentenceGenerator.h"
+#include "../report/ReportEvent.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <chrono>
+#include <ctime>
+
+using namespace std;
+
+// ======================================
+// Sweep
+// ======================================
+vector<GrammarShape> Benchmark::sweep(bool quick) {
+    GrammarShape base;
+    base.nonTerminals = 100;
+
+    vector<GrammarShape> shapes;
+    auto vary = [&](const function<void(GrammarShape &)> &change) {
+        GrammarShape s = base;
+        change(s);
+        shapes.push_back(s);
+    };
+
+    vector<size_t> sizes = quick ? vector<size_t>{25, 100} : vector<size_t>{25, 50, 100, 200};
+    for (size_t n : sizes) vary([&](GrammarShape &s) { s.nonTerminals = n; });
+    if (quick) return shapes;
+
+    for (size_t a : {2, 4, 6}) vary([&](GrammarShape &s) { s.alternatives = a; });
+    for (size_t r : {2, 6, 10}) vary([&](GrammarShape &s) { s.rhsLength = r; });
+    for (double d : {0.0, 0.3, 0.6}) vary([&](GrammarShape &s) { s.nullableDensity = d; });
+    for (size_t d : {0, 1, 8, 24}) vary([&](GrammarShape &s) { s.recursionDepth = d; });
+    return shapes;
+}
+
+// ======================================
+// One grammar, every phase
+// ======================================
+BenchCase Benchmark::runCase(const string &name, const string &kind, const string &source,
+                             const string &text, const BenchOptions &options) {
+    using Clock = chrono::steady_clock;
+    const size_t runs = options.quick ? 1 : max<size_t>(options.repeat, 1);
+
+    BenchCase c;
+    c.name = name;
+    c.kind = kind;
+    c.source = source;
+
+    auto measure = [&](const string &phase, const function<void()> &fn) {
+        vector<double> ms;
+        for (size_t r = 0; r < runs; ++r) {
+            auto t0 = Clock::now();
+            fn();
+            ms.push_back(chrono::duration<double, milli>(Clock::now() - t0).count());
+        }
+        sort(ms.begin(), ms.end());
+        c.phases.push_back({phase, ms[ms.size() / 2], ms.front()});
+    };
+
+    Grammar g;
+    measure("load", [&] {
+        g = Grammar();
+        g.loadFromText(text);
+    });
+
+    FirstFollowEngine ff;
+    measure("first_follow", [&] {
+        ff = FirstFollowEngine();
+        ff.computeFIRST(g);
+        ff.computeFOLLOW(g);
+    });
+
+    unique_ptr<LL1Parser> ll1;
+    measure("ll1_table", [&] {
+        ll1.reset(new LL1Parser(g, ff));
+        ll1->buildTable<SilentLog>();
+    });
+
+    // closure() + findState() over the whole canonical collection
+    unique_ptr<LR0Parser> lr0;
+    measure("lr0_automaton", [&] {
+        lr0.reset(new LR0Parser(g));
+        lr0->setThreadCount(options.threads);
+        lr0->buildAutomaton<SilentLog>();
+    });
+
+    measure("conflicts", [&] {
+        c.ll1Conflicts = ConflictDetector::detectLL1Conflicts(*ll1).size();
+        c.lrConflicts = ConflictDetector::detectLRConflicts(lr0->getTable()).size();
+    });
+
+    // Random grammars are ambiguous and always escalate to LR(1); a
+    // smaller state budget keeps that stage comparable but bounded
+    ParserBuildOptions buildOptions;
+    buildOptions.maxLR1States = options.maxLR1States;
+    ParserBuild build;
+    measure("parser_select", [&] { build = ParserBuilder::build(g, buildOptions); });
+
+    // 🔹 Parse loops over generated sentences
+    SentenceGenerator generator(g);
+    SentenceOptions sentenceOptions;
+    sentenceOptions.maxTokens = options.sentenceTokens;
+    mt19937_64 rng(1);
+    vector<vector<string>> corpus(generator.valid() ? options.sentences : 0);
+    for (auto &sentence : corpus) {
+        generator.generate(rng, sentenceOptions, sentence);
+        c.corpusTokens += sentence.size();
+    }
+
+    measure("parse_ll1", [&] {
+        for (const auto &sentence : corpus) ll1->recognize(sentence);
+    });
+    measure("parse_lr", [&] {
+        for (const auto &sentence : corpus) ParserBuilder::recognize(build, sentence);
+    });
+    EarleyParser earley(g, ff);
+    measure("parse_earley", [&] {
+        for (const auto &sentence : corpus) earley.recognize(sentence);
+    });
+
+    c.nonTerminals = g.getNonTerminals().size();
+    c.terminals = g.getTerminals().size();
+    for (const auto &p : g.getProductions()) c.alternatives += p.getRHS().size();
+    c.lr0States = lr0->getStateCount();
+    c.selected = algorithmName(build.algorithm);
+    return c;
+}
+
+// ======================================
+// Suite
+// ======================================
+int Benchmark::run(const BenchOptions &options) {
+    vector<BenchCase> cases;
+
+    for (const auto &shape : sweep(options.quick)) {
+        string text = GrammarGenerator::generateText(shape);
+        cases.push_back(runCase("gen", "generated", shape.describe(), text, options));
+        cerr << "  ⏱️  " << shape.describe() << "\n";
+    }
+
+    for (const auto &path : options.fixtures) {
+        ifstream file(path);
+        if (!file.is_open()) {
+            cerr << "⚠️ Warning: skipping missing fixture " << path << "\n";
+            continue;
+        }
+        std::ostringstream text;
+        text << file.rdbuf();
+
+        string name = path.substr(path.find_last_of('/') + 1);
+        name = name.substr(0, name.find('.'));
+        cases.push_back(runCase(name, "fixture", path, text.str(), options));
+        cerr << "  ⏱️  " << path << "\n";
+    }
+
+    display(cases);
+    return writeJson(cases, options) ? 0 : 1;
+}
+
+// ======================================
+// Output
+// ======================================
+void Benchmark::display(const vector<BenchCase> &cases) {
+    ReportStream &report = ReportStream::get();
+    std::ostringstream out;
+    out << "\n===== Benchmark (median ms) =====\n";
+    out << left << setw(14) << "Case" << setw(52) << "Source"
+        << right << setw(6) << "NTs" << setw(7) << "Alts" << setw(8) << "States";
+    if (!cases.empty())
+        for (const auto &p : cases[0].phases) out << setw(15) << p.phase;
+    out << "\n";
+
+    for (const auto &c : cases) {
+        ReportEvent event("bench_case");
+        event.add("name", c.name).add("kind", c.kind).add("source", c.source)
+            .add("nonterminals", c.nonTerminals).add("alternatives", c.alternatives)
+            .add("states", c.lr0States).add("selected", c.selected);
+        for (const auto &p : c.phases)
+            event.add(p.phase + "_micros", static_cast<int64_t>(p.medianMs * 1000));
+        report.emit(event);
+
+        out << left << setw(14) << c.name << setw(52) << c.source
+            << right << setw(6) << c.nonTerminals << setw(7) << c.alternatives
+            << setw(8) << c.lr0States << fixed << setprecision(3);
+        for (const auto &p : c.phases) out << setw(15) << p.medianMs;
+        out << "\n";
+    }
+    out << "=================================\n";
+
+    report.emit(ReportEvent("message").add("text", out.str()), Verbosity::SUMMARY);
+}
+
+static string jsonString(const string &s) {
+    string out = "\"";
+    for (char ch : s) {
+        if (ch == '"' || ch == '\\') out += '\\';
+        out += ch;
+    }
+    return out + "\"";
+}
+
+bool Benchmark::writeJson(const vector<BenchCase> &cases, const BenchOptions &options) {
+    ofstream out(options.outputPath);
+    if (!out.is_open()) {
+        cerr << "❌ Failed to open " << options.outputPath << " for writing.\n";
+        return false;
+    }
+
+    out << "{\n  \"label\": " << jsonString(options.label)
+        << ",\n  \"timestamp\": " << time(nullptr)
+        << ",\n  \"repeat\": " << (options.quick ? 1 : options.repeat)
+        << ",\n  \"threads\": " << options.threads
+        << ",\n  \"cases\": [\n";
+
+    for (size_t i = 0; i < cases.size(); ++i) {
+        const BenchCase &c = cases[i];
+        out << "    {\"name\": " << jsonString(c.name) << ", \"kind\": " << jsonString(c.kind)
+            << ", \"source\": " << jsonString(c.source)
+            << ", \"nonterminals\": " << c.nonTerminals << ", \"terminals\": " << c.terminals
+            << ", \"alternatives\": " << c.alternatives << ", \"lr0_states\": " << c.lr0States
+            << ", \"corpus_tokens\": " << c.corpusTokens
+            << ", \"ll1_conflicts\": " << c.ll1Conflicts << ", \"lr_conflicts\": " << c.lrConflicts
+            << ", \"selected\": " << jsonString(c.selected) << ",\n     \"phases\": {";
+        for (size_t k = 0; k < c.phases.size(); ++k) {
+            const PhaseTiming &p = c.phases[k];
+            out << (k ? ", " : "") << jsonString(p.phase) << ": {\"median_ms\": " << fixed
+                << setprecision(4) << p.medianMs << ", \"min_ms\": " << p.minMs << "}";
+        }
+        out << "}}" << (i + 1 < cases.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+
+    cout << "📊 Benchmark results written to " << options.outputPath << "\n";
+    return true;
+}
@@ -0,0 +1,81 @@
+// ===============================================================
+// File: Benchmark.h
+// Description: Benchmark suite over generated and fixture grammars.
+//              Every analysis phase, and LL(1)/LR parse loops over
+//              generated sentences, is timed separately (median and
+//              minimum of several runs) and the results are printed
+//              as a table and written as JSON, so two commits can be
+//              compared with scripts/bench_compare.py.
+// ===============================================================
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <vector>
+#include "GrammarGenerator.h"
+
+using namespace std;
+
+// ===============================================================
+// Struct: BenchOptions
+// ===============================================================
+struct BenchOptions {
+    string outputPath = "build/bench.json";
+    string label;                       // stored in the JSON (e.g. a commit id)
+    size_t repeat = 3;                  // runs per phase; median and min are kept
+    bool quick = false;                 // smaller sweep, one run
+    unsigned threads = 0;               // LR(0) automaton workers
+    size_t maxLR1States = 10000;        // parser selection budget
+    size_t sentences = 2000;            // generated input for the parse loops
+    size_t sentenceTokens = 48;
+    vector<string> fixtures = {"data/bench/c_like.txt", "data/bench/sql_like.txt",
+                               "data/expr_grammar.txt"};
+};
+
+// ===============================================================
+// Struct: PhaseTiming
+// ===============================================================
+struct PhaseTiming {
+    string phase;
+    double medianMs = 0.0;
+    double minMs = 0.0;
+};
+
+// ===============================================================
+// Struct: BenchCase
+// ===============================================================
+struct BenchCase {
+    string name;
+    string kind;                        // "generated" | "fixture"
+    string source;                      // shape spec or file path
+    size_t nonTerminals = 0;
+    size_t terminals = 0;
+    size_t alternatives = 0;
+    size_t lr0States = 0;
+    size_t corpusTokens = 0;            // input of parse_ll1 / parse_lr
+    size_t ll1Conflicts = 0;
+    size_t lrConflicts = 0;
+    string selected;                    // ParserBuilder's choice
+    vector<PhaseTiming> phases;
+};
+
+// ===============================================================
+// Class: Benchmark
+// ===============================================================
+class Benchmark {
+public:
+    // Grammar shapes of the sweep: one parameter varied at a time
+    static vector<GrammarShape> sweep(bool quick);
+
+    static BenchCase runCase(const string &name, const string &kind, const string &source,
+                             const string &text, const BenchOptions &options);
+
+    // Run the whole suite, print it and write the JSON; exit code
+    static int run(const BenchOptions &options);
+
+    static bool writeJson(const vector<BenchCase> &cases, const BenchOptions &options);
+    static void display(const vector<BenchCase> &cases);
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include "GrammarGenerator.h"
+#include <random>
+#include <sstream>
+
+using namespace std;
+
+bool GrammarShape::parse(const string &spec) {
+    stringstream ss(spec);
+    string item;
+    while (getline(ss, item, ',')) {
+        size_t eq = item.find('=');
+        if (eq == string::npos) return false;
+        string key = item.substr(0, eq);
+        string value = item.substr(eq + 1);
+        try {
+            if (key == "nt") nonTerminals = stoul(value);
+            else if (key == "t") terminals = stoul(value);
+            else if (key == "alt") alternatives = stoul(value);
+            else if (key == "rhs") rhsLength = stoul(value);
+            else if (key == "nullable") nullableDensity = stod(value);
+            else if (key == "depth") recursionDepth = stoul(value);
+            else if (key == "ntshare") nonTerminalShare = stod(value);
+            else if (key == "seed") seed = stoull(value);
+            else return false;
+        } catch (const exception &) {
+            return false;
+        }
+    }
+    if (nonTerminals == 0) nonTerminals = 1;
+    if (terminals == 0) terminals = 1;
+    if (alternatives == 0) alternatives = 1;
+    if (rhsLength == 0) rhsLength = 1;
+    return true;
+}
+
+string GrammarShape::describe() const {
+    std::ostringstream out;
+    out << "nt=" << nonTerminals << ",t=" << terminals << ",alt=" << alternatives
+        << ",rhs=" << rhsLength << ",nullable=" << nullableDensity
+        << ",depth=" << recursionDepth << ",seed=" << seed;
+    return out.str();
+}
+
+string GrammarGenerator::generateText(const GrammarShape &shape) {
+    mt19937_64 rng(shape.seed);
+    auto chance = [&](double p) { return uniform_real_distribution<double>(0.0, 1.0)(rng) < p; };
+    auto pick = [&](size_t lo, size_t hi) { return uniform_int_distribution<size_t>(lo, hi)(rng); };
+
+    const size_t n = shape.nonTerminals;
+    auto nt = [](size_t i) { return "N" + to_string(i); };
+    auto terminal = [&]() { return "t" + to_string(pick(0, shape.terminals - 1)); };
+
+    std::ostringstream out;
+    out << "# Generated: " << shape.describe() << "\n";
+
+    for (size_t i = 0; i < n; ++i) {
+        out << nt(i) << " ->";
+
+        for (size_t a = 0; a < shape.alternatives; ++a) {
+            size_t length = pick(1, shape.rhsLength);
+            vector<string> rhs;
+
+            // Alternative 0 carries the chain to Ni+1
+            size_t chainAt = (a == 0 && i + 1 < n) ? pick(0, length - 1) : length;
+            // One later alternative closes a cycle back to Ni-depth+1
+            size_t backAt = (a == 1 && shape.recursionDepth > 0 && i + 1 >= shape.recursionDepth)
+                                ? pick(0, length - 1) : length;
+
+            for (size_t k = 0; k < length; ++k) {
+                if (k == chainAt) rhs.push_back(nt(i + 1));
+                else if (k == backAt) rhs.push_back(nt(i + 1 - shape.recursionDepth));
+                else if (i + 1 < n && chance(shape.nonTerminalShare)) rhs.push_back(nt(pick(i + 1, n - 1)));
+                else rhs.push_back(terminal());
+            }
+
+            out << (a ? " |" : "");
+            for (const auto &sym : rhs) out << " " << sym;
+        }
+
+        if (chance(shape.nullableDensity)) out << " | ε";
+        out << "\n";
+    }
+    return out.str();
+}
+
+Grammar GrammarGenerator::generate(const GrammarShape &shape) {
+    Grammar g;
+    g.loadFromText(generateText(shape));
+    return g;
+}
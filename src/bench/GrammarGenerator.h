@@ -0,0 +1,50 @@
+// ===============================================================
+// File: GrammarGenerator.h
+// Description: Parametric random grammars for benchmarking.
+//              Non-terminals N0..Nn-1 form a chain (the first
+//              alternative of Ni uses only deeper non-terminals and
+//              terminals), so every rule is reachable from N0 and
+//              derives some string. Other alternatives may point back
+//              `recursionDepth` steps to form recursive cycles.
+// ===============================================================
+
+#ifndef GRAMMAR_GENERATOR_H
+#define GRAMMAR_GENERATOR_H
+
+#include <string>
+#include <cstdint>
+#include "../grammar/Grammar.h"
+
+using namespace std;
+
+// ===============================================================
+// Struct: GrammarShape
+// ===============================================================
+struct GrammarShape {
+    size_t nonTerminals = 50;
+    size_t terminals = 20;
+    size_t alternatives = 3;        // fan-out per non-terminal
+    size_t rhsLength = 4;           // longest alternative (lengths are 1..rhsLength)
+    double nullableDensity = 0.1;   // share of non-terminals with an ε alternative
+    size_t recursionDepth = 2;      // cycle length of back references (0 = none)
+    double nonTerminalShare = 0.4;  // chance a RHS symbol is a non-terminal
+    uint64_t seed = 1;
+
+    // "nt=200,alt=4,rhs=5,nullable=0.2,depth=3,t=30,seed=7"; keys
+    // left out keep their defaults. False on an unknown key.
+    bool parse(const string &spec);
+    string describe() const;
+};
+
+// ===============================================================
+// Class: GrammarGenerator
+// ===============================================================
+class GrammarGenerator {
+public:
+    // Grammar text in the data/*.txt format
+    static string generateText(const GrammarShape &shape);
+
+    static Grammar generate(const GrammarShape &shape);
+};
+
+#endif
@@ -0,0 +1,670 @@
+#include "CommandLine.h"
+#include "../grammar/Grammar.h"
+#include "../analysis/FirstFollow.h"
+#include "../analysis/conflictDetector.h"
+#include "../parser/LL1Parser.h"
+#include "../parser/LRParser.h"
+#include "../parser/GLRParser.h"
+#include "../parser/LazyAutomaton.h"
+#include "../parser/EarleyParser.h"
+#include "../parser/ParserBuilder.h"
+#include "../parser/IncrementalParser.h"
+#include "../resolver/CounterexampleFinder.h"
+#include "../resolver/GrammarRewriter.h"
+#include "../report/reportWriter.h"
+#include "../report/ReportEvent.h"
+#include "../report/ReportSinks.h"
+#include "../server/ParseServer.h"
+#include "../server/ParseClient.h"
+#include "../bench/Benchmark.h"
+#include "../generator/CorpusWriter.h"
+#include "../batch/BatchAnalyzer.h"
+#include "../util/Parallel.h"
+#include "../util/Instrumentation.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+
+using namespace std;
+
+const vector<string> CommandLine::PHASES = {
+    "grammar", "sets", "ll1", "lr0", "conflicts", "counterexamples", "select", "rewrite"};
+const vector<string> CommandLine::ENGINES = {"ll1", "slr", "lazy", "glr", "earley", "auto",
+                                                "incremental"};
+
+// Defaults when --phases / --engines are not given
+static const set<string> DEFAULT_PHASES = {"grammar", "sets", "ll1", "lr0", "conflicts"};
+static const set<string> DEFAULT_ENGINES = {"ll1", "slr"};
+
+// Terminal + report file, like every display(); the file is left
+// alone when reporting is compiled out
+static void emitText(const string &text) {
+    cout << text;
+#ifndef GRAMRESOLVE_NO_REPORT
+    ReportWriter::get() << text;
+#endif
+}
+
+static void section(const string &title) {
+    emitText("\n\n================= " + title + " =================\n");
+}
+
+static bool splitList(const string &value, const vector<string> &allowed, set<string> &into,
+                      const string &option) {
+    into.clear();
+    stringstream ss(value);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        if (item == "all") {
+            into.insert(allowed.begin(), allowed.end());
+            continue;
+        }
+        bool known = false;
+        for (const auto &a : allowed) known = known || a == item;
+        if (!known) {
+            cerr << "❌ Unknown value '" << item << "' for " << option << "\n";
+            return false;
+        }
+        into.insert(item);
+    }
+    return true;
+}
+
+// One whitespace-separated sentence per line; "-" reads stdin
+static bool readSentences(const string &path, vector<vector<string>> &sentences) {
+    ifstream file;
+    if (path != "-") {
+        file.open(path);
+        if (!file.is_open()) {
+            cerr << "❌ Error: cannot open input file " << path << "\n";
+            return false;
+        }
+    }
+    istream &in = path == "-" ? cin : file;
+
+    string line;
+    while (getline(in, line)) {
+        istringstream ss(line);
+        vector<string> tokens;
+        string tok;
+        while (ss >> tok) tokens.push_back(tok);
+        if (!tokens.empty()) sentences.push_back(tokens);
+    }
+    return true;
+}
+
+static string joinTokens(const vector<string> &tokens) {
+    string s;
+    for (const auto &t : tokens) s += (s.empty() ? "" : " ") + t;
+    return s;
+}
+
+// Incremental engine: the sentences are successive versions of one
+// document. One edit replaces what lies between the common prefix
+// and suffix of the previous version and the next.
+static TokenEdit versionEdit(const vector<string> &previous, vector<string> tokens) {
+    if (!tokens.empty() && tokens.back() == "$") tokens.pop_back();
+
+    size_t prefix = 0;
+    while (prefix < previous.size() && prefix < tokens.size() && previous[prefix] == tokens[prefix])
+        prefix++;
+    size_t suffix = 0;
+    while (suffix < previous.size() - prefix && suffix < tokens.size() - prefix &&
+           previous[previous.size() - 1 - suffix] == tokens[tokens.size() - 1 - suffix])
+        suffix++;
+
+    return {prefix, previous.size() - prefix - suffix,
+            vector<string>(tokens.begin() + prefix, tokens.end() - suffix)};
+}
+
+// ===================================================
+// Argument parsing
+// ===================================================
+bool CommandLine::parse(int argc, char **argv, CliOptions &options) {
+    options.phases.clear();
+    options.engines.clear();
+    bool phasesGiven = false, enginesGiven = false;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        auto value = [&](string &into) {
+            if (i + 1 >= argc) {
+                cerr << "❌ " << arg << " needs a value\n";
+                return false;
+            }
+            into = argv[++i];
+            return true;
+        };
+        string v;
+
+        if (arg == "-h" || arg == "--help") {
+            options.help = true;
+        } else if (arg == "--batch") {
+            if (!value(options.batchDir)) return false;
+        } else if (arg == "--batch-out") {
+            if (!value(options.batchOutput)) return false;
+        } else if (arg == "--stats") {
+            options.stats = true;
+        } else if (arg == "--trace") {
+            if (!value(options.tracePath)) return false;
+        } else if (arg == "--demo") {
+            options.demo = true;
+        } else if (arg == "-g" || arg == "--grammar") {
+            if (!value(options.grammarPath)) return false;
+        } else if (arg == "-i" || arg == "--input") {
+            if (!value(options.inputPath)) return false;
+        } else if (arg == "-p" || arg == "--phases") {
+            if (!value(v) || !splitList(v, PHASES, options.phases, arg)) return false;
+            phasesGiven = true;
+        } else if (arg == "-e" || arg == "--engines") {
+            if (!value(v) || !splitList(v, ENGINES, options.engines, arg)) return false;
+            enginesGiven = true;
+        } else if (arg == "--automaton") {
+            if (!value(options.automatonPath)) return false;
+        } else if (arg == "-q" || arg == "--quiet") {
+            options.quiet = true;
+        } else if (arg == "-t" || arg == "--throughput") {
+            options.throughput = true;
+        } else if (arg == "--report") {
+            if (!value(options.reportFormat)) return false;
+            if (options.reportFormat != "text" && options.reportFormat != "jsonl" &&
+                options.reportFormat != "binary") {
+                cerr << "❌ --report must be text, jsonl or binary\n";
+                return false;
+            }
+        } else if (arg == "--report-file") {
+            if (!value(options.reportPath)) return false;
+        } else if (arg == "-j" || arg == "--threads") {
+            if (!value(v)) return false;
+            try {
+                int n = stoi(v);
+                if (n < 0) throw invalid_argument(v);
+                options.threads = static_cast<unsigned>(n);
+            } catch (const exception &) {
+                cerr << "❌ --threads needs a number, got '" << v << "'\n";
+                return false;
+            }
+        } else if (arg == "--serve") {
+            if (!value(options.servePath)) return false;
+        } else if (arg == "--connect") {
+            if (!value(options.connectPath)) return false;
+        } else if (arg == "--cache-mb") {
+            if (!value(v)) return false;
+            try {
+                options.cacheMegabytes = stoul(v);
+            } catch (const exception &) {
+                cerr << "❌ --cache-mb needs a number, got '" << v << "'\n";
+                return false;
+            }
+        } else if (arg == "--max-line") {
+            if (!value(v)) return false;
+            try {
+                options.maxLineBytes = stoul(v);
+            } catch (const exception &) {
+                cerr << "❌ --max-line needs a number, got '" << v << "'\n";
+                return false;
+            }
+        } else if (arg == "--bench") {
+            options.bench = true;
+        } else if (arg == "--quick") {
+            options.benchQuick = true;
+        } else if (arg == "--repeat") {
+            if (!value(v)) return false;
+            try {
+                options.benchRepeat = stoul(v);
+            } catch (const exception &) {
+                cerr << "❌ --repeat needs a number, got '" << v << "'\n";
+                return false;
+            }
+        } else if (arg == "--bench-out") {
+            if (!value(options.benchOutput)) return false;
+        } else if (arg == "--bench-label") {
+            if (!value(options.benchLabel)) return false;
+        } else if (arg == "--generate-grammar") {
+            if (!value(options.generateSpec)) return false;
+            GrammarShape shape;
+            if (!shape.parse(options.generateSpec)) {
+                cerr << "❌ Bad grammar shape '" << options.generateSpec
+                     << "' (keys: nt, t, alt, rhs, nullable, depth, ntshare, seed)\n";
+                return false;
+            }
+        } else if (arg == "--generate-corpus") {
+            if (!value(options.corpusPath)) return false;
+        } else if (arg == "--corpus-size") {
+            uint64_t bytes;
+            if (!value(options.corpusSize)) return false;
+            if (!CorpusWriter::parseSize(options.corpusSize, bytes)) {
+                cerr << "❌ --corpus-size needs a size like 64M or 2G, got '" << options.corpusSize << "'\n";
+                return false;
+            }
+        } else if (arg == "--sentences" || arg == "--min-tokens" || arg == "--max-tokens" ||
+                   arg == "--error-rate" || arg == "--seed") {
+            if (!value(v)) return false;
+            try {
+                if (arg == "--sentences") options.corpusSentences = stoul(v);
+                else if (arg == "--min-tokens") options.minTokens = stoul(v);
+                else if (arg == "--max-tokens") options.maxTokens = stoul(v);
+                else if (arg == "--error-rate") options.errorRate = stod(v);
+                else options.seed = stoull(v);
+            } catch (const exception &) {
+                cerr << "❌ " << arg << " needs a number, got '" << v << "'\n";
+                return false;
+            }
+        } else if (!arg.empty() && arg[0] != '-' && options.grammarPath.empty()) {
+            options.grammarPath = arg;          // positional grammar
+        } else {
+            cerr << "❌ Unknown argument '" << arg << "' (see --help)\n";
+            return false;
+        }
+    }
+
+    if (options.help || options.demo || !options.servePath.empty() || options.bench ||
+        !options.generateSpec.empty() || !options.batchDir.empty())
+        return true;
+    if (options.grammarPath.empty()) {
+        cerr << "❌ No grammar given (see --help)\n";
+        return false;
+    }
+
+    // Throughput runs time the engines only, unless phases are named
+    if (!phasesGiven && !options.throughput) options.phases = DEFAULT_PHASES;
+    if (!enginesGiven) options.engines = DEFAULT_ENGINES;
+    // Reports land next to the executable, not in the working directory
+    if (options.reportPath.empty())
+        options.reportPath = ReportWriter::defaultDirectory() +
+            (options.reportFormat == "binary" ? "/report.grpt" :
+             options.reportFormat == "jsonl"  ? "/report.jsonl" : "/report.txt");
+    return true;
+}
+
+void CommandLine::printUsage() {
+    cout << "Usage: text.exe [GRAMMAR] [options]\n"
+            "       text.exe                 run the full demo\n"
+            "\n"
+            "  -g, --grammar FILE      grammar file\n"
+            "  -i, --input FILE        token file, one sentence per line ('-' = stdin)\n"
+            "  -p, --phases LIST       grammar,sets,ll1,lr0,conflicts,counterexamples,select,rewrite | all\n"
+            "                          (default: grammar,sets,ll1,lr0,conflicts)\n"
+            "  -e, --engines LIST      ll1,slr,lazy,glr,earley,auto,incremental | all (default: ll1,slr)\n"
+            "      --automaton FILE    lazy engine: load the saved automaton if FILE exists,\n"
+            "                          save it back with the rows this run built\n"
+            "  -q, --quiet             results only: no dumps, no parse traces\n"
+            "  -t, --throughput        silent runs over every sentence, timed per engine\n"
+            "      --report FORMAT     text | jsonl | binary (structured copy of the dumps)\n"
+            "      --report-file FILE  where the report goes (default: src/report/report.{txt,jsonl,grpt}\n"
+            "                          next to text.exe)\n"
+            "  -j, --threads N         worker threads (0 = all hardware threads)\n"
+            "      --serve SOCKET      run the parse server on a Unix socket ('-' = stdin/stdout)\n"
+            "      --cache-mb N        server grammar cache cap (default 64)\n"
+            "      --max-line BYTES    server request line cap (default 1048576)\n"
+            "      --connect SOCKET    send GRAMMAR and INPUT to a running server\n"
+            "      --bench             time every phase over generated and fixture grammars\n"
+            "      --quick             smaller benchmark sweep, one run per phase\n"
+            "      --repeat N          benchmark runs per phase (default 3)\n"
+            "      --bench-out FILE    benchmark JSON (default build/bench.json)\n"
+            "      --bench-label TEXT  label stored in the JSON, e.g. a commit id\n"
+            "      --generate-grammar SPEC  print a generated grammar,\n"
+            "                          SPEC = nt=100,t=20,alt=3,rhs=4,nullable=0.1,depth=2,seed=1\n"
+            "      --generate-corpus FILE  write random sentences of GRAMMAR ('-' = stdout)\n"
+            "      --sentences N       corpus size in sentences\n"
+            "      --corpus-size SIZE  corpus size in bytes (512K, 64M, 2G)\n"
+            "      --min-tokens N      grow sentences to at least N tokens when possible (default 1)\n"
+            "      --max-tokens N      sentence length bound (default 64)\n"
+            "      --error-rate P      share of sentences given one syntax error (default 0)\n"
+            "      --seed N            corpus / sentence seed (default 1)\n"
+            "      --batch DIR         analyze every grammar under DIR, one per worker (-j)\n"
+            "      --batch-out DIR     per-grammar summaries and summary.txt (default build/batch-summaries)\n"
+            "      --stats             print phase times, work counters, allocations and peak RSS\n"
+            "      --trace FILE        write a Chrome trace-event JSON of every phase\n"
+            "      --demo              run the full demo\n"
+            "  -h, --help              this text\n"
+            "\n"
+            "Exit codes: 0 ok, 1 unreadable grammar/input, 2 bad arguments,\n"
+            "            3 some sentence was rejected by some engine\n";
+}
+
+// ===================================================
+// Run
+// ===================================================
+int CommandLine::run(const CliOptions &o) {
+    using Clock = chrono::steady_clock;
+    auto has = [](const set<string> &s, const string &x) { return s.count(x) != 0; };
+    const bool verbose = !o.quiet && !o.throughput;
+    if (o.reportFormat == "text") ReportWriter::setPath(o.reportPath);
+
+    // 🔹 Server modes: no local analysis
+    if (!o.servePath.empty()) {
+        ServerOptions server;
+        server.socketPath = o.servePath;
+        server.workers = o.threads;
+        server.cacheBytes = o.cacheMegabytes << 20;
+        server.maxLineBytes = o.maxLineBytes;
+        return ParseServer(server).run();
+    }
+    if (!o.generateSpec.empty()) {
+        GrammarShape shape;
+        shape.parse(o.generateSpec);
+        cout << GrammarGenerator::generateText(shape);
+        return 0;
+    }
+    if (o.bench) {
+        BenchOptions bench;
+        bench.outputPath = o.benchOutput;
+        bench.label = o.benchLabel;
+        bench.repeat = o.benchRepeat;
+        bench.quick = o.benchQuick;
+        bench.threads = o.threads;
+        return Benchmark::run(bench);
+    }
+    if (!o.batchDir.empty()) {
+        BatchOptions batch;
+        batch.directory = o.batchDir;
+        batch.outputDir = o.batchOutput;
+        batch.threads = o.threads;
+        return BatchAnalyzer::run(batch);
+    }
+    if (!o.corpusPath.empty()) {
+        Grammar grammar;
+        if (!grammar.loadFromFile(o.grammarPath))
+            return 1;
+
+        CorpusOptions corpus;
+        corpus.outputPath = o.corpusPath;
+        corpus.sentences = o.corpusSentences;
+        if (!o.corpusSize.empty()) CorpusWriter::parseSize(o.corpusSize, corpus.bytes);
+        if (corpus.sentences == 0 && corpus.bytes == 0) corpus.sentences = 1000;
+        corpus.sentence.minTokens = o.minTokens;
+        corpus.sentence.maxTokens = o.maxTokens;
+        corpus.sentence.errorRate = o.errorRate;
+        corpus.seed = o.seed;
+        corpus.threads = o.threads;
+
+        CorpusSummary summary;
+        if (!CorpusWriter::write(SentenceGenerator(grammar), corpus, summary))
+            return 1;
+        CorpusWriter::display(summary, o.corpusPath);
+        return 0;
+    }
+    if (!o.connectPath.empty())
+        return ParseClient::run(o.connectPath, o.grammarPath, o.inputPath, o.quiet);
+
+    // 🔹 Report sinks: text only when verbose, structured on request
+#ifndef GRAMRESOLVE_NO_REPORT
+    ReportWriter::get().clear();
+#endif
+    ReportStream &report = ReportStream::get();
+    report.clearSinks();
+    if (verbose)
+        report.addSink(unique_ptr<ReportSink>(new TextRenderer()));
+    if (o.reportFormat == "jsonl")
+        report.addSink(unique_ptr<ReportSink>(new JsonLinesSink(o.reportPath)));
+    else if (o.reportFormat == "binary")
+        report.addSink(unique_ptr<ReportSink>(new BinarySink(o.reportPath)));
+
+    Grammar grammar;
+    if (!grammar.loadFromFile(o.grammarPath))
+        return 1;                       // loadFromFile says why
+
+    vector<vector<string>> sentences;
+    if (!o.inputPath.empty() && !readSentences(o.inputPath, sentences))
+        return 1;
+
+    vector<pair<string, double>> timings;
+    auto timed = [&](const string &name, const function<void()> &fn) {
+        auto t0 = Clock::now();
+        fn();
+        timings.push_back({name, chrono::duration<double, milli>(Clock::now() - t0).count()});
+    };
+
+    const bool useSentences = !sentences.empty();
+    const bool needLL1 = has(o.phases, "ll1") || has(o.phases, "conflicts") ||
+                         (useSentences && has(o.engines, "ll1"));
+    const bool needLR0 = has(o.phases, "lr0") || has(o.phases, "conflicts") ||
+                         has(o.phases, "counterexamples") ||
+                         (useSentences && (has(o.engines, "slr") || has(o.engines, "glr") ||
+                                           has(o.engines, "incremental")));
+    const bool needBuild = has(o.phases, "select") || (useSentences && has(o.engines, "auto"));
+    const bool needEarley = useSentences && has(o.engines, "earley");
+    const bool needLazy = useSentences && has(o.engines, "lazy");
+
+    // 🔹 Analyses
+    if (has(o.phases, "grammar")) {
+        if (verbose) section("GRAMMAR LOADED");
+        grammar.display();
+    }
+
+    FirstFollowEngine ff;
+    if (needLL1 || needEarley || has(o.phases, "sets")) {
+        timed("FIRST/FOLLOW", [&] {
+            ff.computeFIRST(grammar);
+            ff.computeFOLLOW(grammar);
+        });
+        if (has(o.phases, "sets")) {
+            if (verbose) section("FIRST & FOLLOW");
+            ff.display();
+        }
+    }
+
+    LL1Parser ll1(grammar, ff);
+    if (needLL1) {
+        if (verbose && has(o.phases, "ll1")) section("LL(1) PARSER");
+        timed("LL(1) table", [&] { ll1.buildTable(); });
+        if (has(o.phases, "ll1")) ll1.displayTable();
+    }
+
+    LR0Parser lr0(grammar);
+    lr0.setThreadCount(o.threads);
+    if (needLR0) {
+        if (verbose && has(o.phases, "lr0")) section("LR(0) PARSER");
+        timed("LR(0) automaton", [&] { lr0.buildAutomaton(); });
+        if (has(o.phases, "lr0")) lr0.displayStates();
+    }
+
+    if (has(o.phases, "conflicts")) {
+        if (verbose) section("CONFLICT DETECTOR");
+        vector<Conflict> ll1Conflicts, lrConflicts;
+        timed("Conflict detection", [&] {
+            ll1Conflicts = ConflictDetector::detectLL1Conflicts(ll1);
+            lrConflicts = ConflictDetector::detectLRConflicts(lr0.getTable());
+        });
+        ConflictDetector::displayConflicts(ll1Conflicts);
+        ConflictDetector::displayConflicts(lrConflicts);
+        if (!verbose)
+            emitText("Conflicts: " + to_string(ll1Conflicts.size()) + " LL(1), " +
+                     to_string(lrConflicts.size()) + " LR(0)/SLR\n");
+    }
+
+    if (has(o.phases, "counterexamples")) {
+        if (verbose) section("COUNTEREXAMPLES");
+        CounterexampleBudget budget;
+        budget.threads = o.threads;
+        vector<Counterexample> examples;
+        timed("Counterexamples", [&] { examples = CounterexampleFinder(lr0, budget).findAll(); });
+        if (verbose) CounterexampleFinder::display(examples);
+        else emitText("Counterexamples: " + to_string(examples.size()) + "\n");
+    }
+
+    ParserBuild build;
+    if (needBuild) {
+        timed("Parser selection", [&] { build = ParserBuilder::build(grammar); });
+        if (has(o.phases, "select")) {
+            if (verbose) {
+                section("PARSER SELECTION");
+                ParserBuilder::display(build);
+            } else {
+                emitText("Parser: " + algorithmName(build.algorithm) +
+                         (build.conflictFree ? " (conflict-free)\n" : " (conflicts remain)\n"));
+            }
+        }
+    }
+
+    if (has(o.phases, "rewrite")) {
+        RewriteResult rewritten;
+        timed("Grammar rewriting", [&] { rewritten = GrammarRewriter(grammar).rewriteToLL1(); });
+        if (verbose) {
+            section("GRAMMAR REWRITING");
+            GrammarRewriter::display(rewritten);
+        } else {
+            emitText("Rewriting: " + to_string(rewritten.initialConflicts) + " → " +
+                     to_string(rewritten.finalConflicts) + " LL(1) conflicts in " +
+                     to_string(rewritten.steps.size()) + " steps\n");
+        }
+    }
+
+    // 🔹 Engines over the input
+    vector<string> engines;
+    for (const auto &e : ENGINES)
+        if (has(o.engines, e)) engines.push_back(e);
+
+    size_t rejected = 0;
+    unique_ptr<EarleyParser> earley(needEarley ? new EarleyParser(grammar, ff) : nullptr);
+
+    // The lazy automaton is shared by every worker; a saved one is
+    // only trusted when it was written for this grammar
+    unique_ptr<LazyLRAutomaton> lazy(needLazy ? new LazyLRAutomaton(grammar) : nullptr);
+    if (lazy && !o.automatonPath.empty() && ifstream(o.automatonPath).good() &&
+        lazy->load(o.automatonPath) && !o.quiet)
+        emitText("Lazy automaton: loaded " + to_string(lazy->getExpandedStates()) + " rows from " +
+                 o.automatonPath + "\n");
+
+    if (useSentences && !o.throughput) {
+        if (verbose) section("PARSING");
+        PhaseTimer timer("parse");
+        IncrementalParser incremental(lr0);
+
+        for (size_t k = 0; k < sentences.size(); ++k) {
+            vector<string> tokens = sentences[k];
+            if (tokens.back() != "$") tokens.push_back("$");
+
+            std::ostringstream line;
+            line << "#" << k + 1;
+
+            for (const auto &e : engines) {
+                bool ok = false;
+                string extra;
+                if (e == "ll1") {
+                    ok = ll1.recognize(tokens);
+                    if (verbose) ll1.parse(tokens);
+                } else if (e == "slr") {
+                    vector<int> ids;
+                    ok = lr0.getTable().encodeTokens(tokens, ids) && lr0.recognize(ids);
+                    if (verbose) lr0.parse(tokens);
+                } else if (e == "lazy") {
+                    ok = lazy->recognize(tokens);
+                    if (lazy->limitReached()) extra = " (automaton limit reached)";
+                } else if (e == "glr") {
+                    GLRParser glr(lr0);
+                    ok = glr.parse(tokens);
+                    if (ok) {
+                        uint64_t trees = glr.getForest().countTrees();
+                        extra = trees == UINT64_MAX ? " (infinitely many trees)"
+                                                    : " (" + to_string(trees) + " trees)";
+                    }
+                    if (verbose) glr.displayForest();
+                } else if (e == "earley") {
+                    ok = verbose ? earley->parse(tokens) : earley->recognize(tokens);
+                    if (verbose) earley->displayForest();
+                } else if (e == "incremental") {
+                    // The reparse must end where a parse from scratch does
+                    ok = incremental.reparse({versionEdit(incremental.getTokens(), tokens)});
+                    IncrementalParser full(lr0);
+                    bool fullOk = full.parse<SilentLog>(tokens);
+                    if (ok != fullOk || incremental.getTokens() != full.getTokens() ||
+                        incremental.treeToString() != full.treeToString()) {
+                        ok = false;
+                        extra = " (differs from a full parse)";
+                    } else if (ok) {
+                        extra = " (" + to_string(incremental.getStats().reusedTokens) + " tokens reused)";
+                    }
+                    if (verbose) incremental.displayStats("sentence " + to_string(k + 1));
+                } else {
+                    ok = ParserBuilder::recognize(build, tokens);
+                }
+                if (!ok) rejected++;
+                line << " " << e << " " << (ok ? "✅" : "❌") << extra;
+            }
+            line << "   " << joinTokens(sentences[k]) << "\n";
+            emitText(line.str());
+        }
+    }
+
+    if (useSentences && o.throughput) {
+        size_t tokenCount = 0;
+        for (const auto &s : sentences) tokenCount += s.size();
+
+        std::ostringstream out;
+        out << "\n===== Throughput (" << sentences.size() << " sentences, " << tokenCount
+            << " tokens) =====\n";
+        out << left << setw(13) << "Engine" << setw(9) << "Threads" << setw(11) << "Accepted"
+            << setw(12) << "Time (ms)" << setw(15) << "Sentences/s" << "Tokens/s\n";
+
+        for (const auto &e : engines) {
+            // Engines with per-run state get one driver per block of
+            // sentences; the SLR driver reuses the parser's own stack
+            // and incremental versions build on each other
+            unsigned workers = e == "slr" || e == "incremental" ? 1 : resolveThreadCount(o.threads);
+            size_t blocks = min<size_t>(workers, sentences.size());
+            vector<size_t> accepted(blocks, 0);
+
+            PhaseTimer timer("parse");
+            auto t0 = Clock::now();
+            parallelFor(blocks, workers, [&](size_t b) {
+                size_t from = sentences.size() * b / blocks;
+                size_t to = sentences.size() * (b + 1) / blocks;
+                unique_ptr<GLRParser> glr(e == "glr" ? new GLRParser(lr0) : nullptr);
+                unique_ptr<EarleyParser> chart(e == "earley" ? new EarleyParser(grammar, ff) : nullptr);
+                unique_ptr<IncrementalParser> inc(e == "incremental" ? new IncrementalParser(lr0) : nullptr);
+                vector<int> ids;
+
+                for (size_t k = from; k < to; ++k) {
+                    const auto &tokens = sentences[k];
+                    bool ok;
+                    if (e == "ll1") ok = ll1.recognize(tokens);
+                    else if (e == "slr") ok = lr0.getTable().encodeTokens(tokens, ids) && lr0.recognize(ids);
+                    else if (e == "lazy") ok = lazy->recognize(tokens);
+                    else if (e == "glr") ok = lr0.getTable().encodeTokens(tokens, ids) && glr->parse<SilentLog>(tokens);
+                    else if (e == "earley") ok = chart->recognize(tokens);
+                    else if (e == "incremental") ok = inc->reparse<SilentLog>({versionEdit(inc->getTokens(), tokens)});
+                    else ok = ParserBuilder::recognize(build, tokens);
+                    if (ok) accepted[b]++;
+                }
+            });
+            double ms = chrono::duration<double, milli>(Clock::now() - t0).count();
+
+            size_t total = 0;
+            for (size_t a : accepted) total += a;
+            rejected += sentences.size() - total;
+
+            double seconds = ms / 1000.0;
+            out << setw(13) << e << setw(9) << blocks << setw(11) << total
+                << setw(12) << fixed << setprecision(3) << ms
+                << setw(15) << setprecision(0) << (seconds > 0 ? sentences.size() / seconds : 0.0)
+                << (seconds > 0 ? tokenCount / seconds : 0.0) << "\n";
+        }
+        emitText(out.str());
+    }
+
+    if (lazy) {
+        if (verbose) emitText(lazy->summary());
+        else if (lazy->limitReached()) emitText("Lazy automaton: automaton limit reached, inputs rejected\n");
+        if (!o.automatonPath.empty() && lazy->save(o.automatonPath) && !o.quiet)
+            emitText("Lazy automaton: saved " + to_string(lazy->getExpandedStates()) + " of " +
+                     to_string(lazy->getDiscoveredStates()) + " rows to " + o.automatonPath + "\n");
+    }
+
+    // 🔹 Phase timings
+    if (!o.quiet && !timings.empty()) {
+        std::ostringstream out;
+        out << "\n===== Phase timings =====\n";
+        for (const auto &t : timings)
+            out << "  " << left << setw(22) << t.first << fixed << setprecision(3) << t.second << " ms\n";
+        emitText(out.str());
+    }
+
+    report.flush();
+    return rejected ? 3 : 0;
+}
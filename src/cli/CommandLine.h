@@ -0,0 +1,76 @@
+// ===============================================================
+// File: CommandLine.h
+// Description: Command-line driver. Loads a grammar and an optional
+//              token file (or stdin), runs only the analyses and
+//              parsing engines that were asked for, and either
+//              traces each sentence or measures throughput.
+//              Without arguments main() runs the full demo instead.
+// ===============================================================
+
+#ifndef COMMAND_LINE_H
+#define COMMAND_LINE_H
+
+#include <string>
+#include <vector>
+#include <set>
+
+using namespace std;
+
+// ===============================================================
+// Struct: CliOptions
+// ===============================================================
+struct CliOptions {
+    string grammarPath;
+    string inputPath;                   // "-" = stdin, "" = no input
+    set<string> phases;                 // see CommandLine::PHASES
+    set<string> engines;                // see CommandLine::ENGINES
+    string automatonPath;               // lazy engine: saved automaton to load and update
+    bool quiet = false;                 // results only, no dumps or traces
+    bool throughput = false;            // silent runs over all sentences, timed
+    string reportFormat = "text";       // text | jsonl | binary
+    string reportPath;                  // report file, any format
+    unsigned threads = 0;               // 0 = all hardware threads
+    string servePath;                   // parse server socket ("-" = stdin/stdout)
+    string connectPath;                 // send the input to a running server
+    size_t cacheMegabytes = 64;         // server grammar cache cap
+    size_t maxLineBytes = 1u << 20;     // server request line cap
+    bool bench = false;                 // run the benchmark suite
+    bool benchQuick = false;
+    size_t benchRepeat = 3;
+    string benchOutput = "build/bench.json";
+    string benchLabel;
+    string generateSpec;                // print a generated grammar ("nt=..,alt=..")
+    string corpusPath;                  // write a generated token corpus ("-" = stdout)
+    size_t corpusSentences = 0;
+    string corpusSize;                  // "512M", "2G", ...
+    size_t minTokens = 1;
+    size_t maxTokens = 64;
+    double errorRate = 0.0;
+    uint64_t seed = 1;
+    string batchDir;                    // analyze every grammar under this directory
+    string batchOutput = "build/batch-summaries";   // per-grammar summaries + summary.txt
+    bool stats = false;                 // print the instrumentation summary at exit
+    string tracePath;                   // Chrome trace-event JSON
+    bool demo = false;
+    bool help = false;
+};
+
+// ===============================================================
+// Class: CommandLine
+// ===============================================================
+class CommandLine {
+public:
+    static const vector<string> PHASES;     // grammar, sets, ll1, lr0, conflicts, ...
+    static const vector<string> ENGINES;    // ll1, slr, lazy, glr, earley, auto, incremental
+
+    // Fill `options` from argv; false (after printing why) on a bad
+    // argument
+    static bool parse(int argc, char **argv, CliOptions &options);
+
+    static void printUsage();
+
+    // Run the selected phases and engines; returns the exit code
+    static int run(const CliOptions &options);
+};
+
+#endif
@@ -0,0 +1,189 @@
+#include "CorpusWriter.h"
+#include "../report/reportWriter.h"
+#include "../report/ReportEvent.h"
+#include "../util/Parallel.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+
+using namespace std;
+
+bool CorpusWriter::parseSize(const string &text, uint64_t &bytes) {
+    size_t used = 0;
+    double value;
+    try {
+        value = stod(text, &used);
+    } catch (const exception &) {
+        return false;
+    }
+    string unit = text.substr(used);
+    uint64_t scale = 1;
+    if (unit == "K" || unit == "k") scale = 1ULL << 10;
+    else if (unit == "M" || unit == "m") scale = 1ULL << 20;
+    else if (unit == "G" || unit == "g") scale = 1ULL << 30;
+    else if (!unit.empty()) return false;
+    if (value < 0) return false;
+    bytes = static_cast<uint64_t>(value * scale);
+    return true;
+}
+
+// One block of sentences, rendered as corpus lines
+struct CorpusBlock {
+    string text;
+    size_t sentences = 0;
+    size_t tokens = 0;
+    vector<size_t> errorLines;          // lines given a syntax error, ascending
+};
+
+static void fillBlock(const SentenceGenerator &generator, const CorpusOptions &options,
+                      size_t index, size_t count, CorpusBlock &block) {
+    mt19937_64 rng(options.seed ^ ((index + 1) * 0x9E3779B97F4A7C15ULL));
+
+    block.text.clear();
+    block.sentences = count;
+    block.tokens = 0;
+    block.errorLines.clear();
+    for (size_t k = 0; k < count; ++k)
+        if (generator.appendLine(rng, options.sentence, block.text, block.tokens))
+            block.errorLines.push_back(k);
+}
+
+bool CorpusWriter::write(const SentenceGenerator &generator, const CorpusOptions &options,
+                         CorpusSummary &summary) {
+    if (!generator.valid()) {
+        cerr << "❌ The start symbol derives no terminal string; nothing to generate.\n";
+        return false;
+    }
+    if (options.sentences == 0 && options.bytes == 0) {
+        cerr << "❌ Give a sentence count or a byte size for the corpus.\n";
+        return false;
+    }
+
+    FILE *out = options.outputPath == "-" ? stdout : fopen(options.outputPath.c_str(), "wb");
+    if (!out) {
+        cerr << "❌ Failed to open " << options.outputPath << " for writing.\n";
+        return false;
+    }
+    setvbuf(out, nullptr, _IOFBF, 1 << 20);
+
+    auto t0 = chrono::steady_clock::now();
+    const unsigned workers = resolveThreadCount(options.threads);
+    const size_t perBlock = max<size_t>(options.blockSentences, 1);
+
+    summary = CorpusSummary();
+    bool done = false;                  // set by the writer; read once it is joined
+    bool ok = true;
+
+    // Write whole blocks; the last one is cut at the line where the
+    // sentence or byte target is reached
+    auto writeRound = [&](vector<CorpusBlock> &round) {
+        for (auto &block : round) {
+            if (done || block.sentences == 0) continue;
+
+            size_t length = block.text.size();
+            size_t sentences = block.sentences;
+            size_t tokens = block.tokens;
+            bool last = options.bytes && summary.bytes + length >= options.bytes;
+
+            if (last) {
+                length = 0;
+                sentences = tokens = 0;
+                while (summary.bytes + length < options.bytes) {
+                    size_t nl = block.text.find('\n', length);
+                    tokens += 1 + count(block.text.begin() + length, block.text.begin() + nl, ' ');
+                    if (nl == length) tokens--;         // empty sentence
+                    length = nl + 1;
+                    sentences++;
+                }
+                done = true;
+            }
+
+            if (fwrite(block.text.data(), 1, length, out) != length) {
+                ok = false;
+                done = true;
+            }
+            summary.bytes += length;
+            summary.sentences += sentences;
+            summary.tokens += tokens;
+            summary.errors += lower_bound(block.errorLines.begin(), block.errorLines.end(), sentences) -
+                              block.errorLines.begin();
+        }
+        if (options.sentences && summary.sentences >= options.sentences) done = true;
+    };
+
+    // Two rounds in flight: one being generated, one being written
+    vector<CorpusBlock> rounds[2] = {vector<CorpusBlock>(workers), vector<CorpusBlock>(workers)};
+    thread writer;
+    size_t nextBlock = 0, planned = 0;
+
+    for (int r = 0;; r ^= 1) {
+        vector<CorpusBlock> &round = rounds[r];
+        size_t first = nextBlock;
+        parallelFor(workers, workers, [&](size_t w) {
+            size_t count = perBlock;
+            if (options.sentences) {
+                size_t begin = (first + w) * perBlock;
+                count = begin >= options.sentences ? 0 : min(perBlock, options.sentences - begin);
+            }
+            fillBlock(generator, options, first + w, count, round[w]);
+        });
+        nextBlock += workers;
+        planned += workers * perBlock;
+
+        if (writer.joinable()) writer.join();
+        if (done) break;
+        writer = thread(writeRound, ref(round));
+
+        // With a sentence count the last round is known in advance
+        if (options.sentences && planned >= options.sentences) {
+            writer.join();
+            break;
+        }
+    }
+    if (writer.joinable()) writer.join();
+
+    if (out != stdout) fclose(out);
+    else fflush(out);
+
+    summary.millis = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    if (!ok) cerr << "❌ Writing " << options.outputPath << " failed.\n";
+    return ok;
+}
+
+void CorpusWriter::display(const CorpusSummary &summary, const string &outputPath) {
+    ReportStream &report = ReportStream::get();
+    report.emit(ReportEvent("corpus")
+                    .add("output", outputPath)
+                    .add("sentences", summary.sentences)
+                    .add("tokens", summary.tokens)
+                    .add("bytes", static_cast<int64_t>(summary.bytes))
+                    .add("errors", summary.errors)
+                    .add("micros", static_cast<int64_t>(summary.millis * 1000)));
+
+    double seconds = summary.millis / 1000.0;
+    std::ostringstream out;
+    out << "\n===== Generated Corpus =====\n";
+    out << "Output           : " << (outputPath == "-" ? "stdout" : outputPath) << "\n";
+    out << "Sentences        : " << summary.sentences << "\n";
+    out << "Tokens           : " << summary.tokens << "\n";
+    out << "Bytes            : " << summary.bytes << "\n";
+    out << "With syntax error: " << summary.errors << "\n";
+    out << "Time             : " << fixed << setprecision(1) << summary.millis << " ms ("
+        << setprecision(1) << (seconds > 0 ? summary.bytes / seconds / (1 << 20) : 0.0) << " MiB/s)\n";
+    out << "============================\n";
+
+    // The text renderer writes to stdout; when the corpus itself
+    // goes there, the summary goes to stderr and the report file
+    if (outputPath != "-") {
+        report.emit(ReportEvent("message").add("text", out.str()), Verbosity::SUMMARY);
+        return;
+    }
+    cerr << out.str();
+#ifndef GRAMRESOLVE_NO_REPORT
+    ReportWriter::get() << out.str();
+#endif
+}
@@ -0,0 +1,59 @@
+// ===============================================================
+// File: CorpusWriter.h
+// Description: Streams a generated token corpus to a file (one
+//              sentence per line, the format every driver reads).
+//              Worker threads fill fixed-size blocks of sentences
+//              while the previous round of blocks is written, so
+//              memory stays at two rounds however large the corpus.
+//              Block k always uses the same seed, so the output does
+//              not depend on the thread count.
+// ===============================================================
+
+#ifndef CORPUS_WRITER_H
+#define CORPUS_WRITER_H
+
+#include <string>
+#include <cstdint>
+#include "SentenceGenerator.h"
+
+using namespace std;
+
+// ===============================================================
+// Struct: CorpusOptions
+// ===============================================================
+struct CorpusOptions {
+    string outputPath;                  // "-" = stdout
+    size_t sentences = 0;               // stop after this many (0 = use bytes)
+    uint64_t bytes = 0;                 // ... or once this much was written
+    SentenceOptions sentence;
+    uint64_t seed = 1;
+    unsigned threads = 0;               // 0 = all hardware threads
+    size_t blockSentences = 4096;
+};
+
+// ===============================================================
+// Struct: CorpusSummary
+// ===============================================================
+struct CorpusSummary {
+    size_t sentences = 0;
+    size_t tokens = 0;
+    uint64_t bytes = 0;
+    size_t errors = 0;                  // sentences given a syntax error
+    double millis = 0.0;
+};
+
+// ===============================================================
+// Class: CorpusWriter
+// ===============================================================
+class CorpusWriter {
+public:
+    // Parse "512K", "64M", "2G" (or plain bytes); false on junk
+    static bool parseSize(const string &text, uint64_t &bytes);
+
+    static bool write(const SentenceGenerator &generator, const CorpusOptions &options,
+                      CorpusSummary &summary);
+
+    static void display(const CorpusSummary &summary, const string &outputPath);
+};
+
+#endif
@@ -0,0 +1,202 @@
+#include "SentenceGenerator.h"
+#include <algorithm>
+#include <unordered_map>
+
+using namespace std;
+
+SentenceGenerator::SentenceGenerator(const Grammar &g) {
+    // 🔹 Number the symbols: terminals first, then non-terminals
+    unordered_map<string, int> ids;
+    for (const auto &t : g.getTerminals()) {
+        ids[t] = static_cast<int>(names.size());
+        names.push_back(t);
+    }
+    terminalCount = names.size();
+    for (const auto &nt : g.getNonTerminals()) {
+        ids[nt] = static_cast<int>(names.size());
+        names.push_back(nt);
+    }
+
+    const size_t n = names.size() - terminalCount;
+    alternatives.assign(n, {});
+    for (const auto &p : g.getProductions()) {
+        auto &alts = alternatives[ids[p.getLHS()] - terminalCount];
+        for (const auto &rhs : p.getRHS()) {
+            vector<int> alt;
+            for (const auto &sym : rhs)
+                if (sym != "ε") alt.push_back(ids[sym]);
+            alts.push_back(alt);
+        }
+    }
+    auto it = ids.find(g.getStartSymbol());
+    if (it != ids.end() && !isTerminal(it->second)) start = it->second;
+
+    // 🔹 Minimum derivation length and height, to a fixpoint
+    minLength.assign(n, UNBOUNDED);
+    height.assign(n, UNBOUNDED);
+    altMinLength.assign(n, {});
+    altHeight.assign(n, {});
+    for (size_t i = 0; i < n; ++i) {
+        altMinLength[i].assign(alternatives[i].size(), UNBOUNDED);
+        altHeight[i].assign(alternatives[i].size(), UNBOUNDED);
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t a = 0; a < alternatives[i].size(); ++a) {
+                size_t length = 0, h = 0;
+                for (int sym : alternatives[i][a]) {
+                    if (isTerminal(sym)) {
+                        length++;
+                        continue;
+                    }
+                    size_t k = sym - terminalCount;
+                    if (minLength[k] == UNBOUNDED) {
+                        length = h = UNBOUNDED;
+                        break;
+                    }
+                    length += minLength[k];
+                    h = max(h, height[k]);
+                }
+                if (length == UNBOUNDED) continue;
+
+                altMinLength[i][a] = min(altMinLength[i][a], length);
+                altHeight[i][a] = min(altHeight[i][a], h + 1);
+                if (length < minLength[i]) {
+                    minLength[i] = length;
+                    changed = true;
+                }
+                if (h + 1 < height[i]) {
+                    height[i] = h + 1;
+                    changed = true;
+                }
+            }
+        }
+    }
+}
+
+size_t SentenceGenerator::lowestAlternative(int nt) const {
+    const auto &heights = altHeight[nt - terminalCount];
+    return min_element(heights.begin(), heights.end()) - heights.begin();
+}
+
+bool SentenceGenerator::derive(mt19937_64 &rng, const SentenceOptions &options,
+                               vector<int> &ids) const {
+    ids.clear();
+    if (!valid()) return false;
+
+    // Reused between calls on the same thread
+    thread_local vector<int> stack;
+    thread_local vector<size_t> candidates, growing;
+    stack.assign(1, start);
+
+    // Tokens emitted plus the shortest completion of what is pending
+    size_t committed = minLength[start - terminalCount];
+
+    // Zero-length cycles (A -> B, B -> A) could spin forever; after
+    // this many expansions only height-decreasing choices are made
+    size_t expansions = 0;
+    const size_t patience = 16 * (options.maxTokens + names.size());
+
+    while (!stack.empty()) {
+        int sym = stack.back();
+        stack.pop_back();
+        if (isTerminal(sym)) {
+            ids.push_back(sym);
+            continue;
+        }
+
+        size_t k = sym - terminalCount;
+        size_t chosen;
+        if (++expansions > patience) {
+            chosen = lowestAlternative(sym);
+        } else {
+            candidates.clear();
+            growing.clear();
+            for (size_t a = 0; a < alternatives[k].size(); ++a) {
+                size_t length = altMinLength[k][a];
+                if (length == UNBOUNDED) continue;
+                size_t after = committed - minLength[k] + length;
+                if (after > options.maxTokens && length > minLength[k]) continue;
+                candidates.push_back(a);
+                if (length > minLength[k]) growing.push_back(a);
+            }
+
+            // Below the minimum length, prefer alternatives that grow
+            const auto &pool = (committed < options.minTokens && !growing.empty()) ? growing : candidates;
+            chosen = pool[uniform_int_distribution<size_t>(0, pool.size() - 1)(rng)];
+        }
+
+        committed = committed - minLength[k] + altMinLength[k][chosen];
+        const auto &alt = alternatives[k][chosen];
+        for (auto it = alt.rbegin(); it != alt.rend(); ++it)
+            stack.push_back(*it);
+    }
+
+    if (options.errorRate > 0.0 && terminalCount > 0 &&
+        uniform_real_distribution<double>(0.0, 1.0)(rng) < options.errorRate) {
+        injectError(rng, ids);
+        return true;
+    }
+    return false;
+}
+
+bool SentenceGenerator::generate(mt19937_64 &rng, const SentenceOptions &options,
+                                 vector<string> &out) const {
+    thread_local vector<int> ids;
+    bool injected = derive(rng, options, ids);
+    out.clear();
+    for (int id : ids) out.push_back(names[id]);
+    return injected;
+}
+
+bool SentenceGenerator::appendLine(mt19937_64 &rng, const SentenceOptions &options, string &text,
+                                   size_t &tokens) const {
+    thread_local vector<int> ids;
+    bool injected = derive(rng, options, ids);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (i) text += ' ';
+        text += names[ids[i]];
+    }
+    text += '\n';
+    tokens += ids.size();
+    return injected;
+}
+
+void SentenceGenerator::injectError(mt19937_64 &rng, vector<int> &ids) const {
+    auto pick = [&](size_t n) { return uniform_int_distribution<size_t>(0, n - 1)(rng); };
+
+    // Only edits that change the sequence: replace draws among the
+    // other terminals, swap only exchanges different neighbours
+    vector<size_t> swappable;
+    for (size_t i = 0; i + 1 < ids.size(); ++i)
+        if (ids[i] != ids[i + 1]) swappable.push_back(i);
+
+    enum { DELETE, INSERT, REPLACE, SWAP };
+    vector<int> kinds = {INSERT};
+    if (!ids.empty()) kinds.push_back(DELETE);
+    if (!ids.empty() && terminalCount > 1) kinds.push_back(REPLACE);
+    if (!swappable.empty()) kinds.push_back(SWAP);
+
+    switch (kinds[pick(kinds.size())]) {
+    case DELETE:
+        ids.erase(ids.begin() + pick(ids.size()));
+        break;
+    case INSERT:
+        ids.insert(ids.begin() + pick(ids.size() + 1), static_cast<int>(pick(terminalCount)));
+        break;
+    case REPLACE: {
+        int &token = ids[pick(ids.size())];
+        int other = static_cast<int>(pick(terminalCount - 1));
+        token = other >= token ? other + 1 : other;
+        break;
+    }
+    default: {
+        size_t i = swappable[pick(swappable.size())];
+        swap(ids[i], ids[i + 1]);
+        break;
+    }
+    }
+}
@@ -0,0 +1,80 @@
+// ===============================================================
+// File: SentenceGenerator.h
+// Description: Random sentences of a grammar, for parser throughput
+//              tests. Each non-terminal's minimum derivation length
+//              is computed first; a leftmost derivation then only
+//              picks alternatives that can still finish within the
+//              length bound, so every sentence is derivable and no
+//              sentence runs past `maxTokens` (unless the grammar's
+//              shortest sentence is already longer).
+// ===============================================================
+
+#ifndef SENTENCE_GENERATOR_H
+#define SENTENCE_GENERATOR_H
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include "../grammar/Grammar.h"
+
+using namespace std;
+
+// ===============================================================
+// Struct: SentenceOptions
+// ===============================================================
+struct SentenceOptions {
+    size_t minTokens = 1;           // grow while the derivation is shorter
+    size_t maxTokens = 64;
+    double errorRate = 0.0;         // share of sentences given one syntax error
+};
+
+// ===============================================================
+// Class: SentenceGenerator
+// ===============================================================
+class SentenceGenerator {
+private:
+    static constexpr size_t UNBOUNDED = SIZE_MAX;
+
+    size_t terminalCount = 0;
+    vector<string> names;                   // terminals, then non-terminals
+    vector<vector<vector<int>>> alternatives;   // per non-terminal, ε = {}
+    vector<vector<size_t>> altMinLength;    // minimum tokens per alternative
+    vector<vector<size_t>> altHeight;       // shortest derivation height per alternative
+    vector<size_t> minLength;               // per non-terminal
+    vector<size_t> height;
+    int start = -1;
+
+    bool isTerminal(int sym) const { return sym < static_cast<int>(terminalCount); }
+
+    // Alternative whose derivation height is smallest; always
+    // terminates, used once a derivation runs too long
+    size_t lowestAlternative(int nt) const;
+
+    // Random terminal ids; true when a syntax error was injected
+    bool derive(mt19937_64 &rng, const SentenceOptions &options, vector<int> &ids) const;
+
+    // Delete, insert, replace or swap one token; the sequence always
+    // changes
+    void injectError(mt19937_64 &rng, vector<int> &ids) const;
+
+public:
+    explicit SentenceGenerator(const Grammar &g);
+
+    // False when the start symbol derives no terminal string
+    bool valid() const { return start >= 0 && minLength[start - terminalCount] != UNBOUNDED; }
+
+    // Shortest sentence length of the grammar
+    size_t shortestSentence() const { return valid() ? minLength[start - terminalCount] : 0; }
+
+    // One random sentence (no "$"); true when a syntax error was
+    // injected into it
+    bool generate(mt19937_64 &rng, const SentenceOptions &options, vector<string> &out) const;
+
+    // Same, appended to `text` as one corpus line; `tokens` is
+    // increased by the sentence length
+    bool appendLine(mt19937_64 &rng, const SentenceOptions &options, string &text,
+                    size_t &tokens) const;
+};
+
+#endif
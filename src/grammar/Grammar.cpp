@@ -1,5 +1,7 @@
 #include "Grammar.h"
 #include "../report/reportWriter.h"
+#include "../report/ReportPolicy.h"
+#include "../util/Instrumentation.h"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
@@ -47,14 +49,33 @@ bool Grammar::loadFromFile(const string &filename) {
         cerr << "❌ Error: cannot open grammar file '" << filename << "'\n";
         return false;
     }
+    return loadFromStream(file);
+}
+
+// Load grammar rules from grammar text (server requests)
+bool Grammar::loadFromText(const string &text) {
+    istringstream in(text);
+    return loadFromStream(in);
+}
+
+bool Grammar::loadFromStream(istream &file) {
+    PhaseTimer timer("load");
 
     // Reset existing data
     productions.clear();
     terminals.clear();
     nonTerminals.clear();
     startSymbol.clear();
+    precedence.clear();
+    warnings.clear();
+
+    auto warn = [&](const string &message) {
+        warnings.push_back(message);
+        if (echoWarnings) cerr << "⚠️ Warning: " << message << "\n";
+    };
 
     string line;
+    int precLevel = 0;
     bool firstProduction = true;
 
     // Temporary container for raw production data
@@ -76,6 +97,24 @@ bool Grammar::loadFromFile(const string &filename) {
         line = trim(line);
         if (line.empty()) continue;
 
+        // Precedence declarations: %left / %right / %nonassoc tokens...
+        if (line[0] == '%') {
+            vector<string> decl = splitTokens(line);
+            OperatorPrec::Assoc assoc;
+            if (decl[0] == "%left") assoc = OperatorPrec::LEFT;
+            else if (decl[0] == "%right") assoc = OperatorPrec::RIGHT;
+            else if (decl[0] == "%nonassoc") assoc = OperatorPrec::NONASSOC;
+            else {
+                warn("unknown declaration: " + line);
+                continue;
+            }
+
+            precLevel++;
+            for (size_t k = 1; k < decl.size(); ++k)
+                precedence[decl[k]] = {precLevel, assoc};
+            continue;
+        }
+
         // Find production arrow ("->" or "→")
         size_t arrowPos = line.find("->");
         if (arrowPos == string::npos) {
@@ -84,7 +123,7 @@ bool Grammar::loadFromFile(const string &filename) {
         }
 
         if (arrowPos == string::npos) {
-            cerr << "⚠️ Warning: skipping invalid line (no '->'): " << line << "\n";
+            warn("skipping invalid line (no '->'): " + line);
             continue;
         }
 
@@ -92,7 +131,7 @@ bool Grammar::loadFromFile(const string &filename) {
         string rhsPart = trim(line.substr(arrowPos + 2));
 
         if (lhs.empty() || rhsPart.empty()) {
-            cerr << "⚠️ Warning: malformed production: " << line << "\n";
+            warn("malformed production: " + line);
             continue;
         }
 
@@ -118,8 +157,6 @@ bool Grammar::loadFromFile(const string &filename) {
         temp.push_back({lhs, alts});
     }
 
-    file.close();
-
     // ===============================
     // 🧱 Step 2: Build Production Objects
     // ===============================
@@ -127,9 +164,17 @@ bool Grammar::loadFromFile(const string &filename) {
         Production p(tp.lhs);
         for (const auto &rawAlt : tp.rawAlts) {
             vector<string> tokens = splitTokens(rawAlt);
+
+            // Trailing "%prec X" overrides the rule's precedence
+            string precSymbol;
+            if (tokens.size() >= 2 && tokens[tokens.size() - 2] == "%prec") {
+                precSymbol = tokens.back();
+                tokens.resize(tokens.size() - 2);
+            }
+
             if (tokens.empty())
                 tokens.push_back("ε"); // Empty alternative = epsilon
-            p.addAlternative(tokens);
+            p.addAlternative(tokens, precSymbol);
         }
         productions.push_back(p);
     }
@@ -137,6 +182,18 @@ bool Grammar::loadFromFile(const string &filename) {
     // ===============================
     // 🧠 Step 3: Identify Terminals
     // ===============================
+    refreshSymbols();
+
+    return true;
+}
+
+void Grammar::refreshSymbols() {
+    nonTerminals.clear();
+    terminals.clear();
+
+    for (const auto &prod : productions)
+        nonTerminals.insert(prod.getLHS());
+
     for (const auto &prod : productions) {
         for (const auto &alt : prod.getRHS()) {
             for (const auto &sym : alt) {
@@ -146,44 +203,168 @@ bool Grammar::loadFromFile(const string &filename) {
             }
         }
     }
+}
+
+// ============================================
+// ✏️ Editing
+// ============================================
+
+string GrammarEdit::toString() const {
+    string s = (kind == ADD ? "+ " : "- ") + lhs + " ->";
+    if (rhs.empty()) s += " ε";
+    for (const auto &sym : rhs) s += " " + sym;
+    if (!precSymbol.empty()) s += " %prec " + precSymbol;
+    return s;
+}
+
+bool Grammar::apply(const GrammarEdit &edit) {
+    vector<string> alt = edit.rhs;
+    if (alt.empty())
+        alt.push_back("ε");
+
+    auto prod = productions.begin();
+    while (prod != productions.end() && prod->getLHS() != edit.lhs)
+        ++prod;
+
+    size_t index = 0;
+    bool found = false;
+    if (prod != productions.end()) {
+        for (; index < prod->getRHS().size(); ++index)
+            if (prod->getRHS()[index] == alt) {
+                found = true;
+                break;
+            }
+    }
+
+    if (edit.kind == GrammarEdit::ADD) {
+        if (found) return false;
+
+        if (prod == productions.end()) {
+            Production p(edit.lhs);
+            p.addAlternative(alt, edit.precSymbol);
+            productions.push_back(p);
+            if (startSymbol.empty())
+                startSymbol = edit.lhs;
+        } else {
+            prod->addAlternative(alt, edit.precSymbol);
+        }
+    } else {
+        if (!found) return false;
+        if (edit.lhs == startSymbol && prod->getRHS().size() == 1)
+            return false;
+
+        prod->removeAlternative(index);
+        if (prod->getRHS().empty())
+            productions.erase(prod);
+    }
 
+    refreshSymbols();
     return true;
 }
 
 // ============================================
-// 🖨️ Display Grammar
+// ⚖️ Precedence Lookups
 // ============================================
 
-void Grammar::display() const {
-    std::ostringstream out;
+const OperatorPrec* Grammar::precedenceOf(const string &sym) const {
+    auto it = precedence.find(sym);
+    return (it != precedence.end()) ? &it->second : nullptr;
+}
 
-    out << "===== Grammar =====\n";
-    out << "Start Symbol: " << startSymbol << "\n\nProductions:\n";
+string Grammar::rulePrecSymbol(const Production &p, size_t alt) const {
+    if (!p.getPrecSymbol(alt).empty())
+        return p.getPrecSymbol(alt);
+
+    const auto &rhs = p.getRHS()[alt];
+    for (auto it = rhs.rbegin(); it != rhs.rend(); ++it)
+        if (isTerminal(*it))
+            return *it;
+
+    return "";
+}
 
-    for (const auto &p : productions)
-        out << p.toString() << "\n";
+PrecDecision Grammar::resolveShiftReduce(const string &token, const string &ruleSymbol,
+                                         string &reason) const {
+    const OperatorPrec *tokPrec = precedenceOf(token);
+    const OperatorPrec *rulePrec = ruleSymbol.empty() ? nullptr : precedenceOf(ruleSymbol);
 
-    out << "\nNon-terminals (" << nonTerminals.size() << "): ";
-    bool first = true;
-    for (const auto &nt : nonTerminals) {
-        if (!first) out << ", ";
-        out << nt;
-        first = false;
+    if (!tokPrec || !rulePrec)
+        return PrecDecision::CONFLICT;
+
+    if (rulePrec->level > tokPrec->level) {
+        reason = "'" + ruleSymbol + "' binds tighter than '" + token + "'";
+        return PrecDecision::REDUCE;
+    }
+    if (rulePrec->level < tokPrec->level) {
+        reason = "'" + token + "' binds tighter than '" + ruleSymbol + "'";
+        return PrecDecision::SHIFT;
     }
 
-    out << "\nTerminals (" << terminals.size() << "): ";
-    first = true;
-    for (const auto &t : terminals) {
-        if (!first) out << ", ";
-        out << t;
-        first = false;
+    switch (tokPrec->assoc) {
+    case OperatorPrec::LEFT:
+        reason = "%left " + token;
+        return PrecDecision::REDUCE;
+    case OperatorPrec::RIGHT:
+        reason = "%right " + token;
+        return PrecDecision::SHIFT;
+    default:
+        reason = "%nonassoc " + token;
+        return PrecDecision::ERROR;
     }
+}
 
-    out << "\n===================\n";
+// ============================================
+// 🖨️ Display Grammar
+// ============================================
 
-    // Print to terminal
-    cout << out.str();
+template <typename Log>
+void Grammar::display() const {
+    reportAt<Log>(Verbosity::DETAIL, [&](ReportStream &report) {
+        report.emit(ReportEvent("grammar").add("start", startSymbol));
+
+        for (const auto &p : productions) {
+            vector<string> alternatives, precs;
+            for (size_t i = 0; i < p.getRHS().size(); ++i) {
+                string alt;
+                for (const auto &sym : p.getRHS()[i])
+                    alt += (alt.empty() ? "" : " ") + sym;
+                alternatives.push_back(alt);
+                precs.push_back(p.getPrecSymbol(i));
+            }
+            report.emit(ReportEvent("production")
+                            .add("lhs", p.getLHS())
+                            .add("alternatives", alternatives)
+                            .add("prec", precs));
+        }
+
+        report.emit(ReportEvent("symbols")
+                        .add("kind", "nonterminals")
+                        .add("names", vector<string>(nonTerminals.begin(), nonTerminals.end())));
+        report.emit(ReportEvent("symbols")
+                        .add("kind", "terminals")
+                        .add("names", vector<string>(terminals.begin(), terminals.end())));
+
+        // Group declarations back by level
+        map<int, pair<OperatorPrec::Assoc, vector<string>>> levels;
+        for (const auto &p : precedence) {
+            levels[p.second.level].first = p.second.assoc;
+            levels[p.second.level].second.push_back(p.first);
+        }
+        for (const auto &lv : levels) {
+            const char *name = lv.second.first == OperatorPrec::LEFT ? "%left"
+                             : lv.second.first == OperatorPrec::RIGHT ? "%right"
+                             : "%nonassoc";
+            report.emit(ReportEvent("precedence")
+                            .add("level", lv.first)
+                            .add("assoc", name)
+                            .add("operators", lv.second.second));
+        }
 
-    // Save to report file
-    ReportWriter::get() << out.str();
+        report.emit(ReportEvent("end").add("of", "grammar"));
+    });
 }
+
+#ifndef GRAMRESOLVE_NO_REPORT
+template void Grammar::display<ReportLog>() const;
+#endif
+template void Grammar::display<SilentLog>() const;
@@ -4,17 +4,49 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <map>
 #include <fstream>
 #include <iostream>
 #include "Production.h"
+#include "../report/ReportPolicy.h"
 using namespace std;
 
+// Operator precedence declared with %left / %right / %nonassoc.
+// Later declaration lines bind tighter (higher level).
+struct OperatorPrec {
+    enum Assoc { LEFT, RIGHT, NONASSOC };
+
+    int level;
+    Assoc assoc;
+};
+
+// How precedence settles a shift/reduce pair
+enum class PrecDecision { CONFLICT, SHIFT, REDUCE, ERROR };
+
+// One production alternative added to or removed from a grammar
+struct GrammarEdit {
+    enum Kind { ADD, REMOVE };
+
+    Kind kind;
+    string lhs;
+    vector<string> rhs;        // {} or {"ε"} for an empty alternative
+    string precSymbol;         // ADD only: optional %prec symbol
+
+    string toString() const;
+};
+
 class Grammar {
 private:
     vector<Production> productions;     // All grammar rules
     set<string> terminals;         // Set of terminal symbols
     set<string> nonTerminals;      // Set of non-terminal symbols
     string startSymbol;                 // The grammar's start symbol
+    map<string, OperatorPrec> precedence;   // Declared operator precedence
+    vector<string> warnings;            // lines skipped by the last load
+    bool echoWarnings = true;           // also print them to cerr
+
+    // Recompute terminals/non-terminals from the productions
+    void refreshSymbols();
 
 public:
     Grammar() = default;
@@ -22,13 +54,41 @@ public:
     // 🔹 Grammar Management
     void addProduction(const Production &p);
     bool loadFromFile(const string &filename);
+    bool loadFromText(const string &text);
+    bool loadFromStream(istream &in);
+
+    // Keep load warnings off stderr (embedded use); they are still
+    // collected for getWarnings()
+    void setWarningEcho(bool echo) { echoWarnings = echo; }
+    const vector<string>& getWarnings() const { return warnings; }
+    template <typename Log = DefaultLog>
     void display() const;
 
+    // Add/remove one alternative and refresh the symbol sets.
+    // Fails on duplicates, missing alternatives, or removing the
+    // last alternative of the start symbol.
+    bool apply(const GrammarEdit &edit);
+
     // 🔹 Accessors
     const vector<Production>& getProductions() const { return productions; }
     const set<string>& getTerminals() const { return terminals; }
     const set<string>& getNonTerminals() const { return nonTerminals; }
     const string& getStartSymbol() const { return startSymbol; }
+    const map<string, OperatorPrec>& getPrecedence() const { return precedence; }
+
+    // 🔹 Precedence Helpers
+    // Precedence of a terminal (or %prec pseudo-token), nullptr if undeclared
+    const OperatorPrec* precedenceOf(const string &sym) const;
+
+    // Symbol whose precedence a rule alternative takes: its %prec
+    // symbol, otherwise the last terminal of the RHS ("" if none)
+    string rulePrecSymbol(const Production &p, size_t alt) const;
+
+    // Settle "shift `token`" vs "reduce a rule whose precedence symbol
+    // is `ruleSymbol`"; CONFLICT when either side is undeclared.
+    // `reason` receives a short explanation of the decision.
+    PrecDecision resolveShiftReduce(const string &token, const string &ruleSymbol,
+                                    string &reason) const;
 
     // 🔹 Classification Helpers
     bool isTerminal(const string &sym) const {
@@ -8,8 +8,17 @@ using namespace std;
 // ===============================================================
 // Add a new RHS alternative
 // ===============================================================
-void Production::addAlternative(const vector<string> &alt) {
+void Production::addAlternative(const vector<string> &alt, const string &precSymbol) {
     rhs.push_back(alt);
+    precSymbols.push_back(precSymbol);
+}
+
+// ===============================================================
+// Remove an RHS alternative
+// ===============================================================
+void Production::removeAlternative(size_t i) {
+    rhs.erase(rhs.begin() + i);
+    precSymbols.erase(precSymbols.begin() + i);
 }
 
 // ===============================================================
@@ -26,6 +35,8 @@ string Production::toString() const {
             if (&sym != &rhs[i].back())
                 out << " ";
         }
+        if (!precSymbols[i].empty())
+            out << " %prec " << precSymbols[i];
         if (i < rhs.size() - 1)
             out << " | ";
     }
@@ -39,5 +50,7 @@ string Production::toString() const {
 void Production::display() const {
     string line = toString() + "\n";
     cout << line;
+#ifndef GRAMRESOLVE_NO_REPORT
     ReportWriter::get() << line;
+#endif
 }
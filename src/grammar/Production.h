@@ -10,13 +10,18 @@ class Production {
 private:
     string lhs;  // Left-hand side non-terminal
     vector<std::vector<std::string>> rhs;  // List of right-hand side alternatives
+    vector<std::string> precSymbols;       // %prec symbol per alternative ("" = none)
 
 public:
     /// Default + parameterized constructor
     explicit Production(const string &left = "") : lhs(left) {}
 
-    /// Add an alternative RHS (e.g., {"E", "+", "T"})
-    void addAlternative(const vector<std::string> &alt);
+    /// Add an alternative RHS (e.g., {"E", "+", "T"}), optionally with
+    /// the symbol named by a trailing "%prec X"
+    void addAlternative(const vector<std::string> &alt, const string &precSymbol = "");
+
+    /// Remove alternative i (with its %prec symbol)
+    void removeAlternative(size_t i);
 
     /// Get left-hand side non-terminal
     const string &getLHS() const { return lhs; }
@@ -24,6 +29,9 @@ public:
     /// Get all RHS alternatives
     const vector<std::vector<std::string>> &getRHS() const { return rhs; }
 
+    /// Get the %prec symbol of alternative i ("" when not given)
+    const string &getPrecSymbol(size_t i) const { return precSymbols[i]; }
+
     /// Convert the production to a readable string form (for display)
     string toString() const;
 
@@ -7,17 +7,64 @@
 #include "analysis/conflictDetector.h"
 #include "parser/LL1Parser.h"
 #include "parser/LRParser.h"
+#include "parser/GLRParser.h"
+#include "parser/EarleyParser.h"
+#include "parser/IncrementalParser.h"
+#include "parser/LazyAutomaton.h"
+#include "parser/ParserBuilder.h"
 #include "resolver/conflictResolver.h"
+#include "resolver/CounterexampleFinder.h"
+#include "resolver/GrammarRewriter.h"
 #include "report/reportWriter.h"
+#include "report/ReportEvent.h"
+#include "report/ReportSinks.h"
+#include "cli/CommandLine.h"
+#include "util/Instrumentation.h"
 #include <iostream>
 #include <vector>
 #include <sstream>
+#include <fstream>
+#include <iomanip>
 using namespace std;
 
-int main() {
+// Corpus file: one whitespace-separated token sentence per line
+static vector<vector<string>> loadCorpus(const string &filename) {
+    vector<vector<string>> corpus;
+    ifstream file(filename);
+    string line;
 
-    // Start fresh report
+    while (getline(file, line)) {
+        istringstream ss(line);
+        vector<string> tokens;
+        string tok;
+        while (ss >> tok)
+            tokens.push_back(tok);
+        if (!tokens.empty())
+            corpus.push_back(tokens);
+    }
+
+    return corpus;
+}
+
+// Counts the events replayed from a binary report
+struct CountingSink : public ReportSink {
+    size_t events = 0;
+    void write(const ReportEvent &) override { events++; }
+};
+
+static long fileSize(const string &path) {
+    ifstream in(path, ios::binary | ios::ate);
+    return in ? static_cast<long>(in.tellg()) : -1;
+}
+
+// Full walkthrough over the bundled grammars (no arguments)
+static int runDemo() {
+
+    // Start fresh report; the structured copies stream next to it
+    const string reportDir = ReportWriter::defaultDirectory();
     ReportWriter::get().clear();
+    ReportStream::get().addSink(unique_ptr<ReportSink>(new JsonLinesSink(reportDir + "/report.jsonl")));
+    ReportStream::get().addSink(unique_ptr<ReportSink>(new BinarySink(reportDir + "/report.grpt")));
 
     // Step 1: Load grammar
     Grammar grammar;
@@ -72,7 +119,10 @@ int main() {
         ReportWriter::get() << out.str();
     }
 
-    ll1Parser.parse(inputTokens);
+    {
+        PhaseTimer timer("parse");
+        ll1Parser.parse(inputTokens);
+    }
 
     // Step 5: Run LR(0) Parser
     {
@@ -93,7 +143,193 @@ int main() {
         ReportWriter::get() << out.str();
     }
 
-    lr0.parse(inputTokens);
+    {
+        PhaseTimer timer("parse");
+        lr0.parse(inputTokens);
+    }
+
+    // Step 5b: GLR driver over the same (possibly conflicted) tables
+    {
+        std::ostringstream out;
+        out << "\n\n================= GLR PARSER =====================\n";
+        cout << out.str();
+        ReportWriter::get() << out.str();
+    }
+
+    GLRParser glr(lr0);
+    {
+        PhaseTimer timer("parse");
+        glr.parse(inputTokens);
+    }
+    glr.displayForest();
+
+    // Step 5c: Earley parser on the grammar itself (no table needed)
+    {
+        std::ostringstream out;
+        out << "\n\n================= EARLEY PARSER ==================\n";
+        cout << out.str();
+        ReportWriter::get() << out.str();
+    }
+
+    EarleyParser earley(grammar, ff);
+    {
+        PhaseTimer timer("parse");
+        earley.parse(inputTokens);
+    }
+    earley.displayForest();
+
+    // Step 5d: Unit-rule elimination on the classic expression grammar,
+    // measured as reductions per token over a small corpus
+    {
+        std::ostringstream out;
+        out << "\n\n================= UNIT RULE ELIMINATION ==========\n";
+        cout << out.str();
+        ReportWriter::get() << out.str();
+    }
+
+    Grammar exprGrammar;
+    bool haveExpr = exprGrammar.loadFromFile("data/expr_grammar.txt");
+    vector<vector<string>> corpus = loadCorpus("data/expr_corpus.txt");
+
+    LR0Parser exprParser(exprGrammar);
+    if (haveExpr)
+        exprParser.buildAutomaton();
+
+    if (haveExpr && !corpus.empty()) {
+        CorpusStats before = exprParser.runCorpus(corpus);
+        exprParser.eliminateUnitRules();
+        CorpusStats after = exprParser.runCorpus(corpus);
+
+        std::ostringstream out;
+        out << fixed << setprecision(2)
+            << "Corpus: " << before.sentences << " sentences, " << before.tokens << " tokens\n"
+            << "Accepted (before / after): " << before.accepted << " / " << after.accepted << "\n"
+            << "Reductions per token: " << before.reductionsPerToken()
+            << " → " << after.reductionsPerToken();
+        if (before.reductions)
+            out << "  (" << 100.0 * (before.reductions - after.reductions) / before.reductions
+                << "% fewer)";
+        out << "\n";
+        cout << out.str();
+        ReportWriter::get() << out.str();
+    } else {
+        cerr << "⚠️  Skipping unit-rule elimination: expression grammar or corpus missing.\n";
+        ReportWriter::get() << "⚠️  Skipping unit-rule elimination: expression grammar or corpus missing.\n";
+    }
+
+    // Step 5e: Incremental reparsing of a long expression after
+    // one-token edits near the end and in the middle
+    {
+        std::ostringstream out;
+        out << "\n\n================= INCREMENTAL REPARSE ============\n";
+        cout << out.str();
+        ReportWriter::get() << out.str();
+    }
+
+    if (haveExpr) {
+        vector<string> document;
+        for (int i = 0; i < 2000; ++i)
+            document.insert(document.end(), {"id", "*", "(", "id", "+", "id", ")", "+"});
+        document.push_back("id");
+
+        IncrementalParser inc(exprParser);
+        inc.parse(document);
+        inc.displayStats("full parse");
+
+        inc.reparse({{inc.getTokenCount() - 1, 1, {"(", "id", "*", "id", ")"}}});
+        inc.displayStats("edit near the end");
+
+        inc.reparse({{inc.getTokenCount() / 2, 0, {"id", "*"}}});
+        inc.displayStats("insertion in the middle");
+    }
+
+    // Step 5f: Lazy automaton — rows are built only for the states
+    // the input reaches; the warmed automaton is saved and reloaded
+    {
+        std::ostringstream out;
+        out << "\n\n================= LAZY LR AUTOMATON ==============\n";
+        cout << out.str();
+        ReportWriter::get() << out.str();
+    }
+
+    {
+        LazyLRAutomaton lazy(grammar);
+        bool ok = lazy.recognize(inputTokens);
+
+        std::ostringstream out;
+        out << "Input id + id * id $ : " << (ok ? "✅ Accepted" : "❌ Rejected")
+            << " (eager automaton: " << lr0.getStateCount() << " states)\n";
+        out << lazy.summary();
+
+        const string saved = reportDir + "/lazy_automaton.txt";
+        if (lazy.save(saved)) {
+            LazyLRAutomaton warmed(grammar);
+            if (warmed.load(saved)) {
+                int before = warmed.getExpandedStates();
+                bool again = warmed.recognize(inputTokens);
+                out << "Reloaded from " << saved << ": " << before << " rows, "
+                    << (again ? "accepted" : "rejected") << " with "
+                    << warmed.getExpandedStates() - before << " new rows built\n";
+            }
+        }
+
+        cout << out.str();
+        ReportWriter::get() << out.str();
+    }
+
+    // Step 5g: Grammar edits patch the expression automaton in place;
+    // adding and then removing a rule must give back the same tables
+    {
+        std::ostringstream out;
+        out << "\n\n================= GRAMMAR EDIT ===================\n";
+        cout << out.str();
+        ReportWriter::get() << out.str();
+    }
+
+    if (haveExpr) {
+        Grammar edited = exprGrammar;
+        LR0Parser editParser(edited);
+        editParser.buildAutomaton();
+
+        auto actionBefore = editParser.getACTION();
+        auto gotoBefore = editParser.getGOTO();
+
+        GrammarEdit call{GrammarEdit::ADD, "F", {"id", "(", "E", ")"}, ""};
+        if (edited.apply(call))
+            editParser.applyGrammarEdit(call);
+
+        GrammarEdit undo = call;
+        undo.kind = GrammarEdit::REMOVE;
+        if (edited.apply(undo))
+            editParser.applyGrammarEdit(undo);
+
+        bool same = editParser.getACTION() == actionBefore && editParser.getGOTO() == gotoBefore;
+        string msg = string("Tables after add + remove: ") +
+                     (same ? "✅ identical to the original\n" : "❌ differ from the original\n");
+        cout << msg;
+        ReportWriter::get() << msg;
+    }
+
+    // Step 5h: One entry point picks the cheapest LR table that is
+    // conflict-free: SLR(1), else LALR(1), else LR(1)
+    {
+        std::ostringstream out;
+        out << "\n\n================= PARSER SELECTION ===============\n";
+        cout << out.str();
+        ReportWriter::get() << out.str();
+    }
+
+    ParserBuilder::display(ParserBuilder::build(grammar));
+
+    for (const string file : {"data/lalr_grammar.txt", "data/lr1_grammar.txt", "data/ambigous_grammar.txt"}) {
+        Grammar g;
+        if (!g.loadFromFile(file)) continue;
+
+        string msg = "\n📄 " + file + "\n";
+        cout << msg;
+        ReportWriter::get() << msg;
+        ParserBuilder::display(ParserBuilder::build(g));
+    }
 
     // ---------------------------------------------------------------
     // Step 6: Conflict Detection (LL(1) + LR(0))
@@ -107,7 +343,7 @@ int main() {
 
   // ---------- LL(1) Conflict Detection ----------
 auto ll1Conflicts = ConflictDetector::detectLL1Conflicts(
-    ll1Parser.getTable()
+    ll1Parser
 );
 
 
@@ -127,7 +363,7 @@ auto ll1Conflicts = ConflictDetector::detectLL1Conflicts(
 
     // ---------- LR(0)/SLR Conflict Detection ----------
     auto lrConflicts = ConflictDetector::detectLRConflicts(
-        lr0.getACTION()
+        lr0.getTable()
     );
 
     {
@@ -144,6 +380,29 @@ auto ll1Conflicts = ConflictDetector::detectLL1Conflicts(
         ConflictDetector::displayConflicts(lrConflicts);
     }
 
+    // Step 6b: Counterexamples for the LR conflicts, and for the
+    // ambiguous expression grammar E -> E + E | E * E | ...
+    {
+        std::ostringstream out;
+        out << "\n\n================= COUNTEREXAMPLES ==================\n";
+        cout << out.str();
+        ReportWriter::get() << out.str();
+    }
+
+    if (!lr0.getTable().getConflicts().empty()) {
+        CounterexampleFinder finder(lr0);
+        CounterexampleFinder::display(finder.findAll());
+    }
+
+    Grammar ambiguous;
+    if (ambiguous.loadFromFile("data/ambigous_grammar.txt")) {
+        LR0Parser ambiguousParser(ambiguous);
+        ambiguousParser.buildAutomaton();
+
+        CounterexampleFinder finder(ambiguousParser);
+        CounterexampleFinder::display(finder.findAll());
+    }
+
     // Step 7: Conflict Resolution
     {
         std::ostringstream out;
@@ -155,6 +414,60 @@ auto ll1Conflicts = ConflictDetector::detectLL1Conflicts(
     ConflictResolver::resolveConflicts(ll1Conflicts, grammar);
     ConflictResolver::resolveConflicts(lrConflicts, grammar);
 
+    // Step 7b: Rewrite grammars towards LL(1); each result is checked
+    // again from scratch against the incremental conflict count
+    {
+        std::ostringstream out;
+        out << "\n\n================= GRAMMAR REWRITING =================\n";
+        cout << out.str();
+        ReportWriter::get() << out.str();
+    }
+
+    for (const string file : {"data/expr_grammar.txt", "tests/test_ll1_conflicts.txt"}) {
+        Grammar g;
+        if (!g.loadFromFile(file)) continue;
+
+        string msg = "\n📄 " + file + "\n";
+        cout << msg;
+        ReportWriter::get() << msg;
+
+        GrammarRewriter rewriter(g);
+        RewriteResult rewritten = rewriter.rewriteToLL1();
+        GrammarRewriter::display(rewritten);
+
+        FirstFollowEngine rewrittenFF;
+        rewrittenFF.computeFIRST(rewritten.grammar);
+        rewrittenFF.computeFOLLOW(rewritten.grammar);
+        LL1Parser check(rewritten.grammar, rewrittenFF);
+        check.buildTable<SilentLog>();
+
+        size_t full = check.getConflicts().size();
+        msg = "Full LL(1) re-check: " + to_string(full) + " conflicts " +
+              (full == rewritten.finalConflicts ? "✅" : "❌") + "\n";
+        cout << msg;
+        ReportWriter::get() << msg;
+    }
+
+    // Step 8: Structured report — the JSON Lines and binary sinks saw
+    // the same events as the text; replay the binary file to check it
+    {
+        ReportStream::get().flush();
+
+        CountingSink replay;
+        bool decoded = BinarySink::decode(reportDir + "/report.grpt", replay);
+
+        std::ostringstream out;
+        out << "\n\n================= STRUCTURED REPORT =================\n";
+        out << "Events emitted : " << ReportStream::get().eventCount() << "\n";
+        out << "report.jsonl   : " << fileSize(reportDir + "/report.jsonl") << " bytes\n";
+        out << "report.grpt    : " << fileSize(reportDir + "/report.grpt") << " bytes\n";
+        out << "Binary replay  : " << replay.events << " events "
+            << (decoded && replay.events == ReportStream::get().eventCount(Verbosity::DETAIL) ? "✅" : "❌")
+            << "\n";
+        cout << out.str();
+        ReportWriter::get() << out.str();
+    }
+
     // Final summary
     {
         std::ostringstream out;
@@ -168,3 +481,33 @@ auto ll1Conflicts = ConflictDetector::detectLL1Conflicts(
 
     return 0;
 }
+
+int main(int argc, char **argv) {
+    if (argc <= 1)
+        return runDemo();
+
+    CliOptions options;
+    if (!CommandLine::parse(argc, argv, options)) {
+        CommandLine::printUsage();
+        return 2;
+    }
+    if (options.help) {
+        CommandLine::printUsage();
+        return 0;
+    }
+
+    // 🔹 Instrumentation around whichever mode runs
+    const bool instrument = options.stats || !options.tracePath.empty();
+    if (instrument && !Instrumentation::enable())
+        cerr << "⚠️  Built with STATS=0: --stats and --trace have nothing to report.\n";
+
+    int code = options.demo ? runDemo() : CommandLine::run(options);
+
+    if (instrument && Instrumentation::enabled()) {
+        if (options.stats)
+            Instrumentation::displaySummary(options.corpusPath == "-" || options.servePath == "-");
+        if (!options.tracePath.empty() && Instrumentation::writeTrace(options.tracePath))
+            cerr << "🧵 Trace written to " << options.tracePath << "\n";
+    }
+    return code;
+}
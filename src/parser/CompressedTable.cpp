@@ -0,0 +1,395 @@
+#include "CompressedTable.h"
+#include <sstream>
+#include <iomanip>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <set>
+
+using namespace std;
+
+// ===================================================
+// Build all compressed arrays from a dense table
+// ===================================================
+void CompressedLRTable::build(const LRTable &table, bool measure) {
+    source = &table;
+    stats = CompressionStats();
+    stats.states = table.stateCount();
+
+    packActions();
+    packGotos();
+    updateBytes();
+
+    if (measure)
+        measureLookups();
+}
+
+void CompressedLRTable::updateBytes() {
+    const LRTable &table = *source;
+    size_t S = table.stateCount();
+    stats.denseBytes = S * table.terminalCount() * sizeof(uint32_t)
+                     + S * table.nonTerminalCount() * sizeof(int32_t);
+
+    stats.compressedBytes =
+        rowOf.size() * sizeof(int) + defaultAction.size() * sizeof(uint32_t) +
+        base.size() * sizeof(int) + check.size() * sizeof(int) +
+        next.size() * sizeof(uint32_t) +
+        gotoDefault.size() * sizeof(int) + gotoBase.size() * sizeof(int) +
+        gotoCheck.size() * sizeof(int) + gotoNext.size() * sizeof(int);
+}
+
+// ===================================================
+// One ACTION row: the most frequent reduction becomes
+// the default, everything else is an explicit entry
+// ===================================================
+uint32_t CompressedLRTable::encodeRow(int s, Entries &entries) const {
+    const LRTable &table = *source;
+    int T = static_cast<int>(table.terminalCount());
+
+    map<uint32_t, int> counts;
+    for (int t = 0; t < T; ++t) {
+        uint32_t a = table.getAction(s, t);
+        if (actionTag(a) == ACT_REDUCE)
+            counts[a]++;
+    }
+
+    uint32_t def = ACT_ERROR;
+    int best = 0;
+    for (const auto &c : counts)
+        if (c.second > best) {
+            best = c.second;
+            def = c.first;
+        }
+
+    // Empty cells fall back to the default reduction; the parser
+    // then reports the error one reduction later. %nonassoc errors
+    // are kept: reducing there could go on to accept.
+    entries.clear();
+    for (int t = 0; t < T; ++t) {
+        uint32_t a = table.getAction(s, t);
+        if (a != ACT_ERROR && a != def)
+            entries.push_back({t, a});
+    }
+    return def;
+}
+
+// ===================================================
+// First-fit placement of one row's entries
+// ===================================================
+void CompressedLRTable::placeRow(const Entries &entries, int r) {
+    int T = static_cast<int>(source->terminalCount());
+    stats.explicitEntries += entries.size();
+    if (entries.empty()) return;
+
+    int b = lowestFree - entries.front().first;
+    if (b < 0) b = 0;
+
+    while (true) {
+        bool fits = true;
+        for (const auto &e : entries) {
+            size_t slot = b + e.first;
+            if (slot < check.size() && check[slot] != -1) {
+                fits = false;
+                break;
+            }
+        }
+        if (fits) break;
+        b++;
+    }
+
+    for (const auto &e : entries) {
+        size_t slot = b + e.first;
+        if (slot >= check.size()) {
+            check.resize(slot + 1, -1);
+            next.resize(slot + 1, ACT_ERROR);
+        }
+        check[slot] = r;
+        next[slot] = e.second;
+    }
+
+    base[r] = b;
+    maxBase = max(maxBase, b);
+    while (lowestFree < static_cast<int>(check.size()) && check[lowestFree] != -1)
+        lowestFree++;
+
+    // Every base + terminal must stay inside the arrays
+    if (static_cast<int>(check.size()) < maxBase + T) {
+        check.resize(maxBase + T, -1);
+        next.resize(maxBase + T, ACT_ERROR);
+    }
+}
+
+// ===================================================
+// ACTION: default reductions, row merging, displacement
+// ===================================================
+void CompressedLRTable::packActions() {
+    const LRTable &table = *source;
+    int S = table.stateCount();
+    int T = static_cast<int>(table.terminalCount());
+
+    vector<Entries> rows;
+    rowIds.clear();
+    rowOf.assign(S, 0);
+    defaultAction.clear();
+
+    for (int s = 0; s < S; ++s) {
+        Entries entries;
+        uint32_t def = encodeRow(s, entries);
+        if (def != ACT_ERROR)
+            stats.defaultReductions++;
+
+        auto key = make_pair(def, entries);
+        auto it = rowIds.find(key);
+        if (it == rowIds.end()) {
+            it = rowIds.emplace(key, static_cast<int>(rows.size())).first;
+            rows.push_back(entries);
+            defaultAction.push_back(def);
+        }
+        rowOf[s] = it->second;
+    }
+
+    stats.uniqueRows = rows.size();
+
+    // Pack densest rows first (first-fit decreasing)
+    vector<int> order(rows.size());
+    for (size_t r = 0; r < rows.size(); ++r) order[r] = static_cast<int>(r);
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return rows[a].size() > rows[b].size();
+    });
+
+    base.assign(rows.size(), 0);
+    check.assign(T, -1);
+    next.assign(T, ACT_ERROR);
+    maxBase = 0;
+    lowestFree = 0;
+
+    for (int r : order)
+        placeRow(rows[r], r);
+}
+
+// ===================================================
+// First base that is unused and leaves every entry on
+// a free slot
+// ===================================================
+int CompressedLRTable::placeColumn(const vector<pair<int, int>> &entries) {
+    int S = source->stateCount();
+
+    int b = 0;
+    while (true) {
+        bool fits = !(b < static_cast<int>(gotoBaseUsed.size()) && gotoBaseUsed[b]);
+        for (size_t k = 0; fits && k < entries.size(); ++k) {
+            size_t slot = b + entries[k].first;
+            if (slot < gotoCheck.size() && gotoCheck[slot] != -1)
+                fits = false;
+        }
+        if (fits) break;
+        b++;
+    }
+
+    for (const auto &e : entries) {
+        size_t slot = b + e.first;
+        if (slot >= gotoCheck.size()) {
+            gotoCheck.resize(slot + 1, -1);
+            gotoNext.resize(slot + 1, -1);
+        }
+        gotoCheck[slot] = e.first;
+        gotoNext[slot] = e.second;
+    }
+
+    if (b >= static_cast<int>(gotoBaseUsed.size()))
+        gotoBaseUsed.resize(b + 1, 0);
+    gotoBaseUsed[b] = 1;
+    maxGotoBase = max(maxGotoBase, b);
+
+    if (static_cast<int>(gotoCheck.size()) < maxGotoBase + S) {
+        gotoCheck.resize(maxGotoBase + S, -1);
+        gotoNext.resize(maxGotoBase + S, -1);
+    }
+    return b;
+}
+
+// ===================================================
+// GOTO: default target per non-terminal, columns
+// packed by displacement (bases kept distinct so the
+// state-valued check entries cannot alias)
+// ===================================================
+void CompressedLRTable::packGotos() {
+    const LRTable &table = *source;
+    int S = table.stateCount();
+    int N = static_cast<int>(table.nonTerminalCount());
+
+    gotoDefault.assign(N, -1);
+    gotoBase.assign(N, 0);
+    gotoCheck.clear();
+    gotoNext.clear();
+    gotoBaseUsed.clear();
+    maxGotoBase = 0;
+
+    for (int A = 0; A < N; ++A) {
+        map<int, int> counts;
+        for (int s = 0; s < S; ++s) {
+            int g = table.getGoto(s, A);
+            if (g >= 0) counts[g]++;
+        }
+
+        int best = 0;
+        for (const auto &c : counts)
+            if (c.second > best) {
+                best = c.second;
+                gotoDefault[A] = c.first;
+            }
+
+        vector<pair<int, int>> entries;
+        for (int s = 0; s < S; ++s) {
+            int g = table.getGoto(s, A);
+            if (g >= 0 && g != gotoDefault[A])
+                entries.push_back({s, g});
+        }
+        stats.explicitEntries += entries.size();
+
+        gotoBase[A] = placeColumn(entries);
+    }
+}
+
+// ===================================================
+// Incremental repack after an in-place table edit.
+// Changed rows are merged with an identical existing
+// row or placed on free slots; GOTO entries are written
+// into their column, which moves only on a collision.
+// ===================================================
+void CompressedLRTable::patchRows(const vector<int> &states) {
+    const LRTable &table = *source;
+    int S = table.stateCount();
+    int N = static_cast<int>(table.nonTerminalCount());
+
+    rowOf.resize(S, 0);
+    stats.states = S;
+
+    for (int s : states) {
+        Entries entries;
+        uint32_t def = encodeRow(s, entries);
+
+        auto key = make_pair(def, entries);
+        auto it = rowIds.find(key);
+        if (it == rowIds.end()) {
+            int r = static_cast<int>(defaultAction.size());
+            it = rowIds.emplace(key, r).first;
+            defaultAction.push_back(def);
+            base.push_back(0);
+            placeRow(entries, r);
+            stats.uniqueRows++;
+        }
+        rowOf[s] = it->second;
+    }
+
+    // New states extend every column's check range
+    if (static_cast<int>(gotoCheck.size()) < maxGotoBase + S) {
+        gotoCheck.resize(maxGotoBase + S, -1);
+        gotoNext.resize(maxGotoBase + S, -1);
+    }
+
+    set<int> moved;
+    for (int s : states) {
+        for (int A = 0; A < N; ++A) {
+            int g = table.getGoto(s, A);
+            size_t slot = gotoBase[A] + s;
+            bool own = gotoCheck[slot] == s;
+
+            // Empty cells may read the default, as after build()
+            if (g < 0 || g == gotoDefault[A]) {
+                if (own) {
+                    gotoCheck[slot] = -1;
+                    gotoNext[slot] = -1;
+                }
+                continue;
+            }
+
+            if (own || gotoCheck[slot] == -1) {
+                gotoCheck[slot] = s;
+                gotoNext[slot] = g;
+            } else {
+                moved.insert(A);
+            }
+        }
+    }
+
+    for (int A : moved) {
+        vector<pair<int, int>> entries;
+        for (int s = 0; s < S; ++s) {
+            size_t slot = gotoBase[A] + s;
+            if (gotoCheck[slot] == s) {
+                gotoCheck[slot] = -1;
+                gotoNext[slot] = -1;
+            }
+            int g = table.getGoto(s, A);
+            if (g >= 0 && g != gotoDefault[A])
+                entries.push_back({s, g});
+        }
+        gotoBaseUsed[gotoBase[A]] = 0;
+        gotoBase[A] = placeColumn(entries);
+    }
+
+    updateBytes();
+}
+
+// ===================================================
+// Lookup cost: the same pseudo-random cells read from
+// the dense and the compressed arrays
+// ===================================================
+void CompressedLRTable::measureLookups() {
+    const LRTable &table = *source;
+    int S = table.stateCount();
+    int T = static_cast<int>(table.terminalCount());
+    if (S == 0 || T == 0) return;
+
+    const size_t samples = 200000;
+    vector<pair<int, int>> cells(samples);
+    uint32_t seed = 12345;
+    for (auto &c : cells) {
+        seed = seed * 1664525u + 1013904223u;
+        c.first = static_cast<int>((seed >> 8) % S);
+        seed = seed * 1664525u + 1013904223u;
+        c.second = static_cast<int>((seed >> 8) % T);
+    }
+
+    volatile uint32_t sink = 0;
+    uint32_t acc = 0;
+
+    auto t0 = chrono::steady_clock::now();
+    for (const auto &c : cells)
+        acc += table.getAction(c.first, c.second);
+    auto t1 = chrono::steady_clock::now();
+    for (const auto &c : cells)
+        acc += getAction(c.first, c.second);
+    auto t2 = chrono::steady_clock::now();
+    sink = acc;
+    (void)sink;
+
+    stats.denseLookupNs = chrono::duration<double, nano>(t1 - t0).count() / samples;
+    stats.compressedLookupNs = chrono::duration<double, nano>(t2 - t1).count() / samples;
+    stats.lookupsMeasured = true;
+}
+
+// ===================================================
+// Report
+// ===================================================
+string CompressedLRTable::summary() const {
+    std::ostringstream out;
+
+    out << "\n===== LR Table Compression =====\n";
+    out << left << setw(26) << "States / unique rows" << ": "
+        << stats.states << " / " << stats.uniqueRows << "\n";
+    out << setw(26) << "Default reductions" << ": " << stats.defaultReductions << "\n";
+    out << setw(26) << "Packed entries" << ": " << stats.explicitEntries << "\n";
+    out << setw(26) << "Dense size" << ": " << stats.denseBytes << " bytes\n";
+    out << setw(26) << "Compressed size" << ": " << stats.compressedBytes << " bytes\n";
+    out << setw(26) << "Compression ratio" << ": " << fixed << setprecision(2)
+        << stats.ratio() << "x\n";
+    if (stats.lookupsMeasured) {
+        out << setw(26) << "Lookup cost (dense)" << ": " << stats.denseLookupNs << " ns\n";
+        out << setw(26) << "Lookup cost (compressed)" << ": " << stats.compressedLookupNs << " ns\n";
+    }
+    out << "================================\n";
+
+    return out.str();
+}
@@ -0,0 +1,108 @@
+// ===============================================================
+// File: CompressedTable.h
+// Description: yacc/bison-style compressed LR tables.
+//              ACTION rows get a default reduction, identical rows
+//              are merged, and the remaining entries are packed by row
+//              displacement into base/check/next arrays. GOTO columns
+//              are packed the same way with a default per non-terminal.
+// ===============================================================
+
+#ifndef COMPRESSED_TABLE_H
+#define COMPRESSED_TABLE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <map>
+#include "LRTable.h"
+
+using namespace std;
+
+// ===============================================================
+// Struct: CompressionStats
+// ===============================================================
+struct CompressionStats {
+    size_t denseBytes = 0;
+    size_t compressedBytes = 0;
+    size_t states = 0;
+    size_t uniqueRows = 0;
+    size_t defaultReductions = 0;
+    size_t explicitEntries = 0;        // ACTION + GOTO entries actually packed
+    bool lookupsMeasured = false;       // the two costs below are set
+    double denseLookupNs = 0.0;
+    double compressedLookupNs = 0.0;
+
+    double ratio() const {
+        return compressedBytes ? static_cast<double>(denseBytes) / compressedBytes : 0.0;
+    }
+};
+
+// ===============================================================
+// Class: CompressedLRTable
+// ===============================================================
+class CompressedLRTable {
+private:
+    const LRTable *source = nullptr;   // productions + conflict lists
+
+    // ACTION: state → row, row → (default, base), packed entries
+    vector<int> rowOf;
+    vector<uint32_t> defaultAction;
+    vector<int> base;
+    vector<int> check;
+    vector<uint32_t> next;
+
+    // GOTO: per non-terminal default + packed per-state entries
+    vector<int> gotoDefault;
+    vector<int> gotoBase;
+    vector<int> gotoCheck;
+    vector<int> gotoNext;
+
+    CompressionStats stats;
+
+    // Packing state kept for patchRows()
+    typedef vector<pair<int, uint32_t>> Entries;
+    map<pair<uint32_t, Entries>, int> rowIds;
+    int lowestFree = 0;
+    int maxBase = 0;
+    vector<char> gotoBaseUsed;
+    int maxGotoBase = 0;
+
+    void packActions();
+    void packGotos();
+    void measureLookups();
+    void updateBytes();
+    uint32_t encodeRow(int state, Entries &entries) const;
+    void placeRow(const Entries &entries, int row);
+    int placeColumn(const vector<pair<int, int>> &entries);
+
+public:
+    CompressedLRTable() = default;
+
+    // Compress a fully built table (keeps a pointer to it).
+    // measure = true also times 200k lookups (--stats only).
+    void build(const LRTable &table, bool measure = false);
+
+    // Re-encode the given states after their dense rows changed
+    // (new states included). Other rows and GOTO columns stay where
+    // they are; rows no longer referenced are left as padding.
+    void patchRows(const vector<int> &states);
+
+    // 🔹 Driver lookups
+    uint32_t getAction(int state, int terminal) const {
+        int r = rowOf[state];
+        int i = base[r] + terminal;
+        return (check[i] == r) ? next[i] : defaultAction[r];
+    }
+    int getGoto(int state, int nonTerminal) const {
+        int i = gotoBase[nonTerminal] + state;
+        return (gotoCheck[i] == state) ? gotoNext[i] : gotoDefault[nonTerminal];
+    }
+
+    const LRTable& getSource() const { return *source; }
+    const CompressionStats& getStats() const { return stats; }
+
+    // Compression ratio and lookup cost against the dense table
+    string summary() const;
+};
+
+#endif
@@ -0,0 +1,570 @@
+#include "EarleyParser.h"
+#include "../report/reportWriter.h"
+#include "../util/Instrumentation.h"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+
+using namespace std;
+
+static const uint64_t EMPTY_SLOT = ~0ull;
+static const int64_t LEO_UNKNOWN = -2;
+
+static uint64_t itemKey(uint32_t dot, uint32_t origin) {
+    return (static_cast<uint64_t>(dot) << 32) | origin;
+}
+
+// ===================================================
+// Constructor — number symbols, rules and dotted rules
+// ===================================================
+EarleyParser::EarleyParser(const Grammar &g, const FirstFollowEngine &ff) {
+    for (const auto &t : g.getTerminals()) {
+        terminalIds[t] = static_cast<int>(symbolNames.size());
+        symbolNames.push_back(t);
+    }
+    terminalCount = static_cast<int>(symbolNames.size());
+
+    unordered_map<string, int> nonTerminalIds;
+    for (const auto &nt : g.getNonTerminals()) {
+        nonTerminalIds[nt] = static_cast<int>(symbolNames.size());
+        symbolNames.push_back(nt);
+    }
+    const int start = static_cast<int>(symbolNames.size());
+    symbolNames.push_back(g.getStartSymbol() + "'");
+
+    nullable.assign(symbolNames.size(), 0);
+    for (const auto &nt : nonTerminalIds)
+        nullable[nt.second] = ff.isNullable(nt.first);
+    predictions.assign(symbolNames.size(), {});
+
+    auto addRule = [&](int lhs, const vector<int> &rhs, const string &label) {
+        ruleLHS.push_back(lhs);
+        ruleDot.push_back(static_cast<uint32_t>(postDot.size()));
+        ruleLabels.push_back(label);
+        predictions[lhs].push_back(ruleDot.back());
+        for (int sym : rhs) {
+            postDot.push_back(sym);
+            dotRule.push_back(static_cast<int>(ruleLHS.size() - 1));
+        }
+        postDot.push_back(-1);
+        dotRule.push_back(static_cast<int>(ruleLHS.size() - 1));
+    };
+
+    // Rule 0: START' -> start (no rule at all for an empty grammar)
+    auto startId = nonTerminalIds.find(g.getStartSymbol());
+    if (startId != nonTerminalIds.end()) {
+        nullable[start] = nullable[startId->second];
+        addRule(start, {startId->second}, symbolNames[start] + " -> " + g.getStartSymbol());
+    }
+
+    for (const auto &p : g.getProductions()) {
+        for (const auto &alt : p.getRHS()) {
+            vector<int> rhs;
+            string label = p.getLHS() + " ->";
+            for (const auto &sym : alt) {
+                if (sym == "ε") continue;
+                auto nt = nonTerminalIds.find(sym);
+                rhs.push_back(nt != nonTerminalIds.end() ? nt->second : terminalIds[sym]);
+                label += " " + sym;
+            }
+            if (rhs.empty()) label += " ε";
+            addRule(nonTerminalIds[p.getLHS()], rhs, label);
+        }
+    }
+
+    // FIRST(α) per rule, for the lookahead filter
+    firstWords = (terminalCount + 1 + 63) / 64;
+    ruleFirst.assign(ruleLHS.size() * firstWords, 0);
+    auto setBit = [&](size_t rule, int bit) { ruleFirst[rule * firstWords + bit / 64] |= 1ull << (bit % 64); };
+    for (size_t r = 0; r < ruleLHS.size(); ++r) {
+        for (uint32_t d = ruleDot[r]; ; ++d) {
+            const int sym = postDot[d];
+            if (sym < 0) {
+                setBit(r, terminalCount);
+                break;
+            }
+            if (sym < terminalCount) {
+                setBit(r, sym);
+                break;
+            }
+            for (const auto &t : ff.getFIRST(symbolNames[sym])) {
+                auto id = terminalIds.find(t);
+                if (id != terminalIds.end()) setBit(r, id->second);
+            }
+            if (!nullable[sym]) break;
+        }
+    }
+
+    predictionAt.assign((symbolNames.size() - terminalCount) * (terminalCount + 1), -1);
+    predicted.assign(symbolNames.size(), 0);
+    dotStamp.assign(postDot.size(), 0);
+    slots.assign(64, EMPTY_SLOT);
+}
+
+// ===================================================
+// Prediction closure of `symbol` before the current
+// lookahead, built on first use: the same items run()
+// would reach predicting one rule at a time (filtered
+// rules, terminals that must match, nullables stepped over)
+// ===================================================
+const EarleyParser::Prediction& EarleyParser::prediction(int symbol) {
+    int32_t &at = predictionAt[(symbol - terminalCount) * (terminalCount + 1) + lookahead + 1];
+    if (at >= 0) return predictionSets[at];
+
+    Prediction p;
+    p.dots = static_cast<uint32_t>(predictionDots.size());
+    p.symbols = static_cast<uint32_t>(predictionSymbols.size());
+
+    vector<char> seen(symbolNames.size(), 0);
+    seen[symbol] = 1;
+    predictionSymbols.push_back(symbol);
+    for (size_t k = p.symbols; k < predictionSymbols.size(); ++k) {
+        for (uint32_t dot : predictions[predictionSymbols[k]]) {
+            if (!canStart(dotRule[dot])) continue;
+            for (uint32_t d = dot; ; ++d) {
+                const int sym = postDot[d];
+                if (sym >= 0 && sym < terminalCount && sym != lookahead) break;
+                predictionDots.push_back(d);
+                if (sym < terminalCount) break;
+                if (!seen[sym]) {
+                    seen[sym] = 1;
+                    predictionSymbols.push_back(sym);
+                }
+                if (!nullable[sym]) break;
+            }
+        }
+    }
+
+    p.dotsEnd = static_cast<uint32_t>(predictionDots.size());
+    p.symbolsEnd = static_cast<uint32_t>(predictionSymbols.size());
+    at = static_cast<int32_t>(predictionSets.size());
+    predictionSets.push_back(p);
+    return predictionSets.back();
+}
+
+// ===================================================
+// Item set of the Earley set being built
+// ===================================================
+void EarleyParser::resetItemSet() {
+    for (uint32_t s : usedSlots) slots[s] = EMPTY_SLOT;
+    usedSlots.clear();
+}
+
+bool EarleyParser::hasItem(uint32_t dot, uint32_t origin) const {
+    if (origin == current) return dotStamp[dot] == current + 1;
+    const uint64_t key = itemKey(dot, origin);
+    const size_t mask = slots.size() - 1;
+    for (size_t s = (key * 0x9E3779B97F4A7C15ull) >> 40 & mask; slots[s] != EMPTY_SLOT; s = (s + 1) & mask)
+        if (slots[s] == key) return true;
+    return false;
+}
+
+bool EarleyParser::canStart(int rule) const {
+    const uint64_t *bits = &ruleFirst[rule * firstWords];
+    auto test = [&](int bit) { return (bits[bit / 64] >> (bit % 64)) & 1; };
+    return test(terminalCount) || (lookahead >= 0 && test(lookahead));
+}
+
+bool EarleyParser::addItem(uint32_t dot, uint32_t origin) {
+    // An item that waits on another token can never be advanced
+    const int next = postDot[dot];
+    if (next >= 0 && next < terminalCount && next != lookahead) return false;
+
+    // Items predicted in this set (most of them) only need the dot
+    if (origin == current) {
+        if (dotStamp[dot] == current + 1) return false;
+        dotStamp[dot] = current + 1;
+        items.push_back({dot, origin});
+        return true;
+    }
+
+    // Keep the table at most half full
+    if ((usedSlots.size() + 1) * 2 > slots.size()) {
+        vector<uint64_t> keys;
+        for (uint32_t s : usedSlots) keys.push_back(slots[s]);
+        slots.assign(slots.size() * 2, EMPTY_SLOT);
+        usedSlots.clear();
+        const size_t mask = slots.size() - 1;
+        for (uint64_t key : keys) {
+            size_t s = (key * 0x9E3779B97F4A7C15ull) >> 40 & mask;
+            while (slots[s] != EMPTY_SLOT) s = (s + 1) & mask;
+            slots[s] = key;
+            usedSlots.push_back(static_cast<uint32_t>(s));
+        }
+    }
+
+    const uint64_t key = itemKey(dot, origin);
+    const size_t mask = slots.size() - 1;
+    size_t s = (key * 0x9E3779B97F4A7C15ull) >> 40 & mask;
+    for (; slots[s] != EMPTY_SLOT; s = (s + 1) & mask)
+        if (slots[s] == key) return false;
+
+    slots[s] = key;
+    usedSlots.push_back(static_cast<uint32_t>(s));
+    items.push_back({dot, origin});
+    return true;
+}
+
+// ===================================================
+// Items of a finished set that wait on a non-terminal,
+// grouped by that non-terminal
+// ===================================================
+void EarleyParser::indexWaiting(size_t set) {
+    waitingKeys.clear();
+    for (size_t t = setStart[set]; t < items.size(); ++t) {
+        const int sym = postDot[items[t].dot];
+        if (sym >= terminalCount) waitingKeys.push_back(static_cast<uint64_t>(sym) << 32 | t);
+    }
+
+    sort(waitingKeys.begin(), waitingKeys.end());
+    for (uint64_t key : waitingKeys) {
+        waiting.push_back(static_cast<uint32_t>(key));
+        waitingSymbol.push_back(static_cast<int>(key >> 32));
+    }
+    waitingStart.push_back(waiting.size());
+    leoTop.resize(waiting.size(), LEO_UNKNOWN);
+}
+
+pair<const uint32_t *, const uint32_t *> EarleyParser::waitingOn(size_t set, int symbol) const {
+    const int *symbols = waitingSymbol.data();
+    const int *first = lower_bound(symbols + waitingStart[set], symbols + waitingStart[set + 1], symbol);
+    const int *last = first;
+    while (last != symbols + waitingStart[set + 1] && *last == symbol) ++last;
+    return {waiting.data() + (first - symbols), waiting.data() + (last - symbols)};
+}
+
+// ===================================================
+// Leo item: when exactly one item of `set` waits on `symbol`
+// and `symbol` ends its rule (B -> α • symbol), completing
+// `symbol` from `set` completes B too; follow that path to its
+// top and memoize the top, encoded as dot << 32 | origin,
+// at the first waiting entry of (set, symbol).
+// -1 = no deterministic path.
+// ===================================================
+int64_t EarleyParser::leoItem(uint32_t set, int symbol) {
+    struct Step {
+        size_t group;
+        int64_t completed;          // B -> α symbol • from this step
+    };
+    vector<Step> path;
+    int64_t top = -1;
+
+    while (true) {
+        auto range = waitingOn(set, symbol);
+        if (range.second - range.first != 1) break;
+        const EarleyItem w = items[*range.first];
+        if (postDot[w.dot + 1] != -1) break;
+
+        const size_t group = range.first - waiting.data();
+        if (leoTop[group] != LEO_UNKNOWN) {
+            top = leoTop[group];
+            break;
+        }
+
+        path.push_back({group, static_cast<int64_t>(itemKey(w.dot + 1, w.origin))});
+        leoTop[group] = -1;         // cycles of unit rules end here
+        symbol = ruleLHS[dotRule[w.dot]];
+        set = w.origin;
+    }
+
+    // Each step's top is the next step's top, or its own item
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        if (top < 0) top = it->completed;
+        leoTop[it->group] = top;
+        stats.leoItems++;
+    }
+    return top;
+}
+
+// ===================================================
+// Recognizer
+// ===================================================
+bool EarleyParser::run(const vector<string> &tokens) {
+    items.clear();
+    setStart.assign(1, 0);
+    waiting.clear();
+    waitingSymbol.clear();
+    waitingStart.assign(1, 0);
+    leoTop.clear();
+    leoHits.clear();
+    forest.clear();
+    accepted = false;
+    stoppedAt = 0;
+    stats = EarleyStats();
+    Instrumentation::count(Counter::SENTENCES);
+
+    size_t n = tokens.size();
+    if (n > 0 && tokens.back() == "$") n--;
+
+    input.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        auto id = terminalIds.find(tokens[k]);
+        if (id == terminalIds.end()) {
+            stoppedAt = k;
+            return false;
+        }
+        input[k] = id->second;
+    }
+    if (ruleLHS.empty()) return false;
+
+    size_t steps = 0;
+    CountOnExit countSteps(Counter::PARSE_STEPS, steps);
+
+    fill(predicted.begin(), predicted.end(), 0);
+    fill(dotStamp.begin(), dotStamp.end(), 0);
+    vector<EarleyItem> scanned;
+
+    current = 0;
+    lookahead = n > 0 ? input[0] : -1;
+    resetItemSet();
+    addItem(ruleDot[0], 0);
+
+    for (size_t i = 0; ; ++i) {
+        const uint32_t here = static_cast<uint32_t>(i);
+        scanned.clear();
+
+        for (size_t t = setStart[i]; t < items.size(); ++t) {
+            const EarleyItem item = items[t];
+            const int sym = postDot[item.dot];
+            steps++;
+
+            if (sym < 0) {
+                // Completion; ε-completions were done at prediction
+                if (item.origin == here) continue;
+                const int lhs = ruleLHS[dotRule[item.dot]];
+
+                auto range = waitingOn(item.origin, lhs);
+                if (range.second - range.first == 1 && postDot[items[*range.first].dot + 1] == -1) {
+                    int64_t top = leoItem(item.origin, lhs);
+                    addItem(static_cast<uint32_t>(top >> 32), static_cast<uint32_t>(top));
+                    leoHits.push_back({here, item.origin, lhs});
+                    continue;
+                }
+                for (const uint32_t *w = range.first; w != range.second; ++w) {
+                    const EarleyItem parent = items[*w];
+                    addItem(parent.dot + 1, parent.origin);
+                }
+            }
+            else if (sym < terminalCount) {
+                if (i < n && input[i] == sym) scanned.push_back({item.dot + 1, item.origin});
+            }
+            else {
+                // The whole closure at once; its own items then find
+                // their non-terminals already predicted
+                if (predicted[sym] != here + 1) {
+                    const Prediction &p = prediction(sym);
+                    for (uint32_t k = p.symbols; k < p.symbolsEnd; ++k)
+                        predicted[predictionSymbols[k]] = here + 1;
+                    for (uint32_t k = p.dots; k < p.dotsEnd; ++k) {
+                        const uint32_t dot = predictionDots[k];
+                        if (dotStamp[dot] == here + 1) continue;
+                        dotStamp[dot] = here + 1;
+                        items.push_back({dot, here});
+                    }
+                }
+                // Aycock–Horspool: step over a nullable symbol now
+                if (nullable[sym]) addItem(item.dot + 1, item.origin);
+            }
+        }
+
+        indexWaiting(i);
+        setStart.push_back(items.size());
+        if (i == n) break;
+
+        if (scanned.empty()) {
+            stoppedAt = i;
+            break;
+        }
+        current = here + 1;
+        lookahead = current < n ? input[current] : -1;
+        resetItemSet();
+        for (const auto &item : scanned) addItem(item.dot, item.origin);
+    }
+
+    const size_t sets = setStart.size() - 1;
+    accepted = sets == n + 1 && hasItem(ruleDot[0] + 1, 0);
+    if (!accepted && sets == n + 1) stoppedAt = n;
+
+    stats.sets = sets;
+    stats.items = items.size();
+    stats.leoShortcuts = leoHits.size();
+    stats.bytes = items.capacity() * sizeof(EarleyItem) +
+                  (waiting.capacity() + waitingSymbol.capacity()) * sizeof(uint32_t) +
+                  waitingKeys.capacity() * sizeof(uint64_t) + leoTop.capacity() * sizeof(int64_t) +
+                  (setStart.capacity() + waitingStart.capacity()) * sizeof(size_t) +
+                  slots.capacity() * sizeof(uint64_t) + dotStamp.capacity() * sizeof(uint32_t);
+    return accepted;
+}
+
+bool EarleyParser::recognize(const vector<string> &tokens) {
+    return run(tokens);
+}
+
+bool EarleyParser::parse(const vector<string> &tokens) {
+    if (!run(tokens)) return false;
+    inputTokens.assign(tokens.begin(), tokens.begin() + input.size());
+    buildForest();
+    return true;
+}
+
+// ===================================================
+// Parse forest from the chart
+// ===================================================
+void EarleyParser::buildForest() {
+    forest.setRuleLabels(ruleLabels);
+    const size_t sets = setStart.size() - 1;
+
+    // 🔹 Completed items per set, including the ones Leo skipped
+    struct Completed {
+        uint32_t set;
+        int lhs;
+        uint32_t origin;
+        int rule;
+        bool operator<(const Completed &o) const {
+            return tie(set, lhs, origin, rule) < tie(o.set, o.lhs, o.origin, o.rule);
+        }
+        bool operator==(const Completed &o) const {
+            return set == o.set && lhs == o.lhs && origin == o.origin && rule == o.rule;
+        }
+    };
+    vector<Completed> completed;
+    for (size_t s = 0; s < sets; ++s)
+        for (size_t t = setStart[s]; t < setStart[s + 1]; ++t)
+            if (postDot[items[t].dot] < 0) {
+                int rule = dotRule[items[t].dot];
+                completed.push_back({static_cast<uint32_t>(s), ruleLHS[rule], items[t].origin, rule});
+            }
+
+    for (const auto &hit : leoHits) {
+        uint32_t set = hit.origin;
+        int symbol = hit.symbol;
+        const int64_t top = leoTop[waitingOn(set, symbol).first - waiting.data()];
+        for (size_t guard = 0; guard <= items.size(); ++guard) {
+            const EarleyItem w = items[*waitingOn(set, symbol).first];
+            const int rule = dotRule[w.dot];
+            completed.push_back({hit.set, ruleLHS[rule], w.origin, rule});
+            if (static_cast<int64_t>(itemKey(w.dot + 1, w.origin)) == top) break;
+            symbol = ruleLHS[rule];
+            set = w.origin;
+        }
+    }
+    sort(completed.begin(), completed.end());
+    completed.erase(unique(completed.begin(), completed.end()), completed.end());
+
+    auto completedOf = [&](uint32_t set, int lhs) {
+        Completed lo{set, lhs, 0, -1}, hi{set, lhs + 1, 0, -1};
+        return make_pair(lower_bound(completed.begin(), completed.end(), lo),
+                         lower_bound(completed.begin(), completed.end(), hi));
+    };
+
+    // 🔹 Sorted item keys per set, for "is B -> α • X β in set m"
+    vector<uint64_t> keys(items.size());
+    for (size_t t = 0; t < items.size(); ++t) keys[t] = itemKey(items[t].dot, items[t].origin);
+    for (size_t s = 0; s < sets; ++s)
+        sort(keys.begin() + setStart[s], keys.begin() + setStart[s + 1]);
+    auto inSet = [&](size_t set, uint32_t dot, uint32_t origin) {
+        return binary_search(keys.begin() + setStart[set], keys.begin() + setStart[set + 1],
+                             itemKey(dot, origin));
+    };
+
+    // 🔹 Expand symbol nodes top-down, each once
+    struct Pending {
+        int node;
+        int symbol;
+        uint32_t start;
+        uint32_t end;
+    };
+    vector<Pending> work;
+    vector<char> expanded;
+
+    auto symbolNode = [&](int symbol, uint32_t start, uint32_t end) {
+        int node = forest.getNode(symbolNames[symbol], start, end);
+        if (static_cast<size_t>(node) >= expanded.size()) expanded.resize(node + 1, 0);
+        if (!expanded[node]) {
+            expanded[node] = 1;
+            work.push_back({node, symbol, start, end});
+        }
+        return node;
+    };
+
+    const uint32_t n = static_cast<uint32_t>(input.size());
+    forest.setRoot(symbolNode(postDot[ruleDot[0]], 0, n));
+
+    vector<int> kids;
+    while (!work.empty()) {
+        const Pending x = work.back();
+        work.pop_back();
+
+        auto rules = completedOf(x.end, x.symbol);
+        for (auto c = rules.first; c != rules.second; ++c) {
+            if (c->origin != x.start) continue;
+            const int rule = c->rule;
+
+            // Children right to left: symbol k-1 of the rule ends at `end`
+            function<void(uint32_t, uint32_t)> split = [&](uint32_t k, uint32_t end) {
+                if (k == 0) {
+                    if (end == x.start) forest.addPacked(x.node, rule, vector<int>(kids.rbegin(), kids.rend()));
+                    return;
+                }
+                const uint32_t prefix = ruleDot[rule] + k - 1;
+                const int sym = postDot[prefix];
+
+                if (sym < terminalCount) {
+                    if (end == x.start || input[end - 1] != sym || !inSet(end - 1, prefix, x.start)) return;
+                    kids.push_back(forest.getNode(inputTokens[end - 1], end - 1, end, true));
+                    split(k - 1, end - 1);
+                    kids.pop_back();
+                    return;
+                }
+
+                auto children = completedOf(end, sym);
+                for (auto d = children.first; d != children.second; ++d) {
+                    if (d != children.first && d->origin == (d - 1)->origin) continue;
+                    if (d->origin < x.start || !inSet(d->origin, prefix, x.start)) continue;
+                    kids.push_back(symbolNode(sym, d->origin, end));
+                    split(k - 1, d->origin);
+                    kids.pop_back();
+                }
+            };
+            uint32_t length = 0;
+            while (postDot[ruleDot[rule] + length] >= 0) length++;
+            split(length, x.end);
+        }
+    }
+}
+
+// ===================================================
+// Display parse summary and forest
+// ===================================================
+template <typename Log>
+void EarleyParser::displayForest() const {
+    reportAt<Log>(Verbosity::DETAIL, [&](ReportStream &report) {
+        ReportEvent event("earley_forest");
+        event.add("accepted", static_cast<int>(accepted))
+            .add("stopped_at", stoppedAt)
+            .add("sets", stats.sets)
+            .add("items", stats.items)
+            .add("leo_shortcuts", stats.leoShortcuts)
+            .add("leo_items", stats.leoItems)
+            .add("chart_bytes", stats.bytes)
+            .add("symbol_nodes", forest.getNodes().size())
+            .add("packed_nodes", forest.getPacked().size())
+            .add("edges", forest.edgeCount())
+            .add("ambiguous_nodes", forest.ambiguousNodes());
+
+        // -1 = infinitely many / overflow
+        if (accepted && forest.getRoot() >= 0) {
+            event.add("trees", static_cast<int64_t>(forest.countTrees()));
+            if (report.listening(Verbosity::RENDERED))
+                report.emit(ReportEvent("forest_text").add("forest", forest.toString()), Verbosity::RENDERED);
+        }
+
+        report.emit(event);
+    });
+}
+
+#ifndef GRAMRESOLVE_NO_REPORT
+template void EarleyParser::displayForest<ReportLog>() const;
+#endif
+template void EarleyParser::displayForest<SilentLog>() const;
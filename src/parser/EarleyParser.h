@@ -0,0 +1,161 @@
+// ===============================================================
+// File: EarleyParser.h
+// Description: Earley recognizer and parser for any context-free
+//              grammar, including ones that are neither LL(1) nor
+//              LR. Rules and symbols are numbered once per grammar;
+//              an Earley item is two integers (dotted position,
+//              origin) and each Earley set is a contiguous slice of
+//              one item array.
+//
+//              Nullable symbols follow Aycock–Horspool: predicting a
+//              nullable non-terminal also moves the dot over it, so
+//              no completion needs to look back into the set being
+//              built. Leo's optimization memoizes the top of each
+//              deterministic reduction path, which makes
+//              right-recursive grammars linear instead of quadratic.
+//              Items that cannot take the next token (a terminal
+//              after the dot that does not match it, a predicted rule
+//              whose FIRST set misses it) are never added. What one
+//              non-terminal predicts before a given token never
+//              changes, so that whole prediction closure is built on
+//              first use and then copied into a set in one step.
+//              parse() turns the chart into the shared packed parse
+//              forest used by the GLR driver.
+// ===============================================================
+
+#ifndef EARLEY_PARSER_H
+#define EARLEY_PARSER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "SPPF.h"
+#include "../grammar/Grammar.h"
+#include "../analysis/FirstFollow.h"
+
+using namespace std;
+
+// ===============================================================
+// Struct: EarleyItem
+// `dot` numbers a dotted rule (see EarleyParser::dotRule), `origin`
+// is the set the rule was predicted in
+// ===============================================================
+struct EarleyItem {
+    uint32_t dot;
+    uint32_t origin;
+};
+
+// ===============================================================
+// Struct: EarleyStats
+// ===============================================================
+struct EarleyStats {
+    size_t sets = 0;
+    size_t items = 0;
+    size_t leoShortcuts = 0;        // completions answered by a Leo item
+    size_t leoItems = 0;            // memoized reduction-path tops
+    size_t bytes = 0;               // chart memory (items + indexes)
+};
+
+// ===============================================================
+// Class: EarleyParser
+// One instance per thread; the chart is reused between sentences.
+// ===============================================================
+class EarleyParser {
+private:
+    // 🔹 Grammar, numbered. Terminals are 0..T-1, non-terminals
+    // T..T+N-1; rule 0 is the augmented START' -> start.
+    vector<string> symbolNames;
+    unordered_map<string, int> terminalIds;
+    int terminalCount = 0;
+    vector<char> nullable;              // per symbol
+    vector<int> ruleLHS;
+    vector<uint32_t> ruleDot;           // dot of "A -> • α"
+    vector<string> ruleLabels;          // "A -> α", for the forest
+    vector<int> postDot;                // per dot: symbol after it, -1 at the end
+    vector<int> dotRule;                // per dot: its rule
+    vector<vector<uint32_t>> predictions;   // per non-terminal: dots of its rules
+    vector<uint64_t> ruleFirst;         // per rule: FIRST(α) bits, bit T = α ⇒* ε
+    size_t firstWords = 0;
+
+    // Prediction closure of a non-terminal before one lookahead: the
+    // dots it adds to a set and every non-terminal predicted with it
+    struct Prediction {
+        uint32_t dots, dotsEnd;
+        uint32_t symbols, symbolsEnd;
+    };
+    vector<int32_t> predictionAt;       // [non-terminal × (T + 1) + lookahead + 1], -1 = not built
+    vector<Prediction> predictionSets;
+    vector<uint32_t> predictionDots;
+    vector<int> predictionSymbols;
+
+    // 🔹 Chart of the last run
+    vector<EarleyItem> items;
+    vector<size_t> setStart;            // set i = items[setStart[i], setStart[i+1])
+    vector<uint32_t> waiting;           // per set: items before a non-terminal, by symbol
+    vector<int> waitingSymbol;          // that non-terminal, for the lookup
+    vector<size_t> waitingStart;
+    vector<uint64_t> waitingKeys;       // scratch: symbol << 32 | item, for the sort
+    vector<int64_t> leoTop;             // per waiting entry heading a group: top item,
+                                        // -1 = none, LEO_UNKNOWN = not followed yet
+
+    // A completion answered by leoItem(origin, symbol) in `set`; the
+    // skipped items are recovered from it when the forest is built
+    struct LeoHit {
+        uint32_t set;
+        uint32_t origin;
+        int symbol;
+    };
+    vector<LeoHit> leoHits;
+
+    // Item set of the set being built: items predicted in it by dot,
+    // older origins in an open-addressing table reset per set
+    uint32_t current = 0;
+    int lookahead = -1;                 // token of set `current`, -1 at the end
+    vector<uint32_t> dotStamp;          // per dot: set + 1 it was predicted in
+    vector<uint64_t> slots;
+    vector<uint32_t> usedSlots;
+    vector<uint32_t> predicted;         // per symbol: last set it was predicted in + 1
+
+    vector<int> input;                  // token ids of the last run
+    vector<string> inputTokens;
+    SPPF forest;
+    bool accepted = false;
+    size_t stoppedAt = 0;
+    EarleyStats stats;
+
+    bool canStart(int rule) const;
+    const Prediction& prediction(int symbol);
+    bool addItem(uint32_t dot, uint32_t origin);
+    bool hasItem(uint32_t dot, uint32_t origin) const;
+    void resetItemSet();
+    void indexWaiting(size_t set);
+    pair<const uint32_t *, const uint32_t *> waitingOn(size_t set, int symbol) const;
+    int64_t leoItem(uint32_t set, int symbol);
+    bool run(const vector<string> &tokens);
+    void buildForest();
+
+public:
+    EarleyParser(const Grammar &g, const FirstFollowEngine &ff);
+
+    // Silent membership test; tokens may end with "$"
+    bool recognize(const vector<string> &tokens);
+
+    // recognize() plus the parse forest of an accepted input
+    bool parse(const vector<string> &tokens);
+
+    const SPPF& getForest() const { return forest; }
+    bool isAccepted() const { return accepted; }
+
+    // Rejected: index of the first token no item could scan
+    // (tokens without "$"; the token count = the end of the input)
+    size_t getStoppedAt() const { return stoppedAt; }
+
+    const EarleyStats& getStats() const { return stats; }
+
+    // Print chart statistics + forest (terminal + report)
+    template <typename Log = DefaultLog>
+    void displayForest() const;
+};
+
+#endif
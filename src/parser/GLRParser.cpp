@@ -0,0 +1,393 @@
+#include "GLRParser.h"
+#include "../report/reportWriter.h"
+#include "../report/ReportPolicy.h"
+#include "../util/Instrumentation.h"
+#include <iostream>
+#include <sstream>
+#include <deque>
+#include <algorithm>
+#include <functional>
+
+using namespace std;
+
+// ===================================================
+// Constructor — the driver reads the encoded tables
+// ===================================================
+GLRParser::GLRParser(const LR0Parser &parser) : table(parser.getTable()) {}
+
+// ===================================================
+// GSS helpers
+// ===================================================
+bool GLRParser::hasEdge(int from, int to) const {
+    for (const auto &e : gss[from].edges)
+        if (e.to == to) return true;
+    return false;
+}
+
+// Enumerate all paths of `length` edges below `node`. When
+// requiredEdgeFrom >= 0 only paths using that edge are kept.
+void GLRParser::collectPaths(int node, size_t length, vector<int> &kids,
+                             vector<pair<int, vector<int>>> &paths,
+                             int requiredEdgeFrom, int requiredEdgeTo,
+                             bool usedRequired) const {
+    if (length == 0) {
+        if (requiredEdgeFrom < 0 || usedRequired)
+            paths.push_back({node, vector<int>(kids.rbegin(), kids.rend())});
+        return;
+    }
+
+    for (const auto &e : gss[node].edges) {
+        kids.push_back(e.sppf);
+        bool used = usedRequired || (node == requiredEdgeFrom && e.to == requiredEdgeTo);
+        collectPaths(e.to, length - 1, kids, paths, requiredEdgeFrom, requiredEdgeTo, used);
+        kids.pop_back();
+    }
+}
+
+// ===================================================
+// GLR Parsing
+// ===================================================
+template <typename Log>
+bool GLRParser::parse(const vector<string> &input) {
+    gss.clear();
+    forest.clear();
+    forest.setRuleLabels(table.getProductionLabels());
+    accepted = false;
+    deterministicSteps = 0;
+    forks = 0;
+    Instrumentation::count(Counter::SENTENCES);
+    CountOnExit countSteps(Counter::PARSE_STEPS, deterministicSteps);
+
+    vector<string> tokens = input;
+    if (tokens.empty() || tokens.back() != "$")
+        tokens.push_back("$");
+
+    vector<int> ids;
+    if (!table.encodeTokens(tokens, ids)) {
+        reportMessage<Log>([] {
+            return "❌ GLR: input contains a symbol that is not a terminal of the grammar, or a '$' before its end\n";
+        });
+        return false;
+    }
+
+    // ---------------------------------------------------
+    // Phase 1: plain LR stack while every cell is deterministic.
+    // Phase 2 runs the GSS from that stack and hands a single head
+    // back to phase 1, so only ambiguous stretches pay for the GSS.
+    // ---------------------------------------------------
+    struct Entry {
+        int state;
+        int sppf;
+        size_t level;
+        int node;                       // GSS node mirroring it, -1 = none yet
+    };
+    vector<Entry> stack = {{0, -1, 0, -1}};
+    size_t i = 0;
+
+    // Whether `state` is already among the entries of `level` below
+    // `top` (they sit together at the top of the stack)
+    auto repeatsAtLevel = [&](size_t top, int state, size_t level) {
+        for (size_t k = top; k-- > 0 && stack[k].level == level; )
+            if (stack[k].state == state) return true;
+        return false;
+    };
+
+    vector<int> levelNode(table.stateCount(), -1);
+    vector<int> levelNodes;
+    vector<char> processed;
+    vector<int> stackPos;               // GSS node → its stack entry, -1 = none
+    vector<char> branched;              // GSS node with more than one stack below
+
+    auto newNode = [&](int state, size_t level) {
+        gss.push_back({state, level, {}});
+        processed.push_back(0);
+        stackPos.push_back(-1);
+        branched.push_back(0);
+        return static_cast<int>(gss.size() - 1);
+    };
+
+    // Whether `node` is the top of a single stack; if so, the stack
+    // is made to end with it. Edges are only ever added, so a node
+    // found branched stays so; a second edge marks it at once, which
+    // also covers stack entries of the level phase 2 started on.
+    auto onStack = [&](int node) {
+        return stackPos[node] >= 0 && stackPos[node] < static_cast<int>(stack.size()) &&
+               stack[stackPos[node]].node == node;
+    };
+    auto addEdge = [&](int node, int to, int sppf) {
+        if (!gss[node].edges.empty()) branched[node] = 1;
+        gss[node].edges.push_back({to, sppf});
+    };
+    auto collapse = [&](int node) {
+        vector<int> chain;
+        while (branched[node] || !onStack(node)) {
+            if (branched[node] || gss[node].edges.size() != 1) {
+                for (int n : chain) branched[n] = 1;
+                return false;
+            }
+            chain.push_back(node);
+            node = gss[node].edges[0].to;
+        }
+
+        stack.resize(stackPos[node] + 1);
+        for (size_t k = chain.size(); k-- > 0; ) {
+            const GSSNode &n = gss[chain[k]];
+            stackPos[chain[k]] = static_cast<int>(stack.size());
+            stack.push_back({n.state, n.edges[0].sppf, n.level, chain[k]});
+        }
+        return true;
+    };
+
+    vector<int> acceptNodes;
+
+    while (true) {
+        while (true) {
+            uint32_t act = table.getAction(stack.back().state, ids[i]);
+            if (actionTag(act) == ACT_CONFLICT || actionTag(act) == ACT_ERROR)
+                break;                  // conflict or error → generalized mode
+
+            deterministicSteps++;
+
+            if (actionTag(act) == ACT_SHIFT) {
+                int leaf = forest.getNode(tokens[i], i, i + 1, true);
+                stack.push_back({actionPayload(act), leaf, i + 1, -1});
+                i++;
+            }
+            else if (actionTag(act) == ACT_ACCEPT) {
+                if (i + 1 != ids.size())
+                    return false;       // accepted a prefix only
+                forest.setRoot(stack.back().sppf);
+                accepted = true;
+                return true;
+            }
+            else {
+                int p = actionPayload(act);
+                const LRProduction &rule = table.production(p);
+                const string &lhs = table.nonTerminalName(rule.lhs);
+                const Entry &below = stack[stack.size() - 1 - rule.length];
+
+                int next = table.getGoto(below.state, rule.lhs);
+                if (next < 0) {
+                    reportMessage<Log>([&] {
+                        return "❌ GLR: missing GOTO(" + to_string(below.state) + ", " + lhs + ")\n";
+                    });
+                    return false;
+                }
+
+                // A state already on the stack at this level means a cycle
+                // of empty reductions (A ⇒+ A): the linear stack would grow
+                // forever, the GSS shares the node instead
+                if (repeatsAtLevel(stack.size() - rule.length, next, i)) {
+                    deterministicSteps--;
+                    break;
+                }
+
+                vector<int> kids;
+                for (size_t k = stack.size() - rule.length; k < stack.size(); ++k)
+                    kids.push_back(stack[k].sppf);
+                stack.resize(stack.size() - rule.length);
+
+                int X = forest.getNode(lhs, stack.back().level, i);
+                forest.addPacked(X, p, kids);
+                stack.push_back({next, X, i, -1});
+            }
+        }
+
+        // ---------------------------------------------------
+        // Phase 2: mirror the new part of the stack in the GSS
+        // (entries of earlier rounds already have their node)
+        // ---------------------------------------------------
+        for (size_t k = 0; k < stack.size(); ++k) {
+            if (stack[k].node < 0) {
+                int n = newNode(stack[k].state, stack[k].level);
+                if (k > 0)
+                    gss[n].edges.push_back({stack[k - 1].node, stack[k].sppf});
+                stackPos[n] = static_cast<int>(k);
+                stack[k].node = n;
+            }
+            processed[stack[k].node] = 1;
+
+            if (stack[k].level == i) {
+                levelNode[stack[k].state] = stack[k].node;
+                levelNodes.push_back(stack[k].node);
+            }
+        }
+        processed[stack.back().node] = 0;   // the top still has to act
+
+        bool linear = false;
+        for (; i < ids.size(); ++i) {
+            int a = ids[i];
+            vector<pair<int, int>> shifts;
+            deque<int> queue;
+
+            for (int v : levelNodes)
+                if (!processed[v]) queue.push_back(v);
+
+            // Reducer: apply production p over a path ending at u
+            function<void(int, int, const vector<int> &)> reducer =
+                [&](int u, int p, const vector<int> &kids) {
+                    const LRProduction &rule = table.production(p);
+                    int g = table.getGoto(gss[u].state, rule.lhs);
+                    if (g < 0) return;
+
+                    int X = forest.getNode(table.nonTerminalName(rule.lhs), gss[u].level, i);
+                    forest.addPacked(X, p, kids);
+
+                    int w = levelNode[g];
+                    if (w < 0) {
+                        w = newNode(g, i);
+                        gss[w].edges.push_back({u, X});
+                        levelNode[g] = w;
+                        levelNodes.push_back(w);
+                        queue.push_back(w);
+                        return;
+                    }
+
+                    if (hasEdge(w, u))
+                        return;         // derivation already shared via X
+
+                    addEdge(w, u, X);
+
+                    // New edge below an existing node: redo non-empty
+                    // reductions of processed nodes through that edge
+                    for (size_t n = 0; n < levelNodes.size(); ++n) {
+                        int x = levelNodes[n];
+                        if (!processed[x]) continue;
+
+                        size_t count;
+                        const uint32_t *cell = table.cellActions(gss[x].state, a, count);
+                        for (size_t c = 0; c < count; ++c) {
+                            if (actionTag(cell[c]) != ACT_REDUCE) continue;
+                            int rp = actionPayload(cell[c]);
+                            size_t len = table.production(rp).length;
+                            if (len == 0) continue;
+
+                            vector<int> path;
+                            vector<pair<int, vector<int>>> paths;
+                            collectPaths(x, len, path, paths, w, u, false);
+                            for (const auto &pr : paths)
+                                reducer(pr.first, rp, pr.second);
+                        }
+                    }
+                };
+
+            while (!queue.empty()) {
+                int v = queue.front();
+                queue.pop_front();
+                processed[v] = 1;
+
+                size_t count;
+                const uint32_t *cell = table.cellActions(gss[v].state, a, count);
+                if (count > 1)
+                    forks += count - 1;
+
+                for (size_t c = 0; c < count; ++c) {
+                    uint32_t act = cell[c];
+
+                    if (actionTag(act) == ACT_SHIFT) {
+                        shifts.push_back({v, actionPayload(act)});
+                    }
+                    else if (actionTag(act) == ACT_ACCEPT) {
+                        if (i + 1 == ids.size()) acceptNodes.push_back(v);
+                    }
+                    else if (actionTag(act) == ACT_REDUCE) {
+                        int p = actionPayload(act);
+                        vector<int> path;
+                        vector<pair<int, vector<int>>> paths;
+                        collectPaths(v, table.production(p).length, path, paths, -1, -1, false);
+                        for (const auto &pr : paths)
+                            reducer(pr.first, p, pr.second);
+                    }
+                }
+            }
+
+            if (i + 1 == ids.size())
+                break;                  // "$" consumed by accept only
+
+            if (shifts.empty()) {
+                reportMessage<Log>([&] {
+                    return "❌ GLR: syntax error at token " + to_string(i) + " ('" + tokens[i] + "')\n";
+                });
+                return false;
+            }
+
+            // Shift phase → next level
+            for (int v : levelNodes) levelNode[gss[v].state] = -1;
+            levelNodes.clear();
+
+            int leaf = forest.getNode(tokens[i], i, i + 1, true);
+            for (const auto &sh : shifts) {
+                int w = levelNode[sh.second];
+                if (w < 0) {
+                    w = newNode(sh.second, i + 1);
+                    levelNode[sh.second] = w;
+                    levelNodes.push_back(w);
+                }
+                if (!hasEdge(w, sh.first))
+                    addEdge(w, sh.first, leaf);
+            }
+
+            // One head over a single stack: back to phase 1
+            if (levelNodes.size() == 1 && collapse(levelNodes[0])) {
+                levelNode[gss[levelNodes[0]].state] = -1;
+                levelNodes.clear();
+                i++;
+                linear = true;
+                break;
+            }
+        }
+
+        if (!linear)
+            break;
+    }
+
+    // The accepting node sits on top of the bottom node (state 0)
+    for (int v : acceptNodes)
+        for (const auto &e : gss[v].edges)
+            if (gss[e.to].state == 0 && gss[e.to].level == 0) {
+                forest.setRoot(e.sppf);
+                accepted = true;
+            }
+
+    if (!accepted)
+        reportMessage<Log>([] { return "❌ GLR: input rejected at end of input\n"; });
+
+    return accepted;
+}
+
+#ifndef GRAMRESOLVE_NO_REPORT
+template bool GLRParser::parse<ReportLog>(const vector<string> &input);
+#endif
+template bool GLRParser::parse<SilentLog>(const vector<string> &input);
+
+// ===================================================
+// Display parse summary and forest
+// ===================================================
+template <typename Log>
+void GLRParser::displayForest() const {
+    reportAt<Log>(Verbosity::DETAIL, [&](ReportStream &report) {
+        ReportEvent event("glr_forest");
+        event.add("accepted", static_cast<int>(accepted))
+            .add("deterministic_steps", deterministicSteps)
+            .add("forks", forks)
+            .add("gss_nodes", gss.size())
+            .add("symbol_nodes", forest.getNodes().size())
+            .add("packed_nodes", forest.getPacked().size())
+            .add("edges", forest.edgeCount())
+            .add("ambiguous_nodes", forest.ambiguousNodes());
+
+        // -1 = infinitely many / overflow
+        if (accepted) {
+            event.add("trees", static_cast<int64_t>(forest.countTrees()));
+            if (report.listening(Verbosity::RENDERED))
+                report.emit(ReportEvent("forest_text").add("forest", forest.toString()), Verbosity::RENDERED);
+        }
+
+        report.emit(event);
+    });
+}
+
+#ifndef GRAMRESOLVE_NO_REPORT
+template void GLRParser::displayForest<ReportLog>() const;
+#endif
+template void GLRParser::displayForest<SilentLog>() const;
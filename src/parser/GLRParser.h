@@ -0,0 +1,76 @@
+// ===============================================================
+// File: GLRParser.h
+// Description: Generalized LR driver over the (possibly conflicted)
+//              integer-encoded SLR ACTION/GOTO tables. Forks on
+//              conflicting cells using a graph-structured stack and
+//              builds a shared packed parse forest.
+// ===============================================================
+
+#ifndef GLR_PARSER_H
+#define GLR_PARSER_H
+
+#include <string>
+#include <vector>
+#include "LRParser.h"
+#include "SPPF.h"
+#include "../report/ReportPolicy.h"
+
+using namespace std;
+
+// ===============================================================
+// Structs: GSSNode / GSSEdge
+// Graph-structured stack. Nodes of one level are shared per state,
+// edges point towards the bottom of the stack and carry the SPPF
+// node of the symbol between the two states.
+// ===============================================================
+struct GSSEdge {
+    int to;
+    int sppf;
+};
+
+struct GSSNode {
+    int state;
+    size_t level;
+    vector<GSSEdge> edges;
+};
+
+// ===============================================================
+// Class: GLRParser
+// ===============================================================
+class GLRParser {
+private:
+    const LRTable &table;
+
+    // Parse state
+    vector<GSSNode> gss;
+    SPPF forest;
+    bool accepted = false;
+
+    // Statistics of the last run
+    size_t deterministicSteps = 0;
+    size_t forks = 0;
+
+    // Reduction helpers
+    void collectPaths(int node, size_t length, vector<int> &kids,
+                      vector<pair<int, vector<int>>> &paths,
+                      int requiredEdgeFrom, int requiredEdgeTo, bool usedRequired) const;
+
+    bool hasEdge(int from, int to) const;
+
+public:
+    explicit GLRParser(const LR0Parser &parser);
+
+    // Run the GLR driver. tokens must end with "$". A rejection is
+    // reported as a progress message through Log.
+    template <typename Log = DefaultLog>
+    bool parse(const vector<string> &tokens);
+
+    const SPPF& getForest() const { return forest; }
+    bool isAccepted() const { return accepted; }
+
+    // Print parse summary + forest (terminal + report)
+    template <typename Log = DefaultLog>
+    void displayForest() const;
+};
+
+#endif
@@ -0,0 +1,392 @@
+#include "IncrementalParser.h"
+#include "../report/reportWriter.h"
+#include "../report/ReportPolicy.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+
+// ===================================================
+// Constructor — reads the dense tables, so errors are
+// found on the exact token (no default reductions)
+// ===================================================
+IncrementalParser::IncrementalParser(const LR0Parser &parser) : table(parser.getTable()) {}
+
+uint32_t IncrementalParser::lookupAction(int state, int terminal) const {
+    uint32_t act = table.getAction(state, terminal);
+    if (actionTag(act) == ACT_CONFLICT)
+        act = table.conflictList(act)[0];
+    return act;
+}
+
+// ===================================================
+// A subtree covering old tokens [start, start+width)
+// can be reused only when no edit touches its tokens
+// or the lookahead token right after it
+// ===================================================
+bool IncrementalParser::damaged(size_t start, size_t width, const vector<TokenEdit> &edits) const {
+    size_t lookahead = start + width;
+
+    for (const auto &e : edits) {
+        if (e.start > lookahead)
+            break;
+        if (e.oldLength == 0) {
+            if (e.start > start) return true;     // insertion inside or before the lookahead
+        } else if (e.start + e.oldLength > start) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ===================================================
+// Full parse = reparse of an empty document with one
+// insertion
+// ===================================================
+template <typename Log>
+bool IncrementalParser::parse(const vector<string> &tokens) {
+    vector<string> input = tokens;
+    if (!input.empty() && input.back() == "$")
+        input.pop_back();
+
+    root.reset();
+    tokenCount = 0;
+    fallbackTokens.clear();
+
+    return run<Log>({{0, 0, input}});
+}
+
+template <typename Log>
+bool IncrementalParser::reparse(const vector<TokenEdit> &edits) {
+    vector<TokenEdit> sorted = edits;
+    stable_sort(sorted.begin(), sorted.end(), [](const TokenEdit &a, const TokenEdit &b) {
+        return a.start < b.start;
+    });
+
+    for (size_t k = 0; k < sorted.size(); ++k) {
+        bool outside = sorted[k].start + sorted[k].oldLength > tokenCount;
+        bool overlaps = k > 0 && sorted[k].start < sorted[k - 1].start + sorted[k - 1].oldLength;
+        if (outside || overlaps) {
+            reportAt<Log>(Verbosity::SUMMARY, [&](ReportStream &report) {
+                report.emit(ReportEvent("invalid_edit").add("token", sorted[k].start), Verbosity::SUMMARY);
+            });
+            return false;
+        }
+    }
+
+    // No tree to reuse (last attempt failed): apply the edits to
+    // the token list and start over
+    if (!root) {
+        vector<string> tokens;
+        size_t pos = 0;
+        for (const auto &e : sorted) {
+            tokens.insert(tokens.end(), fallbackTokens.begin() + pos, fallbackTokens.begin() + e.start);
+            tokens.insert(tokens.end(), e.newTokens.begin(), e.newTokens.end());
+            pos = e.start + e.oldLength;
+        }
+        tokens.insert(tokens.end(), fallbackTokens.begin() + pos, fallbackTokens.end());
+        return parse<Log>(tokens);
+    }
+
+    return run<Log>(sorted);
+}
+
+#ifndef GRAMRESOLVE_NO_REPORT
+template bool IncrementalParser::parse<ReportLog>(const vector<string> &tokens);
+template bool IncrementalParser::reparse<ReportLog>(const vector<TokenEdit> &edits);
+#endif
+template bool IncrementalParser::parse<SilentLog>(const vector<string> &tokens);
+template bool IncrementalParser::reparse<SilentLog>(const vector<TokenEdit> &edits);
+
+// ===================================================
+// Driver: an LR parse whose input is a stream of old
+// subtrees and fresh tokens. Damaged subtrees are split
+// lazily, so untouched regions cost one shift each.
+// ===================================================
+template <typename Log>
+bool IncrementalParser::run(const vector<TokenEdit> &edits) {
+    auto t0 = chrono::steady_clock::now();
+    stats = ReparseStats();
+
+    shared_ptr<ParseNode> oldRoot = root;
+    size_t oldCount = tokenCount;
+    size_t newCount = oldCount;
+    for (const auto &e : edits)
+        newCount = newCount - e.oldLength + e.newTokens.size();
+
+    const int T = static_cast<int>(table.terminalCount());
+
+    vector<InputItem> input;                 // back = next item
+    if (oldRoot) input.push_back({oldRoot, 0});
+
+    size_t nextEdit = 0;
+    size_t fresh = 0;                        // next token of edits[nextEdit]
+    string error;
+
+    shared_ptr<ParseNode> ahead;             // nullptr → end of input
+    size_t aheadStart = 0;
+    bool aheadOld = false;
+
+    auto breakdown = [&](const shared_ptr<ParseNode> &node, size_t start) {
+        stats.breakdowns++;
+        size_t end = start + node->width;
+        for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+            end -= (*it)->width;
+            input.push_back({*it, end});
+        }
+    };
+
+    auto advance = [&]() -> bool {
+        while (true) {
+            size_t cursor = input.empty() ? oldCount : input.back().oldStart;
+
+            if (nextEdit < edits.size() && edits[nextEdit].start <= cursor) {
+                const TokenEdit &e = edits[nextEdit];
+
+                if (fresh < e.newTokens.size()) {
+                    const string &tok = e.newTokens[fresh++];
+                    int id = table.terminalId(tok);
+                    if (id < 0 || id == table.endMarker()) {
+                        error = "unknown token '" + tok + "'";
+                        return false;
+                    }
+                    ahead = make_shared<ParseNode>(ParseNode{id, -1, -1, id, 1, {}});
+                    aheadOld = false;
+                    return true;
+                }
+
+                // Drop what the edit replaced, splitting nodes that
+                // stick out of the replaced range
+                size_t end = e.start + e.oldLength;
+                if (!input.empty() && cursor < end) {
+                    InputItem item = input.back();
+                    input.pop_back();
+                    if (item.oldStart + item.node->width > end)
+                        breakdown(item.node, item.oldStart);
+                    continue;
+                }
+
+                nextEdit++;
+                fresh = 0;
+                continue;
+            }
+
+            if (input.empty()) {
+                ahead.reset();
+                return true;
+            }
+
+            InputItem item = input.back();
+            input.pop_back();
+
+            // Empty subtrees are re-derived by reductions
+            if (item.node->width == 0)
+                continue;
+
+            if (item.node->production >= 0 && damaged(item.oldStart, item.node->width, edits)) {
+                breakdown(item.node, item.oldStart);
+                continue;
+            }
+
+            ahead = item.node;
+            aheadStart = item.oldStart;
+            aheadOld = true;
+            return true;
+        }
+    };
+
+    vector<pair<int, shared_ptr<ParseNode>>> stack;
+    stack.push_back({0, nullptr});
+
+    // Same bound as LR0Parser::recognize() on reductions between two
+    // shifts; a cyclic grammar (A =>+ A) would otherwise keep
+    // stacking fresh nodes forever
+    const size_t perLevel = 2 * (table.nonTerminalCount() + 1);
+    size_t reductionsLeft = 2 * perLevel;
+
+    bool ok = advance();
+    while (ok) {
+        int s = stack.back().first;
+        int la = ahead ? ahead->first : table.endMarker();
+        uint32_t act = lookupAction(s, la);
+
+        if (actionTag(act) == ACT_SHIFT) {
+            if (ahead->production >= 0) {
+                // Same left state + same tokens + same lookahead →
+                // the LR parse of this subtree would be identical
+                if (aheadOld && ahead->state == s) {
+                    int target = table.getGoto(s, ahead->symbol - T);
+                    if (target >= 0) {
+                        stack.push_back({target, ahead});
+                        reductionsLeft = (stack.size() + 1) * perLevel;
+                        stats.shifts++;
+                        stats.reusedNodes++;
+                        stats.reusedTokens += ahead->width;
+                        ok = advance();
+                        continue;
+                    }
+                }
+
+                // Left context changed: split and retry
+                breakdown(ahead, aheadStart);
+                ok = advance();
+                continue;
+            }
+
+            // Fresh leaves are unshared; old ones may still be held
+            // by a caller's copy of the previous tree
+            shared_ptr<ParseNode> leaf = ahead;
+            if (!aheadOld)
+                leaf->state = s;
+            else if (leaf->state != s)
+                leaf = make_shared<ParseNode>(ParseNode{ahead->symbol, -1, s, ahead->first, 1, {}});
+
+            stack.push_back({actionPayload(act), leaf});
+            reductionsLeft = (stack.size() + 1) * perLevel;
+            stats.shifts++;
+            ok = advance();
+            continue;
+        }
+
+        if (actionTag(act) == ACT_REDUCE) {
+            if (reductionsLeft-- == 0) {
+                error = "reductions without a shift (cyclic grammar)";
+                ok = false;
+                break;
+            }
+
+            int p = actionPayload(act);
+            const LRProduction &prod = table.production(p);
+            size_t base = stack.size() - prod.length;
+
+            auto node = make_shared<ParseNode>(ParseNode{T + prod.lhs, p, stack[base - 1].first, -1, 0, {}});
+            node->children.reserve(prod.length);
+            for (size_t k = base; k < stack.size(); ++k) {
+                const auto &child = stack[k].second;
+                node->width += child->width;
+                if (node->first < 0) node->first = child->first;
+                node->children.push_back(child);
+            }
+
+            stack.resize(base);
+            int target = table.getGoto(stack.back().first, prod.lhs);
+            if (target < 0) {
+                error = "missing GOTO(" + to_string(stack.back().first) + ", " +
+                        table.nonTerminalName(prod.lhs) + ")";
+                ok = false;
+                break;
+            }
+
+            stack.push_back({target, node});
+            stats.reductions++;
+            continue;
+        }
+
+        if (actionTag(act) == ACT_ACCEPT) {
+            root = stack.back().second;
+            tokenCount = newCount;
+            fallbackTokens.clear();
+            stats.millis = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+            return true;
+        }
+
+        error = "syntax error at '" + table.terminalName(la) + "' in state " + to_string(s);
+        ok = false;
+    }
+
+    // Keep the edited token list so the next call can start over
+    vector<string> old;
+    if (oldRoot) collectTokens(oldRoot, old);
+
+    fallbackTokens.clear();
+    size_t pos = 0;
+    for (const auto &e : edits) {
+        fallbackTokens.insert(fallbackTokens.end(), old.begin() + pos, old.begin() + e.start);
+        fallbackTokens.insert(fallbackTokens.end(), e.newTokens.begin(), e.newTokens.end());
+        pos = e.start + e.oldLength;
+    }
+    fallbackTokens.insert(fallbackTokens.end(), old.begin() + pos, old.end());
+
+    root.reset();
+    tokenCount = newCount;
+    stats.millis = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+    reportAt<Log>(Verbosity::SUMMARY, [&](ReportStream &report) {
+        report.emit(ReportEvent("incremental_error").add("message", error), Verbosity::SUMMARY);
+    });
+    return false;
+}
+
+#ifndef GRAMRESOLVE_NO_REPORT
+template bool IncrementalParser::run<ReportLog>(const vector<TokenEdit> &edits);
+#endif
+template bool IncrementalParser::run<SilentLog>(const vector<TokenEdit> &edits);
+
+// ===================================================
+// Token and tree views
+// ===================================================
+void IncrementalParser::collectTokens(const shared_ptr<ParseNode> &node, vector<string> &out) const {
+    vector<const ParseNode*> pending{node.get()};
+
+    while (!pending.empty()) {
+        const ParseNode *n = pending.back();
+        pending.pop_back();
+
+        if (n->production < 0) {
+            out.push_back(table.terminalName(n->symbol));
+            continue;
+        }
+        for (auto it = n->children.rbegin(); it != n->children.rend(); ++it)
+            pending.push_back(it->get());
+    }
+}
+
+vector<string> IncrementalParser::getTokens() const {
+    if (!root) return fallbackTokens;
+
+    vector<string> out;
+    out.reserve(tokenCount);
+    collectTokens(root, out);
+    return out;
+}
+
+void IncrementalParser::printNode(const shared_ptr<ParseNode> &node, int depth,
+                                  std::ostringstream &out) const {
+    out << string(depth * 2, ' ') << table.symbolName(node->symbol);
+    if (node->production >= 0)
+        out << "  [state " << node->state << ", " << node->width << " tokens]";
+    out << "\n";
+
+    for (const auto &child : node->children)
+        printNode(child, depth + 1, out);
+}
+
+string IncrementalParser::treeToString() const {
+    std::ostringstream out;
+    if (root) printNode(root, 0, out);
+    return out.str();
+}
+
+template <typename Log>
+void IncrementalParser::displayStats(const string &title) const {
+    reportAt<Log>(Verbosity::DETAIL, [&](ReportStream &report) {
+        report.emit(ReportEvent("incremental_stats")
+                        .add("title", title)
+                        .add("accepted", static_cast<int>(root != nullptr))
+                        .add("tokens", tokenCount)
+                        .add("shifts", stats.shifts)
+                        .add("reductions", stats.reductions)
+                        .add("reused_nodes", stats.reusedNodes)
+                        .add("reused_tokens", stats.reusedTokens)
+                        .add("breakdowns", stats.breakdowns)
+                        .add("micros", static_cast<int64_t>(stats.millis * 1000)));
+    });
+}
+
+#ifndef GRAMRESOLVE_NO_REPORT
+template void IncrementalParser::displayStats<ReportLog>(const string &title) const;
+#endif
+template void IncrementalParser::displayStats<SilentLog>(const string &title) const;
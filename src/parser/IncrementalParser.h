@@ -0,0 +1,121 @@
+// ===============================================================
+// File: IncrementalParser.h
+// Description: Incremental LR reparsing. The previous parse tree is
+//              kept with the LR state recorded on every node; after
+//              a token edit only the damaged region is reparsed and
+//              untouched subtrees are shifted back whole when their
+//              left state and lookahead are unchanged.
+// ===============================================================
+
+#ifndef INCREMENTAL_PARSER_H
+#define INCREMENTAL_PARSER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "LRParser.h"
+
+using namespace std;
+
+// ===============================================================
+// Struct: ParseNode
+// Node of the concrete parse tree. Positions are not stored; a
+// node only knows how many tokens it covers, so untouched
+// subtrees stay valid when text before them grows or shrinks.
+// ===============================================================
+struct ParseNode {
+    int symbol;              // unified symbol id (see LRProduction)
+    int production;          // -1 for terminals
+    int state;               // LR state on the stack when the node began
+    int first;               // first terminal id, -1 when the node is empty
+    size_t width;            // tokens covered
+    vector<shared_ptr<ParseNode>> children;
+
+    // Long left-recursive lists make very deep trees; release them
+    // iteratively instead of through nested destructors
+    ~ParseNode() {
+        vector<shared_ptr<ParseNode>> pending;
+        pending.swap(children);
+        while (!pending.empty()) {
+            shared_ptr<ParseNode> node = std::move(pending.back());
+            pending.pop_back();
+            if (node.use_count() == 1)
+                for (auto &child : node->children)
+                    pending.push_back(std::move(child));
+        }
+    }
+};
+
+// ===============================================================
+// Struct: TokenEdit
+// Replace `oldLength` tokens starting at `start` (positions in
+// the previous token sequence) with `newTokens`.
+// ===============================================================
+struct TokenEdit {
+    size_t start;
+    size_t oldLength;
+    vector<string> newTokens;
+};
+
+// ===============================================================
+// Struct: ReparseStats
+// ===============================================================
+struct ReparseStats {
+    size_t shifts = 0;           // terminals + reused subtrees pushed
+    size_t reductions = 0;
+    size_t reusedNodes = 0;      // non-terminal subtrees shifted whole
+    size_t reusedTokens = 0;     // tokens covered by those subtrees
+    size_t breakdowns = 0;       // old nodes split into their children
+    double millis = 0.0;
+};
+
+// ===============================================================
+// Class: IncrementalParser
+// ===============================================================
+class IncrementalParser {
+private:
+    const LRTable &table;
+
+    shared_ptr<ParseNode> root;      // node of the start symbol
+    size_t tokenCount = 0;
+    vector<string> fallbackTokens;   // full input after a failed reparse
+    ReparseStats stats;
+
+    // Input stream item: an old subtree (with its old start) or a
+    // fresh token from an edit
+    struct InputItem {
+        shared_ptr<ParseNode> node;
+        size_t oldStart;
+    };
+
+    template <typename Log>
+    bool run(const vector<TokenEdit> &edits);
+    bool damaged(size_t start, size_t width, const vector<TokenEdit> &edits) const;
+    uint32_t lookupAction(int state, int terminal) const;
+    void collectTokens(const shared_ptr<ParseNode> &node, vector<string> &out) const;
+    void printNode(const shared_ptr<ParseNode> &node, int depth, std::ostringstream &out) const;
+
+public:
+    explicit IncrementalParser(const LR0Parser &parser);
+
+    // Parse a whole token sequence (a trailing "$" is optional)
+    template <typename Log = DefaultLog>
+    bool parse(const vector<string> &tokens);
+
+    // Apply non-overlapping edits to the last input and reparse
+    // only what they damaged
+    template <typename Log = DefaultLog>
+    bool reparse(const vector<TokenEdit> &edits);
+
+    shared_ptr<ParseNode> getTree() const { return root; }
+    size_t getTokenCount() const { return tokenCount; }
+    vector<string> getTokens() const;
+    const ReparseStats& getStats() const { return stats; }
+
+    // Indented tree / statistics (terminal + report)
+    string treeToString() const;
+    template <typename Log = DefaultLog>
+    void displayStats(const string &title) const;
+};
+
+#endif
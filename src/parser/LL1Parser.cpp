@@ -1,63 +1,195 @@
 #include "LL1Parser.h"
-#include "../report/reportWriter.h"
+#include "../report/ReportPolicy.h"
+#include "../util/Instrumentation.h"
 #include <sstream>
 #include <stack>
 #include <iostream>
 #include <algorithm>
 #include <iomanip>
+#include <unordered_map>
+#include <functional>
 
 using namespace std;
 
-// A helper to print+save text
-#define OUT(x) do { cout << x; ReportWriter::get() << x; } while(0)
-
 // ==========================================================
 // 🎯 Build LL(1) Parsing Table
 // ==========================================================
+template <typename Log>
 void LL1Parser::buildTable() {
+    PhaseTimer timer("ll1_table");
     parsingTable.clear();
+    conflicts.clear();
+    alternativeTexts.clear();
+    alternativeSymbols.clear();
+
+    reportMessage<Log>([] { return "\nBuilding LL(1) Parsing Table...\n"; });
+
+    nonTerminalNames.assign(grammar.getNonTerminals().begin(), grammar.getNonTerminals().end());
+    terminalNames.assign(grammar.getTerminals().begin(), grammar.getTerminals().end());
+    if (!grammar.getTerminals().count("$"))
+        terminalNames.push_back("$");
+
+    unordered_map<string, int> ntId, tId;
+    for (size_t k = 0; k < nonTerminalNames.size(); ++k) ntId[nonTerminalNames[k]] = static_cast<int>(k);
+    for (size_t k = 0; k < terminalNames.size(); ++k) tId[terminalNames[k]] = static_cast<int>(k);
+
+    cellOwner.assign(nonTerminalNames.size() * terminalNames.size(), -1);
+
+    const int T = static_cast<int>(terminalNames.size());
+    terminalIds = tId;
+    auto start = ntId.find(grammar.getStartSymbol());
+    startId = start == ntId.end() ? -1 : start->second;
 
-    OUT("\nBuilding LL(1) Parsing Table...\n");
+    // FIRST(rhs) and predict sets of one alternative; reset for the
+    // next one, so only a grammar with huge sets reaches the heap
+    char scratch[16384];
+    pmr::monotonic_buffer_resource arena(scratch, sizeof scratch);
 
     for (const auto &prod : grammar.getProductions()) {
-        const string &A = prod.getLHS();
+        int A = ntId.at(prod.getLHS());
 
         for (const auto &rhs : prod.getRHS()) {
-            set<string> firstSet = computeFirstOfString(rhs);
+            arena.release();
+            int alt = static_cast<int>(alternativeTexts.size());
+            alternativeTexts.push_back(join(rhs, " "));
+            alternativeSymbols.emplace_back();
+            for (const auto &sym : rhs) {
+                if (sym == "ε") continue;
+                auto t = tId.find(sym);
+                alternativeSymbols.back().push_back(t != tId.end() ? t->second : T + ntId.at(sym));
+            }
+            pmr::set<string> firstSet = computeFirstOfString(rhs, &arena);
+            pmr::set<string> predict(&arena);
 
             // Rule 1: FIRST(rhs)
             for (const auto &a : firstSet) {
-                if (a != "ε") {
-                    string rhsStr = join(rhs, " ");
-                    if (parsingTable[A][a].empty())
-                        parsingTable[A][a] = rhsStr;
-                    else
-                        parsingTable[A][a] += "|" + rhsStr; // conflict
-                }
+                if (a != "ε")
+                    predict.insert(a);
             }
 
             // Rule 2: ε in FIRST(rhs) → FOLLOW(A)
             if (firstSet.find("ε") != firstSet.end()) {
-                const auto &followA = ff.getFOLLOW(A);
-                for (const auto &b : followA) {
-                    string rhsStr = join(rhs, " ");
-                    if (parsingTable[A][b].empty())
-                        parsingTable[A][b] = rhsStr;
-                    else
-                        parsingTable[A][b] += "|" + rhsStr; // conflict
-                }
+                const auto &followA = ff.getFOLLOW(prod.getLHS());
+                predict.insert(followA.begin(), followA.end());
+            }
+
+            for (const auto &a : predict)
+                place(A, tId.at(a), alt);
+        }
+    }
+
+    // Left corners (through nullable prefixes); a cycle would make
+    // the first-alternative driver expand forever
+    const int N = static_cast<int>(nonTerminalNames.size());
+    vector<vector<int>> corners(N);
+    for (const auto &prod : grammar.getProductions())
+        for (const auto &rhs : prod.getRHS())
+            for (const auto &sym : rhs) {
+                auto nt = ntId.find(sym);
+                if (nt == ntId.end()) break;
+                corners[ntId.at(prod.getLHS())].push_back(nt->second);
+                if (!ff.isNullable(sym)) break;
             }
+
+    leftRecursive = false;
+    vector<int> color(N, 0);
+    function<void(int)> visit = [&](int a) {
+        color[a] = 1;
+        for (int b : corners[a]) {
+            if (color[b] == 1) leftRecursive = true;
+            else if (color[b] == 0) visit(b);
         }
+        color[a] = 2;
+    };
+    for (int a = 0; a < N && !leftRecursive; ++a)
+        if (color[a] == 0) visit(a);
+
+    reportMessage<Log>([] { return "✅ LL(1) Table construction complete.\n"; });
+}
+
+#ifndef GRAMRESOLVE_NO_REPORT
+template void LL1Parser::buildTable<ReportLog>();
+#endif
+template void LL1Parser::buildTable<SilentLog>();
+
+// ==========================================================
+// Write an alternative into a cell; a second alternative is
+// a conflict and is recorded right here
+// ==========================================================
+void LL1Parser::place(int nonTerminal, int terminal, int alternative) {
+    int &owner = cellOwner[nonTerminal * terminalNames.size() + terminal];
+    string &cell = parsingTable[nonTerminalNames[nonTerminal]][terminalNames[terminal]];
+
+    if (owner < 0) {
+        owner = alternative;
+        cell = alternativeTexts[alternative];
+        return;
+    }
+
+    cell += "|" + alternativeTexts[alternative];   // shown as "A|B" in the table
+    conflicts.push_back({nonTerminal, terminal, static_cast<uint32_t>(owner),
+                         static_cast<uint32_t>(alternative), ConflictKind::LL1_MULTIPLE});
+}
+
+// ==========================================================
+// Silent recognizer over the structured table
+// ==========================================================
+bool LL1Parser::recognize(const vector<string> &tokens) const {
+    if (startId < 0) return false;
+    Instrumentation::count(Counter::SENTENCES);
+
+    const int T = static_cast<int>(terminalNames.size());
+    const int end = terminalIds.at("$");
+
+    vector<int> ids;
+    ids.reserve(tokens.size() + 1);
+    for (const auto &tok : tokens) {
+        auto t = terminalIds.find(tok);
+        if (t == terminalIds.end()) return false;
+        ids.push_back(t->second);
     }
+    if (ids.empty() || ids.back() != end) ids.push_back(end);
+
+    vector<int> stack = {end, T + startId};
+    size_t i = 0;
+
+    // Left-recursive grammars: give up after too many expansions
+    // without consuming a token
+    size_t expansions = 0;
+    size_t limit = (nonTerminalNames.size() + 1) * 4;
+
+    size_t steps = 0;
+    CountOnExit countSteps(Counter::PARSE_STEPS, steps);
+
+    while (!stack.empty()) {
+        int top = stack.back();
+        stack.pop_back();
+        steps++;
+
+        if (top < T) {                      // terminal (or "$") must match
+            if (i >= ids.size() || top != ids[i]) return false;
+            i++;
+            expansions = 0;
+            limit = (nonTerminalNames.size() + 1) * (stack.size() + 4);
+            continue;
+        }
+        if (i >= ids.size()) return false;
+        if (leftRecursive && ++expansions > limit) return false;
 
-    OUT("✅ LL(1) Table construction complete.\n");
+        int alt = cellOwner[(top - T) * T + ids[i]];
+        if (alt < 0) return false;
+        const auto &rhs = alternativeSymbols[alt];
+        stack.insert(stack.end(), rhs.rbegin(), rhs.rend());
+    }
+    return i == ids.size();
 }
 
 // ==========================================================
 // 🧩 Compute FIRST(α)
 // ==========================================================
-set<string> LL1Parser::computeFirstOfString(const vector<string> &rhs) const {
-    set<string> result;
+pmr::set<string> LL1Parser::computeFirstOfString(const vector<string> &rhs,
+                                                 pmr::memory_resource *arena) const {
+    pmr::set<string> result(arena);
 
     for (const auto &symbol : rhs) {
         const set<string> &firstSym = ff.getFIRST(symbol);
@@ -94,33 +226,38 @@ string LL1Parser::join(const vector<string> &rhs, const string &sep) const {
 // ==========================================================
 // 📄 Display LL(1) Table
 // ==========================================================
+template <typename Log>
 void LL1Parser::displayTable() const {
-    std::ostringstream out;
-
-    out << "\n=== LL(1) Parsing Table ===\n";
-    for (const auto &row : parsingTable)
-        for (const auto &col : row.second)
-            out << "(" << row.first << ", " << col.first
-                << ") => " << col.second << "\n";
-    out << "===========================\n";
-
-    OUT(out.str());
+    reportAt<Log>(Verbosity::DETAIL, [&](ReportStream &report) {
+        report.emit(ReportEvent("ll1_table"));
+        for (const auto &row : parsingTable)
+            for (const auto &col : row.second)
+                report.emit(ReportEvent("ll1_entry")
+                                .add("nonterminal", row.first)
+                                .add("terminal", col.first)
+                                .add("production", col.second));
+        report.emit(ReportEvent("end").add("of", "ll1_table"));
+    });
 }
 
+#ifndef GRAMRESOLVE_NO_REPORT
+template void LL1Parser::displayTable<ReportLog>() const;
+#endif
+template void LL1Parser::displayTable<SilentLog>() const;
+
 // ==========================================================
 // 🧠 Parse input
 // ==========================================================
+template <typename Log>
 void LL1Parser::parse(const std::vector<std::string> &tokens) const {
-    std::ostringstream out;
-
-    out << "\n===== Parsing Input =====\n";
-    out << left << setw(30) << "Stack"
-        << setw(30) << "Input"
-        << "Action\n";
-    out << string(80, '-') << "\n";
+    // Nothing but a trace: skip the run when no sink takes it
+    if (!reportsAt<Log>(Verbosity::DETAIL)) return;
+    ReportStream &report = ReportStream::get();
+    auto finish = [&](bool accepted) {
+        report.emit(ReportEvent("end").add("of", "parse_trace").add("accepted", static_cast<int>(accepted)));
+    };
 
-    OUT(out.str());
-    out.str("");
+    report.emit(ReportEvent("parse_trace").add("parser", "ll1"));
 
     stack<string> st;
     st.push("$");
@@ -129,6 +266,11 @@ void LL1Parser::parse(const std::vector<std::string> &tokens) const {
     size_t i = 0;
     string current = tokens[i];
 
+    // Same bound as recognize(): a left-recursive table expands
+    // forever without matching a token
+    size_t expansions = 0;
+    size_t limit = (nonTerminalNames.size() + 1) * 4;
+
     while (!st.empty()) {
         // ---------- Build stack string ----------
         stack<string> tmp = st;
@@ -152,9 +294,8 @@ void LL1Parser::parse(const std::vector<std::string> &tokens) const {
             if (j + 1 < tokens.size()) inputStr += " ";
         }
 
-        ostringstream line;
-        line << setw(30) << stackStr
-             << setw(30) << inputStr;
+        ReportEvent step("parse_step");
+        step.add("stack", stackStr).add("input", inputStr);
 
         string top = st.top();
 
@@ -163,30 +304,43 @@ void LL1Parser::parse(const std::vector<std::string> &tokens) const {
             st.pop();
             i++;
             current = (i < tokens.size()) ? tokens[i] : "$";
-            line << "Match " << top << "\n";
+            step.add("kind", "match").add("action", "Match " + top);
+            expansions = 0;
+            limit = (nonTerminalNames.size() + 1) * (st.size() + 4);
         }
         else if (grammar.isTerminal(top)) {
-            line << "❌ Error: unexpected terminal '" << top << "'\n";
-            OUT(line.str());
+            report.emit(step.add("kind", "error").add("action", "❌ Error: unexpected terminal '" + top + "'"));
+            finish(false);
             return;
         }
         else {
             auto row = parsingTable.find(top);
             if (row == parsingTable.end()) {
-                line << "❌ Error: no entry for non-terminal '" << top << "'\n";
-                OUT(line.str());
+                report.emit(step.add("kind", "error")
+                                .add("action", "❌ Error: no entry for non-terminal '" + top + "'"));
+                finish(false);
                 return;
             }
 
             auto col = row->second.find(current);
             if (col == row->second.end()) {
-                line << "❌ Error: no rule for (" << top << ", " << current << ")\n";
-                OUT(line.str());
+                report.emit(step.add("kind", "error")
+                                .add("action", "❌ Error: no rule for (" + top + ", " + current + ")"));
+                finish(false);
                 return;
             }
 
-            string rhs = col->second;
-            line << top << " → " << rhs << "\n";
+            if (++expansions > limit) {
+                report.emit(step.add("kind", "error")
+                                .add("action", "❌ Error: " + to_string(limit) +
+                                                   " expansions without matching a token (left recursion)"));
+                finish(false);
+                return;
+            }
+
+            // Conflicted cell "α|β": follow the first alternative
+            string rhs = col->second.substr(0, col->second.find('|'));
+            step.add("kind", "expand").add("action", top + " → " + rhs);
 
             st.pop();
 
@@ -197,12 +351,23 @@ void LL1Parser::parse(const std::vector<std::string> &tokens) const {
             }
         }
 
-        OUT(line.str());
+        report.emit(step);
     }
 
-    OUT("\n✅ Parsing complete: Input accepted!\n");
+    // "$" matched with tokens left, as recognize() rejects it
+    if (i < tokens.size()) {
+        report.emit(ReportEvent("parse_error").add("message", "input continues after '$'"));
+        finish(false);
+        return;
+    }
+    finish(true);
 }
 
+#ifndef GRAMRESOLVE_NO_REPORT
+template void LL1Parser::parse<ReportLog>(const vector<string> &tokens) const;
+#endif
+template void LL1Parser::parse<SilentLog>(const vector<string> &tokens) const;
+
 // ==========================================================
 // 🪓 Tokenizer
 // ==========================================================
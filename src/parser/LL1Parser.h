@@ -5,10 +5,14 @@
 #include <set>
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include <iostream>
+#include <memory_resource>
 
 #include "../grammar/Grammar.h"
 #include "../analysis/FirstFollow.h"
+#include "../analysis/ConflictRecord.h"
+#include "../report/ReportPolicy.h"
 
 using namespace std;
 
@@ -19,6 +23,21 @@ private:
     const FirstFollowEngine &ff;        // Reference to FIRST/FOLLOW sets
     map<string, map<string, string>> parsingTable; // Table[NonTerm][Term] = RHS
 
+    // Structured view: symbol/alternative ids, the first
+    // alternative placed in each [non-terminal × terminal] cell,
+    // and a record for every further alternative
+    vector<string> nonTerminalNames;
+    vector<string> terminalNames;         // grammar terminals, then "$"
+    vector<string> alternativeTexts;      // alternative id → joined RHS
+    vector<vector<int>> alternativeSymbols;   // alternative id → RHS ids (terminals, then T + nt)
+    unordered_map<string, int> terminalIds;
+    int startId = -1;
+    bool leftRecursive = false;           // recognize() then bounds non-consuming steps
+    vector<int> cellOwner;
+    vector<ConflictRecord> conflicts;
+
+    void place(int nonTerminal, int terminal, int alternative);
+
 public:
     // Default constructor (disallowed)
     LL1Parser() = delete;
@@ -32,22 +51,39 @@ public:
         return parsingTable;
     }
 
-    // 🧱 Build LL(1) parsing table
+    // 🧱 Build LL(1) parsing table (progress at Verbosity::SUMMARY)
+    template <typename Log = DefaultLog>
     void buildTable();
 
-    // 🧩 Compute FIRST(α)
-    set<string> computeFirstOfString(const vector<string> &rhs) const;
+    // Conflicts found while the table was built
+    const vector<ConflictRecord>& getConflicts() const { return conflicts; }
+    const string& nonTerminalName(int nt) const { return nonTerminalNames[nt]; }
+    const string& terminalName(int t) const { return terminalNames[t]; }
+    const string& alternativeText(int alt) const { return alternativeTexts[alt]; }
+
+    // 🧩 Compute FIRST(α), the set's nodes taken from `arena`
+    pmr::set<string> computeFirstOfString(const vector<string> &rhs,
+                                          pmr::memory_resource *arena = pmr::get_default_resource()) const;
 
     // 🪓 Join RHS symbols
     string join(const vector<string> &rhs, const string &sep) const;
 
-    // ⚙️ Parse token sequence
+    // ⚙️ Parse token sequence, printing each step. Conflicted cells
+    // take their first alternative; stops with an error where
+    // recognize() gives up on left recursion.
+    template <typename Log = DefaultLog>
     void parse(const vector<string> &tokens) const;
 
+    // Silent table-driven run; "$" is appended when missing. A
+    // conflicted cell takes its first alternative. Safe to call
+    // from several threads.
+    bool recognize(const vector<string> &tokens) const;
+
     // 🧰 Tokenize string
     vector<string> tokenize(const string &input) const;
 
     // 🖨️ Display LL(1) Parsing Table (Declaration Only!)
+    template <typename Log = DefaultLog>
     void displayTable() const;   // <---- FIXED
 };
 
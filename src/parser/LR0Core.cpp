@@ -0,0 +1,109 @@
+#include "LR0Core.h"
+#include <algorithm>
+
+using namespace std;
+
+// ===================================================
+// ActionRow
+// ===================================================
+void ActionRow::add(int terminal, uint32_t act) {
+    uint32_t &cell = action[terminal];
+
+    if (cell == ACT_ERROR) {
+        cell = act;
+        return;
+    }
+
+    if (actionTag(cell) == ACT_CONFLICT) {
+        auto &list = conflicts[actionPayload(cell)];
+        if (find(list.begin(), list.end(), act) == list.end())
+            list.push_back(act);
+        return;
+    }
+
+    if (cell == act)
+        return;
+
+    conflicts.push_back({cell, act});
+    cell = ACT_CONFLICT | static_cast<uint32_t>(conflicts.size() - 1);
+}
+
+// ===================================================
+// Productions by LHS and reduce order
+// ===================================================
+void LR0Core::init(const LRTable &table) {
+    symbols = &table;
+    const auto &prods = table.getProductions();
+
+    auto key = [&](int p) {
+        vector<string> rhs;
+        for (int sym : prods[p].rhs) rhs.push_back(table.symbolName(sym));
+        return make_pair(table.nonTerminalName(prods[p].lhs), rhs);
+    };
+
+    // A repeated alternative is one production, and a retired one
+    // (grammar edit) is no longer indexed: both are skipped
+    vector<pair<string, vector<string>>> keys(prods.size());
+    prodsOf.assign(table.nonTerminalCount(), {});
+    for (size_t p = 0; p < prods.size(); ++p) {
+        keys[p] = key(static_cast<int>(p));
+        if (table.productionId(keys[p].first, keys[p].second) == static_cast<int>(p))
+            prodsOf[prods[p].lhs].push_back(static_cast<int>(p));
+    }
+
+    vector<int> order(prods.size());
+    for (size_t p = 0; p < prods.size(); ++p) order[p] = static_cast<int>(p);
+    sort(order.begin(), order.end(), [&](int a, int b) { return keys[a] < keys[b]; });
+
+    prodRank.assign(prods.size(), 0);
+    for (size_t r = 0; r < order.size(); ++r)
+        prodRank[order[r]] = static_cast<int>(r);
+}
+
+// ===================================================
+// Closure over packed items
+// ===================================================
+vector<uint64_t> LR0Core::closure(const vector<uint64_t> &kernel) const {
+    const int T = static_cast<int>(symbols->terminalCount());
+    vector<uint64_t> items = kernel;
+    vector<char> added(symbols->nonTerminalCount(), 0);
+
+    for (size_t i = 0; i < items.size(); ++i) {
+        const LRProduction &rule = symbols->production(itemProduction(items[i]));
+        int dot = itemDot(items[i]);
+        if (dot >= rule.length || symbols->isTerminalSymbol(rule.rhs[dot]))
+            continue;
+
+        int B = rule.rhs[dot] - T;
+        if (added[B]) continue;
+        added[B] = 1;
+
+        for (int q : prodsOf[B])
+            items.push_back(packItem(q, 0));
+    }
+    return items;
+}
+
+// ===================================================
+// GOTO kernels and completed productions of a state
+// ===================================================
+void LR0Core::successors(const vector<uint64_t> &kernel, map<int, vector<uint64_t>> &next,
+                         vector<int> &completed) const {
+    next.clear();
+    completed.clear();
+
+    for (uint64_t item : closure(kernel)) {
+        int p = itemProduction(item);
+        int dot = itemDot(item);
+        const LRProduction &rule = symbols->production(p);
+
+        if (dot < rule.length)
+            next[rule.rhs[dot]].push_back(packItem(p, dot + 1));
+        else
+            completed.push_back(p);
+    }
+
+    for (auto &succ : next)
+        sort(succ.second.begin(), succ.second.end());
+    sort(completed.begin(), completed.end(), [&](int a, int b) { return reducesBefore(a, b); });
+}
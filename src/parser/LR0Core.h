@@ -0,0 +1,131 @@
+// ===============================================================
+// File: LR0Core.h
+// Description: LR(0) construction shared by every LR builder: the
+//              eager automaton (LR0Parser), the staged SLR → LALR →
+//              LR(1) builder (ParserBuilder) and the lazy automaton.
+//              Items are packed as (production << 32 | dot) over an
+//              LRTable's numbering; closure and successor kernels are
+//              computed here, and placeReduce() holds the one copy of
+//              the %left/%right/%nonassoc/%prec rules for putting a
+//              reduce into an ACTION row.
+// ===============================================================
+
+#ifndef LR0_CORE_H
+#define LR0_CORE_H
+
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <cstdint>
+#include "LRTable.h"
+#include "../grammar/Grammar.h"
+
+using namespace std;
+
+inline uint64_t packItem(int production, size_t dot) {
+    return (static_cast<uint64_t>(production) << 32) | static_cast<uint64_t>(dot);
+}
+inline int itemProduction(uint64_t item) { return static_cast<int>(item >> 32); }
+inline int itemDot(uint64_t item)        { return static_cast<int>(item & 0xffffffffu); }
+
+// ===============================================================
+// Struct: PackedKernelHash
+// FNV-1a over the sorted packed items of a kernel
+// ===============================================================
+struct PackedKernelHash {
+    size_t operator()(const vector<uint64_t> &kernel) const {
+        size_t h = 1469598103934665603ull;
+        for (uint64_t item : kernel)
+            h = (h ^ item) * 1099511628211ull;
+        return h;
+    }
+};
+
+// ===============================================================
+// Struct: ActionRow
+// One ACTION row while it is being filled; a cell holding several
+// actions points into `conflicts` (ACT_CONFLICT | list index)
+// ===============================================================
+struct ActionRow {
+    vector<uint32_t> action;              // [terminal]
+    vector<vector<uint32_t>> conflicts;
+
+    uint32_t get(int terminal) const { return action[terminal]; }
+    void set(int terminal, uint32_t act) { action[terminal] = act; }
+
+    // A second distinct action turns the cell into a conflict list
+    void add(int terminal, uint32_t act);
+};
+
+// ===============================================================
+// Class: LR0Core
+// Productions by left-hand side and their reduce order, read from
+// an LRTable's numbering. Re-run init() after the table's
+// productions are appended or retired.
+// ===============================================================
+class LR0Core {
+private:
+    const LRTable *symbols = nullptr;
+    vector<vector<int>> prodsOf;          // non-terminal → live production ids
+    vector<int> prodRank;                 // reduce order (see reducesBefore)
+
+public:
+    void init(const LRTable &table);
+
+    const vector<int>& productionsOf(int nonTerminal) const { return prodsOf[nonTerminal]; }
+
+    // Completed items are reduced in LRItem order (lhs, rhs names),
+    // so every builder lists conflicting actions the same way
+    bool reducesBefore(int a, int b) const { return prodRank[a] < prodRank[b]; }
+
+    // Kernel plus the start items of every non-terminal after a dot
+    vector<uint64_t> closure(const vector<uint64_t> &kernel) const;
+
+    // Successor kernels of closure(kernel) by symbol id, each sorted,
+    // and its completed productions in reduce order
+    void successors(const vector<uint64_t> &kernel, map<int, vector<uint64_t>> &next,
+                    vector<int> &completed) const;
+};
+
+// ===============================================================
+// Reduce `production` on `terminal`. A clash with a shift is
+// decided by precedence; %nonassoc turns the cell into an error and
+// adds the terminal to `nonassoc`, which blocks later reduces on it
+// in the same row. Row provides get/set/add as ActionRow does.
+// Returns true when precedence decided the cell (`decision`,
+// `reason` tell how).
+// ===============================================================
+template <typename Row>
+bool placeReduce(const Grammar &g, const LRTable &symbols, Row &row, set<int> &nonassoc,
+                 int terminal, int production, PrecDecision &decision, string &reason) {
+    uint32_t reduce = makeReduce(production);
+
+    if (nonassoc.count(terminal))
+        return false;
+
+    if (actionTag(row.get(terminal)) != ACT_SHIFT) {
+        row.add(terminal, reduce);
+        return false;
+    }
+
+    decision = g.resolveShiftReduce(symbols.terminalName(terminal),
+                                    symbols.productionPrecSymbol(production), reason);
+    switch (decision) {
+    case PrecDecision::CONFLICT:
+        row.add(terminal, reduce);          // genuine conflict
+        return false;
+    case PrecDecision::REDUCE:
+        row.set(terminal, reduce);
+        break;
+    case PrecDecision::SHIFT:
+        break;
+    case PrecDecision::ERROR:
+        row.set(terminal, ACT_NONASSOC);
+        nonassoc.insert(terminal);
+        break;
+    }
+    return true;
+}
+
+#endif
@@ -7,167 +7,368 @@
 #include <set>
 #include <algorithm>
 #include "../report/reportWriter.h"
+#include "../report/ReportPolicy.h"
+#include "../util/Parallel.h"
+#include "../util/Instrumentation.h"
 #include <sstream>
+#include <mutex>
+#include <chrono>
 
 using namespace std;
 
+// ===================================================
+// Concurrent kernel set used while expanding one BFS
+// level: sharded hash maps, each behind its own mutex
+// ===================================================
+namespace {
+
+class ConcurrentKernelSet {
+private:
+    static const size_t SHARDS = 64;
+
+    struct Shard {
+        mutex lock;
+        unordered_map<ItemSet, size_t, LRKernelHash> index;
+        vector<ItemSet> kernels;
+    };
+
+    Shard shards[SHARDS];
+    LRKernelHash hasher;
+
+public:
+    // Returns a slot id; equal kernels always get the same slot
+    size_t insert(const ItemSet &kernel) {
+        size_t shard = hasher(kernel) % SHARDS;
+        Shard &sh = shards[shard];
+
+        lock_guard<mutex> guard(sh.lock);
+        auto it = sh.index.find(kernel);
+        if (it != sh.index.end())
+            return it->second;
+
+        size_t slot = sh.kernels.size() * SHARDS + shard;
+        sh.kernels.push_back(kernel);
+        sh.index.emplace(kernel, slot);
+        return slot;
+    }
+
+    // Flatten to a list of (slot, kernel) once inserts are done
+    vector<pair<size_t, const ItemSet *>> entries() const {
+        vector<pair<size_t, const ItemSet *>> out;
+        for (size_t sh = 0; sh < SHARDS; ++sh)
+            for (size_t k = 0; k < shards[sh].kernels.size(); ++k)
+                out.push_back({k * SHARDS + sh, &shards[sh].kernels[k]});
+        return out;
+    }
+};
+
+}
+
 // ===================================================
 // Constructor
 // ===================================================
-LR0Parser::LR0Parser(const Grammar &g) : grammar(g) {}
+LR0Parser::LR0Parser(const Grammar &g)
+    : grammar(g), itemPool(new pmr::synchronized_pool_resource()) {}
 
 // ===================================================
-// Accessor for ACTION table
+// Textual ACTION/GOTO tables, from the encoded table
 // ===================================================
 const map<int, map<string, string>>& LR0Parser::getACTION() const {
+    if (textStale) {
+        ACTION = table.actionStrings();
+        GOTO = table.gotoMap();
+        textStale = false;
+    }
     return ACTION;
 }
 
+const map<int, map<string, int>>& LR0Parser::getGOTO() const {
+    getACTION();
+    return GOTO;
+}
+
 // ===================================================
 // Build Canonical Collection of LR(0) Items
 // ===================================================
+template <typename Log>
 void LR0Parser::buildAutomaton() {
-    std::ostringstream out;
-    out << "\n🔧 Building LR(0) Automaton (with SLR reduce placement)...\n";
-    cout << out.str();
-    ReportWriter::get() << out.str();
-    out.str("");
+    PhaseTimer timer("lr0_automaton");
+    reportMessage<Log>([] { return "\n🔧 Building LR(0) Automaton (with SLR reduce placement)...\n"; });
 
-    FirstFollowEngine ff;
+    ff = FirstFollowEngine();
     ff.computeFIRST(grammar);
     ff.computeFOLLOW(grammar);
 
     string start = grammar.getStartSymbol();
-    string augmented = start + "'";
-    Production aug(augmented);
-    aug.addAlternative({start});
 
-    Grammar g2 = grammar;
-    g2.addProduction(aug);
+    // Pick an augmented name that does not clash with an existing
+    // non-terminal (e.g. E' in the stratified expression grammar)
+    augmented = start + "'";
+    while (grammar.isNonTerminal(augmented))
+        augmented += "'";
+
+    states.clear();
+    kernelIndex.clear();
+    retiredKernels.clear();
+    unitBypasses.clear();
+    bypassIndex.clear();
+    table.init(grammar, augmented);
+    rules.clear();
+    ruleItems.clear();
+    indexProductions();
+
+    // No item set of the previous build is left: hand its memory back
+    itemPool->release();
+
+    ItemSet startKernel({ruleItems[0]}, itemPool.get());
+    states.push_back({0, closure(startKernel), ItemSet(startKernel, itemPool.get())});
+    kernelIndex.emplace(move(startKernel), 0);
+
+    // Transitions discovered while building the collection
+    stateTransitions.assign(1, {});
+
+    // Canonical collection, expanded one BFS level at a time.
+    // Workers compute GOTO kernels for the frontier and close every
+    // kernel not seen before exactly once; a sequential pass then
+    // numbers the new states in the order a single FIFO queue would.
+    unsigned workers = resolveThreadCount(threadCount);
+    vector<int> frontier = {0};
+
+    struct Successor {
+        string symbol;
+        ItemSet kernel;
+        size_t slot;
+    };
+
+    PhaseTimer collection("closure_goto");
+    while (!frontier.empty()) {
+        vector<vector<Successor>> successors(frontier.size());
+        ConcurrentKernelSet pending;
+
+        parallelFor(frontier.size(), workers, [&](size_t k) {
+            const LRState &st = states[frontier[k]];
+
+            // FIXED: removed unused Grammar parameter
+            for (const string &sym : collectSymbols(st)) {
+                ItemSet kernel = GOTOkernel(st.items, sym);
+                if (kernel.empty()) continue;
+
+                size_t slot = (findState(kernel) == -1) ? pending.insert(kernel) : 0;
+                successors[k].push_back({sym, move(kernel), slot});
+            }
+        }, 8);
+
+        // Closures of the new kernels, keyed by slot
+        auto fresh = pending.entries();
+        unordered_map<size_t, size_t> slotPos;
+        vector<ItemSet> closures;
+        closures.reserve(fresh.size());
+        for (size_t k = 0; k < fresh.size(); ++k) {
+            slotPos[fresh[k].first] = k;
+            closures.emplace_back(itemPool.get());     // same pool, so the assignment below moves
+        }
 
-    LRItem startItem = {augmented, {start}, 0};
-    LRState startState = {0, closure({startItem}, g2)};
-    states.push_back(startState);
+        parallelFor(fresh.size(), workers, [&](size_t k) {
+            closures[k] = closure(*fresh[k].second);
+        }, 8);
+
+        // Deterministic renumbering pass
+        vector<int> nextFrontier;
+        for (size_t k = 0; k < frontier.size(); ++k) {
+            for (auto &succ : successors[k]) {
+                int found = findState(succ.kernel);
+                if (found == -1) {
+                    found = static_cast<int>(states.size());
+                    states.push_back({found, move(closures[slotPos[succ.slot]]),
+                                      ItemSet(succ.kernel, itemPool.get())});
+                    kernelIndex.emplace(move(succ.kernel), found);
+                    stateTransitions.emplace_back();
+                    nextFrontier.push_back(found);
+                }
 
-    queue<int> q;
-    q.push(0);
+                stateTransitions[frontier[k]][succ.symbol] = found;
+            }
+        }
 
-    // Canonical collection
-    while (!q.empty()) {
-        int i = q.front(); q.pop();
+        frontier.swap(nextFrontier);
+    }
+    collection.stop();
+    Instrumentation::count(Counter::STATES_CREATED, states.size());
 
-        // FIXED: removed unused Grammar parameter
-        set<string> symbols = collectSymbols(states[i]);
+    table.resize(static_cast<int>(states.size()));
 
-        for (const string &sym : symbols) {
-            set<LRItem> gotoItems = GOTOset(states[i].items, sym, g2);
-            if (gotoItems.empty()) continue;
+    // Shift / GOTO / reduce / accept entries
+    resolutions.clear();
+    resolutionStates.clear();
 
-            int found = findState(gotoItems);
-            if (found == -1) {
-                LRState newState = {static_cast<int>(states.size()), gotoItems};
-                states.push_back(newState);
-                q.push(newState.id);
-                found = newState.id;
-            }
+    for (size_t i = 0; i < states.size(); ++i)
+        fillRow(static_cast<int>(i));
 
-            if (g2.isTerminal(sym)) {
-                string act = "s" + to_string(found);
-                if (ACTION[i][sym].empty())
-                    ACTION[i][sym] = act;
-                else
-                    ACTION[i][sym] += "|" + act;
-            } else {
-                GOTO[i][sym] = found;
-            }
+    textStale = true;
+
+    // Compressed form used by the drivers; lookups are only timed
+    // for --stats, and only when the summary is going to be reported
+    compressed.build(table, Instrumentation::enabled() && reportsAt<Log>(Verbosity::SUMMARY));
+
+    reportMessage<Log>([&] {
+        std::ostringstream out;
+        out << "✅ LR(0)/SLR Automaton built with " << states.size() << " states.\n";
+
+        if (!resolutions.empty()) {
+            out << "\n⚖️  Precedence resolutions (" << resolutions.size() << "):\n";
+            for (const auto &r : resolutions)
+                out << "   " << r << "\n";
         }
+        out << compressed.summary();
+        return out.str();
+    });
+}
+
+#ifndef GRAMRESOLVE_NO_REPORT
+template void LR0Parser::buildAutomaton<ReportLog>();
+#endif
+template void LR0Parser::buildAutomaton<SilentLog>();
+
+// ===================================================
+// One table row from a state's transitions and items
+// ===================================================
+void LR0Parser::fillRow(int state) {
+    for (const auto &tr : stateTransitions[state]) {
+        if (grammar.isTerminal(tr.first))
+            table.addAction(state, table.terminalId(tr.first), makeShift(tr.second));
+        else
+            table.setGoto(state, table.nonTerminalId(tr.first), tr.second);
     }
 
-    // Add reduce/accept actions
-    for (size_t i = 0; i < states.size(); ++i) {
-        for (const auto &item : states[i].items) {
+    set<int> nonassoc;
+    for (const auto &item : states[state].items) {
+        if (item.dot != item.rhs().size())
+            continue;
 
-            if (item.dot == item.rhs.size()) {
-                if (item.lhs == augmented) {
-                    ACTION[i]["$"] = "acc";
-                } else {
-                    stringstream rule;
-                    rule << item.lhs << "->";
-                    for (auto &sym : item.rhs)
-                        rule << sym << " ";
-                    string ruleStr = rule.str();
-
-                    for (const auto &t : ff.getFOLLOW(item.lhs)) {
-                        string act = "r" + ruleStr;
-                        if (ACTION[i][t].empty())
-                            ACTION[i][t] = act;
-                        else
-                            ACTION[i][t] += "|" + act;
-                    }
-                }
-            }
+        if (item.lhs() == augmented) {
+            table.addAction(state, table.endMarker(), makeAccept());
+        } else {
+            int prod = table.productionId(item.lhs(), item.rhs());
+
+            for (const auto &t : ff.getFOLLOW(item.lhs()))
+                placeReduce(state, nonassoc, table.terminalId(t), prod);
         }
     }
-
-    out << "✅ LR(0)/SLR Automaton built with " << states.size() << " states.\n";
-    cout << out.str();
-    ReportWriter::get() << out.str();
 }
 
 // ===================================================
-// Compute closure(I)
+// Reduce placement with precedence/associativity
 // ===================================================
-set<LRItem> LR0Parser::closure(set<LRItem> I, const Grammar &g) {
-    bool changed = true;
+namespace {
 
-    while (changed) {
-        changed = false;
-        set<LRItem> newItems = I;
+// One row of an LRTable, as placeReduce() reads and writes it
+struct TableRow {
+    LRTable &table;
+    int state;
 
-        for (const auto &item : I) {
-            if (item.dot < item.rhs.size()) {
-                string B = item.rhs[item.dot];
+    uint32_t get(int terminal) const { return table.getAction(state, terminal); }
+    void set(int terminal, uint32_t act) { table.setAction(state, terminal, act); }
+    void add(int terminal, uint32_t act) { table.addAction(state, terminal, act); }
+};
 
-                if (g.isNonTerminal(B)) {
-                    for (const auto &p : g.getProductions()) {
-                        if (p.getLHS() == B) {
-                            for (const auto &alt : p.getRHS()) {
-                                vector<string> rhs = alt;
+}
 
-                                if (rhs.size() == 1 && rhs[0] == "ε")
-                                    rhs.clear();
+void LR0Parser::placeReduce(int state, set<int> &nonassoc, int terminal, int production) {
+    uint32_t cell = table.getAction(state, terminal);
+    TableRow row = {table, state};
+
+    PrecDecision decision = PrecDecision::CONFLICT;
+    string reason;
+    if (!::placeReduce(grammar, table, row, nonassoc, terminal, production, decision, reason))
+        return;
+
+    const char *outcome = decision == PrecDecision::REDUCE ? "reduce"
+                        : decision == PrecDecision::SHIFT  ? "shift" : "error";
+    resolutionStates.push_back(state);
+    resolutions.push_back("State " + to_string(state) + ", on '" + table.terminalName(terminal) + "': " +
+                          table.actionToString(cell) + " vs reduce " +
+                          table.productionLabel(production) + " → " + outcome +
+                          " (" + reason + ")");
+}
 
-                                LRItem newItem = {B, rhs, 0};
+// ===================================================
+// Productions of the table (S' -> S included) for the
+// packed closure, and their items with the dot at 0.
+// Ids are only appended or retired, so the names of
+// known productions (and items pointing at them) stay
+// ===================================================
+void LR0Parser::indexProductions() {
+    lr0.init(table);
+
+    const auto &prods = table.getProductions();
+    for (size_t p = rules.size(); p < prods.size(); ++p) {
+        LRRule rule = {table.nonTerminalName(prods[p].lhs), {}};
+        for (int sym : prods[p].rhs)
+            rule.rhs.push_back(table.symbolName(sym));
+        rules.push_back(move(rule));
+        ruleItems.push_back({&rules.back(), 0});
+    }
+}
 
-                                if (newItems.insert(newItem).second)
-                                    changed = true;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        I = newItems;
+// ===================================================
+// Compute closure(I): the start items of every
+// non-terminal after a dot, closed by LR0Core
+// ===================================================
+ItemSet LR0Parser::closure(const ItemSet &I) const {
+    Instrumentation::count(Counter::CLOSURE_CALLS);
+    ItemSet items(I, itemPool.get());
+
+    // Marks live on the stack unless the grammar is very large;
+    // the seed list is handed to LR0Core, which grows it into the
+    // closure, so it stays a plain vector
+    char scratch[4096];
+    pmr::monotonic_buffer_resource arena(scratch, sizeof scratch);
+    pmr::vector<char> seeded(table.nonTerminalCount(), 0, &arena);
+    vector<uint64_t> start;
+
+    for (const auto &item : I) {
+        if (item.dot >= item.rhs().size())
+            continue;
+
+        int B = table.nonTerminalId(item.rhs()[item.dot]);
+        if (B < 0 || seeded[B])
+            continue;
+        seeded[B] = 1;
+
+        for (int q : lr0.productionsOf(B))
+            start.push_back(packItem(q, 0));
     }
 
-    return I;
+    for (uint64_t item : lr0.closure(start))
+        items.insert(ruleItems[itemProduction(item)]);
+
+    Instrumentation::count(Counter::SET_INSERTS, items.size() - I.size());
+    return items;
 }
 
 // ===================================================
-// Compute GOTO(I, X)
+// Kernel of GOTO(I, X): items of I with the dot moved over X
 // ===================================================
-set<LRItem> LR0Parser::GOTOset(const set<LRItem> &I, const string &X, const Grammar &g) {
-    set<LRItem> J;
+ItemSet LR0Parser::GOTOkernel(const ItemSet &I, const string &X) const {
+    Instrumentation::count(Counter::GOTO_CALLS);
+    ItemSet J(itemPool.get());
 
     for (const auto &item : I) {
-        if (item.dot < item.rhs.size() && item.rhs[item.dot] == X) {
+        if (item.dot < item.rhs().size() && item.rhs()[item.dot] == X) {
             LRItem moved = item;
             moved.dot++;
             J.insert(moved);
         }
     }
 
-    return closure(J, g);
+    return J;
+}
+
+// ===================================================
+// Compute GOTO(I, X)
+// ===================================================
+ItemSet LR0Parser::GOTOset(const ItemSet &I, const string &X) const {
+    return closure(GOTOkernel(I, X));
 }
 
 // ===================================================
@@ -177,193 +378,589 @@ set<string> LR0Parser::collectSymbols(const LRState &state) const {
     set<string> symbols;
 
     for (const auto &item : state.items) {
-        if (item.dot < item.rhs.size())
-            symbols.insert(item.rhs[item.dot]);
+        if (item.dot < item.rhs().size())
+            symbols.insert(item.rhs()[item.dot]);
     }
 
     return symbols;
 }
 
 // ===================================================
-// Check if state already exists
+// Check if a state with this kernel already exists
 // ===================================================
-int LR0Parser::findState(const set<LRItem> &items) const {
-    for (size_t i = 0; i < states.size(); ++i)
-        if (states[i].items == items)
-            return static_cast<int>(i);
-
-    return -1;
+int LR0Parser::findState(const ItemSet &kernel) const {
+    auto it = kernelIndex.find(kernel);
+    return (it != kernelIndex.end()) ? it->second : -1;
 }
 
 // ===================================================
 // Display canonical states
 // ===================================================
+template <typename Log>
 void LR0Parser::displayStates() const {
-    std::ostringstream out;
-
-    out << "\n===== Canonical Collection of LR(0) Items =====\n";
-    for (const auto &st : states)
-        out << st.toString() << "\n";
-
-    out << "===============================================\n";
-
-    cout << out.str();
-    ReportWriter::get() << out.str();
+    reportAt<Log>(Verbosity::DETAIL, [&](ReportStream &report) {
+        report.emit(ReportEvent("lr_states"));
+        for (const auto &st : states) {
+            if (st.kernel.empty()) continue;     // retired by a grammar edit
+
+            vector<string> items;
+            for (const auto &item : st.items) items.push_back(item.toString());
+            report.emit(ReportEvent("lr_state").add("id", st.id).add("items", items));
+
+            auto a = getACTION().find(st.id);
+            if (a != ACTION.end())
+                for (const auto &cell : a->second)
+                    report.emit(ReportEvent("lr_action")
+                                    .add("state", st.id)
+                                    .add("symbol", cell.first)
+                                    .add("action", cell.second));
+            auto g = getGOTO().find(st.id);
+            if (g != GOTO.end())
+                for (const auto &cell : g->second)
+                    report.emit(ReportEvent("lr_goto")
+                                    .add("state", st.id)
+                                    .add("symbol", cell.first)
+                                    .add("target", cell.second));
+        }
+        report.emit(ReportEvent("end").add("of", "lr_states"));
+    });
 }
 
+#ifndef GRAMRESOLVE_NO_REPORT
+template void LR0Parser::displayStates<ReportLog>() const;
+#endif
+template void LR0Parser::displayStates<SilentLog>() const;
+
 // ===================================================
 // LR Parsing Simulation
 // ===================================================
+template <typename Log>
 void LR0Parser::parse(const vector<string> &tokens) {
-    std::ostringstream out;
-
-    out << "\n===== Parsing Input (LR(0)) =====\n";
-    out << left << setw(40) << "Stack (States + Symbols)"
-        << setw(25) << "Input"
-        << "Action\n";
-    out << string(90, '-') << "\n";
-
-    cout << out.str();
-    ReportWriter::get() << out.str();
-    out.str("");
-
-    stack<int> stateStack;
-    stack<string> symbolStack;
+    // Nothing but a trace: skip the run when no sink takes it
+    if (!reportsAt<Log>(Verbosity::DETAIL)) return;
+    ReportStream &report = ReportStream::get();
+    auto finish = [&](bool accepted) {
+        report.emit(ReportEvent("end").add("of", "parse_trace").add("accepted", static_cast<int>(accepted)));
+    };
+
+    report.emit(ReportEvent("parse_trace").add("parser", "lr0"));
+
+    vector<int> ids;
+    if (!table.encodeTokens(tokens, ids)) {
+        report.emit(ReportEvent("parse_error")
+                        .add("message", "input contains a symbol that is not a terminal of the grammar, "
+                                        "or a '$' before its end"));
+        finish(false);
+        return;
+    }
 
-    stateStack.push(0);
+    vector<int> stackStates = {0};
+    vector<int> stackSymbols;
     size_t i = 0;
-    string a = tokens[i];
+
+    // Same bound as recognize() on reductions between two shifts
+    const size_t perLevel = 2 * (table.nonTerminalCount() + 1);
+    size_t reductionsLeft = 2 * perLevel;
 
     while (true) {
-        int s = stateStack.top();
-        string act = ACTION[s][a];
+        int s = stackStates.back();
+        int a = ids[i];
+        uint32_t act = compressed.getAction(s, a);
 
-        std::ostringstream line;
-        line << setw(40) << fullStackToString(stateStack, symbolStack)
-             << setw(25) << remainingInput(tokens, i);
+        // Conflicted cell: follow the first recorded action
+        if (actionTag(act) == ACT_CONFLICT)
+            act = table.conflictList(act)[0];
 
-        if (act.empty()) {
-            line << "❌ Error: no action for (" << s << ", " << a << ")\n";
-            cout << line.str();
-            ReportWriter::get() << line.str();
-            return;
-        }
-
-        // SHIFT
-        if (act[0] == 's') {
-            int next = stoi(act.substr(1));
+        ReportEvent step("parse_step");
+        step.add("stack", fullStackToString(stackStates, stackSymbols))
+            .add("input", remainingInput(tokens, i));
 
-            line << "Shift and go to state " << next << "\n";
+        switch (actionTag(act)) {
 
-            symbolStack.push(a);
-            stateStack.push(next);
+        // SHIFT
+        case ACT_SHIFT: {
+            int next = actionPayload(act);
+            step.add("kind", "shift").add("action", "Shift and go to state " + to_string(next));
 
+            stackSymbols.push_back(a);
+            stackStates.push_back(next);
+            reductionsLeft = (stackStates.size() + 1) * perLevel;
             i++;
-            a = tokens[i];
+            break;
         }
 
         // REDUCE
-        else if (act[0] == 'r') {
-            string rule = act.substr(1);
-            size_t arrow = rule.find("->");
-
-            string A = rule.substr(0, arrow);
-            string rhsPart = rule.substr(arrow + 2);
-
-            vector<string> rhs;
-            stringstream ss(rhsPart);
-            string sym;
-            while (ss >> sym)
-                rhs.push_back(sym);
-
-            if (rhs.empty())
-                line << "Reduce by " << A << " -> ε\n";
-            else
-                line << "Reduce by " << A << " -> " << rhsPart << "\n";
-
-            for (size_t j = 0; j < rhs.size(); ++j) {
-                if (!rhs[j].empty() && rhs[j] != "ε") {
-                    if (!symbolStack.empty()) symbolStack.pop();
-                    if (!stateStack.empty()) stateStack.pop();
-                }
+        case ACT_REDUCE: {
+            if (reductionsLeft-- == 0) {
+                report.emit(step.add("kind", "error")
+                                .add("action", "❌ Error: reductions without a shift (cyclic grammar)"));
+                finish(false);
+                return;
             }
 
-            int t = stateStack.top();
-            int next = GOTO[t][A];
+            int p = actionPayload(act);
+            const LRProduction &prod = table.production(p);
+
+            string action = "Reduce by " + table.productionLabel(p);
+
+            stackStates.resize(stackStates.size() - prod.length);
+            stackSymbols.resize(stackSymbols.size() - prod.length);
 
-            symbolStack.push(A);
-            stateStack.push(next);
+            if (const UnitBypass *bp = findBypass(stackStates.back(), prod.lhs)) {
+                action += "  (bypassing";
+                for (int r : bp->chain)
+                    action += " [" + table.productionLabel(r) + "]";
+                action += ")";
+            }
+            step.add("kind", "reduce").add("action", action);
+
+            int next = compressed.getGoto(stackStates.back(), prod.lhs);
+            stackSymbols.push_back(static_cast<int>(table.terminalCount()) + prod.lhs);
+            stackStates.push_back(next);
+            break;
         }
 
         // ACCEPT
-        else if (act == "acc") {
-            line << "✅ Accept!\n";
-            cout << line.str();
-            ReportWriter::get() << line.str();
-            break;
+        case ACT_ACCEPT: {
+            bool atEnd = i + 1 == ids.size();
+            step.add("kind", atEnd ? "accept" : "error")
+                .add("action", atEnd ? "✅ Accept!" : "❌ Error: input continues after '$'");
+            report.emit(step);
+            finish(atEnd);
+            return;
         }
 
-        // UNKNOWN
-        else {
-            line << "❌ Unknown action: " << act << "\n";
-            cout << line.str();
-            ReportWriter::get() << line.str();
+        // ERROR
+        default:
+            step.add("kind", "error")
+                .add("action", "❌ Error: no action for (" + to_string(s) + ", " + table.terminalName(a) + ")");
+            report.emit(step);
+            finish(false);
             return;
         }
 
-        cout << line.str();
-        ReportWriter::get() << line.str();
+        report.emit(step);
     }
 }
 
+#ifndef GRAMRESOLVE_NO_REPORT
+template void LR0Parser::parse<ReportLog>(const vector<string> &tokens);
+#endif
+template void LR0Parser::parse<SilentLog>(const vector<string> &tokens);
+
 // ===================================================
-// Helpers
+// Silent driver: one compressed ACTION lookup per step,
+// production length and LHS come from the precomputed table
 // ===================================================
-string LR0Parser::fullStackToString(stack<int> stateStack, stack<string> symbolStack) {
-    vector<pair<int, string>> temp;
+bool LR0Parser::recognize(const vector<int> &tokenIds) {
+    const LRProduction *prods = table.getProductions().data();
 
-    while (!stateStack.empty()) {
-        string sym = symbolStack.empty() ? "" : symbolStack.top();
-        temp.push_back({stateStack.top(), sym});
+    stateStack.clear();
+    stateStack.push_back(0);
+    lastReductions = 0;
+    Instrumentation::count(Counter::SENTENCES);
 
-        stateStack.pop();
-        if (!symbolStack.empty()) symbolStack.pop();
-    }
+    // Cyclic grammars (A =>+ A) can reduce forever without reading;
+    // that many reductions between two shifts means such a loop
+    const size_t perLevel = 2 * (table.nonTerminalCount() + 1);
+    size_t reductionsLeft = 2 * perLevel;
 
-    reverse(temp.begin(), temp.end());
+    size_t i = 0, steps = 0;
+    CountOnExit countSteps(Counter::PARSE_STEPS, steps);
+    while (true) {
+        steps++;
+        uint32_t act = compressed.getAction(stateStack.back(), tokenIds[i]);
+        if (actionTag(act) == ACT_CONFLICT)
+            act = table.conflictList(act)[0];
+
+        switch (actionTag(act)) {
+        case ACT_SHIFT:
+            stateStack.push_back(actionPayload(act));
+            reductionsLeft = (stateStack.size() + 1) * perLevel;
+            i++;
+            break;
 
-    string result;
-    for (auto &[state, sym] : temp) {
-        result += to_string(state);
-        if (!sym.empty())
-            result += " " + sym + " ";
+        case ACT_REDUCE: {
+            if (reductionsLeft-- == 0)
+                return false;
+            const LRProduction &prod = prods[actionPayload(act)];
+            stateStack.resize(stateStack.size() - prod.length);
+            stateStack.push_back(compressed.getGoto(stateStack.back(), prod.lhs));
+            lastReductions++;
+            break;
+        }
+
+        case ACT_ACCEPT:
+            return i + 1 == tokenIds.size();   // never on a prefix
+
+        default:
+            return false;
+        }
     }
+}
 
-    return result;
+// ===================================================
+// Corpus run: totals for reductions-per-token reports
+// ===================================================
+CorpusStats LR0Parser::runCorpus(const vector<vector<string>> &corpus) {
+    CorpusStats stats;
+    vector<int> ids;
+
+    for (const auto &sentence : corpus) {
+        if (!table.encodeTokens(sentence, ids))
+            continue;
+
+        stats.sentences++;
+        stats.tokens += ids.size() - 1;
+        if (recognize(ids))
+            stats.accepted++;
+        stats.reductions += lastReductions;
+    }
+
+    return stats;
 }
 
-string LR0Parser::remainingInput(const vector<string> &tokens, size_t i) {
-    string s;
+// ===================================================
+// Unit-rule elimination on the built tables
+// ===================================================
+template <typename Log>
+size_t LR0Parser::eliminateUnitRules(const set<string> &keep) {
+    UnitRuleEliminator::restore(table, unitBypasses);
+
+    set<int> keepIds;
+    for (size_t p = 0; p < table.getProductions().size(); ++p)
+        if (keep.count(table.productionLabel(static_cast<int>(p))))
+            keepIds.insert(static_cast<int>(p));
+
+    unitBypasses = UnitRuleEliminator::apply(table, keepIds);
+
+    bypassIndex.clear();
+    for (size_t k = 0; k < unitBypasses.size(); ++k)
+        bypassIndex[{unitBypasses[k].state, unitBypasses[k].symbol}] = k;
+
+    compressed.build(table);
+    textStale = true;
+
+    reportAt<Log>(Verbosity::SUMMARY, [&](ReportStream &report) {
+        report.emit(ReportEvent("unit_rules").add("bypassed", unitBypasses.size()), Verbosity::SUMMARY);
+        for (const auto &bp : unitBypasses) {
+            vector<string> skips;
+            for (int r : bp.chain)
+                skips.push_back(table.productionLabel(r));
+            report.emit(ReportEvent("unit_bypass")
+                            .add("state", bp.state)
+                            .add("nonterminal", table.nonTerminalName(bp.symbol))
+                            .add("from", bp.originalTarget)
+                            .add("to", bp.target)
+                            .add("skips", skips),
+                        Verbosity::SUMMARY);
+        }
+    });
 
-    for (size_t k = i; k < tokens.size(); ++k)
-        s += tokens[k] + " ";
+    return unitBypasses.size();
+}
 
-    return s;
+#ifndef GRAMRESOLVE_NO_REPORT
+template size_t LR0Parser::eliminateUnitRules<ReportLog>(const set<string> &keep);
+#endif
+template size_t LR0Parser::eliminateUnitRules<SilentLog>(const set<string> &keep);
+
+const UnitBypass* LR0Parser::findBypass(int state, int nonTerminal) const {
+    auto it = bypassIndex.find({state, nonTerminal});
+    return (it != bypassIndex.end()) ? &unitBypasses[it->second] : nullptr;
 }
 
-string LR0Parser::stackToString(stack<int> st) {
-    vector<int> temp;
+// ===================================================
+// Incremental rebuild after a grammar edit
+// ===================================================
+vector<int> LR0Parser::expandStates(vector<int> work) {
+    vector<int> added;
+
+    for (size_t k = 0; k < work.size(); ++k) {
+        int s = work[k];
+        map<string, int> next;
 
-    while (!st.empty()) {
-        temp.push_back(st.top());
-        st.pop();
+        for (const string &sym : collectSymbols(states[s])) {
+            ItemSet kernel = GOTOkernel(states[s].items, sym);
+            int found = findState(kernel);
+            if (found == -1) {
+                // A kernel seen before an earlier edit gets its old id back
+                auto old = retiredKernels.find(kernel);
+                if (old != retiredKernels.end()) {
+                    found = old->second;
+                    retiredKernels.erase(old);
+                    states[found].items = closure(kernel);
+                    states[found].kernel = kernel;
+                } else {
+                    found = static_cast<int>(states.size());
+                    states.push_back({found, closure(kernel), ItemSet(kernel, itemPool.get())});
+                    Instrumentation::count(Counter::STATES_CREATED);
+                    stateTransitions.emplace_back();
+                }
+                kernelIndex.emplace(kernel, found);
+                work.push_back(found);
+                added.push_back(found);
+            }
+            next[sym] = found;
+        }
+
+        stateTransitions[s] = move(next);
     }
 
-    reverse(temp.begin(), temp.end());
+    return added;
+}
+
+template <typename Log>
+GrammarEditResult LR0Parser::applyGrammarEdit(const GrammarEdit &edit) {
+    auto t0 = chrono::steady_clock::now();
+    GrammarEditResult result;
+
+    // Restored bypass rows must be repacked as well
+    set<int> repack;
+    if (!unitBypasses.empty()) {
+        for (const auto &bp : unitBypasses)
+            repack.insert(bp.state);
+        UnitRuleEliminator::restore(table, unitBypasses);
+        unitBypasses.clear();
+        bypassIndex.clear();
+    }
 
+    // Text form of one row of the encoded table (empty past its end)
+    auto rowText = [&](int s) {
+        map<string, string> row;
+        if (s >= table.stateCount()) return row;
+        for (size_t t = 0; t < table.terminalCount(); ++t) {
+            uint32_t act = table.getAction(s, static_cast<int>(t));
+            if (actionTag(act) != ACT_ERROR)
+                row[table.terminalName(static_cast<int>(t))] = table.actionToString(act);
+        }
+        for (size_t nt = 0; nt < table.nonTerminalCount(); ++nt) {
+            int target = table.getGoto(s, static_cast<int>(nt));
+            if (target >= 0)
+                row[table.nonTerminalName(static_cast<int>(nt))] = to_string(target);
+        }
+        return row;
+    };
+
+    auto diffRow = [&](int s, const map<string, string> &before, const map<string, string> &after) {
+        set<string> keys;
+        for (const auto &e : before) keys.insert(e.first);
+        for (const auto &e : after) keys.insert(e.first);
+
+        for (const auto &k : keys) {
+            auto b = before.find(k);
+            auto a = after.find(k);
+            string was = (b != before.end()) ? b->second : "";
+            string now = (a != after.end()) ? a->second : "";
+            if (was != now)
+                result.changes.push_back({s, k, was, now});
+        }
+    };
+
+    // Summary plus every changed cell; the text renderer lists the
+    // first few
+    auto report = [&]() {
+        reportAt<Log>(Verbosity::SUMMARY, [&](ReportStream &stream) {
+            stream.emit(ReportEvent("grammar_edit")
+                            .add("edit", edit.toString())
+                            .add("full_rebuild", static_cast<int>(result.fullRebuild))
+                            .add("affected_states", result.affectedStates)
+                            .add("new_states", result.newStates)
+                            .add("retired_states", result.retiredStates)
+                            .add("rows_patched", result.rowsPatched)
+                            .add("analysis_micros", static_cast<int64_t>(result.analysisMs * 1000))
+                            .add("repack_micros", static_cast<int64_t>(result.repackMs * 1000))
+                            .add("changes", result.changes.size()),
+                        Verbosity::SUMMARY);
+            for (const auto &c : result.changes)
+                stream.emit(ReportEvent("table_change")
+                                .add("state", c.state)
+                                .add("symbol", c.symbol)
+                                .add("before", c.before)
+                                .add("after", c.after),
+                            Verbosity::SUMMARY);
+            stream.emit(ReportEvent("end").add("of", "grammar_edit"), Verbosity::SUMMARY);
+        });
+    };
+
+    // New or vanished symbols renumber the table: rebuild
+    bool sameSymbols = grammar.getTerminals().size() + 1 == table.terminalCount() &&
+                       grammar.getNonTerminals().size() + 1 == table.nonTerminalCount();
+    for (const auto &t : grammar.getTerminals())
+        if (table.terminalId(t) < 0) sameSymbols = false;
+    for (const auto &nt : grammar.getNonTerminals())
+        if (table.nonTerminalId(nt) < 0) sameSymbols = false;
+
+    if (!sameSymbols) {
+        int oldStates = static_cast<int>(states.size());
+        vector<map<string, string>> oldRows;
+        for (int s = 0; s < oldStates; ++s)
+            oldRows.push_back(rowText(s));
+
+        buildAutomaton<Log>();
+
+        result.applied = true;
+        result.fullRebuild = true;
+        result.rowsPatched = states.size();
+        int rows = max(oldStates, static_cast<int>(states.size()));
+        for (int s = 0; s < rows; ++s)
+            diffRow(s, s < oldStates ? oldRows[s] : map<string, string>(), rowText(s));
+
+        result.analysisMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        report();
+        return result;
+    }
+
+    auto reject = [&]() {
+        result.error = "edit does not match the grammar: " + edit.toString();
+        reportMessage<Log>([&] { return "❌ Edit does not match the grammar: " + edit.toString() + "\n"; });
+        return result;
+    };
+
+    // Production numbering: append the new alternative, or retire
+    // the removed one (ids of the others stay valid)
+    vector<string> rhs = edit.rhs;
+    if (rhs.size() == 1 && rhs[0] == "ε")
+        rhs.clear();
+    vector<string> alt = rhs.empty() ? vector<string>{"ε"} : rhs;
+
+    if (edit.kind == GrammarEdit::ADD) {
+        const Production *prod = nullptr;
+        size_t index = 0;
+        for (const auto &p : grammar.getProductions())
+            if (p.getLHS() == edit.lhs)
+                for (size_t a = 0; a < p.getRHS().size(); ++a)
+                    if (p.getRHS()[a] == alt) {
+                        prod = &p;
+                        index = a;
+                    }
+
+        if (!prod || table.productionId(edit.lhs, rhs) >= 0)
+            return reject();
+        table.appendProduction(edit.lhs, alt, grammar.rulePrecSymbol(*prod, index));
+    } else {
+        int id = table.productionId(edit.lhs, rhs);
+        if (id < 0)
+            return reject();
+        table.retireProduction(id);
+    }
+
+    indexProductions();
+
+    // FOLLOW changes move reduce actions even in untouched states
+    FirstFollowEngine oldFF = ff;
+    ff = FirstFollowEngine();
+    ff.computeFIRST(grammar);
+    ff.computeFOLLOW(grammar);
+
+    set<string> followChanged;
+    for (const auto &nt : grammar.getNonTerminals())
+        if (oldFF.getFOLLOW(nt) != ff.getFOLLOW(nt))
+            followChanged.insert(nt);
+
+    // States whose closure contains the edited LHS are re-closed
+    vector<int> affected;
+    set<int> refill;
+    for (size_t s = 0; s < states.size(); ++s) {
+        bool closes = false, reduces = false;
+        for (const auto &item : states[s].items) {
+            if (item.dot == 0 && item.lhs() == edit.lhs) closes = true;
+            if (item.dot == item.rhs().size() && followChanged.count(item.lhs())) reduces = true;
+        }
+        if (closes) affected.push_back(static_cast<int>(s));
+        if (closes || reduces) refill.insert(static_cast<int>(s));
+    }
+    result.affectedStates = affected.size();
+
+    for (int s : affected)
+        states[s].items = closure(states[s].kernel);
+    vector<int> added = expandStates(affected);
+
+    result.newStates = added.size();
+    refill.insert(added.begin(), added.end());
+
+    // Retire states no longer reachable from state 0
+    vector<char> seen(states.size(), 0);
+    vector<int> work = {0};
+    seen[0] = 1;
+    while (!work.empty()) {
+        int s = work.back();
+        work.pop_back();
+        for (const auto &tr : stateTransitions[s])
+            if (!seen[tr.second]) {
+                seen[tr.second] = 1;
+                work.push_back(tr.second);
+            }
+    }
+
+    for (size_t s = 0; s < states.size(); ++s) {
+        if (seen[s] || states[s].kernel.empty()) continue;
+        kernelIndex.erase(states[s].kernel);
+        retiredKernels[states[s].kernel] = static_cast<int>(s);
+        states[s].items.clear();
+        states[s].kernel.clear();
+        stateTransitions[s].clear();
+        refill.insert(static_cast<int>(s));
+        result.retiredStates++;
+    }
+
+    // Patch the rows in place
+    table.grow(static_cast<int>(states.size()));
+
+    vector<string> keptResolutions;
+    vector<int> keptStates;
+    for (size_t k = 0; k < resolutions.size(); ++k)
+        if (!refill.count(resolutionStates[k])) {
+            keptResolutions.push_back(resolutions[k]);
+            keptStates.push_back(resolutionStates[k]);
+        }
+    resolutions.swap(keptResolutions);
+    resolutionStates.swap(keptStates);
+
+    for (int s : refill) {
+        map<string, string> before = rowText(s);
+
+        table.clearRow(s);
+        fillRow(s);
+        diffRow(s, before, rowText(s));
+    }
+    textStale = true;
+
+    result.applied = true;
+    result.rowsPatched = refill.size();
+    auto t1 = chrono::steady_clock::now();
+    result.analysisMs = chrono::duration<double, milli>(t1 - t0).count();
+
+    repack.insert(refill.begin(), refill.end());
+    compressed.patchRows(vector<int>(repack.begin(), repack.end()));
+    result.repackMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t1).count();
+
+    report();
+    return result;
+}
+
+#ifndef GRAMRESOLVE_NO_REPORT
+template GrammarEditResult LR0Parser::applyGrammarEdit<ReportLog>(const GrammarEdit &edit);
+#endif
+template GrammarEditResult LR0Parser::applyGrammarEdit<SilentLog>(const GrammarEdit &edit);
+
+// ===================================================
+// Helpers
+// ===================================================
+string LR0Parser::fullStackToString(const vector<int> &stateStack, const vector<int> &symbolStack) const {
+    string result = to_string(stateStack[0]);
+
+    for (size_t k = 0; k < symbolStack.size(); ++k)
+        result += " " + table.symbolName(symbolStack[k]) + " " + to_string(stateStack[k + 1]);
+
+    return result;
+}
+
+string LR0Parser::remainingInput(const vector<string> &tokens, size_t i) {
     string s;
-    for (int v : temp)
-        s += to_string(v) + " ";
+
+    for (size_t k = i; k < tokens.size(); ++k)
+        s += tokens[k] + " ";
 
     return s;
 }
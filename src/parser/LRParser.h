@@ -5,55 +5,87 @@
 #include <vector>
 #include <set>
 #include <map>
+#include <deque>
 #include <stack>
 #include <queue>
+#include <unordered_map>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include "../grammar/Grammar.h"
 #include "../analysis/FirstFollow.h"
+#include "LRTable.h"
+#include "LR0Core.h"
+#include "CompressedTable.h"
+#include "UnitRuleElimination.h"
 
 using namespace std;
 
 // ===============================================================
-// Struct: LRItem
-// Represents an LR(0) item [A → α • β]
+// Struct: LRRule
+// Symbol names of one production, shared by all of its items
 // ===============================================================
-struct LRItem {
+struct LRRule {
     string lhs;
     vector<string> rhs;
+};
+
+// ===============================================================
+// Struct: LRItem
+// Represents an LR(0) item [A → α • β]. The names live in the
+// parser's rule list, so an item owns no memory; items still
+// compare by name, as rules re-added after a retirement are new
+// LRRule objects.
+// ===============================================================
+struct LRItem {
+    const LRRule *rule;
     size_t dot; // position of dot
 
+    const string& lhs() const { return rule->lhs; }
+    const vector<string>& rhs() const { return rule->rhs; }
+
     bool operator<(const LRItem &other) const {
-        if (lhs != other.lhs) return lhs < other.lhs;
-        if (rhs != other.rhs) return rhs < other.rhs;
+        if (rule != other.rule) {
+            if (lhs() != other.lhs()) return lhs() < other.lhs();
+            if (rhs() != other.rhs()) return rhs() < other.rhs();
+        }
         return dot < other.dot;
     }
 
     bool operator==(const LRItem &other) const {
-        return lhs == other.lhs && rhs == other.rhs && dot == other.dot;
+        return dot == other.dot &&
+               (rule == other.rule || (lhs() == other.lhs() && rhs() == other.rhs()));
     }
 
     string toString() const {
-        string s = lhs + " → ";
-        if (rhs.empty()) {
+        string s = lhs() + " → ";
+        if (rhs().empty()) {
             s += "• (ε)";
         } else {
-            for (size_t i = 0; i < rhs.size(); ++i) {
+            for (size_t i = 0; i < rhs().size(); ++i) {
                 if (i == dot) s += "• ";
-                s += rhs[i] + " ";
+                s += rhs()[i] + " ";
             }
-            if (dot == rhs.size()) s += "•";
+            if (dot == rhs().size()) s += "•";
         }
         return s;
     }
 };
 
+// Item sets of one automaton; LR0Parser allocates them from a pool
+// it owns (see itemPool), other copies use the default heap. Items
+// are plain values, so a set's memory is all in its nodes.
+typedef pmr::set<LRItem> ItemSet;
+
 // ===============================================================
 // Struct: LRState
 // Represents a state (set of LRItems)
 // ===============================================================
 struct LRState {
     int id;
-    set<LRItem> items;
+    ItemSet items;
+    ItemSet kernel;       // items that identify the state (before closure)
 
     bool operator==(const LRState &other) const {
         return items == other.items;
@@ -67,6 +99,64 @@ struct LRState {
     }
 };
 
+// ===============================================================
+// Struct: LRKernelHash
+// Hash of a kernel item set, used to deduplicate states
+// ===============================================================
+struct LRKernelHash {
+    size_t operator()(const ItemSet &items) const {
+        hash<string> h;
+        size_t seed = items.size();
+        for (const auto &item : items) {
+            size_t v = h(item.lhs()) ^ (item.dot * 0x9e3779b97f4a7c15ULL);
+            for (const auto &sym : item.rhs())
+                v = v * 31 + h(sym);
+            seed ^= v + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+        }
+        return seed;
+    }
+};
+
+// ===============================================================
+// Struct: CorpusStats
+// Totals of a silent driver run over many sentences
+// ===============================================================
+struct CorpusStats {
+    size_t sentences = 0;
+    size_t accepted = 0;
+    size_t tokens = 0;          // excluding the end marker
+    size_t reductions = 0;
+
+    double reductionsPerToken() const {
+        return tokens ? static_cast<double>(reductions) / tokens : 0.0;
+    }
+};
+
+// ===============================================================
+// Structs: TableChange / GrammarEditResult
+// Outcome of patching the automaton after a grammar edit. Cells
+// are given in the legacy text form ("" = empty cell).
+// ===============================================================
+struct TableChange {
+    int state;
+    string symbol;
+    string before;
+    string after;
+};
+
+struct GrammarEditResult {
+    bool applied = false;
+    string error;                   // why the edit was not applied
+    bool fullRebuild = false;       // symbol set changed
+    size_t affectedStates = 0;      // closures that involve the edited LHS
+    size_t newStates = 0;           // appended or revived ids
+    size_t retiredStates = 0;       // no longer reachable
+    size_t rowsPatched = 0;
+    double analysisMs = 0.0;        // FIRST/FOLLOW, states and rows
+    double repackMs = 0.0;          // compressed table patch
+    vector<TableChange> changes;
+};
+
 // ===============================================================
 // Class: LR0Parser
 // Implements LR(0)/SLR(1) Automaton and Parsing Table
@@ -74,40 +164,139 @@ struct LRState {
 class LR0Parser {
 private:
     const Grammar &grammar;
+
+    // Item set nodes of this automaton. Declared before everything
+    // that holds an ItemSet, so it is destroyed last; each build
+    // releases the previous build's memory in one call.
+    unique_ptr<pmr::synchronized_pool_resource> itemPool;
+
     vector<LRState> states;
+    string augmented;                      // augmented start symbol (S')
+    unordered_map<ItemSet, int, LRKernelHash> kernelIndex;   // kernel → state id
+    map<ItemSet, int> retiredKernels;      // retired by an edit; revived with the same id
+    unsigned threadCount = 0;              // 0 = all hardware threads
+
+    FirstFollowEngine ff;
+    LR0Core lr0;                           // closure over the table's productions
+    deque<LRRule> rules;                   // production → names; stable, items point here
+    vector<LRItem> ruleItems;              // production → its item with the dot at 0
+    vector<map<string, int>> stateTransitions;                      // state → symbol → state
+
+    LRTable table;                         // integer-encoded ACTION/GOTO
+    CompressedLRTable compressed;          // what the drivers read
+    // Textual views of ACTION[state][symbol] and GOTO[state][NonTerminal],
+    // rebuilt from `table` by the first accessor call after a change
+    mutable map<int, map<string, string>> ACTION;
+    mutable map<int, map<string, int>> GOTO;
+    mutable bool textStale = true;
 
-    map<int, map<string, string>> ACTION;  // ACTION[state][symbol]
-    map<int, map<string, int>> GOTO;       // GOTO[state][NonTerminal]
+    // Shift/reduce decisions made from %left/%right/%nonassoc/%prec
+    vector<string> resolutions;
+    vector<int> resolutionStates;          // state of each resolution
+
+    // GOTO entries rewritten by unit-rule elimination
+    vector<UnitBypass> unitBypasses;
+    map<pair<int, int>, size_t> bypassIndex;   // (state, non-terminal) → record
+
+    // Driver stack, reused between runs
+    vector<int> stateStack;
+    size_t lastReductions = 0;
 
 public:
     explicit LR0Parser(const Grammar &g);
 
-    // Build automaton and populate ACTION/GOTO
+    // Worker threads used by buildAutomaton (0 = hardware concurrency)
+    void setThreadCount(unsigned threads) { threadCount = threads; }
+
+    // Build automaton and populate ACTION/GOTO (progress and the
+    // compression summary at Verbosity::SUMMARY)
+    template <typename Log = DefaultLog>
     void buildAutomaton();
 
     // Display canonical collection
+    template <typename Log = DefaultLog>
     void displayStates() const;
 
-    // Run parser simulation
+    // Run parser simulation, printing each step. Bounded like
+    // recognize(): stops on a reduction loop of a cyclic grammar.
+    template <typename Log = DefaultLog>
     void parse(const vector<string> &tokens);
 
-    // Accessor for ACTION table
+    // Silent driver over encoded tokens (must end with the "$" id).
+    // Allocates nothing once the stack has grown to the input depth.
+    bool recognize(const vector<int> &tokenIds);
+
+    // Reductions performed by the last recognize() call
+    size_t getLastReductions() const { return lastReductions; }
+
+    // Silent run over a corpus of token sentences
+    CorpusStats runCorpus(const vector<vector<string>> &corpus);
+
+    // Redirect GOTOs past chain productions (A -> B) so they cost no
+    // parse step. Productions named in `keep` ("A -> B") stay intact.
+    // Returns the number of rewritten GOTO entries.
+    template <typename Log = DefaultLog>
+    size_t eliminateUnitRules(const set<string> &keep = {});
+
+    // Skipped chain for GOTO(state, nonTerminal), nullptr if none
+    const UnitBypass* findBypass(int state, int nonTerminal) const;
+    const vector<UnitBypass>& getUnitBypasses() const { return unitBypasses; }
+
+    // Patch the automaton after `edit` was applied to the grammar
+    // this parser was built from. Only states whose closure contains
+    // the edited LHS are re-closed; new kernels become new states,
+    // unreachable ones are retired, and existing state ids are kept.
+    // Falls back to buildAutomaton() when the symbol set changed.
+    // Unit-rule bypasses are undone first.
+    template <typename Log = DefaultLog>
+    GrammarEditResult applyGrammarEdit(const GrammarEdit &edit);
+
+    // Accessors for the textual ACTION/GOTO tables (built on first
+    // use after a table change; not for concurrent first calls)
     const map<int, map<string, string>>& getACTION() const;
+    const map<int, map<string, int>>& getGOTO() const;
+    size_t getStateCount() const { return states.size(); }
+
+    // Automaton internals for analyses (retired states have no kernel)
+    const vector<LRState>& getStates() const { return states; }
+    const vector<map<string, int>>& getTransitions() const { return stateTransitions; }
+    const FirstFollowEngine& getFirstFollow() const { return ff; }
+    const string& getAugmentedSymbol() const { return augmented; }
+
+    // Precedence resolutions applied by the last build
+    const vector<string>& getResolutions() const { return resolutions; }
+
+    // Integer-encoded tables (dense and compressed)
+    const LRTable& getTable() const { return table; }
+    const CompressedLRTable& getCompressedTable() const { return compressed; }
 
 private:
     // LR(0) core helper functions
-    set<LRItem> closure(set<LRItem> I, const Grammar &g);
-    set<LRItem> GOTOset(const set<LRItem> &I, const string &X, const Grammar &g);
+    void indexProductions();
+    ItemSet closure(const ItemSet &I) const;
+    ItemSet GOTOkernel(const ItemSet &I, const string &X) const;
+    ItemSet GOTOset(const ItemSet &I, const string &X) const;
 
     // FIXED: removed unused Grammar parameter
     set<string> collectSymbols(const LRState &state) const;
 
-    int findState(const set<LRItem> &items) const;
+    // State lookup by kernel (-1 when new)
+    int findState(const ItemSet &kernel) const;
+
+    // Place a reduce action (LR0Core placeReduce) and record the
+    // precedence resolution, if any; `nonassoc` is per row
+    void placeReduce(int state, set<int> &nonassoc, int terminal, int production);
+
+    // Fill a state's ACTION/GOTO row (row must be empty)
+    void fillRow(int state);
+
+    // Successors of new or re-closed states; new states are appended
+    // or revived. Returns the ids of both.
+    vector<int> expandStates(vector<int> work);
 
     // Stack + display helpers
-    string fullStackToString(stack<int> stateStack, stack<string> symbolStack);
+    string fullStackToString(const vector<int> &stateStack, const vector<int> &symbolStack) const;
     string remainingInput(const vector<string> &tokens, size_t i);
-    string stackToString(stack<int> st);
 };
 
 #endif
@@ -0,0 +1,304 @@
+#include "LRTable.h"
+#include <sstream>
+#include <algorithm>
+
+using namespace std;
+
+// ===================================================
+// Number symbols and productions
+// ===================================================
+void LRTable::init(const Grammar &g, const string &augmented) {
+    terminals.clear();
+    nonTerminals.clear();
+    terminalIds.clear();
+    nonTerminalIds.clear();
+    productions.clear();
+    productionLabels.clear();
+    productionPrec.clear();
+    productionIndex.clear();
+
+    for (const auto &t : g.getTerminals()) {
+        terminalIds[t] = static_cast<int>(terminals.size());
+        terminals.push_back(t);
+    }
+    terminalIds["$"] = static_cast<int>(terminals.size());
+    terminals.push_back("$");
+
+    nonTerminalIds[augmented] = 0;
+    nonTerminals.push_back(augmented);
+    for (const auto &nt : g.getNonTerminals()) {
+        nonTerminalIds[nt] = static_cast<int>(nonTerminals.size());
+        nonTerminals.push_back(nt);
+    }
+
+    addProduction(augmented, {g.getStartSymbol()}, "");
+    for (const auto &prod : g.getProductions())
+        for (size_t a = 0; a < prod.getRHS().size(); ++a)
+            addProduction(prod.getLHS(), prod.getRHS()[a], g.rulePrecSymbol(prod, a));
+
+    resize(0);
+}
+
+// ===================================================
+// Append one production (ε alternative → empty RHS)
+// ===================================================
+void LRTable::addProduction(const string &lhs, const vector<string> &alt, const string &prec) {
+    vector<string> rhs = alt;
+    if (rhs.size() == 1 && rhs[0] == "ε")
+        rhs.clear();
+
+    LRProduction p;
+    p.lhs = nonTerminalIds[lhs];
+    p.length = static_cast<int>(rhs.size());
+    for (const auto &sym : rhs) {
+        auto nt = nonTerminalIds.find(sym);
+        if (nt != nonTerminalIds.end())
+            p.rhs.push_back(static_cast<int>(terminals.size()) + nt->second);
+        else
+            p.rhs.push_back(terminalIds[sym]);
+    }
+
+    string label = lhs + " ->";
+    if (rhs.empty()) label += " ε";
+    for (const auto &sym : rhs) label += " " + sym;
+
+    int id = static_cast<int>(productions.size());
+    productionIndex.emplace(make_pair(lhs, rhs), id);
+    productions.push_back(p);
+    productionLabels.push_back(label);
+    productionPrec.push_back(prec);
+}
+
+int LRTable::appendProduction(const string &lhs, const vector<string> &alt, const string &prec) {
+    addProduction(lhs, alt, prec);
+    return static_cast<int>(productions.size()) - 1;
+}
+
+void LRTable::retireProduction(int p) {
+    vector<string> rhs;
+    for (int sym : productions[p].rhs)
+        rhs.push_back(symbolName(sym));
+
+    auto it = productionIndex.find(make_pair(nonTerminals[productions[p].lhs], rhs));
+    if (it != productionIndex.end() && it->second == p)
+        productionIndex.erase(it);
+}
+
+// ===================================================
+// Allocate rows
+// ===================================================
+void LRTable::resize(int states) {
+    numStates = states;
+    action.assign(static_cast<size_t>(states) * terminals.size(), ACT_ERROR);
+    gotoTable.assign(static_cast<size_t>(states) * nonTerminals.size(), -1);
+    conflictLists.clear();
+    freeConflictLists.clear();
+    conflictRecords.clear();
+}
+
+void LRTable::grow(int states) {
+    if (states <= numStates) return;
+    numStates = states;
+    action.resize(static_cast<size_t>(states) * terminals.size(), ACT_ERROR);
+    gotoTable.resize(static_cast<size_t>(states) * nonTerminals.size(), -1);
+}
+
+void LRTable::clearRow(int state) {
+    auto row = action.begin() + state * terminals.size();
+    for (auto cell = row; cell != row + terminals.size(); ++cell)
+        if (actionTag(*cell) == ACT_CONFLICT) {
+            vector<uint32_t>().swap(conflictLists[actionPayload(*cell)]);
+            freeConflictLists.push_back(actionPayload(*cell));
+        }
+
+    fill(row, row + terminals.size(), ACT_ERROR);
+    fill(gotoTable.begin() + state * nonTerminals.size(),
+         gotoTable.begin() + (state + 1) * nonTerminals.size(), -1);
+
+    conflictRecords.erase(remove_if(conflictRecords.begin(), conflictRecords.end(),
+                                    [state](const ConflictRecord &c) { return c.row == state; }),
+                          conflictRecords.end());
+}
+
+static ConflictKind conflictKind(uint32_t a, uint32_t b) {
+    uint32_t ta = actionTag(a), tb = actionTag(b);
+    if (ta == ACT_SHIFT && tb == ACT_SHIFT) return ConflictKind::SHIFT_SHIFT;
+    if (ta == ACT_REDUCE && tb == ACT_REDUCE) return ConflictKind::REDUCE_REDUCE;
+    if ((ta == ACT_SHIFT && tb == ACT_REDUCE) || (ta == ACT_REDUCE && tb == ACT_SHIFT))
+        return ConflictKind::SHIFT_REDUCE;
+    return ConflictKind::OTHER;
+}
+
+// ===================================================
+// Store an action, turning the cell into a conflict
+// list when a second distinct action arrives
+// ===================================================
+void LRTable::addAction(int state, int terminal, uint32_t act) {
+    uint32_t &cell = action[state * terminals.size() + terminal];
+
+    if (cell == ACT_ERROR) {
+        cell = act;
+        return;
+    }
+
+    if (actionTag(cell) == ACT_CONFLICT) {
+        auto &list = conflictLists[actionPayload(cell)];
+        if (find(list.begin(), list.end(), act) == list.end()) {
+            list.push_back(act);
+            conflictRecords.push_back({state, terminal, list[0], act, conflictKind(list[0], act)});
+        }
+        return;
+    }
+
+    if (cell == act)
+        return;
+
+    conflictRecords.push_back({state, terminal, cell, act, conflictKind(cell, act)});
+
+    uint32_t slot;
+    if (!freeConflictLists.empty()) {
+        slot = freeConflictLists.back();
+        freeConflictLists.pop_back();
+        conflictLists[slot] = {cell, act};
+    } else {
+        slot = static_cast<uint32_t>(conflictLists.size());
+        conflictLists.push_back({cell, act});
+    }
+    cell = ACT_CONFLICT | slot;
+}
+
+const uint32_t* LRTable::cellActions(int state, int terminal, size_t &count) const {
+    const uint32_t &cell = action[state * terminals.size() + terminal];
+
+    if (actionTag(cell) == ACT_ERROR) {
+        count = 0;
+        return nullptr;
+    }
+    if (actionTag(cell) == ACT_CONFLICT) {
+        const auto &list = conflictLists[actionPayload(cell)];
+        count = list.size();
+        return list.data();
+    }
+
+    count = 1;
+    return &cell;
+}
+
+// ===================================================
+// Symbol lookups
+// ===================================================
+int LRTable::terminalId(const string &t) const {
+    auto it = terminalIds.find(t);
+    return (it != terminalIds.end()) ? it->second : -1;
+}
+
+int LRTable::nonTerminalId(const string &nt) const {
+    auto it = nonTerminalIds.find(nt);
+    return (it != nonTerminalIds.end()) ? it->second : -1;
+}
+
+string LRTable::symbolName(int sym) const {
+    if (isTerminalSymbol(sym))
+        return terminals[sym];
+    return nonTerminals[sym - terminals.size()];
+}
+
+bool LRTable::encodeTokens(const vector<string> &tokens, vector<int> &ids) const {
+    ids.clear();
+    ids.reserve(tokens.size() + 1);
+
+    for (const auto &tok : tokens) {
+        int id = terminalId(tok);
+        if (id < 0)
+            return false;
+        // "$" only ends the input; the drivers must not stop early
+        if (!ids.empty() && ids.back() == endMarker())
+            return false;
+        ids.push_back(id);
+    }
+
+    if (ids.empty() || ids.back() != endMarker())
+        ids.push_back(endMarker());
+    return true;
+}
+
+int LRTable::productionId(const string &lhs, const vector<string> &rhs) const {
+    auto it = productionIndex.find(make_pair(lhs, rhs));
+    return (it != productionIndex.end()) ? it->second : -1;
+}
+
+// ===================================================
+// Textual views
+// ===================================================
+size_t LRTable::memoryBytes() const {
+    size_t bytes = action.capacity() * sizeof(uint32_t) + gotoTable.capacity() * sizeof(int32_t);
+    for (const auto &list : conflictLists)
+        bytes += sizeof(list) + list.capacity() * sizeof(uint32_t);
+    bytes += freeConflictLists.capacity() * sizeof(uint32_t);
+    bytes += conflictRecords.capacity() * sizeof(ConflictRecord);
+
+    // Names are counted twice: once in the vectors, once in the maps
+    for (const auto &t : terminals) bytes += 2 * (sizeof(string) + t.size()) + sizeof(int);
+    for (const auto &nt : nonTerminals) bytes += 2 * (sizeof(string) + nt.size()) + sizeof(int);
+    for (const auto &p : productions)
+        bytes += sizeof(LRProduction) + p.rhs.capacity() * sizeof(int);
+    for (const auto &label : productionLabels)
+        bytes += 2 * (sizeof(string) + label.size());
+    return bytes;
+}
+
+string LRTable::actionToString(uint32_t act) const {
+    switch (actionTag(act)) {
+    case ACT_SHIFT:
+        return "s" + to_string(actionPayload(act));
+
+    case ACT_REDUCE: {
+        const LRProduction &p = productions[actionPayload(act)];
+        string s = "r" + nonTerminals[p.lhs] + "->";
+        for (int sym : p.rhs)
+            s += symbolName(sym) + " ";
+        return s;
+    }
+
+    case ACT_ACCEPT:
+        return "acc";
+
+    case ACT_CONFLICT: {
+        string s;
+        for (uint32_t a : conflictLists[actionPayload(act)]) {
+            if (!s.empty()) s += "|";
+            s += actionToString(a);
+        }
+        return s;
+    }
+
+    default:
+        return "";
+    }
+}
+
+map<int, map<string, string>> LRTable::actionStrings() const {
+    map<int, map<string, string>> out;
+
+    for (int s = 0; s < numStates; ++s)
+        for (size_t t = 0; t < terminals.size(); ++t) {
+            uint32_t act = getAction(s, static_cast<int>(t));
+            if (actionTag(act) != ACT_ERROR)
+                out[s][terminals[t]] = actionToString(act);
+        }
+
+    return out;
+}
+
+map<int, map<string, int>> LRTable::gotoMap() const {
+    map<int, map<string, int>> out;
+
+    for (int s = 0; s < numStates; ++s)
+        for (size_t nt = 0; nt < nonTerminals.size(); ++nt) {
+            int target = getGoto(s, static_cast<int>(nt));
+            if (target >= 0)
+                out[s][nonTerminals[nt]] = target;
+        }
+
+    return out;
+}
@@ -0,0 +1,167 @@
+// ===============================================================
+// File: LRTable.h
+// Description: Integer-encoded LR ACTION/GOTO tables.
+//              Actions are tagged 32-bit words stored in dense
+//              [state × terminal] arrays; productions carry their
+//              precomputed LHS id and RHS length for the driver.
+// ===============================================================
+
+#ifndef LR_TABLE_H
+#define LR_TABLE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+#include "../grammar/Grammar.h"
+#include "../analysis/ConflictRecord.h"
+
+using namespace std;
+
+// ===============================================================
+// Action encoding: 3-bit tag | 29-bit payload
+// ===============================================================
+enum LRActionTag : uint32_t {
+    ACT_ERROR    = 0u,
+    ACT_SHIFT    = 1u << 29,   // payload = target state
+    ACT_REDUCE   = 2u << 29,   // payload = production id
+    ACT_ACCEPT   = 3u << 29,
+    ACT_CONFLICT = 4u << 29    // payload = index into conflict lists
+};
+
+const uint32_t ACT_TAG_MASK     = 7u << 29;
+const uint32_t ACT_PAYLOAD_MASK = (1u << 29) - 1;
+
+// Error placed by %nonassoc: tagged ACT_ERROR, so every driver
+// rejects it, but not an empty cell, so a compressed row keeps it
+// instead of falling back to its default reduction
+const uint32_t ACT_NONASSOC     = ACT_ERROR | 1u;
+
+inline uint32_t makeShift(int state)      { return ACT_SHIFT | static_cast<uint32_t>(state); }
+inline uint32_t makeReduce(int prod)      { return ACT_REDUCE | static_cast<uint32_t>(prod); }
+inline uint32_t makeAccept()              { return ACT_ACCEPT; }
+inline uint32_t actionTag(uint32_t a)     { return a & ACT_TAG_MASK; }
+inline int      actionPayload(uint32_t a) { return static_cast<int>(a & ACT_PAYLOAD_MASK); }
+
+// ===============================================================
+// Struct: LRProduction
+// One alternative of the (augmented) grammar. RHS symbols use a
+// single id space: terminals first, non-terminals offset by the
+// number of terminals.
+// ===============================================================
+struct LRProduction {
+    int lhs;               // non-terminal id
+    int length;            // number of RHS symbols (ε → 0)
+    vector<int> rhs;
+};
+
+// ===============================================================
+// Class: LRTable
+// ===============================================================
+class LRTable {
+private:
+    vector<string> terminals;            // "$" is always the last terminal
+    vector<string> nonTerminals;         // augmented start symbol is id 0
+    unordered_map<string, int> terminalIds;
+    unordered_map<string, int> nonTerminalIds;
+
+    vector<LRProduction> productions;    // production 0 = S' -> S
+    vector<string> productionLabels;
+    vector<string> productionPrec;       // symbol giving each rule its precedence
+    map<pair<string, vector<string>>, int> productionIndex;
+
+    void addProduction(const string &lhs, const vector<string> &alt, const string &prec);
+
+    int numStates = 0;
+    vector<uint32_t> action;             // [state * numTerminals + terminal]
+    vector<int32_t> gotoTable;           // [state * numNonTerminals + nonTerminal]
+    vector<vector<uint32_t>> conflictLists;
+    vector<uint32_t> freeConflictLists;  // slots released by clearRow, reused first
+    vector<ConflictRecord> conflictRecords;   // written by addAction
+
+public:
+    LRTable() = default;
+
+    // Number symbols and productions of the grammar augmented with
+    // `augmented -> start`
+    void init(const Grammar &g, const string &augmented);
+
+    // Allocate empty rows for `states` states
+    void resize(int states);
+
+    // 🔹 Incremental updates (grammar edits)
+    // Append rows, keeping existing ones
+    void grow(int states);
+    // Reset a state's ACTION and GOTO entries; its conflict lists
+    // are freed and their slots reused
+    void clearRow(int state);
+    // Number a new alternative after the existing productions
+    int appendProduction(const string &lhs, const vector<string> &alt, const string &prec);
+    // Forget a removed alternative; its id is never reused
+    void retireProduction(int p);
+
+    // Add an action to a cell; a second distinct action turns the
+    // cell into a conflict list and is recorded
+    void addAction(int state, int terminal, uint32_t act);
+
+    // Overwrite a cell (used by precedence resolution)
+    void setAction(int state, int terminal, uint32_t act) {
+        action[state * terminals.size() + terminal] = act;
+    }
+    void setGoto(int state, int nonTerminal, int target) {
+        gotoTable[state * nonTerminals.size() + nonTerminal] = target;
+    }
+
+    // 🔹 Driver lookups
+    uint32_t getAction(int state, int terminal) const {
+        return action[state * terminals.size() + terminal];
+    }
+    int getGoto(int state, int nonTerminal) const {
+        return gotoTable[state * nonTerminals.size() + nonTerminal];
+    }
+
+    // All actions stored in a cell (one, several, or none)
+    const uint32_t* cellActions(int state, int terminal, size_t &count) const;
+    const vector<uint32_t>& conflictList(uint32_t act) const {
+        return conflictLists[actionPayload(act)];
+    }
+
+    // Conflicts in the order addAction found them
+    const vector<ConflictRecord>& getConflicts() const { return conflictRecords; }
+
+    // 🔹 Symbols
+    int terminalId(const string &t) const;
+    int nonTerminalId(const string &nt) const;
+    int endMarker() const { return static_cast<int>(terminals.size()) - 1; }
+    size_t terminalCount() const { return terminals.size(); }
+    size_t nonTerminalCount() const { return nonTerminals.size(); }
+    const string& terminalName(int t) const { return terminals[t]; }
+    const string& nonTerminalName(int nt) const { return nonTerminals[nt]; }
+    bool isTerminalSymbol(int sym) const { return sym < static_cast<int>(terminals.size()); }
+    string symbolName(int sym) const;
+
+    // Map a token sequence to terminal ids and end it with "$";
+    // false on an unknown token or a "$" before the last token
+    bool encodeTokens(const vector<string> &tokens, vector<int> &ids) const;
+
+    // 🔹 Productions
+    int productionId(const string &lhs, const vector<string> &rhs) const;
+    const vector<LRProduction>& getProductions() const { return productions; }
+    const LRProduction& production(int p) const { return productions[p]; }
+    const string& productionLabel(int p) const { return productionLabels[p]; }
+    const vector<string>& getProductionLabels() const { return productionLabels; }
+    const string& productionPrecSymbol(int p) const { return productionPrec[p]; }
+
+    int stateCount() const { return numStates; }
+
+    // Approximate heap footprint (tables, conflict lists, symbols)
+    size_t memoryBytes() const;
+
+    // 🔹 Textual views (legacy format: "s5", "rE->E + T ", "acc")
+    string actionToString(uint32_t act) const;
+    map<int, map<string, string>> actionStrings() const;
+    map<int, map<string, int>> gotoMap() const;
+};
+
+#endif
@@ -0,0 +1,477 @@
+#include "LazyAutomaton.h"
+#include "../analysis/FirstFollow.h"
+#include "../report/reportWriter.h"
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <map>
+#include <chrono>
+#include <cctype>
+#include <cstdint>
+
+using namespace std;
+
+// ===================================================
+// Constructor — symbol numbering, FOLLOW sets and the
+// start state; no other state is built yet
+// ===================================================
+LazyLRAutomaton::LazyLRAutomaton(const Grammar &g) : grammar(g), chunks(MAX_CHUNKS) {
+    for (auto &c : chunks)
+        c.store(nullptr);
+
+    string start = grammar.getStartSymbol();
+    augmented = start + "'";
+    while (grammar.isNonTerminal(augmented))
+        augmented += "'";
+
+    symbols.init(grammar, augmented);
+
+    FirstFollowEngine ff;
+    ff.computeFIRST(grammar);
+    ff.computeFOLLOW(grammar);
+
+    lr0.init(symbols);
+
+    size_t N = symbols.nonTerminalCount();
+    followOf.assign(N, {});
+    for (size_t A = 1; A < N; ++A)
+        for (const auto &t : ff.getFOLLOW(symbols.nonTerminalName(static_cast<int>(A)))) {
+            int id = symbols.terminalId(t);
+            if (id >= 0) followOf[A].push_back(id);
+        }
+
+    intern({packItem(0, 0)});
+}
+
+LazyLRAutomaton::~LazyLRAutomaton() {
+    for (auto &c : chunks)
+        delete[] c.load();
+}
+
+void LazyLRAutomaton::reset() {
+    unique_lock<shared_mutex> lock(indexMutex);
+    for (auto &c : chunks) {
+        delete[] c.load();
+        c.store(nullptr);
+    }
+    kernelIndex.clear();
+    discovered = 0;
+    expanded = 0;
+    exhausted = false;
+    resolved = 0;
+    buildNs = 0;
+}
+
+// ===================================================
+// State storage
+// ===================================================
+LazyState& LazyLRAutomaton::stateRef(int id) const {
+    return chunks[id / CHUNK_SIZE].load(memory_order_acquire)[id % CHUNK_SIZE];
+}
+
+// Number a kernel, creating an unexpanded state the first time;
+// -1, with the automaton marked exhausted, once the chunks are full
+int LazyLRAutomaton::intern(vector<uint64_t> kernel) {
+    {
+        shared_lock<shared_mutex> lock(indexMutex);
+        auto it = kernelIndex.find(kernel);
+        if (it != kernelIndex.end())
+            return it->second;
+    }
+
+    unique_lock<shared_mutex> lock(indexMutex);
+    auto it = kernelIndex.find(kernel);
+    if (it != kernelIndex.end())
+        return it->second;
+
+    int id = discovered.load(memory_order_relaxed);
+    size_t c = id / CHUNK_SIZE;
+    if (c >= MAX_CHUNKS) {
+        exhausted.store(true);
+        return -1;
+    }
+    if (!chunks[c].load(memory_order_relaxed))
+        chunks[c].store(new LazyState[CHUNK_SIZE], memory_order_release);
+
+    stateRef(id).kernel = kernel;
+    kernelIndex.emplace(move(kernel), id);
+    discovered.store(id + 1, memory_order_release);
+    return id;
+}
+
+// Build the row on first use; later calls only read it
+LazyState& LazyLRAutomaton::ensure(int id) {
+    LazyState &st = stateRef(id);
+    if (!st.ready.load(memory_order_acquire)) {
+        call_once(st.once, [&] {
+            if (!st.ready.load(memory_order_acquire))
+                expand(id);
+            st.ready.store(true, memory_order_release);
+        });
+    }
+    return st;
+}
+
+// ===================================================
+// One state: successors, shifts/GOTOs, reductions
+// ===================================================
+void LazyLRAutomaton::expand(int id) {
+    auto t0 = chrono::steady_clock::now();
+    const int T = static_cast<int>(symbols.terminalCount());
+
+    LazyState &st = stateRef(id);
+    st.action.assign(T, ACT_ERROR);
+    st.gotoRow.assign(symbols.nonTerminalCount(), -1);
+    st.conflicts.clear();
+
+    map<int, vector<uint64_t>> successors;
+    vector<int> completed;
+    lr0.successors(st.kernel, successors, completed);
+
+    for (auto &succ : successors) {
+        int target = intern(move(succ.second));
+        if (target < 0) continue;          // row left incomplete; see limitReached()
+
+        if (symbols.isTerminalSymbol(succ.first))
+            st.add(succ.first, makeShift(target));
+        else
+            st.gotoRow[succ.first - T] = target;
+    }
+
+    set<int> nonassoc;
+    PrecDecision decision;
+    string reason;
+    for (int p : completed) {
+        if (p == 0) {
+            st.add(symbols.endMarker(), makeAccept());
+            continue;
+        }
+        for (int t : followOf[symbols.production(p).lhs])
+            if (placeReduce(grammar, symbols, st, nonassoc, t, p, decision, reason))
+                resolved++;
+    }
+
+    expanded++;
+    buildNs += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - t0).count();
+}
+
+// ===================================================
+// Driver lookups
+// ===================================================
+uint32_t LazyLRAutomaton::getAction(int state, int terminal) {
+    return ensure(state).action[terminal];
+}
+
+int LazyLRAutomaton::getGoto(int state, int nonTerminal) {
+    return ensure(state).gotoRow[nonTerminal];
+}
+
+bool LazyLRAutomaton::recognize(const vector<string> &tokens) {
+    vector<int> ids;
+    if (!symbols.encodeTokens(tokens, ids))
+        return false;
+
+    vector<int> stack = {0};
+    size_t i = 0;
+
+    // Same bound as LR0Parser::recognize() on reductions between
+    // two shifts: a cyclic grammar (A =>+ A) would loop forever
+    const size_t perLevel = 2 * (symbols.nonTerminalCount() + 1);
+    size_t reductionsLeft = 2 * perLevel;
+
+    while (true) {
+        LazyState &st = ensure(stack.back());
+        if (exhausted.load(memory_order_relaxed))
+            return false;                  // a row may miss a shift or GOTO
+
+        uint32_t act = st.action[ids[i]];
+        if (actionTag(act) == ACT_CONFLICT)
+            act = st.conflicts[actionPayload(act)][0];
+
+        switch (actionTag(act)) {
+        case ACT_SHIFT:
+            stack.push_back(actionPayload(act));
+            reductionsLeft = (stack.size() + 1) * perLevel;
+            i++;
+            break;
+
+        case ACT_REDUCE: {
+            if (reductionsLeft-- == 0)
+                return false;
+            const LRProduction &prod = symbols.production(actionPayload(act));
+            stack.resize(stack.size() - prod.length);
+            int target = getGoto(stack.back(), prod.lhs);
+            if (target < 0)
+                return false;
+            stack.push_back(target);
+            break;
+        }
+
+        case ACT_ACCEPT:
+            return i + 1 == ids.size();   // never on a prefix
+
+        default:
+            return false;
+        }
+    }
+}
+
+void LazyLRAutomaton::expandAll() {
+    for (int s = 0; s < discovered.load(memory_order_acquire); ++s)
+        ensure(s);
+}
+
+// ===================================================
+// Persistence
+// Format (text):
+//   GRAMRESOLVE-LAZY-LR 1
+//   fingerprint <hex>
+//   states <n>
+//   state <id> <built 0|1> <k> <prod:dot> ...
+//   action <t>=<code>[|<code>...] ...     (built states only)
+//   goto <A>=<target> ...                  (built states only)
+// ===================================================
+uint64_t LazyLRAutomaton::fingerprint() const {
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&](const string &s) {
+        for (unsigned char c : s)
+            h = (h ^ c) * 1099511628211ull;
+        h = (h ^ 0xff) * 1099511628211ull;
+    };
+
+    for (size_t t = 0; t < symbols.terminalCount(); ++t)
+        mix(symbols.terminalName(static_cast<int>(t)));
+    for (size_t p = 0; p < symbols.getProductions().size(); ++p) {
+        mix(symbols.productionLabel(static_cast<int>(p)));
+        mix(symbols.productionPrecSymbol(static_cast<int>(p)));
+    }
+    for (const auto &entry : grammar.getPrecedence())
+        mix(entry.first + "/" + to_string(entry.second.level) + "/" + to_string(entry.second.assoc));
+
+    return h;
+}
+
+bool LazyLRAutomaton::save(const string &filename) const {
+    if (exhausted.load())
+        return false;
+
+    ofstream out(filename);
+    if (!out) {
+        cerr << "❌ Error: cannot write automaton file " << filename << "\n";
+        return false;
+    }
+
+    int n = discovered.load();
+    out << "GRAMRESOLVE-LAZY-LR 1\n";
+    out << "fingerprint " << hex << fingerprint() << dec << "\n";
+    out << "states " << n << "\n";
+
+    for (int s = 0; s < n; ++s) {
+        const LazyState &st = stateRef(s);
+        bool built = st.ready.load(memory_order_acquire);
+
+        out << "state " << s << " " << built << " " << st.kernel.size();
+        for (uint64_t item : st.kernel)
+            out << " " << itemProduction(item) << ":" << itemDot(item);
+        out << "\n";
+
+        if (!built) continue;
+
+        out << "action";
+        for (size_t t = 0; t < st.action.size(); ++t) {
+            uint32_t act = st.action[t];
+            if (actionTag(act) == ACT_ERROR) continue;
+
+            out << " " << t << "=";
+            if (actionTag(act) == ACT_CONFLICT) {
+                const auto &list = st.conflicts[actionPayload(act)];
+                for (size_t k = 0; k < list.size(); ++k)
+                    out << (k ? "|" : "") << list[k];
+            } else {
+                out << act;
+            }
+        }
+        out << "\n";
+
+        out << "goto";
+        for (size_t A = 0; A < st.gotoRow.size(); ++A)
+            if (st.gotoRow[A] >= 0)
+                out << " " << A << "=" << st.gotoRow[A];
+        out << "\n";
+    }
+
+    return static_cast<bool>(out);
+}
+
+bool LazyLRAutomaton::load(const string &filename) {
+    ifstream in(filename);
+    if (!in) {
+        cerr << "❌ Error: cannot open automaton file " << filename << "\n";
+        return false;
+    }
+
+    auto fail = [&](const string &why) {
+        cerr << "❌ Cannot load automaton from " << filename << ": " << why << "\n";
+        reset();
+        intern({packItem(0, 0)});
+        return false;
+    };
+
+    string line, word;
+    getline(in, line);
+    if (line != "GRAMRESOLVE-LAZY-LR 1")
+        return fail("unknown format");
+
+    uint64_t fp = 0;
+    int n = 0;
+    {
+        getline(in, line);
+        istringstream ss(line);
+        ss >> word >> hex >> fp;
+        if (word != "fingerprint" || fp != fingerprint())
+            return fail("written for a different grammar");
+    }
+    {
+        getline(in, line);
+        istringstream ss(line);
+        ss >> word >> n;
+        if (word != "states" || n <= 0)
+            return fail("bad state count");
+    }
+
+    reset();
+
+    const size_t T = symbols.terminalCount();
+    const size_t N = symbols.nonTerminalCount();
+    const size_t P = symbols.getProductions().size();
+
+    // Whole-word unsigned decimal; false on junk or overflow
+    auto number = [](const string &text, uint64_t &value) {
+        if (text.empty() || !isdigit(static_cast<unsigned char>(text[0]))) return false;
+        try {
+            size_t used = 0;
+            value = stoull(text, &used);
+            return used == text.size();
+        } catch (const exception &) {
+            return false;
+        }
+    };
+
+    // Targets must name states and productions that exist; conflict
+    // lists are rebuilt from the plain actions, never read
+    auto valid = [&](uint32_t act) {
+        switch (actionTag(act)) {
+        case ACT_SHIFT:  return actionPayload(act) < n;
+        case ACT_REDUCE: return static_cast<size_t>(actionPayload(act)) < P;
+        case ACT_ACCEPT: return true;
+        default:         return false;
+        }
+    };
+
+    for (int s = 0; s < n; ++s) {
+        int id = -1, built = 0;
+        size_t k = 0;
+
+        if (!getline(in, line)) return fail("truncated file");
+        istringstream ss(line);
+        ss >> word >> id >> built >> k;
+        if (word != "state" || id != s)
+            return fail("bad state line " + to_string(s));
+
+        vector<uint64_t> kernel;
+        for (size_t i = 0; i < k; ++i) {
+            uint64_t p = 0, dot = 0;
+            char colon = 0;
+            if (!(ss >> p >> colon >> dot) || colon != ':' || p >= P ||
+                dot > static_cast<uint64_t>(symbols.production(static_cast<int>(p)).length))
+                return fail("bad kernel item in state " + to_string(s));
+            kernel.push_back((p << 32) | dot);
+        }
+        int interned = intern(kernel);
+        if (exhausted.load())
+            return fail("automaton limit reached");
+        if (interned != s)
+            return fail("duplicate kernel in state " + to_string(s));
+
+        if (!built) continue;
+
+        LazyState &st = stateRef(s);
+        st.action.assign(T, ACT_ERROR);
+        st.gotoRow.assign(N, -1);
+        st.conflicts.clear();
+
+        if (!getline(in, line)) return fail("truncated file");
+        istringstream as(line);
+        as >> word;
+        if (word != "action") return fail("missing action row in state " + to_string(s));
+        while (as >> word) {
+            size_t eq = word.find('=');
+            uint64_t t = 0;
+            if (eq == string::npos || !number(word.substr(0, eq), t))
+                return fail("bad action entry in state " + to_string(s));
+            if (t >= T) return fail("bad terminal in state " + to_string(s));
+
+            istringstream codes(word.substr(eq + 1));
+            string code;
+            size_t count = 0;
+            while (getline(codes, code, '|')) {
+                uint64_t act = 0;
+                if (!number(code, act) || act > UINT32_MAX || !valid(static_cast<uint32_t>(act)))
+                    return fail("bad action in state " + to_string(s));
+                st.add(static_cast<int>(t), static_cast<uint32_t>(act));
+                count++;
+            }
+            if (count == 0) return fail("bad action entry in state " + to_string(s));
+        }
+
+        if (!getline(in, line)) return fail("truncated file");
+        istringstream gs(line);
+        gs >> word;
+        if (word != "goto") return fail("missing goto row in state " + to_string(s));
+        while (gs >> word) {
+            size_t eq = word.find('=');
+            uint64_t A = 0, target = 0;
+            if (eq == string::npos || !number(word.substr(0, eq), A) || !number(word.substr(eq + 1), target))
+                return fail("bad goto entry in state " + to_string(s));
+            if (A >= N) return fail("bad non-terminal in state " + to_string(s));
+            if (target >= static_cast<uint64_t>(n)) return fail("GOTO target out of range");
+            st.gotoRow[A] = static_cast<int32_t>(target);
+        }
+
+        st.ready.store(true, memory_order_release);
+        expanded++;
+    }
+
+    // Every conflict cell must index a list of this state
+    for (int s = 0; s < n; ++s) {
+        const LazyState &st = stateRef(s);
+        if (!st.ready.load()) continue;
+
+        for (uint32_t act : st.action)
+            if (actionTag(act) == ACT_CONFLICT && static_cast<size_t>(actionPayload(act)) >= st.conflicts.size())
+                return fail("bad conflict entry in state " + to_string(s));
+    }
+
+    return true;
+}
+
+// ===================================================
+// Report
+// ===================================================
+string LazyLRAutomaton::summary() const {
+    std::ostringstream out;
+
+    out << "\n===== Lazy LR Automaton =====\n";
+    out << left << setw(24) << "Discovered states" << ": " << discovered.load() << "\n";
+    out << setw(24) << "Built rows" << ": " << expanded.load() << "\n";
+    if (exhausted.load())
+        out << setw(24) << "Status" << ": automaton limit reached\n";
+    out << setw(24) << "Precedence resolutions" << ": " << resolved.load() << "\n";
+    out << setw(24) << "Row build time" << ": " << fixed << setprecision(3)
+        << buildNs.load() / 1e6 << " ms\n";
+    out << "=============================\n";
+
+    return out.str();
+}
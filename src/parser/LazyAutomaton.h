@@ -0,0 +1,109 @@
+// ===============================================================
+// File: LazyAutomaton.h
+// Description: On-demand LR(0)/SLR automaton. A state's closure,
+//              successors and ACTION/GOTO row are built the first
+//              time a driver looks it up and memoized; lookups from
+//              several threads are safe. A warmed automaton can be
+//              saved and loaded again.
+// ===============================================================
+
+#ifndef LAZY_AUTOMATON_H
+#define LAZY_AUTOMATON_H
+
+#include <string>
+#include <vector>
+#include <set>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include "LRTable.h"
+#include "LR0Core.h"
+#include "../grammar/Grammar.h"
+
+using namespace std;
+
+// ===============================================================
+// Struct: LazyState
+// Kernel items are packed as (production << 32 | dot).
+// The row is filled once, under `once`, then read without locks.
+// ===============================================================
+struct LazyState : ActionRow {
+    vector<uint64_t> kernel;
+    once_flag once;
+    atomic<bool> ready{false};
+
+    vector<int32_t> gotoRow;              // [non-terminal]
+};
+
+// ===============================================================
+// Class: LazyLRAutomaton
+// ===============================================================
+class LazyLRAutomaton {
+private:
+    static const size_t CHUNK_SIZE = 1024;
+    static const size_t MAX_CHUNKS = 4096;
+
+    Grammar grammar;
+    string augmented;
+    LRTable symbols;                       // numbering only, no rows
+
+    LR0Core lr0;                           // closure, successors, reduce order
+    vector<vector<int>> followOf;          // non-terminal → FOLLOW terminal ids
+
+    // State storage: fixed chunk table so published states never move
+    vector<atomic<LazyState*>> chunks;
+    atomic<int> discovered{0};
+    atomic<int> expanded{0};
+    atomic<bool> exhausted{false};         // a successor found no free state slot
+    atomic<size_t> resolved{0};
+    atomic<long long> buildNs{0};
+
+    mutable shared_mutex indexMutex;
+    unordered_map<vector<uint64_t>, int, PackedKernelHash> kernelIndex;
+
+    LazyState& stateRef(int id) const;
+    LazyState& ensure(int id);
+    int intern(vector<uint64_t> kernel);
+    void expand(int id);
+    uint64_t fingerprint() const;
+    void reset();
+
+public:
+    explicit LazyLRAutomaton(const Grammar &g);
+    ~LazyLRAutomaton();
+
+    LazyLRAutomaton(const LazyLRAutomaton &) = delete;
+    LazyLRAutomaton& operator=(const LazyLRAutomaton &) = delete;
+
+    // 🔹 Driver lookups (build the state's row on first use)
+    uint32_t getAction(int state, int terminal);
+    int getGoto(int state, int nonTerminal);
+
+    // Silent parse; tokens may end with "$". Safe to call from
+    // several threads at once.
+    bool recognize(const vector<string> &tokens);
+
+    // Build every reachable row (same states as the eager builder)
+    void expandAll();
+
+    // 🔹 Persistence of the warmed automaton. Not thread-safe;
+    // load() rejects files written for a different grammar.
+    bool save(const string &filename) const;
+    bool load(const string &filename);
+
+    const LRTable& getSymbols() const { return symbols; }
+    int getDiscoveredStates() const { return discovered.load(); }
+    int getExpandedStates() const { return expanded.load(); }
+
+    // Set once a row could not number one of its successors. Rows
+    // are then incomplete: recognize() rejects every input and
+    // save() refuses to write them.
+    bool limitReached() const { return exhausted.load(); }
+
+    // Counters (terminal + report)
+    string summary() const;
+};
+
+#endif
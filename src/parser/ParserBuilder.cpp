@@ -0,0 +1,861 @@
+#include "ParserBuilder.h"
+#include "LR0Core.h"
+#include "../analysis/FirstFollow.h"
+#include "../util/Instrumentation.h"
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <unordered_map>
+#include <map>
+#include <set>
+#include <deque>
+#include <chrono>
+
+using namespace std;
+
+string algorithmName(LRAlgorithm algorithm) {
+    switch (algorithm) {
+    case LRAlgorithm::SLR1:  return "SLR(1)";
+    case LRAlgorithm::LALR1: return "LALR(1)";
+    case LRAlgorithm::LR1:   return "LR(1)";
+    }
+    return "?";
+}
+
+namespace {
+
+typedef vector<uint64_t> Bits;
+
+bool testBit(const Bits &b, int i) { return (b[i / 64] >> (i % 64)) & 1; }
+void setBit(Bits &b, int i) { b[i / 64] |= uint64_t(1) << (i % 64); }
+
+// a |= b; true when a changed
+bool orInto(Bits &a, const Bits &b) {
+    bool changed = false;
+    for (size_t w = 0; w < a.size(); ++w) {
+        uint64_t v = a[w] | b[w];
+        if (v != a[w]) {
+            a[w] = v;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+double elapsedMs(chrono::steady_clock::time_point t0) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+}
+
+// One LR(0) state; SLR and LALR rows are filled on these ids
+struct Core {
+    vector<uint64_t> kernel;                // sorted packed items
+    vector<pair<int, int>> transitions;     // symbol → state, by symbol
+    vector<int> completed;                  // reduced productions, in reduce order
+};
+
+// Canonical LR(1) state: an LR(0) core plus lookaheads
+struct LR1State {
+    int core;
+    vector<pair<int, int>> transitions;     // symbol → LR(1) state
+    vector<Bits> reduceLA;                  // aligned with Core::completed
+};
+
+// ACTION row before it is written to a table
+struct Row : ActionRow {
+    size_t resolved = 0;
+};
+
+// ===================================================
+// Builder — symbol numbering, FIRST/FOLLOW bitsets,
+// the LR(0) automaton and the row builders shared by
+// the three stages
+// ===================================================
+class Builder {
+public:
+    const Grammar &grammar;
+    LRTable symbols;                        // numbering only, no rows
+    int T = 0;                              // terminals incl. "$"
+    int N = 0;
+    int PROPAGATE = 0;                      // extra lookahead bit for LALR propagation
+    size_t words = 0;
+
+    LR0Core lr0;                            // closure, successors, reduce order
+    vector<char> nullable;                  // per non-terminal
+    vector<Bits> followBits;                // per non-terminal
+    vector<vector<Bits>> firstAfter;        // production → position → FIRST
+    vector<vector<char>> nullableAfter;
+
+    vector<Core> cores;
+    unordered_map<vector<uint64_t>, int, PackedKernelHash> coreIndex;
+    vector<int> slot;                       // closure scratch, per production
+
+    explicit Builder(const Grammar &g);
+
+    void computeSets();
+    void buildLR0();
+    int coreTarget(int core, int symbol) const;
+    int kernelPosition(int core, uint64_t item) const;
+
+    void closure1(vector<uint64_t> &items, vector<Bits> &las);
+
+    Row makeRow(const Core &core, const vector<Bits> &las) const;
+    void writeRow(LRTable &table, int state, const vector<pair<int, int>> &transitions, const Row &row) const;
+    vector<int> conflictCells(const Row &row) const;
+
+    vector<Bits> slrLookaheads(const Core &core) const;
+    vector<Bits> lalrLookaheads(vector<Bits> &kernelLA, const vector<size_t> &offset, int state);
+    void computeLALR(vector<Bits> &kernelLA, vector<size_t> &offset);
+
+    bool buildLR1(size_t maxStates, vector<LR1State> &states);
+    vector<int> mergeLR1(const vector<LR1State> &states);
+};
+
+Builder::Builder(const Grammar &g) : grammar(g) {
+    string augmented = grammar.getStartSymbol() + "'";
+    while (grammar.isNonTerminal(augmented))
+        augmented += "'";
+
+    symbols.init(grammar, augmented);
+    T = static_cast<int>(symbols.terminalCount());
+    N = static_cast<int>(symbols.nonTerminalCount());
+    PROPAGATE = T;
+    words = (T + 1 + 63) / 64;
+
+    lr0.init(symbols);
+    slot.assign(symbols.getProductions().size(), -1);
+}
+
+void Builder::computeSets() {
+    FirstFollowEngine ff;
+    ff.computeFIRST(grammar);
+    ff.computeFOLLOW(grammar);
+
+    vector<Bits> first(N, Bits(words, 0));
+    nullable.assign(N, 0);
+    followBits.assign(N, Bits(words, 0));
+
+    for (int A = 1; A < N; ++A) {
+        const string &name = symbols.nonTerminalName(A);
+        nullable[A] = ff.isNullable(name);
+        for (const auto &t : ff.getFIRST(name)) {
+            int id = symbols.terminalId(t);
+            if (id >= 0) setBit(first[A], id);
+        }
+        for (const auto &t : ff.getFOLLOW(name)) {
+            int id = symbols.terminalId(t);
+            if (id >= 0) setBit(followBits[A], id);
+        }
+    }
+    first[0] = first[symbols.production(0).rhs[0] - T];
+    nullable[0] = nullable[symbols.production(0).rhs[0] - T];
+
+    const auto &prods = symbols.getProductions();
+    firstAfter.resize(prods.size());
+    nullableAfter.resize(prods.size());
+
+    for (size_t p = 0; p < prods.size(); ++p) {
+        const LRProduction &rule = prods[p];
+        firstAfter[p].assign(rule.length + 1, Bits(words, 0));
+        nullableAfter[p].assign(rule.length + 1, 1);
+
+        for (int k = rule.length - 1; k >= 0; --k) {
+            int sym = rule.rhs[k];
+            bool symNullable = !symbols.isTerminalSymbol(sym) && nullable[sym - T];
+
+            if (symbols.isTerminalSymbol(sym))
+                setBit(firstAfter[p][k], sym);
+            else
+                orInto(firstAfter[p][k], first[sym - T]);
+
+            nullableAfter[p][k] = symNullable && nullableAfter[p][k + 1];
+            if (symNullable)
+                orInto(firstAfter[p][k], firstAfter[p][k + 1]);
+        }
+    }
+}
+
+// ===================================================
+// LR(0) automaton over packed items (LR0Core)
+// ===================================================
+void Builder::buildLR0() {
+    cores.clear();
+    coreIndex.clear();
+
+    cores.push_back({{packItem(0, 0)}, {}, {}});
+    coreIndex[cores[0].kernel] = 0;
+
+    map<int, vector<uint64_t>> successors;
+    for (size_t s = 0; s < cores.size(); ++s) {
+        lr0.successors(cores[s].kernel, successors, cores[s].completed);
+
+        for (auto &succ : successors) {
+            auto it = coreIndex.find(succ.second);
+            int target;
+            if (it != coreIndex.end()) {
+                target = it->second;
+            } else {
+                target = static_cast<int>(cores.size());
+                coreIndex.emplace(succ.second, target);
+                cores.push_back({succ.second, {}, {}});
+            }
+            cores[s].transitions.push_back({succ.first, target});
+        }
+    }
+}
+
+int Builder::coreTarget(int core, int symbol) const {
+    const auto &tr = cores[core].transitions;
+    auto it = lower_bound(tr.begin(), tr.end(), make_pair(symbol, -1));
+    return (it != tr.end() && it->first == symbol) ? it->second : -1;
+}
+
+int Builder::kernelPosition(int core, uint64_t item) const {
+    const auto &k = cores[core].kernel;
+    return static_cast<int>(lower_bound(k.begin(), k.end(), item) - k.begin());
+}
+
+// ===================================================
+// LR(1) closure: `items` starts as a kernel with its
+// lookaheads; added items get FIRST(β a)
+// ===================================================
+void Builder::closure1(vector<uint64_t> &items, vector<Bits> &las) {
+    deque<size_t> work;
+    for (size_t i = 0; i < items.size(); ++i) work.push_back(i);
+
+    Bits incoming(words);
+    while (!work.empty()) {
+        size_t i = work.front();
+        work.pop_front();
+
+        int p = itemProduction(items[i]);
+        int dot = itemDot(items[i]);
+        const LRProduction &rule = symbols.production(p);
+        if (dot >= rule.length || symbols.isTerminalSymbol(rule.rhs[dot]))
+            continue;
+
+        incoming = firstAfter[p][dot + 1];
+        if (nullableAfter[p][dot + 1])
+            orInto(incoming, las[i]);
+
+        for (int q : lr0.productionsOf(rule.rhs[dot] - T)) {
+            if (slot[q] < 0) {
+                slot[q] = static_cast<int>(items.size());
+                items.push_back(packItem(q, 0));
+                las.push_back(incoming);
+                work.push_back(items.size() - 1);
+            } else if (orInto(las[slot[q]], incoming)) {
+                work.push_back(slot[q]);
+            }
+        }
+    }
+
+    for (uint64_t item : items)
+        if (itemDot(item) == 0) slot[itemProduction(item)] = -1;
+}
+
+// ===================================================
+// Rows — reduce placement and precedence from LR0Core
+// ===================================================
+Row Builder::makeRow(const Core &core, const vector<Bits> &las) const {
+    Row row;
+    row.action.assign(T, ACT_ERROR);
+
+    for (const auto &tr : core.transitions)
+        if (symbols.isTerminalSymbol(tr.first))
+            row.add(tr.first, makeShift(tr.second));
+
+    set<int> nonassoc;
+    PrecDecision decision;
+    string reason;
+    for (size_t k = 0; k < core.completed.size(); ++k) {
+        int p = core.completed[k];
+        if (p == 0) {
+            row.add(symbols.endMarker(), makeAccept());
+            continue;
+        }
+        for (int t = 0; t < T; ++t)
+            if (testBit(las[k], t))
+                row.resolved += placeReduce(grammar, symbols, row, nonassoc, t, p, decision, reason);
+    }
+    return row;
+}
+
+// Row must be empty in `table`; shift targets come from `transitions`
+void Builder::writeRow(LRTable &table, int state, const vector<pair<int, int>> &transitions,
+                       const Row &row) const {
+    for (const auto &tr : transitions) {
+        if (symbols.isTerminalSymbol(tr.first)) continue;
+        table.setGoto(state, tr.first - T, tr.second);
+    }
+
+    for (int t = 0; t < T; ++t) {
+        uint32_t cell = row.action[t];
+        if (cell == ACT_ERROR) continue;
+
+        vector<uint32_t> acts;
+        if (actionTag(cell) == ACT_CONFLICT)
+            acts = row.conflicts[actionPayload(cell)];
+        else
+            acts.push_back(cell);
+
+        for (uint32_t act : acts) {
+            if (actionTag(act) == ACT_SHIFT)
+                act = makeShift(transitions[lower_bound(transitions.begin(), transitions.end(),
+                                                        make_pair(t, -1)) - transitions.begin()].second);
+            table.addAction(state, t, act);
+        }
+    }
+}
+
+vector<int> Builder::conflictCells(const Row &row) const {
+    vector<int> cells;
+    for (int t = 0; t < T; ++t)
+        if (actionTag(row.action[t]) == ACT_CONFLICT) cells.push_back(t);
+    return cells;
+}
+
+vector<Bits> Builder::slrLookaheads(const Core &core) const {
+    vector<Bits> las;
+    for (int p : core.completed)
+        las.push_back(followBits[symbols.production(p).lhs]);
+    return las;
+}
+
+// ===================================================
+// LALR(1) lookaheads by propagation: the closure of
+// each kernel item with a marker lookahead tells which
+// lookaheads arise spontaneously and which propagate
+// ===================================================
+void Builder::computeLALR(vector<Bits> &kernelLA, vector<size_t> &offset) {
+    offset.assign(cores.size() + 1, 0);
+    for (size_t s = 0; s < cores.size(); ++s)
+        offset[s + 1] = offset[s] + cores[s].kernel.size();
+
+    kernelLA.assign(offset.back(), Bits(words, 0));
+    vector<vector<size_t>> edges(offset.back());
+    setBit(kernelLA[0], symbols.endMarker());
+
+    for (size_t s = 0; s < cores.size(); ++s) {
+        for (size_t i = 0; i < cores[s].kernel.size(); ++i) {
+            vector<uint64_t> items = {cores[s].kernel[i]};
+            vector<Bits> las(1, Bits(words, 0));
+            setBit(las[0], PROPAGATE);
+            closure1(items, las);
+
+            for (size_t k = 0; k < items.size(); ++k) {
+                int p = itemProduction(items[k]);
+                int dot = itemDot(items[k]);
+                const LRProduction &rule = symbols.production(p);
+                if (dot >= rule.length) continue;
+
+                int t = coreTarget(static_cast<int>(s), rule.rhs[dot]);
+                size_t g = offset[t] + kernelPosition(t, packItem(p, dot + 1));
+
+                bool propagates = testBit(las[k], PROPAGATE);
+                las[k][PROPAGATE / 64] &= ~(uint64_t(1) << (PROPAGATE % 64));
+                orInto(kernelLA[g], las[k]);
+                if (propagates)
+                    edges[offset[s] + i].push_back(g);
+            }
+        }
+    }
+
+    deque<size_t> work;
+    for (size_t k = 0; k < kernelLA.size(); ++k) work.push_back(k);
+    vector<char> queued(kernelLA.size(), 1);
+
+    while (!work.empty()) {
+        size_t a = work.front();
+        work.pop_front();
+        queued[a] = 0;
+
+        for (size_t b : edges[a])
+            if (orInto(kernelLA[b], kernelLA[a]) && !queued[b]) {
+                queued[b] = 1;
+                work.push_back(b);
+            }
+    }
+}
+
+// Lookaheads of a state's completed items
+vector<Bits> Builder::lalrLookaheads(vector<Bits> &kernelLA, const vector<size_t> &offset, int state) {
+    const Core &core = cores[state];
+    vector<uint64_t> items = core.kernel;
+    vector<Bits> las(kernelLA.begin() + offset[state], kernelLA.begin() + offset[state + 1]);
+    closure1(items, las);
+
+    vector<Bits> result;
+    for (int p : core.completed) {
+        uint64_t done = packItem(p, symbols.production(p).length);
+        size_t k = find(items.begin(), items.end(), done) - items.begin();
+        result.push_back(las[k]);
+    }
+    return result;
+}
+
+// ===================================================
+// Canonical LR(1) automaton; a state is keyed by its
+// core and the lookaheads of the core's kernel items
+// ===================================================
+bool Builder::buildLR1(size_t maxStates, vector<LR1State> &states) {
+    unordered_map<vector<uint64_t>, int, PackedKernelHash> index;
+    vector<vector<Bits>> kernelLAs;
+
+    auto keyOf = [&](int core, const vector<Bits> &las) {
+        vector<uint64_t> key = {static_cast<uint64_t>(core)};
+        for (const auto &b : las) key.insert(key.end(), b.begin(), b.end());
+        return key;
+    };
+
+    vector<Bits> startLA(1, Bits(words, 0));
+    setBit(startLA[0], symbols.endMarker());
+    index[keyOf(0, startLA)] = 0;
+    states.push_back({0, {}, {}});
+    kernelLAs.push_back(startLA);
+
+    for (size_t s = 0; s < states.size(); ++s) {
+        const Core &core = cores[states[s].core];
+        vector<uint64_t> items = core.kernel;
+        vector<Bits> las = kernelLAs[s];
+        closure1(items, las);
+
+        vector<vector<Bits>> succLA(core.transitions.size());
+        for (size_t k = 0; k < core.transitions.size(); ++k)
+            succLA[k].assign(cores[core.transitions[k].second].kernel.size(), Bits(words, 0));
+
+        for (size_t k = 0; k < items.size(); ++k) {
+            int p = itemProduction(items[k]);
+            int dot = itemDot(items[k]);
+            const LRProduction &rule = symbols.production(p);
+            if (dot >= rule.length) continue;
+
+            size_t tr = lower_bound(core.transitions.begin(), core.transitions.end(),
+                                    make_pair(rule.rhs[dot], -1)) - core.transitions.begin();
+            int t = core.transitions[tr].second;
+            orInto(succLA[tr][kernelPosition(t, packItem(p, dot + 1))], las[k]);
+        }
+
+        for (int p : core.completed) {
+            uint64_t done = packItem(p, symbols.production(p).length);
+            size_t k = find(items.begin(), items.end(), done) - items.begin();
+            states[s].reduceLA.push_back(las[k]);
+        }
+
+        for (size_t k = 0; k < core.transitions.size(); ++k) {
+            int t = core.transitions[k].second;
+            vector<uint64_t> key = keyOf(t, succLA[k]);
+            auto it = index.find(key);
+            int target;
+            if (it != index.end()) {
+                target = it->second;
+            } else {
+                if (states.size() >= maxStates)
+                    return false;
+                target = static_cast<int>(states.size());
+                index.emplace(move(key), target);
+                states.push_back({t, {}, {}});
+                kernelLAs.push_back(move(succLA[k]));
+            }
+            states[s].transitions.push_back({core.transitions[k].first, target});
+        }
+    }
+    return true;
+}
+
+// ===================================================
+// Merge canonical states with the same core whenever
+// the merged row gains no conflicted cell, then split
+// groups until successors agree. Returns the class of
+// every canonical state (class 0 holds state 0).
+// ===================================================
+vector<int> Builder::mergeLR1(const vector<LR1State> &states) {
+    vector<vector<int>> membersOf(cores.size());
+    for (size_t s = 0; s < states.size(); ++s)
+        membersOf[states[s].core].push_back(static_cast<int>(s));
+
+    vector<int> cls(states.size(), -1);
+    int classes = 0;
+
+    for (size_t c = 0; c < cores.size(); ++c) {
+        struct Group {
+            int id;
+            vector<Bits> las;
+            vector<int> conflicts;
+        };
+        vector<Group> groups;
+
+        for (int m : membersOf[c]) {
+            if (cores[c].completed.empty() && !groups.empty()) {
+                cls[m] = groups[0].id;
+                continue;
+            }
+
+            vector<int> own = conflictCells(makeRow(cores[c], states[m].reduceLA));
+            bool placed = false;
+
+            for (auto &g : groups) {
+                vector<Bits> merged = g.las;
+                for (size_t k = 0; k < merged.size(); ++k) orInto(merged[k], states[m].reduceLA[k]);
+
+                vector<int> cells = conflictCells(makeRow(cores[c], merged));
+                vector<int> allowed;
+                set_union(g.conflicts.begin(), g.conflicts.end(), own.begin(), own.end(),
+                          back_inserter(allowed));
+                if (!includes(allowed.begin(), allowed.end(), cells.begin(), cells.end()))
+                    continue;
+
+                g.las = merged;
+                g.conflicts = cells;
+                cls[m] = g.id;
+                placed = true;
+                break;
+            }
+
+            if (!placed) {
+                groups.push_back({classes++, states[m].reduceLA, own});
+                cls[m] = groups.back().id;
+            }
+        }
+    }
+
+    // Split classes whose members disagree on a successor class
+    int previous = -1;
+    while (classes != previous) {
+        previous = classes;
+        map<vector<int>, int> signatures;
+        vector<int> next(states.size());
+
+        for (size_t s = 0; s < states.size(); ++s) {
+            vector<int> sig = {cls[s]};
+            for (const auto &tr : states[s].transitions) sig.push_back(cls[tr.second]);
+            auto it = signatures.emplace(sig, static_cast<int>(signatures.size())).first;
+            next[s] = it->second;
+        }
+        cls = next;
+        classes = static_cast<int>(signatures.size());
+    }
+    return cls;
+}
+
+size_t inadequateStates(const Builder &b) {
+    size_t count = 0;
+    for (const auto &core : b.cores) {
+        bool shifts = false;
+        for (const auto &tr : core.transitions)
+            shifts = shifts || b.symbols.isTerminalSymbol(tr.first);
+        if (core.completed.size() > 1 || (core.completed.size() == 1 && shifts))
+            count++;
+    }
+    return count;
+}
+
+} // namespace
+
+// ===================================================
+// build — statistics and LR(0) automaton, then
+// SLR(1) → LALR(1) → LR(1), stopping at the first
+// conflict-free table
+// ===================================================
+ParserBuild ParserBuilder::build(const Grammar &g, const ParserBuildOptions &options) {
+    PhaseTimer timer("parser_select");
+    ParserBuild result;
+    Builder b(g);
+
+    // 🔹 Statistics + LR(0) automaton (shared by SLR and LALR)
+    auto t0 = chrono::steady_clock::now();
+    b.computeSets();
+    b.buildLR0();
+
+    GrammarStats &stats = result.stats;
+    stats.terminals = b.T - 1;
+    stats.nonTerminals = b.N - 1;
+    stats.productions = b.symbols.getProductions().size() - 1;
+    for (int A = 1; A < b.N; ++A) stats.nullableNonTerminals += b.nullable[A];
+    for (const auto &p : b.symbols.getProductions())
+        stats.longestRhs = max(stats.longestRhs, static_cast<size_t>(p.length));
+    stats.lr0States = b.cores.size();
+    stats.inadequateStates = inadequateStates(b);
+    stats.millis = elapsedMs(t0);
+
+    const int states0 = static_cast<int>(b.cores.size());
+
+    // 🔹 SLR(1): every row from FOLLOW sets
+    t0 = chrono::steady_clock::now();
+    LRTable slr = b.symbols;
+    slr.resize(states0);
+
+    BuildStage slrStage{LRAlgorithm::SLR1};
+    for (int s = 0; s < states0; ++s) {
+        Row row = b.makeRow(b.cores[s], b.slrLookaheads(b.cores[s]));
+        b.writeRow(slr, s, b.cores[s].transitions, row);
+        slrStage.resolved += row.resolved;
+    }
+    slrStage.states = slrStage.rowsBuilt = states0;
+    slrStage.conflicts = slr.getConflicts().size();
+    slrStage.millis = elapsedMs(t0);
+    result.stages.push_back(slrStage);
+
+    if (slrStage.conflicts == 0) {
+        result.algorithm = LRAlgorithm::SLR1;
+        result.table = move(slr);
+        result.conflictFree = true;
+        result.reason = stats.inadequateStates == 0
+                            ? "the LR(0) automaton has no inadequate states"
+                            : "FOLLOW sets settle all " + to_string(stats.inadequateStates) +
+                                  " inadequate states";
+        if (slrStage.resolved)
+            result.reason += " (" + to_string(slrStage.resolved) + " cells by precedence)";
+        return result;
+    }
+
+    // Cheapest table with the fewest conflicts so far
+    LRTable best = slr;
+    size_t bestConflicts = slrStage.conflicts;
+    result.algorithm = LRAlgorithm::SLR1;
+
+    set<int> conflicted;
+    for (const auto &c : slr.getConflicts()) conflicted.insert(c.row);
+
+    string capped;
+    if (options.strongest == LRAlgorithm::SLR1)
+        capped = "escalation capped at SLR(1)";
+
+    // 🔹 LALR(1): lookaheads for the rows still in conflict
+    BuildStage lalrStage{LRAlgorithm::LALR1};
+    if (capped.empty()) {
+        t0 = chrono::steady_clock::now();
+        vector<Bits> kernelLA;
+        vector<size_t> offset;
+        b.computeLALR(kernelLA, offset);
+
+        LRTable lalr = move(slr);
+        for (int s : conflicted) {
+            Row row = b.makeRow(b.cores[s], b.lalrLookaheads(kernelLA, offset, s));
+            lalr.clearRow(s);
+            b.writeRow(lalr, s, b.cores[s].transitions, row);
+            lalrStage.resolved += row.resolved;
+        }
+        lalrStage.states = states0;
+        lalrStage.rowsBuilt = conflicted.size();
+        lalrStage.conflicts = lalr.getConflicts().size();
+        lalrStage.millis = elapsedMs(t0);
+        result.stages.push_back(lalrStage);
+
+        if (lalrStage.conflicts == 0) {
+            result.algorithm = LRAlgorithm::LALR1;
+            result.table = move(lalr);
+            result.conflictFree = true;
+            result.reason = "LALR(1) lookaheads remove every SLR(1) conflict (" +
+                            to_string(slrStage.conflicts) + " FOLLOW-set artifacts in " +
+                            to_string(conflicted.size()) + " rows)";
+            return result;
+        }
+
+        if (lalrStage.conflicts < bestConflicts) {
+            best = move(lalr);
+            bestConflicts = lalrStage.conflicts;
+            result.algorithm = LRAlgorithm::LALR1;
+        }
+
+        if (options.strongest == LRAlgorithm::LALR1)
+            capped = "escalation capped at LALR(1)";
+    }
+
+    // 🔹 LR(1): canonical automaton, same-core states merged back
+    if (capped.empty()) {
+        t0 = chrono::steady_clock::now();
+        BuildStage lr1Stage{LRAlgorithm::LR1};
+        vector<LR1State> canonical;
+
+        if (!b.buildLR1(options.maxLR1States, canonical)) {
+            lr1Stage.completed = false;
+            lr1Stage.states = canonical.size();
+            lr1Stage.millis = elapsedMs(t0);
+            result.stages.push_back(lr1Stage);
+
+            result.table = move(best);
+            result.reason = "LR(1) construction stopped at " + to_string(options.maxLR1States) +
+                            " states; keeping " + algorithmName(result.algorithm) + " with " +
+                            to_string(bestConflicts) + " conflicts";
+            return result;
+        }
+
+        vector<int> cls = b.mergeLR1(canonical);
+        int classes = 0;
+        for (int c : cls) classes = max(classes, c + 1);
+
+        // Representative transitions, union of member lookaheads
+        vector<int> rep(classes, -1);
+        vector<vector<Bits>> las(classes);
+        for (size_t s = 0; s < canonical.size(); ++s) {
+            int c = cls[s];
+            if (rep[c] < 0) {
+                rep[c] = static_cast<int>(s);
+                las[c] = canonical[s].reduceLA;
+            } else {
+                for (size_t k = 0; k < las[c].size(); ++k) orInto(las[c][k], canonical[s].reduceLA[k]);
+            }
+        }
+
+        LRTable lr1 = b.symbols;
+        lr1.resize(classes);
+        for (int c = 0; c < classes; ++c) {
+            const LR1State &st = canonical[rep[c]];
+            vector<pair<int, int>> transitions;
+            for (const auto &tr : st.transitions) transitions.push_back({tr.first, cls[tr.second]});
+
+            Row row = b.makeRow(b.cores[st.core], las[c]);
+            b.writeRow(lr1, c, transitions, row);
+            lr1Stage.resolved += row.resolved;
+        }
+
+        lr1Stage.states = classes;
+        lr1Stage.rowsBuilt = classes;
+        lr1Stage.conflicts = lr1.getConflicts().size();
+        lr1Stage.millis = elapsedMs(t0);
+        result.stages.push_back(lr1Stage);
+
+        string sizes = to_string(canonical.size()) + " canonical states merged to " +
+                       to_string(classes) + ", LR(0) has " + to_string(states0);
+
+        if (lr1Stage.conflicts == 0) {
+            result.algorithm = LRAlgorithm::LR1;
+            result.table = move(lr1);
+            result.conflictFree = true;
+            result.reason = "LALR(1) state merging leaves " + to_string(lalrStage.conflicts) +
+                            " conflicts; LR(1) splits them (" + sizes + ")";
+            return result;
+        }
+
+        if (lr1Stage.conflicts < bestConflicts) {
+            best = move(lr1);
+            bestConflicts = lr1Stage.conflicts;
+            result.algorithm = LRAlgorithm::LR1;
+        }
+
+        result.table = move(best);
+        result.reason = "not LR(1): " + to_string(lr1Stage.conflicts) +
+                        " conflicts remain in LR(1) (" + sizes + "), the grammar is likely ambiguous; keeping " +
+                        algorithmName(result.algorithm) + " with " + to_string(bestConflicts) + " conflicts";
+        return result;
+    }
+
+    result.table = move(best);
+    result.reason = capped + "; keeping " + algorithmName(result.algorithm) + " with " +
+                    to_string(bestConflicts) + " conflicts";
+    return result;
+}
+
+// ===================================================
+// Silent driver over the selected table
+// ===================================================
+bool ParserBuilder::recognize(const ParserBuild &build, const vector<string> &tokens,
+                              size_t *stoppedAt) {
+    const LRTable &table = build.table;
+    vector<int> ids;
+    if (!table.encodeTokens(tokens, ids)) {
+        if (stoppedAt) *stoppedAt = ids.size();     // the unknown token
+        return false;
+    }
+
+    vector<int> stack = {0};
+    size_t i = 0, steps = 0;
+    auto reject = [&] {
+        if (stoppedAt) *stoppedAt = i;
+        return false;
+    };
+    Instrumentation::count(Counter::SENTENCES);
+    CountOnExit countSteps(Counter::PARSE_STEPS, steps);
+
+    // Bounded reductions between shifts, see LR0Parser::recognize
+    const size_t perLevel = 2 * (table.nonTerminalCount() + 1);
+    size_t reductionsLeft = 2 * perLevel;
+
+    while (true) {
+        steps++;
+        uint32_t act = table.getAction(stack.back(), ids[i]);
+        if (actionTag(act) == ACT_CONFLICT)
+            act = table.conflictList(act)[0];
+
+        switch (actionTag(act)) {
+        case ACT_SHIFT:
+            stack.push_back(actionPayload(act));
+            reductionsLeft = (stack.size() + 1) * perLevel;
+            i++;
+            break;
+
+        case ACT_REDUCE: {
+            if (reductionsLeft-- == 0)
+                return reject();
+            const LRProduction &prod = table.production(actionPayload(act));
+            stack.resize(stack.size() - prod.length);
+            int target = table.getGoto(stack.back(), prod.lhs);
+            if (target < 0)
+                return reject();
+            stack.push_back(target);
+            break;
+        }
+
+        case ACT_ACCEPT:
+            return i + 1 == ids.size();   // never on a prefix
+
+        default:
+            return reject();
+        }
+    }
+}
+
+// ===================================================
+// Report
+// ===================================================
+template <typename Log>
+void ParserBuilder::display(const ParserBuild &build) {
+    reportAt<Log>(Verbosity::DETAIL, [&](ReportStream &report) {
+        std::ostringstream out;
+        const GrammarStats &st = build.stats;
+
+        out << "\n===== Parser Construction =====\n";
+        out << left << setw(24) << "Grammar" << ": " << st.terminals << " terminals, "
+            << st.nonTerminals << " non-terminals, " << st.productions << " productions\n";
+        out << setw(24) << "Nullable / longest RHS" << ": " << st.nullableNonTerminals << " / "
+            << st.longestRhs << "\n";
+        out << setw(24) << "LR(0) automaton" << ": " << st.lr0States << " states, "
+            << st.inadequateStates << " inadequate (" << fixed << setprecision(3) << st.millis << " ms)\n\n";
+
+        out << setw(10) << "Stage" << setw(12) << "Time (ms)" << setw(9) << "States"
+            << setw(7) << "Rows" << "Conflicts\n";
+        for (const auto &stage : build.stages) {
+            report.emit(ReportEvent("parser_stage")
+                            .add("algorithm", algorithmName(stage.algorithm))
+                            .add("micros", static_cast<int64_t>(stage.millis * 1000))
+                            .add("states", stage.states)
+                            .add("rows", stage.rowsBuilt)
+                            .add("conflicts", stage.conflicts)
+                            .add("resolved", stage.resolved)
+                            .add("completed", static_cast<int>(stage.completed)));
+            out << setw(10) << algorithmName(stage.algorithm) << setw(12) << fixed << setprecision(3)
+                << stage.millis << setw(9) << stage.states << setw(7) << stage.rowsBuilt;
+            if (stage.completed)
+                out << stage.conflicts << "\n";
+            else
+                out << "(state budget exceeded)\n";
+        }
+
+        out << "\n" << (build.conflictFree ? "✅ " : "⚠️  ") << "Selected "
+            << algorithmName(build.algorithm) << " (" << build.table.stateCount() << " states): "
+            << build.reason << "\n";
+        out << "===============================\n";
+
+        report.emit(ReportEvent("parser_selection")
+                        .add("algorithm", algorithmName(build.algorithm))
+                        .add("states", build.table.stateCount())
+                        .add("conflict_free", static_cast<int>(build.conflictFree))
+                        .add("reason", build.reason));
+        report.emit(ReportEvent("message").add("text", out.str()));
+    });
+}
+
+#ifndef GRAMRESOLVE_NO_REPORT
+template void ParserBuilder::display<ReportLog>(const ParserBuild &);
+#endif
+template void ParserBuilder::display<SilentLog>(const ParserBuild &);
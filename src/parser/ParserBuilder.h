@@ -0,0 +1,99 @@
+// ===============================================================
+// File: ParserBuilder.h
+// Description: One entry point that builds the cheapest LR table
+//              that works for a grammar. Grammar statistics and the
+//              LR(0) automaton come first; SLR(1) rows are filled
+//              from FOLLOW sets, rows still in conflict get LALR(1)
+//              lookaheads, and only if conflicts remain is the
+//              canonical LR(1) automaton built and its same-core
+//              states merged back wherever that adds no conflict.
+// ===============================================================
+
+#ifndef PARSER_BUILDER_H
+#define PARSER_BUILDER_H
+
+#include <string>
+#include <vector>
+#include "LRTable.h"
+#include "../grammar/Grammar.h"
+#include "../report/ReportPolicy.h"
+
+using namespace std;
+
+enum class LRAlgorithm {
+    SLR1,
+    LALR1,
+    LR1
+};
+
+string algorithmName(LRAlgorithm algorithm);
+
+// ===============================================================
+// Struct: GrammarStats
+// Cheap numbers gathered before any table is filled
+// ===============================================================
+struct GrammarStats {
+    size_t terminals = 0;
+    size_t nonTerminals = 0;
+    size_t productions = 0;
+    size_t nullableNonTerminals = 0;
+    size_t longestRhs = 0;
+    size_t lr0States = 0;
+    size_t inadequateStates = 0;    // a completed item next to another item
+    double millis = 0.0;            // FIRST/FOLLOW + LR(0) automaton
+};
+
+// ===============================================================
+// Struct: BuildStage
+// ===============================================================
+struct BuildStage {
+    LRAlgorithm algorithm;
+    double millis = 0.0;
+    size_t states = 0;
+    size_t rowsBuilt = 0;           // rows (re)filled by this stage
+    size_t conflicts = 0;           // conflict records left in the table
+    size_t resolved = 0;            // precedence decisions
+    bool completed = true;          // false: gave up on the state budget
+};
+
+// ===============================================================
+// Struct: ParserBuild
+// ===============================================================
+struct ParserBuild {
+    LRAlgorithm algorithm = LRAlgorithm::SLR1;
+    LRTable table;
+    GrammarStats stats;
+    vector<BuildStage> stages;
+    string reason;
+    bool conflictFree = false;
+};
+
+// ===============================================================
+// Struct: ParserBuildOptions
+// ===============================================================
+struct ParserBuildOptions {
+    LRAlgorithm strongest = LRAlgorithm::LR1;   // do not escalate past this
+    size_t maxLR1States = 200000;               // canonical LR(1) budget
+};
+
+// ===============================================================
+// Class: ParserBuilder
+// ===============================================================
+class ParserBuilder {
+public:
+    static ParserBuild build(const Grammar &g, const ParserBuildOptions &options = ParserBuildOptions());
+
+    // Silent driver over a built table; tokens may end with "$".
+    // A conflicted cell takes its first action. On rejection
+    // `stoppedAt` gets the index of the offending token
+    // (tokens.size() = the end of the input).
+    static bool recognize(const ParserBuild &build, const vector<string> &tokens,
+                          size_t *stoppedAt = nullptr);
+
+    // Stages, timings and the choice: one parser_stage event per
+    // stage, a parser_selection event, and the table as text
+    template <typename Log = DefaultLog>
+    static void display(const ParserBuild &build);
+};
+
+#endif
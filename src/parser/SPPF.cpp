@@ -0,0 +1,191 @@
+#include "SPPF.h"
+#include <sstream>
+#include <algorithm>
+
+using namespace std;
+
+// ===================================================
+// Reset forest
+// ===================================================
+void SPPF::clear() {
+    nodes.clear();
+    packedNodes.clear();
+    index.clear();
+    root = -1;
+}
+
+// ===================================================
+// Find or create a shared symbol node
+// ===================================================
+int SPPF::getNode(const string &label, size_t start, size_t end, bool terminal) {
+    auto key = make_tuple(label, start, end);
+    auto it = index.find(key);
+    if (it != index.end())
+        return it->second;
+
+    int id = static_cast<int>(nodes.size());
+    nodes.push_back({label, start, end, terminal, {}});
+    index.emplace(key, id);
+    return id;
+}
+
+// ===================================================
+// Add a packed (derivation) node below a symbol node
+// ===================================================
+bool SPPF::addPacked(int node, int production, const vector<int> &children) {
+    for (int p : nodes[node].packed) {
+        const SPPFPacked &existing = packedNodes[p];
+        if (existing.production == production && existing.children == children)
+            return false;
+    }
+
+    nodes[node].packed.push_back(static_cast<int>(packedNodes.size()));
+    packedNodes.push_back({production, children});
+    return true;
+}
+
+// ===================================================
+// Statistics
+// ===================================================
+size_t SPPF::ambiguousNodes() const {
+    size_t count = 0;
+    for (const auto &n : nodes)
+        if (n.packed.size() > 1)
+            count++;
+    return count;
+}
+
+size_t SPPF::edgeCount() const {
+    size_t count = 0;
+    for (const auto &p : packedNodes)
+        count += p.children.size();
+    return count;
+}
+
+uint64_t SPPF::countTrees() const {
+    if (root < 0) return 0;
+
+    const uint64_t INF = UINT64_MAX;
+    // 0 = unvisited, 1 = in progress, 2 = done
+    vector<int> mark(nodes.size(), 0);
+    vector<uint64_t> memo(nodes.size(), 0);
+
+    auto satAdd = [&](uint64_t a, uint64_t b) {
+        return (a > INF - b) ? INF : a + b;
+    };
+    auto satMul = [&](uint64_t a, uint64_t b) {
+        if (a == 0 || b == 0) return uint64_t(0);
+        return (a > INF / b) ? INF : a * b;
+    };
+
+    // Post-order with an explicit stack, so deep forests do not
+    // exhaust the call stack. A frame walks the children of one
+    // packed node after another; a child still in progress is a
+    // cycle, which counts as infinitely many trees.
+    struct Frame {
+        int node;
+        size_t packed = 0;      // index into nodes[node].packed
+        size_t child = 0;       // index into that packed node's children
+        uint64_t total = 0;
+        uint64_t product = 1;
+    };
+    vector<Frame> work = {{root}};
+    mark[root] = 1;
+
+    while (!work.empty()) {
+        size_t top = work.size() - 1;
+        const SPPFNode &node = nodes[work[top].node];
+
+        if (node.packed.empty()) {
+            work[top].total = 1;        // leaf (terminal or ε)
+        } else if (work[top].packed < node.packed.size()) {
+            const auto &children = packedNodes[node.packed[work[top].packed]].children;
+            if (work[top].child < children.size()) {
+                int c = children[work[top].child];
+                if (mark[c] == 0) {
+                    mark[c] = 1;
+                    work.push_back({c});
+                    continue;           // revisit this child once it is done
+                }
+                work[top].product = satMul(work[top].product, mark[c] == 2 ? memo[c] : INF);
+                work[top].child++;
+                continue;
+            }
+            work[top].total = satAdd(work[top].total, work[top].product);
+            work[top].packed++;
+            work[top].child = 0;
+            work[top].product = 1;
+            continue;
+        }
+
+        mark[work[top].node] = 2;
+        memo[work[top].node] = work[top].total;
+        work.pop_back();
+    }
+
+    return memo[root];
+}
+
+// ===================================================
+// Display helpers
+// ===================================================
+string SPPF::nodeName(int node) const {
+    const SPPFNode &n = nodes[node];
+    return n.label + "[" + to_string(n.start) + "," + to_string(n.end) + "]";
+}
+
+string SPPF::toString() const {
+    std::ostringstream out;
+
+    if (root < 0) {
+        out << "(empty forest)\n";
+        return out.str();
+    }
+
+    // Collect nodes reachable from the root in depth-first order
+    vector<int> order;
+    vector<bool> seen(nodes.size(), false);
+    vector<int> work = {root};
+    while (!work.empty()) {
+        int n = work.back();
+        work.pop_back();
+        if (seen[n]) continue;
+        seen[n] = true;
+        order.push_back(n);
+
+        for (auto p = nodes[n].packed.rbegin(); p != nodes[n].packed.rend(); ++p) {
+            const auto &kids = packedNodes[*p].children;
+            for (auto c = kids.rbegin(); c != kids.rend(); ++c)
+                if (!seen[*c]) work.push_back(*c);
+        }
+    }
+
+    for (int n : order) {
+        if (nodes[n].packed.empty()) continue;
+
+        out << nodeName(n);
+        if (nodes[n].packed.size() > 1)
+            out << "  (ambiguous: " << nodes[n].packed.size() << " derivations)";
+        out << "\n";
+
+        for (int p : nodes[n].packed) {
+            const SPPFPacked &pk = packedNodes[p];
+            out << "    ";
+            if (pk.production >= 0 && pk.production < static_cast<int>(ruleLabels.size()))
+                out << ruleLabels[pk.production];
+            else
+                out << "rule#" << pk.production;
+            out << "  :  ";
+
+            if (pk.children.empty())
+                out << "ε";
+            for (size_t i = 0; i < pk.children.size(); ++i) {
+                if (i) out << " ";
+                out << nodeName(pk.children[i]);
+            }
+            out << "\n";
+        }
+    }
+
+    return out.str();
+}
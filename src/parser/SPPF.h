@@ -0,0 +1,88 @@
+// ===============================================================
+// File: SPPF.h
+// Description: Shared Packed Parse Forest used by the generalized
+//              parsers. Symbol nodes are shared by (label, start, end),
+//              packed nodes hold one derivation of their parent each.
+// ===============================================================
+
+#ifndef SPPF_H
+#define SPPF_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <tuple>
+#include <cstdint>
+
+using namespace std;
+
+// ===============================================================
+// Struct: SPPFPacked
+// One way of deriving a symbol node: production + child nodes
+// ===============================================================
+struct SPPFPacked {
+    int production;          // index into SPPF rule labels
+    vector<int> children;    // symbol node ids, left to right
+};
+
+// ===============================================================
+// Struct: SPPFNode
+// A symbol (terminal, non-terminal or ε) spanning [start, end)
+// ===============================================================
+struct SPPFNode {
+    string label;
+    size_t start;
+    size_t end;
+    bool terminal;
+    vector<int> packed;      // ids into SPPF packed nodes
+};
+
+// ===============================================================
+// Class: SPPF
+// ===============================================================
+class SPPF {
+private:
+    vector<SPPFNode> nodes;
+    vector<SPPFPacked> packedNodes;
+    vector<string> ruleLabels;                       // production id → "A -> α"
+    map<tuple<string, size_t, size_t>, int> index;   // (label, start, end) → node
+    int root = -1;
+
+public:
+    SPPF() = default;
+
+    void clear();
+
+    // Register production names used by packed nodes
+    void setRuleLabels(const vector<string> &labels) { ruleLabels = labels; }
+
+    // Find or create the node for (label, start, end)
+    int getNode(const string &label, size_t start, size_t end, bool terminal = false);
+
+    // Attach a derivation to a node, ignoring duplicates.
+    // Returns true when the derivation is new.
+    bool addPacked(int node, int production, const vector<int> &children);
+
+    void setRoot(int node) { root = node; }
+    int getRoot() const { return root; }
+
+    const vector<SPPFNode>& getNodes() const { return nodes; }
+    const vector<SPPFPacked>& getPacked() const { return packedNodes; }
+
+    // Number of symbol nodes with more than one derivation
+    size_t ambiguousNodes() const;
+
+    // Child links of all packed nodes
+    size_t edgeCount() const;
+
+    // Number of distinct parse trees below the root (saturates,
+    // returns UINT64_MAX for cyclic forests)
+    uint64_t countTrees() const;
+
+    // Human readable dump of the forest reachable from the root
+    string toString() const;
+
+    string nodeName(int node) const;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#include "UnitRuleElimination.h"
+
+using namespace std;
+
+// ===================================================
+// Find unit-reduce states and redirect GOTOs into them
+// ===================================================
+vector<UnitBypass> UnitRuleEliminator::apply(LRTable &table, const set<int> &keep) {
+    int S = table.stateCount();
+    int T = static_cast<int>(table.terminalCount());
+    int N = static_cast<int>(table.nonTerminalCount());
+
+    // A state qualifies when every non-error action is the same
+    // reduction by a chain production and it has no GOTO entries
+    vector<int> unitProd(S, -1);
+    for (int q = 0; q < S; ++q) {
+        uint32_t only = ACT_ERROR;
+        bool ok = true;
+
+        for (int t = 0; t < T && ok; ++t) {
+            uint32_t a = table.getAction(q, t);
+            if (a == ACT_ERROR) continue;
+            if (actionTag(a) != ACT_REDUCE || (only != ACT_ERROR && a != only))
+                ok = false;
+            only = a;
+        }
+        for (int A = 0; A < N && ok; ++A)
+            if (table.getGoto(q, A) >= 0)
+                ok = false;
+
+        if (!ok || only == ACT_ERROR) continue;
+
+        int p = actionPayload(only);
+        const LRProduction &prod = table.production(p);
+        if (p != 0 && prod.length == 1 && !table.isTerminalSymbol(prod.rhs[0]) && !keep.count(p))
+            unitProd[q] = p;
+    }
+
+    // Follow chains on the original table, then write back
+    vector<UnitBypass> bypasses;
+    size_t limit = table.getProductions().size();
+
+    for (int p = 0; p < S; ++p) {
+        for (int B = 0; B < N; ++B) {
+            int q = table.getGoto(p, B);
+            if (q < 0 || unitProd[q] < 0) continue;
+
+            UnitBypass bp{p, B, q, q, {}};
+            while (bp.target >= 0 && unitProd[bp.target] >= 0 && bp.chain.size() <= limit) {
+                int r = unitProd[bp.target];
+                bp.chain.push_back(r);
+                bp.target = table.getGoto(p, table.production(r).lhs);
+            }
+
+            if (bp.target >= 0 && bp.chain.size() <= limit)
+                bypasses.push_back(bp);
+        }
+    }
+
+    for (const auto &bp : bypasses)
+        table.setGoto(bp.state, bp.symbol, bp.target);
+
+    return bypasses;
+}
+
+// ===================================================
+// Restore original GOTO entries
+// ===================================================
+void UnitRuleEliminator::restore(LRTable &table, const vector<UnitBypass> &bypasses) {
+    for (const auto &bp : bypasses)
+        table.setGoto(bp.state, bp.symbol, bp.originalTarget);
+}
@@ -0,0 +1,46 @@
+// ===============================================================
+// File: UnitRuleElimination.h
+// Description: Table-level removal of chain (unit) productions.
+//              A GOTO entry that leads into a state whose only action
+//              is "reduce A -> B" is redirected to the state the parser
+//              would reach after that reduction, so chains such as
+//              E -> T -> F cost no parse steps.
+// ===============================================================
+
+#ifndef UNIT_RULE_ELIMINATION_H
+#define UNIT_RULE_ELIMINATION_H
+
+#include <vector>
+#include <set>
+#include "LRTable.h"
+
+using namespace std;
+
+// ===============================================================
+// Struct: UnitBypass
+// One rewritten GOTO entry. `chain` lists the skipped unit
+// productions innermost first, so a tree builder can wrap the
+// node for `symbol` back into them.
+// ===============================================================
+struct UnitBypass {
+    int state;               // state the GOTO is taken from
+    int symbol;              // non-terminal id (B in A -> B)
+    int originalTarget;      // unit-reduce state reached before
+    int target;              // state reached after the bypass
+    vector<int> chain;       // skipped production ids
+};
+
+// ===============================================================
+// Class: UnitRuleEliminator
+// ===============================================================
+class UnitRuleEliminator {
+public:
+    // Rewrite GOTO entries of `table` in place. Productions listed in
+    // `keep` (e.g. ones with a semantic action) are never bypassed.
+    static vector<UnitBypass> apply(LRTable &table, const set<int> &keep = {});
+
+    // Undo a previous apply() using its records
+    static void restore(LRTable &table, const vector<UnitBypass> &bypasses);
+};
+
+#endif
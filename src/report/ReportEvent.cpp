@@ -0,0 +1,99 @@
+#include "ReportEvent.h"
+#include "ReportSinks.h"
+
+using namespace std;
+
+// ======================================
+// Fields
+// ======================================
+ReportEvent& ReportEvent::add(const string &key, const string &value) {
+    Field f;
+    f.key = key;
+    f.kind = TEXT;
+    f.text = value;
+    fields.push_back(move(f));
+    return *this;
+}
+
+ReportEvent& ReportEvent::add(const string &key, int64_t value) {
+    Field f;
+    f.key = key;
+    f.kind = INTEGER;
+    f.integer = value;
+    fields.push_back(move(f));
+    return *this;
+}
+
+ReportEvent& ReportEvent::add(const string &key, const vector<string> &values) {
+    Field f;
+    f.key = key;
+    f.kind = LIST;
+    f.list = values;
+    fields.push_back(move(f));
+    return *this;
+}
+
+const ReportEvent::Field* ReportEvent::find(const string &key) const {
+    for (const auto &f : fields)
+        if (f.key == key) return &f;
+    return nullptr;
+}
+
+const string& ReportEvent::text(const string &key) const {
+    static const string empty;
+    const Field *f = find(key);
+    return f ? f->text : empty;
+}
+
+int64_t ReportEvent::integer(const string &key) const {
+    const Field *f = find(key);
+    return f ? f->integer : 0;
+}
+
+const vector<string>& ReportEvent::list(const string &key) const {
+    static const vector<string> empty;
+    const Field *f = find(key);
+    return f ? f->list : empty;
+}
+
+// ======================================
+// Stream — text renderer attached by default
+// ======================================
+ReportStream::ReportStream() {
+    addSink(unique_ptr<ReportSink>(new TextRenderer()));
+}
+
+ReportStream& ReportStream::get() {
+    static ReportStream instance;
+    return instance;
+}
+
+void ReportStream::addSink(unique_ptr<ReportSink> sink) {
+    lock_guard<mutex> guard(lock);
+    if (sink->verbosity() > loudest.load()) loudest = sink->verbosity();
+    sinks.push_back(move(sink));
+}
+
+void ReportStream::clearSinks() {
+    lock_guard<mutex> guard(lock);
+    for (auto &sink : sinks)
+        sink->flush();
+    sinks.clear();
+    loudest = Verbosity::QUIET;
+}
+
+void ReportStream::emit(const ReportEvent &event, Verbosity level) {
+    if (!listening(level)) return;
+
+    lock_guard<mutex> guard(lock);
+    emitted[static_cast<int>(level)]++;
+    for (auto &sink : sinks)
+        if (level <= sink->verbosity())
+            sink->write(event);
+}
+
+void ReportStream::flush() {
+    lock_guard<mutex> guard(lock);
+    for (auto &sink : sinks)
+        sink->flush();
+}
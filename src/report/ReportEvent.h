@@ -0,0 +1,134 @@
+// ===============================================================
+// File: ReportEvent.h
+// Description: The report as a stream of small structured events
+//              (a grammar production, one FIRST set, one table cell,
+//              one conflict, ...). display() functions emit events;
+//              sinks turn them into text, JSON Lines or binary
+//              records as they arrive, so no sink ever holds the
+//              whole report.
+// ===============================================================
+
+#ifndef REPORT_EVENT_H
+#define REPORT_EVENT_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <mutex>
+#include <atomic>
+
+using namespace std;
+
+// How much a sink wants to see; an event reaches the sinks whose
+// verbosity is at least the event's level
+enum class Verbosity {
+    QUIET = 0,          // nothing
+    SUMMARY = 1,        // progress lines ("Building ...", state counts)
+    DETAIL = 2,         // full dumps: grammar, sets, tables, states, conflicts
+    RENDERED = 3        // pre-rendered text of a whole structure (parse forests);
+                        // the text renderer's default, structured sinks opt in
+};
+
+// ===============================================================
+// Class: ReportEvent
+// A type ("production", "first", "ll1_entry", ...) and an ordered
+// list of named fields. A field holds a string, an integer or a
+// list of strings.
+// ===============================================================
+class ReportEvent {
+public:
+    enum FieldKind { TEXT, INTEGER, LIST };
+
+    struct Field {
+        string key;
+        FieldKind kind = TEXT;
+        string text;
+        int64_t integer = 0;
+        vector<string> list;
+    };
+
+    explicit ReportEvent(const string &type) : type(type) {}
+
+    ReportEvent& add(const string &key, const string &value);
+    ReportEvent& add(const string &key, const char *value) { return add(key, string(value)); }
+    ReportEvent& add(const string &key, int64_t value);
+    ReportEvent& add(const string &key, int value) { return add(key, static_cast<int64_t>(value)); }
+    ReportEvent& add(const string &key, size_t value) { return add(key, static_cast<int64_t>(value)); }
+    ReportEvent& add(const string &key, const vector<string> &values);
+
+    const string& getType() const { return type; }
+    const vector<Field>& getFields() const { return fields; }
+
+    // Field lookup for renderers; a missing field reads as empty / 0
+    const string& text(const string &key) const;
+    int64_t integer(const string &key) const;
+    const vector<string>& list(const string &key) const;
+
+private:
+    string type;
+    vector<Field> fields;
+
+    const Field* find(const string &key) const;
+};
+
+// ===============================================================
+// Class: ReportSink
+// ===============================================================
+class ReportSink {
+private:
+    Verbosity level;
+
+public:
+    explicit ReportSink(Verbosity level = Verbosity::DETAIL) : level(level) {}
+    virtual ~ReportSink() {}
+
+    Verbosity verbosity() const { return level; }
+
+    virtual void write(const ReportEvent &event) = 0;
+    virtual void flush() {}
+};
+
+// ===============================================================
+// Class: ReportStream
+// Global event stream (singleton, like ReportWriter). The text
+// renderer is attached from the start, so the terminal and
+// report.txt look the same as before; structured sinks are added
+// by the caller.
+// ===============================================================
+class ReportStream {
+private:
+    // Sinks are not thread-safe: events from several threads are
+    // written one at a time
+    mutable mutex lock;
+    vector<unique_ptr<ReportSink>> sinks;
+    atomic<Verbosity> loudest{Verbosity::QUIET};    // highest sink verbosity
+    atomic<size_t> emitted[static_cast<int>(Verbosity::RENDERED) + 1] = {};   // by level
+
+    ReportStream();
+
+public:
+    static ReportStream& get();
+
+    void addSink(unique_ptr<ReportSink> sink);
+    void clearSinks();                  // the text renderer included
+
+    // Whether any sink takes events of `level`; callers check this
+    // before formatting anything
+    bool listening(Verbosity level) const {
+        return level <= loudest.load(memory_order_relaxed);
+    }
+
+    void emit(const ReportEvent &event, Verbosity level = Verbosity::DETAIL);
+    void flush();
+
+    // Events emitted up to `level`: what a sink of that verbosity got
+    size_t eventCount(Verbosity level = Verbosity::RENDERED) const {
+        size_t count = 0;
+        for (int l = 0; l <= static_cast<int>(level); ++l)
+            count += emitted[l];
+        return count;
+    }
+};
+
+#endif
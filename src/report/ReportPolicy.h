@@ -0,0 +1,63 @@
+// ===============================================================
+// File: ReportPolicy.h
+// Description: Compile-time logging policies for the analysis
+//              classes. Their build and display functions are
+//              templates over a policy:
+//                ReportLog — format and emit, but only when some
+//                            sink listens at the event's level
+//                SilentLog — every reporting path is discarded at
+//                            compile time
+//              DefaultLog is ReportLog unless the build defines
+//              GRAMRESOLVE_NO_REPORT (make REPORT=0).
+// ===============================================================
+
+#ifndef REPORT_POLICY_H
+#define REPORT_POLICY_H
+
+#include <string>
+#include "ReportEvent.h"
+
+using namespace std;
+
+struct ReportLog {
+    static constexpr bool enabled = true;
+};
+
+struct SilentLog {
+    static constexpr bool enabled = false;
+};
+
+#ifdef GRAMRESOLVE_NO_REPORT
+typedef SilentLog DefaultLog;
+#else
+typedef ReportLog DefaultLog;
+#endif
+
+// Whether the policy reports and a sink takes `level`
+template <typename Log>
+inline bool reportsAt(Verbosity level) {
+    if constexpr (Log::enabled)
+        return ReportStream::get().listening(level);
+    else
+        return false;
+}
+
+// Run `format(stream)` only if the policy reports and a sink takes
+// `level`; with SilentLog the call is not even compiled
+template <typename Log, typename Format>
+inline void reportAt(Verbosity level, [[maybe_unused]] Format &&format) {
+    if constexpr (Log::enabled) {
+        ReportStream &stream = ReportStream::get();
+        if (stream.listening(level)) format(stream);
+    }
+}
+
+// A progress line rendered as-is by the text renderer
+template <typename Log, typename Format>
+inline void reportMessage(Format &&format) {
+    reportAt<Log>(Verbosity::SUMMARY, [&](ReportStream &stream) {
+        stream.emit(ReportEvent("message").add("text", string(format())), Verbosity::SUMMARY);
+    });
+}
+
+#endif
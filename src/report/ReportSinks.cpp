@@ -0,0 +1,535 @@
+#include "ReportSinks.h"
+#include "reportWriter.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+using namespace std;
+
+// Tree count and forest of an accepted parse; -1 = overflow. The
+// forest itself arrives just before, as a forest_text event.
+static void renderForest(const ReportEvent &event, const string &forest, ostringstream &out) {
+    out << "SPPF symbol nodes : " << event.integer("symbol_nodes") << "\n";
+    out << "SPPF packed nodes : " << event.integer("packed_nodes") << "\n";
+    out << "Ambiguous nodes   : " << event.integer("ambiguous_nodes") << "\n";
+
+    if (forest.empty()) return;
+    out << "Parse trees       : ";
+    if (event.integer("trees") < 0) out << "infinitely many / overflow";
+    else out << event.integer("trees");
+    out << "\n\n" << forest;
+}
+
+static string joinList(const vector<string> &items, const string &sep) {
+    string out;
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (i) out += sep;
+        out += items[i];
+    }
+    return out;
+}
+
+// ======================================
+// Text — the classic report layout
+// ======================================
+static const int64_t SHOWN_CHANGES = 20;   // table changes listed per grammar edit
+
+void TextRenderer::write(const ReportEvent &event) {
+    render(event);
+}
+
+void TextRenderer::render(const ReportEvent &event) {
+    const string &type = event.getType();
+    std::ostringstream out;
+
+    // 🔹 Grammar
+    if (type == "grammar") {
+        out << "===== Grammar =====\n";
+        out << "Start Symbol: " << event.text("start") << "\n\nProductions:\n";
+        precedenceStarted = false;
+    } else if (type == "production") {
+        const auto &alts = event.list("alternatives");
+        const auto &precs = event.list("prec");
+        out << event.text("lhs") << " -> ";
+        for (size_t i = 0; i < alts.size(); ++i) {
+            out << alts[i];
+            if (i < precs.size() && !precs[i].empty())
+                out << " %prec " << precs[i];
+            if (i < alts.size() - 1)
+                out << " | ";
+        }
+        out << "\n";
+    } else if (type == "symbols") {
+        const auto &names = event.list("names");
+        out << (event.text("kind") == "terminals" ? "\nTerminals (" : "\nNon-terminals (")
+            << names.size() << "): " << joinList(names, ", ");
+    } else if (type == "precedence") {
+        if (!precedenceStarted) out << "\nPrecedence (lowest first):\n";
+        precedenceStarted = true;
+        out << "  " << event.text("assoc");
+        for (const auto &t : event.list("operators"))
+            out << " " << t;
+        out << "\n";
+    }
+
+    // 🔹 FIRST / FOLLOW
+    else if (type == "first_follow") {
+        out << "\n===== FIRST & FOLLOW Sets =====\n";
+        out << "\nFIRST sets:\n";
+        followStarted = false;
+    } else if (type == "first") {
+        out << "FIRST(" << event.text("symbol") << ") = { " << joinList(event.list("set"), ", ") << " }\n";
+    } else if (type == "follow") {
+        if (!followStarted) out << "\nFOLLOW sets:\n";
+        followStarted = true;
+        out << "FOLLOW(" << event.text("symbol") << ") = { " << joinList(event.list("set"), ", ") << " }\n";
+    }
+
+    // 🔹 LL(1) table
+    else if (type == "ll1_table") {
+        out << "\n=== LL(1) Parsing Table ===\n";
+    } else if (type == "ll1_entry") {
+        out << "(" << event.text("nonterminal") << ", " << event.text("terminal")
+            << ") => " << event.text("production") << "\n";
+    }
+
+    // 🔹 LR(0) states (ACTION/GOTO cells are for structured sinks)
+    else if (type == "lr_states") {
+        out << "\n===== Canonical Collection of LR(0) Items =====\n";
+    } else if (type == "lr_state") {
+        out << "State " << event.integer("id") << ":\n";
+        for (const auto &item : event.list("items"))
+            out << "  " << item << "\n";
+        out << "\n";
+    }
+
+    // 🔹 Conflicts
+    else if (type == "conflicts") {
+        conflictCount = event.integer("count");
+        if (conflictCount == 0) {
+            out << "✅ No conflicts detected!\n";
+        } else {
+            out << "\n⚠️  Conflicts detected:\n";
+            out << left << setw(30) << "Type"
+                << setw(25) << "Location"
+                << "Details\n";
+            out << string(80, '-') << "\n";
+        }
+    } else if (type == "conflict") {
+        const auto &details = event.list("details");
+        out << left << setw(30) << event.text("kind")
+            << setw(25) << event.text("location");
+        if (!details.empty())
+            out << details[0];
+        out << "\n";
+        for (size_t i = 1; i < details.size(); ++i)
+            out << setw(55) << " " << details[i] << "\n";
+    }
+
+    // 🔹 Unit-rule elimination and grammar edits
+    else if (type == "unit_rules") {
+        out << "\n🔗 Unit-rule elimination: " << event.integer("bypassed") << " GOTO entries bypassed\n";
+    } else if (type == "unit_bypass") {
+        out << "   GOTO(" << event.integer("state") << ", " << event.text("nonterminal") << "): "
+            << event.integer("from") << " → " << event.integer("to") << "  skips";
+        for (const auto &label : event.list("skips"))
+            out << " [" << label << "]";
+        out << "\n";
+    } else if (type == "grammar_edit") {
+        out << "\n🔁 Grammar edit: " << event.text("edit") << "\n";
+        if (event.integer("full_rebuild"))
+            out << "⚠️  Symbol set changed — rebuilding from scratch (state ids may change)\n";
+        out << "   States: " << event.integer("affected_states") << " re-closed, "
+            << event.integer("new_states") << " new, " << event.integer("retired_states") << " retired; "
+            << event.integer("rows_patched") << " rows patched\n";
+        out << "   Analysis " << fixed << setprecision(3) << event.integer("analysis_micros") / 1000.0
+            << " ms, compressed table patched in " << event.integer("repack_micros") / 1000.0 << " ms\n";
+        out << "   Changed entries (" << event.integer("changes") << "):\n";
+        editChanges = 0;
+    } else if (type == "table_change") {
+        if (editChanges++ < SHOWN_CHANGES) {
+            const string &before = event.text("before");
+            const string &after = event.text("after");
+            out << "     State " << event.integer("state") << ", '" << event.text("symbol") << "': "
+                << (before.empty() ? "(empty)" : before) << " → "
+                << (after.empty() ? "(empty)" : after) << "\n";
+        }
+    }
+
+    // 🔹 Parse traces
+    else if (type == "parse_trace") {
+        traceParser = event.text("parser");
+        if (traceParser == "lr0") {
+            out << "\n===== Parsing Input (LR(0)) =====\n";
+            out << left << setw(40) << "Stack (States + Symbols)" << setw(25) << "Input" << "Action\n";
+            out << string(90, '-') << "\n";
+        } else {
+            out << "\n===== Parsing Input =====\n";
+            out << left << setw(30) << "Stack" << setw(30) << "Input" << "Action\n";
+            out << string(80, '-') << "\n";
+        }
+    } else if (type == "parse_step") {
+        bool lr = traceParser == "lr0";
+        out << setw(lr ? 40 : 30) << event.text("stack") << setw(lr ? 25 : 30) << event.text("input")
+            << event.text("action") << "\n";
+    } else if (type == "parse_error") {
+        out << "❌ Error: " << event.text("message") << "\n";
+    }
+
+    // 🔹 Parse forests and incremental parses
+    else if (type == "forest_text") {
+        pendingForest = event.text("forest");
+    } else if (type == "glr_forest") {
+        out << "\n===== GLR Parse Forest (SPPF) =====\n";
+        out << "Result            : " << (event.integer("accepted") ? "✅ Accepted" : "❌ Rejected") << "\n";
+        out << "Deterministic steps: " << event.integer("deterministic_steps") << "\n";
+        out << "Forks             : " << event.integer("forks") << "\n";
+        out << "GSS nodes         : " << event.integer("gss_nodes") << "\n";
+        renderForest(event, pendingForest, out);
+        pendingForest.clear();
+        out << "===================================\n";
+    } else if (type == "earley_forest") {
+        out << "\n===== Earley Parse Forest (SPPF) =====\n";
+        out << "Result            : " << (event.integer("accepted") ? "✅ Accepted" : "❌ Rejected");
+        if (!event.integer("accepted")) out << " at token " << event.integer("stopped_at");
+        out << "\n";
+        out << "Earley sets       : " << event.integer("sets") << "\n";
+        out << "Items             : " << event.integer("items") << "\n";
+        out << "Leo shortcuts     : " << event.integer("leo_shortcuts") << " ("
+            << event.integer("leo_items") << " Leo items)\n";
+        out << "Chart memory      : " << event.integer("chart_bytes") << " bytes\n";
+        renderForest(event, pendingForest, out);
+        pendingForest.clear();
+        out << "======================================\n";
+    } else if (type == "incremental_stats") {
+        out << "\n===== Incremental Parse: " << event.text("title") << " =====\n";
+        out << left << setw(20) << "Result" << ": " << (event.integer("accepted") ? "✅ Accepted" : "❌ Rejected") << "\n";
+        out << setw(20) << "Tokens" << ": " << event.integer("tokens") << "\n";
+        out << setw(20) << "Shifts" << ": " << event.integer("shifts") << "\n";
+        out << setw(20) << "Reductions" << ": " << event.integer("reductions") << "\n";
+        out << setw(20) << "Reused subtrees" << ": " << event.integer("reused_nodes")
+            << " (" << event.integer("reused_tokens") << " tokens)\n";
+        out << setw(20) << "Breakdowns" << ": " << event.integer("breakdowns") << "\n";
+        out << setw(20) << "Time" << ": " << fixed << setprecision(3) << event.integer("micros") / 1000.0 << " ms\n";
+    } else if (type == "incremental_error") {
+        out << "❌ Incremental parse failed: " << event.text("message") << "\n";
+    } else if (type == "invalid_edit") {
+        out << "❌ Invalid edit at token " << event.integer("token") << ".\n";
+    }
+
+    // 🔹 Progress lines, already formatted
+    else if (type == "message") {
+        out << event.text("text");
+    }
+
+    // 🔹 Section ends
+    else if (type == "end") {
+        const string &of = event.text("of");
+        if (of == "grammar") {
+            out << "\n===================\n";
+        } else if (of == "first_follow") {
+            if (!followStarted) out << "\nFOLLOW sets:\n";
+            out << "===============================\n";
+        } else if (of == "ll1_table") {
+            out << "===========================\n";
+        } else if (of == "lr_states") {
+            out << "===============================================\n";
+        } else if (of == "conflicts" && conflictCount > 0) {
+            out << string(80, '-') << "\n";
+            out << "Total Conflicts: " << conflictCount << "\n";
+        } else if (of == "grammar_edit" && editChanges > SHOWN_CHANGES) {
+            out << "     ... and " << editChanges - SHOWN_CHANGES << " more\n";
+        } else if (of == "parse_trace" && traceParser == "ll1" && event.integer("accepted")) {
+            // an LR trace ends on its accept step instead
+            out << "\n✅ Parsing complete: Input accepted!\n";
+        }
+    }
+
+    string text = out.str();
+    if (text.empty()) return;
+    cout << text;
+#ifndef GRAMRESOLVE_NO_REPORT
+    ReportWriter::get() << text;
+#endif
+}
+
+// ======================================
+// JSON Lines
+// ======================================
+static void appendJsonString(string &out, const string &s) {
+    static const char *HEX = "0123456789abcdef";
+    out += '"';
+    for (unsigned char c : s) {
+        switch (c) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\t': out += "\\t"; break;
+        case '\r': out += "\\r"; break;
+        default:
+            if (c < 0x20) {
+                out += "\\u00";
+                out += HEX[c >> 4];
+                out += HEX[c & 15];
+            } else {
+                out += static_cast<char>(c);        // UTF-8 passes through
+            }
+        }
+    }
+    out += '"';
+}
+
+JsonLinesSink::JsonLinesSink(const string &path, Verbosity level) : ReportSink(level) {
+    file = fopen(path.c_str(), "w");
+    if (!file) {
+        cerr << "❌ Failed to open " << path << " for writing.\n";
+        return;
+    }
+    setvbuf(file, nullptr, _IOFBF, 1 << 20);
+}
+
+JsonLinesSink::~JsonLinesSink() {
+    if (file) fclose(file);
+}
+
+void JsonLinesSink::write(const ReportEvent &event) {
+    if (!file) return;
+
+    line.clear();
+    line += "{\"type\":";
+    appendJsonString(line, event.getType());
+
+    for (const auto &f : event.getFields()) {
+        line += ',';
+        appendJsonString(line, f.key);
+        line += ':';
+        switch (f.kind) {
+        case ReportEvent::TEXT:
+            appendJsonString(line, f.text);
+            break;
+        case ReportEvent::INTEGER:
+            line += to_string(f.integer);
+            break;
+        case ReportEvent::LIST:
+            line += '[';
+            for (size_t i = 0; i < f.list.size(); ++i) {
+                if (i) line += ',';
+                appendJsonString(line, f.list[i]);
+            }
+            line += ']';
+            break;
+        }
+    }
+    line += "}\n";
+
+    fwrite(line.data(), 1, line.size(), file);
+}
+
+void JsonLinesSink::flush() {
+    if (file) fflush(file);
+}
+
+// ======================================
+// Binary — varints and interned strings
+// ======================================
+static const uint8_t REC_STRING = 0x01;
+static const uint8_t REC_EVENT = 0x02;
+static const uint8_t TAG_ID = 0, TAG_INT = 1, TAG_LIST = 2, TAG_INLINE = 3;
+
+static void putVarint(string &out, uint64_t v) {
+    while (v >= 0x80) {
+        out += static_cast<char>((v & 0x7F) | 0x80);
+        v >>= 7;
+    }
+    out += static_cast<char>(v);
+}
+
+BinarySink::BinarySink(const string &path, Verbosity level) : ReportSink(level) {
+    file = fopen(path.c_str(), "wb");
+    if (!file) {
+        cerr << "❌ Failed to open " << path << " for writing.\n";
+        return;
+    }
+    setvbuf(file, nullptr, _IOFBF, 1 << 20);
+    fwrite("GRPT", 1, 4, file);
+    fputc(VERSION, file);
+}
+
+BinarySink::~BinarySink() {
+    if (file) fclose(file);
+}
+
+// A new string is defined in the file before the record using it.
+// Types and keys are a small fixed set and are always interned; only
+// values are held to MAX_STRINGS.
+uint64_t BinarySink::intern(const string &s) {
+    auto it = ids.find(s);
+    if (it != ids.end()) return it->second;
+
+    uint64_t id = ids.size();
+    ids.emplace(s, id);
+
+    string def(1, static_cast<char>(REC_STRING));
+    putVarint(def, s.size());
+    def += s;
+    fwrite(def.data(), 1, def.size(), file);
+    return id;
+}
+
+// A value: interned when it looks like a symbol or a kind, inline
+// otherwise, so one-off items and messages never enter the table
+void BinarySink::putString(const string &s) {
+    bool symbolLike = s.size() <= INTERN_LENGTH && ids.size() < MAX_STRINGS &&
+                      s.find_first_of(" \t\n") == string::npos;
+    if (symbolLike) {
+        record += static_cast<char>(TAG_ID);
+        putVarint(record, intern(s));
+    } else {
+        record += static_cast<char>(TAG_INLINE);
+        putVarint(record, s.size());
+        record += s;
+    }
+}
+
+void BinarySink::write(const ReportEvent &event) {
+    if (!file) return;
+
+    record.clear();
+    record += static_cast<char>(REC_EVENT);
+    putVarint(record, intern(event.getType()));
+    putVarint(record, event.getFields().size());
+
+    for (const auto &f : event.getFields()) {
+        putVarint(record, intern(f.key));
+        switch (f.kind) {
+        case ReportEvent::TEXT:
+            putString(f.text);
+            break;
+        case ReportEvent::INTEGER:
+            record += static_cast<char>(TAG_INT);
+            putVarint(record, (static_cast<uint64_t>(f.integer) << 1) ^
+                                  static_cast<uint64_t>(f.integer >> 63));
+            break;
+        case ReportEvent::LIST:
+            record += static_cast<char>(TAG_LIST);
+            putVarint(record, f.list.size());
+            for (const auto &s : f.list) putString(s);
+            break;
+        }
+    }
+
+    fwrite(record.data(), 1, record.size(), file);
+}
+
+void BinarySink::flush() {
+    if (file) fflush(file);
+}
+
+// ======================================
+// Binary → events
+// ======================================
+static bool getVarint(FILE *in, uint64_t &v) {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = fgetc(in);
+        if (c == EOF) return false;
+        v |= static_cast<uint64_t>(c & 0x7F) << shift;
+        if (!(c & 0x80)) return true;
+    }
+    return false;
+}
+
+// n bytes; false when fewer than n are left in a file of `size`
+static bool getBytes(FILE *in, uint64_t size, uint64_t n, string &s) {
+    long at = ftell(in);
+    if (at < 0 || n > size - static_cast<uint64_t>(at)) return false;
+    s.resize(n);
+    return n == 0 || fread(&s[0], 1, n, in) == n;
+}
+
+bool BinarySink::decode(const string &path, ReportSink &into) {
+    FILE *in = fopen(path.c_str(), "rb");
+    if (!in) {
+        cerr << "❌ Failed to open " << path << " for reading.\n";
+        return false;
+    }
+
+    uint64_t size = 0;
+    if (fseek(in, 0, SEEK_END) == 0) {
+        long end = ftell(in);
+        size = end > 0 ? static_cast<uint64_t>(end) : 0;
+    }
+    rewind(in);
+
+    char magic[4];
+    bool ok = fread(magic, 1, 4, in) == 4 && string(magic, 4) == "GRPT";
+    int version = ok ? fgetc(in) : EOF;
+    ok = ok && version == VERSION;
+    vector<string> strings;
+
+    auto str = [&](uint64_t id, const string *&s) {
+        if (id >= strings.size()) return false;
+        s = &strings[id];
+        return true;
+    };
+
+    // One string value: an id or inline bytes, by tag
+    string inlineText;
+    auto value = [&](int tag, const string *&s) {
+        uint64_t v;
+        if (tag == TAG_ID) return getVarint(in, v) && str(v, s);
+        if (tag != TAG_INLINE || !getVarint(in, v) || !getBytes(in, size, v, inlineText)) return false;
+        s = &inlineText;
+        return true;
+    };
+
+    while (ok) {
+        int kind = fgetc(in);
+        if (kind == EOF) break;
+
+        uint64_t n, id;
+        const string *s = nullptr;
+
+        if (kind == REC_STRING) {
+            string def;
+            ok = getVarint(in, n) && getBytes(in, size, n, def);
+            if (ok) strings.push_back(def);
+            continue;
+        }
+        if (kind != REC_EVENT || !getVarint(in, id) || !str(id, s) || !getVarint(in, n)) {
+            ok = false;
+            break;
+        }
+
+        ReportEvent event(*s);
+        for (uint64_t k = 0; ok && k < n; ++k) {
+            const string *key = nullptr;
+            ok = getVarint(in, id) && str(id, key);
+            int tag = ok ? fgetc(in) : EOF;
+            uint64_t v;
+
+            if (tag == TAG_ID || tag == TAG_INLINE) {
+                ok = value(tag, s);
+                if (ok) event.add(*key, *s);
+            } else if (tag == TAG_INT) {
+                ok = getVarint(in, v);
+                if (ok) event.add(*key, static_cast<int64_t>((v >> 1) ^ (~(v & 1) + 1)));
+            } else if (tag == TAG_LIST) {
+                vector<string> values;
+                ok = getVarint(in, v);
+                for (uint64_t i = 0; ok && i < v; ++i) {
+                    ok = value(fgetc(in), s);
+                    if (ok) values.push_back(*s);
+                }
+                if (ok) event.add(*key, values);
+            } else {
+                ok = false;
+            }
+        }
+        if (ok) into.write(event);
+    }
+
+    fclose(in);
+    if (!ok) cerr << "❌ " << path << " is not a valid binary report.\n";
+    return ok;
+}
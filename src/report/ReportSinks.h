@@ -0,0 +1,100 @@
+// ===============================================================
+// File: ReportSinks.h
+// Description: Sinks for the report event stream.
+//   TextRenderer  — the human report (terminal + report.txt)
+//   JsonLinesSink — one JSON object per line
+//   BinarySink    — compact records with an inline string table
+//
+// Binary format (integers are LEB128 varints):
+//   file    := "GRPT" version:u8 record*
+//   record  := 0x01 length bytes              define the next string id
+//            | 0x02 type:id count field*      one event
+//   field   := key:id tag:u8 value
+//   value   := tag 0: id                      interned string
+//              tag 1: zigzag varint           integer
+//              tag 2: count (tag:u8 value)*   list of strings (tags 0/3)
+//              tag 3: length bytes            string, not interned
+// Ids count up from 0 in definition order. Event types, keys and
+// symbol-like values (short, no spaces: names, action kinds) are
+// interned; items, productions and messages are written inline.
+// Files of any other version are rejected.
+// ===============================================================
+
+#ifndef REPORT_SINKS_H
+#define REPORT_SINKS_H
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include "ReportEvent.h"
+
+using namespace std;
+
+// ===============================================================
+// Class: TextRenderer
+// ===============================================================
+class TextRenderer : public ReportSink {
+private:
+    bool followStarted = false;
+    bool precedenceStarted = false;
+    int64_t conflictCount = 0;
+    string traceParser;                 // "ll1" | "lr0": column widths of the steps
+    int64_t editChanges = 0;            // table_change events of the edit so far
+    string pendingForest;               // forest_text, shown in the next forest summary
+
+    void render(const ReportEvent &event);
+
+public:
+    explicit TextRenderer(Verbosity level = Verbosity::RENDERED) : ReportSink(level) {}
+
+    void write(const ReportEvent &event) override;
+};
+
+// ===============================================================
+// Class: JsonLinesSink
+// ===============================================================
+class JsonLinesSink : public ReportSink {
+private:
+    FILE *file = nullptr;
+    string line;                        // reused for every event
+
+public:
+    explicit JsonLinesSink(const string &path, Verbosity level = Verbosity::DETAIL);
+    ~JsonLinesSink() override;
+
+    bool isOpen() const { return file != nullptr; }
+
+    void write(const ReportEvent &event) override;
+    void flush() override;
+};
+
+// ===============================================================
+// Class: BinarySink
+// ===============================================================
+class BinarySink : public ReportSink {
+private:
+    FILE *file = nullptr;
+    string record;                      // reused for every event
+    unordered_map<string, uint64_t> ids;
+
+    uint64_t intern(const string &s);
+    void putString(const string &s);
+
+public:
+    static const uint8_t VERSION = 2;
+    static const size_t INTERN_LENGTH = 24;     // longer values are written inline
+    static const size_t MAX_STRINGS = 1 << 16;  // string table cap; then all inline
+
+    explicit BinarySink(const string &path, Verbosity level = Verbosity::DETAIL);
+    ~BinarySink() override;
+
+    bool isOpen() const { return file != nullptr; }
+
+    void write(const ReportEvent &event) override;
+    void flush() override;
+
+    // Read a binary report back and replay its events into `into`
+    static bool decode(const string &path, ReportSink &into);
+};
+
+#endif
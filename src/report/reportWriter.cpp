@@ -1,25 +1,158 @@
 #include "reportWriter.h"
 #include <iostream>
+#include <csignal>
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
 
 using namespace std;
 
+// Set by setPath() before the first get(); empty = default
+static string requestedPath;
+
+// Signals that end the process: pending report text is written first.
+// Stop signals are handled by the watcher thread, crash signals in
+// the handler itself (the faulting thread cannot go on).
+static const int STOP_SIGNALS[] = {SIGINT, SIGTERM};
+static const int CRASH_SIGNALS[] = {SIGSEGV, SIGABRT, SIGFPE, SIGILL};
+
+// Self-pipe: onStop writes the signal number, the watcher reads it;
+// 0 tells the watcher to exit
+static int stopPipe[2] = {-1, -1};
+
+thread_local ReportWriter::ThreadBuffer ReportWriter::local;
+thread_local const string *ReportWriter::liveText = nullptr;
+atomic<ReportWriter *> ReportWriter::instance{nullptr};
+
+// write(2) all of `size` bytes; async-signal-safe
+static void writeAll(int fd, const char *data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
 // ======================================
-// Constructor — Opens report file
+// Report location
+// ======================================
+string ReportWriter::defaultDirectory() {
+    char exe[4096];
+    ssize_t n = readlink("/proc/self/exe", exe, sizeof exe - 1);
+    if (n <= 0) return "src/report";
+
+    string dir(exe, static_cast<size_t>(n));
+    size_t slash = dir.rfind('/');
+    return (slash == string::npos ? string(".") : dir.substr(0, slash)) + "/src/report";
+}
+
+void ReportWriter::setPath(const string &filename) {
+    requestedPath = filename;
+    ReportWriter *current = instance.load();
+    if (!current || current->path == filename) return;    // opened on first use
+    ReportWriter &writer = *current;
+
+    FILE *fresh = fopen(filename.c_str(), "a");
+    if (!fresh) {
+        cerr << "❌ Failed to open " << filename << " for writing.\n";
+        return;
+    }
+    setvbuf(fresh, nullptr, _IONBF, 0);
+
+    // Everything queued goes to the old file; the writer takes the
+    // new one with its next wake-up
+    writer.flush();
+    lock_guard<mutex> lock(writer.wakeMutex);
+    fclose(writer.file);
+    writer.file = fresh;
+    writer.path = filename;
+    writer.fd.store(fileno(fresh));
+}
+
+// ======================================
+// Constructor — Opens report file and
+// starts the writer thread
 // ======================================
 ReportWriter::ReportWriter() {
-    file.open("src/report/report.txt", ios::app);
-    if (!file.is_open()) {
-        cerr << "❌ Failed to open src/report/report.txt for writing.\n";
+    open(requestedPath.empty() ? defaultDirectory() + "/report.txt" : requestedPath);
+}
+
+void ReportWriter::open(const string &filename) {
+    file = fopen(filename.c_str(), "a");
+    if (!file) {
+        cerr << "❌ Failed to open " << filename << " for writing.\n";
+        return;
+    }
+    path = filename;
+    setvbuf(file, nullptr, _IONBF, 0);        // chunks are already large
+    fd.store(fileno(file));
+
+    writer = thread(&ReportWriter::writerLoop, this);
+    instance.store(this);
+    for (int sig : CRASH_SIGNALS) signal(sig, &ReportWriter::onCrash);
+
+    if (pipe(stopPipe) == 0) {
+        watcher = thread(&ReportWriter::watchLoop, this);
+        for (int sig : STOP_SIGNALS) signal(sig, &ReportWriter::onStop);
     }
 }
 
 // ======================================
-// Destructor — Close safely
+// Destructor — Drain the queue, stop the
+// writer and close safely
 // ======================================
 ReportWriter::~ReportWriter() {
-    if (file.is_open()) {
-        file.close();
+    if (!file) return;
+
+    stopWriter();
+
+    if (watcher.joinable()) {
+        for (int sig : STOP_SIGNALS) signal(sig, SIG_DFL);
+        unsigned char quit = 0;
+        writeAll(stopPipe[1], reinterpret_cast<const char *>(&quit), 1);
+        watcher.join();
+        close(stopPipe[0]);
+        close(stopPipe[1]);
     }
+
+    instance.store(nullptr);
+    for (int sig : CRASH_SIGNALS) signal(sig, SIG_DFL);
+
+    drain();
+    fclose(file);
+}
+
+// Once, from the destructor or the watcher, whichever comes first
+void ReportWriter::stopWriter() {
+    call_once(writerStopped, [this] {
+        {
+            lock_guard<mutex> lock(wakeMutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        writer.join();
+    });
+}
+
+// A thread's leftover text goes out when the thread ends; the main
+// thread's buffer is destroyed before the singleton, so this also
+// covers normal exit
+ReportWriter::ThreadBuffer::~ThreadBuffer() {
+    ReportWriter *writer = instance.load();
+    if (!writer) return;
+
+    {
+        lock_guard<mutex> guard(writer->buffersMutex);
+        auto &all = writer->buffers;
+        all.erase(remove(all.begin(), all.end(), this), all.end());
+    }
+    if (text.empty()) return;
+
+    Chunk *chunk = new Chunk;
+    chunk->text.swap(text);
+    writer->submit(chunk);
 }
 
 // ======================================
@@ -31,26 +164,222 @@ ReportWriter& ReportWriter::get() {
 }
 
 // ======================================
-// Append text to report file
+// Queue — lock-free push; the writer takes
+// the whole stack at once, so no ABA
+// ======================================
+void ReportWriter::submit(Chunk *chunk) {
+    // Counted before the push: flush() may wait for a chunk that is
+    // not pushed yet, never return before its own is written
+    submitted.fetch_add(1);
+
+    chunk->next = pending.load(memory_order_relaxed);
+    while (!pending.compare_exchange_weak(chunk->next, chunk, memory_order_release,
+                                          memory_order_relaxed)) {
+    }
+
+    // Taking the mutex orders the push before the writer's wait check
+    { lock_guard<mutex> lock(wakeMutex); }
+    wake.notify_one();
+}
+
+void ReportWriter::submitLocal() {
+    lock_guard<mutex> guard(local.lock);
+    if (local.text.empty()) return;
+
+    Chunk *chunk = new Chunk;
+    chunk->text.swap(local.text);
+    submit(chunk);
+}
+
+size_t ReportWriter::drain() {
+    Chunk *chunk = pending.exchange(nullptr, memory_order_acquire);
+
+    Chunk *oldest = nullptr;
+    while (chunk) {
+        Chunk *next = chunk->next;
+        chunk->next = oldest;
+        oldest = chunk;
+        chunk = next;
+    }
+
+    size_t count = 0;
+    while (oldest) {
+        Chunk *next = oldest->next;
+        // Opened for appending, so the next write starts the file
+        if (oldest->truncate && file && ftruncate(fileno(file), 0) != 0)
+            cerr << "❌ Failed to clear " << path << ".\n";
+        if (file && !oldest->text.empty())
+            fwrite(oldest->text.data(), 1, oldest->text.size(), file);
+        delete oldest;
+        oldest = next;
+        count++;
+    }
+    return count;
+}
+
+void ReportWriter::writerLoop() {
+    while (true) {
+        bool stop;
+        {
+            unique_lock<mutex> lock(wakeMutex);
+            wake.wait(lock, [this] { return stopping || pending.load() != nullptr; });
+            stop = stopping;
+        }
+
+        size_t count = drain();
+        if (count) {
+            {
+                lock_guard<mutex> lock(wakeMutex);
+                written.fetch_add(count);
+            }
+            drained.notify_all();
+        }
+        if (stop && !pending.load()) return;
+    }
+}
+
+// ======================================
+// SIGINT/SIGTERM — the handler only wakes
+// the watcher, which stops the writer in
+// thread context and re-raises
+// ======================================
+void ReportWriter::onStop(int sig) {
+    int saved = errno;
+    unsigned char code = static_cast<unsigned char>(sig);
+    writeAll(stopPipe[1], reinterpret_cast<const char *>(&code), 1);
+    errno = saved;
+}
+
+void ReportWriter::watchLoop() {
+    unsigned char sig = 0;
+    while (true) {
+        ssize_t n = read(stopPipe[0], &sig, 1);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0 || sig == 0) return;         // destructor
+        break;
+    }
+
+    // Queued chunks first, then what each thread still holds (newer
+    // than its chunks); the writer is gone, so the file is ours
+    stopWriter();
+    drain();
+    {
+        lock_guard<mutex> guard(buffersMutex);
+        for (ThreadBuffer *buffer : buffers) {
+            lock_guard<mutex> hold(buffer->lock);
+            if (file && !buffer->text.empty())
+                fwrite(buffer->text.data(), 1, buffer->text.size(), file);
+            buffer->text.clear();
+        }
+    }
+    drain();
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+// ======================================
+// Crash — take the queue and write it and
+// this thread's buffer with write(2);
+// nothing is freed, then die as before
+// ======================================
+void ReportWriter::onCrash(int sig) {
+    ReportWriter *writer = instance.exchange(nullptr);
+    if (writer) {
+        int out = writer->fd.load();
+
+        // The writer thread may hold chunks it took earlier; only
+        // the ones still queued are ours
+        Chunk *chunk = writer->pending.exchange(nullptr, memory_order_acquire);
+        Chunk *oldest = nullptr;
+        while (chunk) {
+            Chunk *next = chunk->next;
+            chunk->next = oldest;
+            oldest = chunk;
+            chunk = next;
+        }
+
+        for (; out >= 0 && oldest; oldest = oldest->next) {
+            if (oldest->truncate && ftruncate(out, 0) != 0) continue;
+            writeAll(out, oldest->text.data(), oldest->text.size());
+        }
+        if (out >= 0 && liveText)
+            writeAll(out, liveText->data(), liveText->size());
+    }
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+// ======================================
+// Append text to this thread's buffer
 // ======================================
 ReportWriter& ReportWriter::operator<<(const string &text) {
-    if (file.is_open()) {
-        file << text;
-        file.flush();              // flush after each write
+    if (!file) return *this;
+
+    string &buffer = local.text;
+    if (!liveText) {
+        liveText = &buffer;
+        lock_guard<mutex> guard(buffersMutex);
+        buffers.push_back(&local);
+    }
+
+    lock_guard<mutex> guard(local.lock);
+    if (buffer.capacity() < BUFFER_SIZE) buffer.reserve(BUFFER_SIZE);
+    buffer += text;
+
+    if (buffer.size() >= BUFFER_SIZE && !local.holding) {
+        Chunk *chunk = new Chunk;
+        chunk->text.swap(buffer);
+        submit(chunk);
     }
     return *this;
 }
 
+// ======================================
+// Flush — wait until everything this
+// thread wrote is in the file
+// ======================================
+void ReportWriter::flush() {
+    if (!file) return;
+
+    submitLocal();
+
+    uint64_t ticket = submitted.load();
+    unique_lock<mutex> lock(wakeMutex);
+    drained.wait(lock, [&] { return written.load() >= ticket; });
+}
+
+// ======================================
+// Sections — one chunk per section
+// ======================================
+void ReportWriter::beginSection() {
+    if (!file) return;
+
+    // Text written before the section goes out on its own
+    submitLocal();
+    local.holding = true;
+}
+
+void ReportWriter::endSection() {
+    local.holding = false;
+    if (!file) return;
+
+    submitLocal();
+}
+
 // ======================================
 // Clear the report file (fresh output)
 // ======================================
 void ReportWriter::clear() {
-    if (file.is_open()) {
-        file.close();
+    if (!file) {
+        cerr << "❌ Failed to clear report file.\n";
+        return;
     }
 
-    file.open("src/report/report.txt", ios::trunc);
-    if (!file.is_open()) {
-        cerr << "❌ Failed to clear report file.\n";
+    {
+        lock_guard<mutex> guard(local.lock);
+        local.text.clear();
     }
+    Chunk *chunk = new Chunk;
+    chunk->truncate = true;
+    submit(chunk);
 }
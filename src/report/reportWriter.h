@@ -1,28 +1,110 @@
 #ifndef REPORT_WRITER_H
 #define REPORT_WRITER_H
 
-#include <fstream>
+#include <cstdio>
+#include <cstdint>
 #include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 using namespace std;
 
+// ===============================================================
+// Class: ReportWriter
+// Text goes into a buffer owned by the calling thread; full buffers
+// are pushed onto a lock-free queue and written by a background
+// thread, so analysis threads never wait on the file. Everything is
+// flushed on exit. SIGINT/SIGTERM reach a watcher thread through a
+// pipe, which stops the writer and writes the queued chunks and every
+// thread's buffer before the process dies; crash signals only
+// write(2) the queued chunks and the crashing thread's buffer, best
+// effort.
+// ===============================================================
 class ReportWriter {
 private:
-    ofstream file;
+    // One buffer handed to the writer thread
+    struct Chunk {
+        string text;
+        bool truncate = false;          // clear(): empty the file first
+        Chunk *next = nullptr;
+    };
+
+    // Per-thread buffer; submitted when full or when its thread ends.
+    // The lock is only contended by the watcher draining it.
+    struct ThreadBuffer {
+        string text;
+        bool holding = false;           // inside beginSection()/endSection()
+        mutex lock;
+        ~ThreadBuffer();
+    };
+
+    static thread_local ThreadBuffer local;
+    static thread_local const string *liveText;     // `local.text` once used, for onCrash
+    static atomic<ReportWriter *> instance;         // for the signal handlers
+
+    FILE *file = nullptr;
+    string path;                                // file's path
+    atomic<int> fd{-1};                         // file's descriptor, for onCrash
+    atomic<Chunk *> pending{nullptr};           // newest first (Treiber stack)
+    atomic<uint64_t> submitted{0};
+    atomic<uint64_t> written{0};
+    bool stopping = false;
+
+    mutex wakeMutex;
+    condition_variable wake;                    // writer waits for chunks
+    condition_variable drained;                 // flush() waits for the writer
+    thread writer;
+    once_flag writerStopped;
+    thread watcher;                             // handles SIGINT/SIGTERM
+
+    mutex buffersMutex;
+    vector<ThreadBuffer *> buffers;             // every thread's buffer once used, for the watcher
 
     // Private constructor (Singleton)
     ReportWriter();
 
+    void open(const string &filename);          // file, writer thread, signal handlers
+    void submit(Chunk *chunk);
+    void submitLocal();                         // hand over this thread's buffer
+    void writerLoop();
+    size_t drain();                             // write queued chunks, oldest first
+    void stopWriter();                          // writer drains the queue and exits
+    void watchLoop();
+    static void onStop(int sig);                // async-signal-safe: one pipe write
+    static void onCrash(int sig);               // async-signal-safe: write(2) only
+
 public:
-    // Destroy file safely
+    static const size_t BUFFER_SIZE = 64 * 1024;
+
+    // Flush everything and close the file
     ~ReportWriter();
 
     // Access global instance
     static ReportWriter& get();
 
+    // The text report: src/report/report.txt next to the executable,
+    // whatever the working directory, unless setPath() names another
+    // file. Once the report is open, setPath() flushes and switches
+    // files; call it before other threads write.
+    static string defaultDirectory();
+    static void setPath(const string &filename);
+    const string& getPath() const { return path; }
+
     // Append text to report
     ReportWriter& operator<<(const string &text);
 
+    // Hand over this thread's buffer and wait until it is on disk
+    void flush();
+
+    // Keep this thread's text together until endSection(): a full
+    // buffer is not handed over meanwhile, so the section reaches
+    // the file in one piece however many threads write
+    void beginSection();
+    void endSection();
+
     // Clear the report (start fresh)
     void clear();
 };
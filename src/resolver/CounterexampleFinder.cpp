@@ -0,0 +1,622 @@
+#include "CounterexampleFinder.h"
+#include "../parser/GLRParser.h"
+#include "../util/Parallel.h"
+#include "../util/Instrumentation.h"
+#include "../report/reportWriter.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <deque>
+#include <set>
+#include <unordered_set>
+#include <climits>
+
+using namespace std;
+
+static const int INF = INT_MAX / 4;
+
+static uint64_t itemKey(int state, int production, int dot) {
+    return (static_cast<uint64_t>(state) << 40) | (static_cast<uint64_t>(production) << 12) |
+           static_cast<uint64_t>(dot);
+}
+
+// ===================================================
+// Constructor — integer views of the automaton:
+// items per state, closure parents, predecessors and
+// FIRST of every production suffix
+// ===================================================
+CounterexampleFinder::CounterexampleFinder(const LR0Parser &p, CounterexampleBudget b)
+    : parser(p), table(p.getTable()), budget(b) {
+    T = static_cast<int>(table.terminalCount());
+    const int N = static_cast<int>(table.nonTerminalCount());
+    const int S = table.stateCount();
+    const auto &prods = table.getProductions();
+    const auto &states = parser.getStates();
+    const FirstFollowEngine &ff = parser.getFirstFollow();
+    const size_t words = (T + 63) / 64;
+
+    // Retired productions keep their slot but leave the index
+    live.assign(prods.size(), 0);
+    live[0] = 1;
+    for (size_t q = 1; q < prods.size(); ++q) {
+        vector<string> rhs;
+        for (int sym : prods[q].rhs) rhs.push_back(table.symbolName(sym));
+        live[q] = table.productionId(table.nonTerminalName(prods[q].lhs), rhs) == static_cast<int>(q);
+    }
+
+    items.resize(S);
+    parentsOf.resize(S);
+    predecessors.resize(S);
+
+    for (int s = 0; s < S && s < static_cast<int>(states.size()); ++s) {
+        for (const auto &it : states[s].items) {
+            int prod = (it.lhs() == parser.getAugmentedSymbol()) ? 0 : table.productionId(it.lhs(), it.rhs());
+            if (prod < 0) continue;
+
+            int idx = static_cast<int>(items[s].size());
+            items[s].push_back({prod, static_cast<int>(it.dot)});
+            itemIndex[itemKey(s, prod, static_cast<int>(it.dot))] = idx;
+
+            const LRProduction &rule = prods[prod];
+            if (static_cast<int>(it.dot) < rule.length && !table.isTerminalSymbol(rule.rhs[it.dot]))
+                parentsOf[s].push_back({rule.rhs[it.dot] - T, idx});
+        }
+        sort(parentsOf[s].begin(), parentsOf[s].end());
+    }
+
+    const auto &transitions = parser.getTransitions();
+    for (int s = 0; s < S && s < static_cast<int>(transitions.size()); ++s)
+        for (const auto &tr : transitions[s]) {
+            int t = table.terminalId(tr.first);
+            int sym = (t >= 0) ? t : T + table.nonTerminalId(tr.first);
+            predecessors[tr.second].push_back({s, sym});
+        }
+
+    // FIRST / nullable per symbol
+    nullable.assign(T + N, 0);
+    vector<Bits> first(T + N, Bits(words, 0));
+    for (int t = 0; t < T; ++t)
+        first[t][t / 64] |= uint64_t(1) << (t % 64);
+    for (int A = 0; A < N; ++A) {
+        const string &name = table.nonTerminalName(A);
+        nullable[T + A] = ff.isNullable(name);
+        for (const auto &f : ff.getFIRST(name)) {
+            int t = table.terminalId(f);
+            if (t >= 0) first[T + A][t / 64] |= uint64_t(1) << (t % 64);
+        }
+    }
+
+    // FIRST(rhs[k..]) for every production position
+    firstAfter.resize(prods.size());
+    nullableAfter.resize(prods.size());
+    for (size_t q = 0; q < prods.size(); ++q) {
+        const LRProduction &rule = prods[q];
+        firstAfter[q].assign(rule.length + 1, Bits(words, 0));
+        nullableAfter[q].assign(rule.length + 1, 1);
+
+        for (int k = rule.length - 1; k >= 0; --k) {
+            int sym = rule.rhs[k];
+            firstAfter[q][k] = first[sym];
+            nullableAfter[q][k] = nullable[sym] && nullableAfter[q][k + 1];
+            if (nullable[sym])
+                for (size_t w = 0; w < words; ++w)
+                    firstAfter[q][k][w] |= firstAfter[q][k + 1][w];
+        }
+    }
+
+    computeYields();
+}
+
+int CounterexampleFinder::findItem(int state, int production, int dot) const {
+    auto it = itemIndex.find(itemKey(state, production, dot));
+    return (it != itemIndex.end()) ? it->second : -1;
+}
+
+// Item behind an action of the conflicted cell, and the
+// terminal that must follow it
+int CounterexampleFinder::itemFor(int state, uint32_t action, int terminal, int &lookahead) const {
+    lookahead = terminal;
+
+    switch (actionTag(action)) {
+    case ACT_REDUCE: {
+        int p = actionPayload(action);
+        return findItem(state, p, table.production(p).length);
+    }
+    case ACT_ACCEPT:
+        return findItem(state, 0, 1);
+    case ACT_SHIFT:
+        lookahead = -1;             // the terminal is part of the item
+        for (size_t k = 0; k < items[state].size(); ++k) {
+            const Item &it = items[state][k];
+            const LRProduction &rule = table.production(it.production);
+            if (it.dot < rule.length && rule.rhs[it.dot] == terminal)
+                return static_cast<int>(k);
+        }
+        return -1;
+    default:
+        return -1;
+    }
+}
+
+// ===================================================
+// Backward breadth-first search from a conflict item
+// to S' → • S. A node carries the terminal that must
+// follow the item; closure steps keep it, drop it when
+// the parent's suffix starts with it, or fail. With a
+// state path, the search must retrace that prefix.
+// ===================================================
+bool CounterexampleFinder::search(int state, int item, int lookahead, const vector<int> *path,
+                                  const vector<int> *prefix, chrono::steady_clock::time_point deadline,
+                                  size_t &nodes, vector<Level> &levels, vector<int> &statePath,
+                                  vector<int> &symbols) const {
+    const int end = table.endMarker();
+    vector<Node> pool;
+    unordered_set<uint64_t> seen;
+    deque<int> queue;
+
+    // With a path the step index determines the state
+    auto key = [&](const Node &n) {
+        uint64_t where = path ? static_cast<uint64_t>(n.step) : static_cast<uint64_t>(n.state);
+        return (where << 44) | (static_cast<uint64_t>(n.item) << 20) |
+               static_cast<uint64_t>(n.lookahead + 1);
+    };
+    auto push = [&](const Node &n) {
+        if (seen.insert(key(n)).second) {
+            pool.push_back(n);
+            queue.push_back(static_cast<int>(pool.size()) - 1);
+        }
+    };
+
+    int startStep = path ? static_cast<int>(path->size()) - 1 : 0;
+    push({state, item, lookahead, startStep, -1, false});
+
+    int goal = -1;
+    while (!queue.empty()) {
+        if (pool.size() > budget.maxNodes)
+            break;
+        if ((pool.size() & 1023) == 0 && chrono::steady_clock::now() > deadline)
+            break;
+
+        int id = queue.front();
+        queue.pop_front();
+        nodes++;
+
+        const Node n = pool[id];
+        const Item it = items[n.state][n.item];
+        const LRProduction &rule = table.production(it.production);
+
+        if (n.state == 0 && it.production == 0 && it.dot == 0 &&
+            (n.lookahead < 0 || n.lookahead == end) && (!path || n.step == 0)) {
+            goal = id;
+            break;
+        }
+
+        if (it.dot > 0) {
+            int X = rule.rhs[it.dot - 1];
+            if (path) {
+                if (n.step == 0 || (*prefix)[n.step - 1] != X) continue;
+                int q = (*path)[n.step - 1];
+                int j = findItem(q, it.production, it.dot - 1);
+                if (j >= 0) push({q, j, n.lookahead, n.step - 1, id, false});
+            } else {
+                for (const auto &pred : predecessors[n.state]) {
+                    if (pred.second != X) continue;
+                    int j = findItem(pred.first, it.production, it.dot - 1);
+                    if (j >= 0) push({pred.first, j, n.lookahead, 0, id, false});
+                }
+            }
+            continue;
+        }
+
+        // Closure step: items C → δ • A η of the same state
+        if (it.production == 0) continue;
+        const auto &parents = parentsOf[n.state];
+        auto range = equal_range(parents.begin(), parents.end(), make_pair(rule.lhs, INT_MIN),
+                                 [](const pair<int, int> &a, const pair<int, int> &b) {
+                                     return a.first < b.first;
+                                 });
+
+        for (auto pit = range.first; pit != range.second; ++pit) {
+            const Item &parent = items[n.state][pit->second];
+            int after = parent.dot + 1;
+
+            int la;
+            if (n.lookahead < 0)
+                la = -1;
+            else if ((firstAfter[parent.production][after][n.lookahead / 64] >> (n.lookahead % 64)) & 1)
+                la = -1;
+            else if (nullableAfter[parent.production][after])
+                la = n.lookahead;
+            else
+                continue;
+
+            push({n.state, pit->second, la, n.step, id, true});
+        }
+    }
+
+    if (goal < 0)
+        return false;
+
+    // Parents lead from the start item forward to the conflict item
+    levels.clear();
+    statePath.assign(1, 0);
+    symbols.clear();
+
+    const Item &start = items[pool[goal].state][pool[goal].item];
+    levels.push_back({start.production, start.dot});
+
+    for (int cur = goal; pool[cur].parent >= 0; cur = pool[cur].parent) {
+        const Node &next = pool[pool[cur].parent];
+        const Item &nextItem = items[next.state][next.item];
+
+        if (pool[cur].production) {
+            levels.push_back({nextItem.production, nextItem.dot});
+        } else {
+            const LRProduction &rule = table.production(levels.back().production);
+            symbols.push_back(rule.rhs[levels.back().dot]);
+            levels.back().dot++;
+            statePath.push_back(next.state);
+        }
+    }
+
+    return true;
+}
+
+// ===================================================
+// Shortest terminal yields: any yield, and yields that
+// start with a given terminal (for the lookahead)
+// ===================================================
+void CounterexampleFinder::computeYields() {
+    const auto &prods = table.getProductions();
+    const int symbols = T + static_cast<int>(table.nonTerminalCount());
+
+    minLength.assign(symbols, INF);
+    minChoice.assign(symbols, -1);
+    for (int t = 0; t < T; ++t) minLength[t] = 1;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t q = 0; q < prods.size(); ++q) {
+            if (!live[q]) continue;
+            long long len = 0;
+            for (int sym : prods[q].rhs) len += minLength[sym];
+            int A = T + prods[q].lhs;
+            if (len < minLength[A]) {
+                minLength[A] = static_cast<int>(len);
+                minChoice[A] = static_cast<int>(q);
+                changed = true;
+            }
+        }
+    }
+
+    startLength.assign(T, {});
+    startChoice.assign(T, {});
+}
+
+void CounterexampleFinder::computeStartYield(int terminal) {
+    if (!startLength[terminal].empty()) return;
+
+    const auto &prods = table.getProductions();
+    const int symbols = T + static_cast<int>(table.nonTerminalCount());
+    vector<int> &len = startLength[terminal];
+    vector<pair<int, int>> &choice = startChoice[terminal];
+
+    len.assign(symbols, INF);
+    choice.assign(symbols, {-1, -1});
+    len[terminal] = 1;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t q = 0; q < prods.size(); ++q) {
+            if (!live[q]) continue;
+            const LRProduction &rule = prods[q];
+            int A = T + rule.lhs;
+
+            // Symbols before position k derive ε
+            for (int k = 0; k < rule.length; ++k) {
+                int sym = rule.rhs[k];
+                if (len[sym] < INF) {
+                    long long cand = len[sym];
+                    for (int j = k + 1; j < rule.length; ++j) cand += minLength[rule.rhs[j]];
+                    if (cand < len[A]) {
+                        len[A] = static_cast<int>(cand);
+                        choice[A] = {static_cast<int>(q), k};
+                        changed = true;
+                    }
+                }
+                if (!nullable[sym]) break;
+            }
+        }
+    }
+}
+
+void CounterexampleFinder::minYield(int symbol, vector<int> &out) const {
+    if (table.isTerminalSymbol(symbol)) {
+        out.push_back(symbol);
+        return;
+    }
+    int q = minChoice[symbol];
+    if (q < 0) return;
+    for (int sym : table.production(q).rhs)
+        minYield(sym, out);
+}
+
+bool CounterexampleFinder::startYield(int symbol, int terminal, vector<int> &out) const {
+    if (table.isTerminalSymbol(symbol)) {
+        if (symbol != terminal) return false;
+        out.push_back(symbol);
+        return true;
+    }
+
+    const auto &choice = startChoice[terminal];
+    if (choice.empty() || choice[symbol].first < 0) return false;
+
+    const LRProduction &rule = table.production(choice[symbol].first);
+    int k = choice[symbol].second;
+    for (int j = 0; j < k; ++j) minYield(rule.rhs[j], out);
+    if (!startYield(rule.rhs[k], terminal, out)) return false;
+    for (int j = k + 1; j < rule.length; ++j) minYield(rule.rhs[j], out);
+    return true;
+}
+
+// Prefix, then the rest of every open production from the
+// innermost outwards, starting with `terminal`
+bool CounterexampleFinder::sentenceFor(const vector<int> &prefix, const vector<Level> &levels,
+                                       int terminal, vector<string> &out) const {
+    vector<int> ids;
+    for (int sym : prefix) minYield(sym, ids);
+
+    vector<int> rest;
+    for (size_t i = levels.size(); i-- > 0;) {
+        const LRProduction &rule = table.production(levels[i].production);
+        int from = levels[i].dot + (i + 1 < levels.size() ? 1 : 0);
+        for (int k = from; k < rule.length; ++k) rest.push_back(rule.rhs[k]);
+    }
+
+    bool started = (terminal == table.endMarker());
+    for (int sym : rest) {
+        if (started) {
+            minYield(sym, ids);
+        } else if (startYield(sym, terminal, ids)) {
+            started = true;
+        } else if (nullable[sym]) {
+            minYield(sym, ids);
+        } else {
+            return false;
+        }
+    }
+    if (!started) return false;
+
+    out.clear();
+    for (int id : ids) out.push_back(table.terminalName(id));
+    return true;
+}
+
+// ===================================================
+// Text forms
+// ===================================================
+string CounterexampleFinder::symbolText(int symbol) const {
+    return table.symbolName(symbol);
+}
+
+string CounterexampleFinder::exampleText(const vector<int> &prefix, const vector<Level> &levels) const {
+    string s;
+    for (int sym : prefix) s += symbolText(sym) + " ";
+    s += "•";
+
+    for (size_t i = levels.size(); i-- > 0;) {
+        const LRProduction &rule = table.production(levels[i].production);
+        int from = levels[i].dot + (i + 1 < levels.size() ? 1 : 0);
+        for (int k = from; k < rule.length; ++k) s += " " + symbolText(rule.rhs[k]);
+    }
+    return s;
+}
+
+// Nested productions, "[...]" marking the expanded symbol;
+// the S' → S level is left out
+string CounterexampleFinder::derivationText(const vector<Level> &levels) const {
+    string inner;
+    for (size_t i = levels.size(); i-- > 1;) {
+        const LRProduction &rule = table.production(levels[i].production);
+        bool last = (i + 1 == levels.size());
+
+        string s = table.nonTerminalName(rule.lhs) + " →";
+        for (int k = 0; k < rule.length; ++k) {
+            if (k == levels[i].dot) s += last ? " •" : " [" + inner + "]";
+            if (!(k == levels[i].dot && !last)) s += " " + symbolText(rule.rhs[k]);
+        }
+        if (levels[i].dot == rule.length && last) s += " •";
+        if (rule.length == 0 && last) s += " ε";
+        inner = s;
+    }
+    return inner;
+}
+
+// ===================================================
+// One conflict: derivation of the action with a
+// lookahead constraint first, then the other one over
+// the same state path (any path if that fails)
+// ===================================================
+Counterexample CounterexampleFinder::searchOne(const ConflictRecord &conflict,
+                                               vector<vector<string>> &sentences) const {
+    auto t0 = chrono::steady_clock::now();
+    auto deadline = t0 + chrono::duration_cast<chrono::steady_clock::duration>(
+                             chrono::duration<double, milli>(budget.millis));
+
+    Counterexample ex;
+    ex.conflict = conflict;
+    ex.terminal = table.terminalName(conflict.column);
+    ex.firstAction = table.actionToString(conflict.first);
+    ex.secondAction = table.actionToString(conflict.second);
+
+    uint32_t actions[2] = {conflict.first, conflict.second};
+    int primary = (actionTag(conflict.first) == ACT_SHIFT) ? 1 : 0;
+
+    int la[2];
+    int item[2] = {itemFor(conflict.row, actions[0], conflict.column, la[0]),
+                   itemFor(conflict.row, actions[1], conflict.column, la[1])};
+
+    vector<Level> levels[2];
+    vector<int> prefix[2], path[2];
+    bool ok = false;
+
+    // Constrained to the other derivation's path when given; if the
+    // terminal only reached the cell through FOLLOW, the items are
+    // shown anyway, without the lookahead
+    auto derive = [&](int k, const vector<int> *onPath, const vector<int> *onPrefix) {
+        if (search(conflict.row, item[k], la[k], onPath, onPrefix, deadline, ex.nodes,
+                   levels[k], path[k], prefix[k]))
+            return true;
+        if (la[k] < 0 || chrono::steady_clock::now() > deadline)
+            return false;
+        if (!search(conflict.row, item[k], -1, onPath, onPrefix, deadline, ex.nodes,
+                    levels[k], path[k], prefix[k]))
+            return false;
+        ex.followOnly = true;
+        return true;
+    };
+
+    if (item[0] >= 0 && item[1] >= 0) {
+        int other = 1 - primary;
+        ok = derive(primary, nullptr, nullptr) &&
+             (derive(other, &path[primary], &prefix[primary]) || derive(other, nullptr, nullptr));
+    }
+
+    ex.found = ok;
+    ex.exhausted = !ok && chrono::steady_clock::now() > deadline;
+
+    if (ok) {
+        for (int k = 0; k < 2 && !ex.followOnly; ++k) {
+            vector<string> words;
+            if (sentenceFor(prefix[k], levels[k], conflict.column, words))
+                sentences.push_back(words);
+        }
+        ex.firstExample = exampleText(prefix[0], levels[0]);
+        ex.secondExample = exampleText(prefix[1], levels[1]);
+        ex.firstDerivation = derivationText(levels[0]);
+        ex.secondDerivation = derivationText(levels[1]);
+    }
+
+    ex.millis = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    return ex;
+}
+
+// ===================================================
+// All conflicts: searches run in parallel; the GLR
+// ambiguity check of the example sentences runs after
+// ===================================================
+vector<Counterexample> CounterexampleFinder::findAll() {
+    PhaseTimer timer("counterexamples");
+    const auto &records = table.getConflicts();
+
+    set<int> terminals;
+    for (const auto &r : records) terminals.insert(r.column);
+    for (int t : terminals) computeStartYield(t);
+
+    vector<Counterexample> results(records.size());
+    vector<vector<vector<string>>> sentences(records.size());
+
+    parallelFor(records.size(), budget.threads, [&](size_t i) {
+        results[i] = searchOne(records[i], sentences[i]);
+    });
+
+    GLRParser glr(parser);
+    for (size_t i = 0; i < records.size(); ++i) {
+        Counterexample &ex = results[i];
+        auto t0 = chrono::steady_clock::now();
+
+        for (const auto &words : sentences[i]) {
+            string text;
+            for (const auto &w : words) text += (text.empty() ? "" : " ") + w;
+            if (!ex.sentence.empty() && text == ex.sentence) continue;
+
+            if (!glr.parse<SilentLog>(words)) continue;
+            uint64_t trees = glr.getForest().countTrees();
+            if (ex.sentence.empty() || trees > ex.parseTrees) {
+                ex.sentence = text;
+                ex.parseTrees = trees;
+            }
+            if (trees > 1) {
+                ex.unifying = true;
+                break;
+            }
+        }
+
+        ex.millis += chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    }
+
+    return results;
+}
+
+// ===================================================
+// Report
+// ===================================================
+template <typename Log>
+void CounterexampleFinder::display(const vector<Counterexample> &examples) {
+    reportAt<Log>(Verbosity::DETAIL, [&](ReportStream &report) {
+        std::ostringstream out;
+        size_t found = 0, ambiguous = 0, followOnly = 0;
+        double millis = 0.0;
+
+        out << "\n===== Conflict Counterexamples =====\n";
+
+        for (const auto &ex : examples) {
+            string kind;
+            switch (ex.conflict.kind) {
+            case ConflictKind::SHIFT_REDUCE:  kind = "Shift/Reduce"; break;
+            case ConflictKind::REDUCE_REDUCE: kind = "Reduce/Reduce"; break;
+            case ConflictKind::SHIFT_SHIFT:   kind = "Shift/Shift"; break;
+            default:                          kind = "Multiple Actions"; break;
+            }
+
+            out << "\n🔎 " << kind << " in state " << ex.conflict.row << " on '" << ex.terminal << "': "
+                << ex.firstAction << " vs " << ex.secondAction << "\n";
+            millis += ex.millis;
+
+            if (!ex.found) {
+                out << (ex.exhausted ? "   ⏱️  No counterexample within the budget"
+                                     : "   ⚠️  No counterexample found")
+                    << " (" << ex.nodes << " nodes)\n";
+                continue;
+            }
+            found++;
+            if (ex.followOnly) followOnly++;
+
+            if (ex.firstExample == ex.secondExample) {
+                out << "   Example            : " << ex.firstExample << "\n";
+            } else {
+                out << "   First example      : " << ex.firstExample << "\n";
+                out << "   Second example     : " << ex.secondExample << "\n";
+            }
+            out << "   First derivation   : " << ex.firstDerivation << "   (" << ex.firstAction << ")\n";
+            out << "   Second derivation  : " << ex.secondDerivation << "   (" << ex.secondAction << ")\n";
+
+            if (ex.followOnly) {
+                out << "   ℹ️  '" << ex.terminal << "' never follows the reduction in this state;"
+                    << " SLR-only conflict (FOLLOW set artifact)\n";
+            } else if (ex.unifying) {
+                ambiguous++;
+                out << "   ✅ Ambiguous sentence: \"" << ex.sentence << "\" has "
+                    << ex.parseTrees << " parse trees\n";
+            } else if (!ex.sentence.empty()) {
+                out << "   Sentence \"" << ex.sentence << "\" has a single parse (non-unifying example)\n";
+            }
+            out << "   (" << ex.nodes << " nodes, " << fixed << setprecision(2) << ex.millis << " ms)\n";
+        }
+
+        out << "\nCounterexamples: " << found << " / " << examples.size() << " found, "
+            << ambiguous << " ambiguous sentences, " << followOnly << " SLR-only, " << fixed << setprecision(2) << millis
+            << " ms of search\n";
+        out << "====================================\n";
+
+        report.emit(ReportEvent("message").add("text", out.str()), Verbosity::DETAIL);
+    });
+}
+
+#ifndef GRAMRESOLVE_NO_REPORT
+template void CounterexampleFinder::display<ReportLog>(const vector<Counterexample> &examples);
+#endif
+template void CounterexampleFinder::display<SilentLog>(const vector<Counterexample> &examples);
@@ -0,0 +1,140 @@
+// ===============================================================
+// File: CounterexampleFinder.h
+// Description: Counterexamples for LR conflicts (in the spirit of
+//              Bison's -Wcounterexamples). For each conflict the
+//              automaton is searched backwards for the shortest
+//              lookahead-sensitive item path to the conflicted state;
+//              both actions get a derivation over the same prefix,
+//              and the example is checked for ambiguity with GLR.
+//              Conflicts are searched in parallel, each under its
+//              own time and node budget.
+// ===============================================================
+
+#ifndef COUNTEREXAMPLE_FINDER_H
+#define COUNTEREXAMPLE_FINDER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include <chrono>
+#include "../parser/LRParser.h"
+#include "../analysis/ConflictRecord.h"
+
+using namespace std;
+
+// ===============================================================
+// Struct: CounterexampleBudget
+// ===============================================================
+struct CounterexampleBudget {
+    double millis = 200.0;          // per conflict
+    size_t maxNodes = 200000;       // search nodes per conflict (memory)
+    unsigned threads = 0;           // 0 = all hardware threads
+};
+
+// ===============================================================
+// Struct: Counterexample
+// ===============================================================
+struct Counterexample {
+    ConflictRecord conflict;
+    string terminal;
+    string firstAction;             // e.g. "s6", "rE->E + E "
+    string secondAction;
+
+    bool found = false;             // both derivations built
+    bool exhausted = false;         // gave up on the budget
+    bool unifying = false;          // one sentence, several parse trees
+    bool followOnly = false;        // terminal cannot follow here: SLR-only conflict
+
+    string firstExample;            // sentential form with "•"
+    string secondExample;
+    string firstDerivation;         // "E → [E → E + E •] + E"
+    string secondDerivation;
+    string sentence;                // terminal string tried with GLR
+    uint64_t parseTrees = 0;
+
+    size_t nodes = 0;               // search nodes expanded
+    double millis = 0.0;
+};
+
+// ===============================================================
+// Class: CounterexampleFinder
+// ===============================================================
+class CounterexampleFinder {
+private:
+    typedef vector<uint64_t> Bits;
+
+    // Item of one state: production id + dot
+    struct Item {
+        int production;
+        int dot;
+    };
+
+    // Backward search node; `parent` points towards the conflict
+    struct Node {
+        int state;
+        int item;                   // index into items[state]
+        int lookahead;              // required next terminal, -1 = any
+        int step;                   // index into the state path (constrained search)
+        int parent;
+        bool production;            // reached through a closure step
+    };
+
+    // One level of a derivation: production with its dot
+    struct Level {
+        int production;
+        int dot;
+    };
+
+    const LR0Parser &parser;
+    const LRTable &table;
+    CounterexampleBudget budget;
+    int T = 0;
+
+    vector<vector<Item>> items;                           // state → items
+    unordered_map<uint64_t, int> itemIndex;               // (state, production, dot) → item
+    vector<vector<pair<int, int>>> parentsOf;             // state → sorted (A, item with •A)
+    vector<vector<pair<int, int>>> predecessors;          // state → (state, symbol)
+    vector<char> live;                                    // production not retired
+    vector<vector<Bits>> firstAfter;                      // production → position → FIRST
+    vector<vector<char>> nullableAfter;
+    vector<char> nullable;                                // per symbol
+
+    // Shortest yields for the example sentences
+    vector<int> minLength;
+    vector<int> minChoice;
+    vector<vector<int>> startLength;                      // terminal → symbol → length
+    vector<vector<pair<int, int>>> startChoice;           // terminal → symbol → (production, position)
+
+    int findItem(int state, int production, int dot) const;
+    int itemFor(int state, uint32_t action, int terminal, int &lookahead) const;
+
+    bool search(int state, int item, int lookahead, const vector<int> *path,
+                const vector<int> *prefix, chrono::steady_clock::time_point deadline, size_t &nodes,
+                vector<Level> &levels, vector<int> &statePath, vector<int> &symbols) const;
+
+    void computeYields();
+    void computeStartYield(int terminal);
+    void minYield(int symbol, vector<int> &out) const;
+    bool startYield(int symbol, int terminal, vector<int> &out) const;
+    bool sentenceFor(const vector<int> &prefix, const vector<Level> &levels,
+                     int terminal, vector<string> &out) const;
+
+    string symbolText(int symbol) const;
+    string exampleText(const vector<int> &prefix, const vector<Level> &levels) const;
+    string derivationText(const vector<Level> &levels) const;
+
+    Counterexample searchOne(const ConflictRecord &conflict, vector<vector<string>> &sentences) const;
+
+public:
+    CounterexampleFinder(const LR0Parser &parser, CounterexampleBudget budget = CounterexampleBudget());
+
+    // One counterexample per conflict record of the parser's table
+    vector<Counterexample> findAll();
+
+    // Report (terminal + report file)
+    template <typename Log = DefaultLog>
+    static void display(const vector<Counterexample> &examples);
+};
+
+#endif
@@ -0,0 +1,829 @@
+#include "GrammarRewriter.h"
+#include "../util/Instrumentation.h"
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <deque>
+#include <chrono>
+#include <functional>
+
+using namespace std;
+
+// ε variants of one alternative: at most 2^MAX_OPTIONAL
+static const size_t MAX_OPTIONAL = 10;
+
+template <typename T>
+static void addAll(set<T> &into, const set<T> &from) {
+    into.insert(from.begin(), from.end());
+}
+
+// Append an alternative; a repeated RHS only adds its origins
+template <typename Alt>
+static void addAlternative(vector<Alt> &alts, const Alt &alt) {
+    for (auto &a : alts)
+        if (a.rhs == alt.rhs) {
+            addAll(a.origins, alt.origins);
+            return;
+        }
+    alts.push_back(alt);
+}
+
+// ===================================================
+// Constructor — copy the rules (ε → empty RHS), number
+// the original productions and analyze everything once
+// ===================================================
+GrammarRewriter::GrammarRewriter(const Grammar &g) {
+    start = g.getStartSymbol();
+    terminals = g.getTerminals();
+
+    for (const auto &prod : g.getProductions()) {
+        const string &A = prod.getLHS();
+        if (!rules.count(A)) {
+            order.push_back(A);
+            rules[A];
+        }
+
+        for (const auto &alt : prod.getRHS()) {
+            Alternative a;
+            if (!(alt.size() == 1 && alt[0] == "ε"))
+                a.rhs = alt;
+            a.origins.insert(static_cast<int>(originals.size()));
+            originals.push_back(A + " -> " + altText(a.rhs));
+            addAlternative(rules[A], a);
+        }
+    }
+
+    for (const auto &t : terminals) {
+        terminalIndex[t] = static_cast<int>(terminalNames.size());
+        terminalNames.push_back(t);
+    }
+    terminalIndex["$"] = static_cast<int>(terminalNames.size());
+    terminalNames.push_back("$");
+    words = (terminalNames.size() + 63) / 64;
+
+    reanalyze(set<string>(order.begin(), order.end()));
+}
+
+string GrammarRewriter::freshName(const string &base) const {
+    string name = base + "'";
+    while (rules.count(name) || terminals.count(name))
+        name += "'";
+    return name;
+}
+
+string GrammarRewriter::altText(const vector<string> &rhs) {
+    if (rhs.empty()) return "ε";
+    string s;
+    for (const auto &sym : rhs) s += (s.empty() ? "" : " ") + sym;
+    return s;
+}
+
+// ===================================================
+// Incremental LL(1) analysis
+// ===================================================
+GrammarRewriter::Bits GrammarRewriter::firstOf(const vector<string> &rhs, size_t from,
+                                               bool &allNullable) const {
+    Bits result(words, 0);
+    allNullable = true;
+
+    for (size_t k = from; k < rhs.size(); ++k) {
+        auto nt = first.find(rhs[k]);
+        if (nt == first.end()) {
+            auto t = terminalIndex.find(rhs[k]);
+            if (t != terminalIndex.end())
+                result[t->second / 64] |= uint64_t(1) << (t->second % 64);
+            allNullable = false;
+            return result;
+        }
+
+        for (size_t w = 0; w < words; ++w) result[w] |= nt->second[w];
+        if (!nullable.at(rhs[k])) {
+            allNullable = false;
+            return result;
+        }
+    }
+    return result;
+}
+
+// Records as LL1Parser counts them: k alternatives in a cell → k - 1
+size_t GrammarRewriter::countConflicts(const string &A) const {
+    const auto &alts = rules.at(A);
+    if (alts.size() < 2) return 0;
+
+    vector<Bits> predict;
+    for (const auto &alt : alts) {
+        bool n;
+        predict.push_back(firstOf(alt.rhs, 0, n));
+        if (n)
+            for (size_t w = 0; w < words; ++w) predict.back()[w] |= follow.at(A)[w];
+    }
+
+    size_t records = 0;
+    for (size_t t = 0; t < terminalNames.size(); ++t) {
+        size_t count = 0;
+        for (const auto &p : predict) count += (p[t / 64] >> (t % 64)) & 1;
+        if (count > 1) records += count - 1;
+    }
+    return records;
+}
+
+size_t GrammarRewriter::totalConflicts() const {
+    size_t total = 0;
+    for (const auto &c : conflictsOf) total += c.second;
+    return total;
+}
+
+// FIRST/nullable are recomputed for the changed non-terminals and
+// every non-terminal that uses them; FOLLOW for the symbols used in
+// those rules (before and after) and wherever their FOLLOW flows.
+// Everything else keeps its sets.
+void GrammarRewriter::reanalyze(const set<string> &changed) {
+    set<string> seeds;
+
+    // Use lists of the changed rules
+    for (const auto &A : changed) {
+        for (const auto &B : uses[A]) {
+            usedBy[B].erase(A);
+            seeds.insert(B);
+        }
+        uses[A].clear();
+
+        if (!rules.count(A)) {
+            uses.erase(A);
+            first.erase(A);
+            nullable.erase(A);
+            follow.erase(A);
+            conflictsOf.erase(A);
+            continue;
+        }
+
+        seeds.insert(A);
+        for (const auto &alt : rules[A])
+            for (const auto &sym : alt.rhs)
+                if (isNonTerminal(sym)) {
+                    uses[A].insert(sym);
+                    usedBy[sym].insert(A);
+                }
+    }
+    for (auto it = seeds.begin(); it != seeds.end();)
+        it = rules.count(*it) ? next(it) : seeds.erase(it);
+
+    // 🔹 FIRST / nullable
+    set<string> affectedFirst;
+    deque<string> work;
+    for (const auto &A : changed)
+        if (rules.count(A) && affectedFirst.insert(A).second) work.push_back(A);
+    while (!work.empty()) {
+        string X = work.front();
+        work.pop_front();
+        for (const auto &A : usedBy[X])
+            if (affectedFirst.insert(A).second) work.push_back(A);
+    }
+
+    for (const auto &A : affectedFirst) {
+        first[A].assign(words, 0);
+        nullable[A] = false;
+    }
+
+    bool grew = true;
+    while (grew) {
+        grew = false;
+        for (const auto &A : affectedFirst)
+            for (const auto &alt : rules[A]) {
+                bool n;
+                Bits f = firstOf(alt.rhs, 0, n);
+                for (size_t w = 0; w < words; ++w)
+                    if ((first[A][w] | f[w]) != first[A][w]) {
+                        first[A][w] |= f[w];
+                        grew = true;
+                    }
+                if (n && !nullable[A]) {
+                    nullable[A] = true;
+                    grew = true;
+                }
+            }
+    }
+
+    // 🔹 FOLLOW
+    for (const auto &A : affectedFirst) addAll(seeds, uses[A]);
+
+    set<string> affectedFollow;
+    for (const auto &B : seeds)
+        if (affectedFollow.insert(B).second) work.push_back(B);
+    while (!work.empty()) {
+        string X = work.front();
+        work.pop_front();
+        for (const auto &alt : rules[X])
+            for (size_t k = alt.rhs.size(); k-- > 0;) {
+                const string &sym = alt.rhs[k];
+                if (!isNonTerminal(sym)) break;
+                if (affectedFollow.insert(sym).second) work.push_back(sym);
+                if (!nullable[sym]) break;
+            }
+    }
+
+    const int end = terminalIndex.at("$");
+    for (const auto &B : affectedFollow) {
+        follow[B].assign(words, 0);
+        if (B == start) follow[B][end / 64] |= uint64_t(1) << (end % 64);
+    }
+
+    grew = true;
+    while (grew) {
+        grew = false;
+        for (const auto &B : affectedFollow) {
+            Bits f = follow[B];
+            for (const auto &A : usedBy[B])
+                for (const auto &alt : rules[A])
+                    for (size_t k = 0; k < alt.rhs.size(); ++k) {
+                        if (alt.rhs[k] != B) continue;
+                        bool n;
+                        Bits rest = firstOf(alt.rhs, k + 1, n);
+                        for (size_t w = 0; w < words; ++w) {
+                            f[w] |= rest[w];
+                            if (n) f[w] |= follow[A][w];
+                        }
+                    }
+            if (f != follow[B]) {
+                follow[B] = f;
+                grew = true;
+            }
+        }
+    }
+
+    // 🔹 Conflicts of every non-terminal whose sets may have moved
+    set<string> recheck = affectedFirst;
+    addAll(recheck, affectedFollow);
+    for (const auto &A : recheck)
+        conflictsOf[A] = countConflicts(A);
+    lastRechecked = recheck.size();
+}
+
+// ===================================================
+// Left recursion: strongly connected components of the
+// left-corner graph (Tarjan); `hidden` when some edge of
+// the cycle goes through a nullable prefix
+// ===================================================
+bool GrammarRewriter::findLeftRecursion(vector<string> &cycle, bool &hidden) const {
+    map<string, vector<pair<string, bool>>> edges;
+    for (const auto &A : order)
+        for (const auto &alt : rules.at(A))
+            for (size_t k = 0; k < alt.rhs.size(); ++k) {
+                const string &sym = alt.rhs[k];
+                if (!isNonTerminal(sym)) break;
+                edges[A].push_back({sym, k > 0});
+                if (!nullable.at(sym)) break;
+            }
+
+    map<string, int> index, low;
+    vector<string> stack;
+    set<string> onStack;
+    int counter = 0;
+    vector<vector<string>> components;
+
+    function<void(const string &)> connect = [&](const string &v) {
+        index[v] = low[v] = counter++;
+        stack.push_back(v);
+        onStack.insert(v);
+
+        for (const auto &e : edges[v]) {
+            if (!index.count(e.first)) {
+                connect(e.first);
+                low[v] = min(low[v], low[e.first]);
+            } else if (onStack.count(e.first)) {
+                low[v] = min(low[v], index[e.first]);
+            }
+        }
+
+        if (low[v] == index[v]) {
+            vector<string> comp;
+            string w;
+            do {
+                w = stack.back();
+                stack.pop_back();
+                onStack.erase(w);
+                comp.push_back(w);
+            } while (w != v);
+            components.push_back(comp);
+        }
+    };
+
+    for (const auto &A : order)
+        if (!index.count(A)) connect(A);
+
+    map<string, size_t> position;
+    for (size_t i = 0; i < order.size(); ++i) position[order[i]] = i;
+
+    for (auto &comp : components) {
+        set<string> members(comp.begin(), comp.end());
+        bool cyclic = comp.size() > 1;
+        bool viaNullable = false;
+
+        for (const auto &A : comp)
+            for (const auto &e : edges[A]) {
+                if (!members.count(e.first)) continue;
+                if (e.first == A) cyclic = true;
+                if (e.second) viaNullable = true;
+            }
+        if (!cyclic) continue;
+
+        sort(comp.begin(), comp.end(), [&](const string &a, const string &b) {
+            return position[a] < position[b];
+        });
+        cycle = comp;
+        hidden = viaNullable;
+        return true;
+    }
+    return false;
+}
+
+// ===================================================
+// A → A α | β   ⇒   A → β A',  A' → α A' | ε
+// ===================================================
+set<string> GrammarRewriter::eliminateDirect(const string &A, string &detail) {
+    vector<Alternative> recursive, base;
+    bool dropped = false;
+
+    for (const auto &alt : rules[A]) {
+        if (!alt.rhs.empty() && alt.rhs[0] == A) {
+            if (alt.rhs.size() == 1) {
+                dropped = true;             // A → A adds nothing
+                continue;
+            }
+            recursive.push_back({vector<string>(alt.rhs.begin() + 1, alt.rhs.end()), alt.origins});
+        } else {
+            base.push_back(alt);
+        }
+    }
+
+    if (recursive.empty() && dropped) {
+        rules[A] = base;
+        detail += "dropped " + A + " -> " + A + "; ";
+        return {A};
+    }
+    if (recursive.empty() || base.empty())
+        return {};
+
+    string tail = freshName(A);
+    order.push_back(tail);
+
+    vector<Alternative> head, loop;
+    set<int> loopOrigins;
+    for (auto alt : base) {
+        alt.rhs.push_back(tail);
+        addAlternative(head, alt);
+    }
+    for (auto alt : recursive) {
+        addAll(loopOrigins, alt.origins);
+        alt.rhs.push_back(tail);
+        addAlternative(loop, alt);
+    }
+    addAlternative(loop, Alternative{{}, loopOrigins});
+
+    rules[A] = head;
+    rules[tail] = loop;
+
+    auto joined = [](const vector<Alternative> &alts) {
+        string s;
+        for (const auto &alt : alts) s += (s.empty() ? "" : " | ") + altText(alt.rhs);
+        return s;
+    };
+    detail += A + " -> " + joined(head) + ", " + tail + " -> " + joined(loop) + "; ";
+    return {A, tail};
+}
+
+// Substitute A_j into A_i (j < i) along the cycle, then remove
+// the direct recursion that surfaces
+set<string> GrammarRewriter::eliminateIndirect(const vector<string> &cycle, string &detail) {
+    set<string> changed;
+
+    for (size_t i = 0; i < cycle.size(); ++i) {
+        const string &Ai = cycle[i];
+
+        for (size_t j = 0; j < i; ++j) {
+            const string &Aj = cycle[j];
+            vector<Alternative> next;
+            bool substituted = false;
+
+            for (const auto &alt : rules[Ai]) {
+                if (alt.rhs.empty() || alt.rhs[0] != Aj) {
+                    addAlternative(next, alt);
+                    continue;
+                }
+                substituted = true;
+                for (const auto &b : rules[Aj]) {
+                    Alternative merged{b.rhs, b.origins};
+                    merged.rhs.insert(merged.rhs.end(), alt.rhs.begin() + 1, alt.rhs.end());
+                    addAll(merged.origins, alt.origins);
+                    addAlternative(next, merged);
+                }
+            }
+
+            if (substituted) {
+                rules[Ai] = next;
+                changed.insert(Ai);
+                detail += Aj + " into " + Ai + "; ";
+            }
+        }
+
+        addAll(changed, eliminateDirect(Ai, detail));
+    }
+
+    if (detail.size() >= 2) detail.erase(detail.size() - 2);
+    return changed;
+}
+
+// ===================================================
+// A → α β1 | α β2 | γ   ⇒   A → α A' | γ,  A' → β1 | β2
+// ===================================================
+set<string> GrammarRewriter::leftFactor(const string &A, string &detail) {
+    map<string, vector<size_t>> byFirst;
+    const vector<Alternative> alts = rules[A];
+    for (size_t i = 0; i < alts.size(); ++i)
+        if (!alts[i].rhs.empty()) byFirst[alts[i].rhs[0]].push_back(i);
+
+    set<string> changed;
+    vector<Alternative> next;
+    set<string> done;
+
+    for (size_t i = 0; i < alts.size(); ++i) {
+        if (alts[i].rhs.empty() || byFirst[alts[i].rhs[0]].size() < 2) {
+            addAlternative(next, alts[i]);
+            continue;
+        }
+
+        const string &lead = alts[i].rhs[0];
+        if (!done.insert(lead).second) continue;
+
+        const auto &group = byFirst[lead];
+        size_t prefix = alts[group[0]].rhs.size();
+        for (size_t g : group) {
+            size_t k = 0;
+            while (k < prefix && k < alts[g].rhs.size() && alts[g].rhs[k] == alts[group[0]].rhs[k]) ++k;
+            prefix = k;
+        }
+
+        string tail = freshName(A);
+        order.push_back(tail);
+        rules[tail];
+
+        Alternative factored;
+        factored.rhs.assign(alts[i].rhs.begin(), alts[i].rhs.begin() + prefix);
+        factored.rhs.push_back(tail);
+
+        for (size_t g : group) {
+            addAll(factored.origins, alts[g].origins);
+            Alternative rest{vector<string>(alts[g].rhs.begin() + prefix, alts[g].rhs.end()), alts[g].origins};
+            addAlternative(rules[tail], rest);
+        }
+        addAlternative(next, factored);
+
+        vector<string> common(alts[i].rhs.begin(), alts[i].rhs.begin() + prefix);
+        detail += A + " -> " + altText(common) + " " + tail + "; ";
+        changed.insert(tail);
+    }
+
+    if (changed.empty()) return {};
+
+    rules[A] = next;
+    changed.insert(A);
+    detail.erase(detail.size() - 2);
+    return changed;
+}
+
+// Alternatives in a FIRST/FIRST conflict that start with another
+// non-terminal get that non-terminal's alternatives spliced in, so
+// the common prefix becomes visible to left factoring
+set<string> GrammarRewriter::expandLeading(const string &A, string &detail) {
+    const auto &alts = rules[A];
+    vector<Bits> firsts;
+    for (const auto &alt : alts) {
+        bool n;
+        firsts.push_back(firstOf(alt.rhs, 0, n));
+    }
+
+    string B;
+    for (size_t i = 0; i < alts.size() && B.empty(); ++i)
+        for (size_t j = 0; j < alts.size() && B.empty(); ++j) {
+            if (i == j) continue;
+            bool overlap = false;
+            for (size_t w = 0; w < words; ++w) overlap = overlap || (firsts[i][w] & firsts[j][w]);
+            if (overlap && !alts[i].rhs.empty() && isNonTerminal(alts[i].rhs[0]) && alts[i].rhs[0] != A)
+                B = alts[i].rhs[0];
+        }
+    if (B.empty()) return {};
+
+    vector<Alternative> next;
+    for (const auto &alt : alts) {
+        if (alt.rhs.empty() || alt.rhs[0] != B) {
+            addAlternative(next, alt);
+            continue;
+        }
+        for (const auto &b : rules[B]) {
+            Alternative merged{b.rhs, b.origins};
+            merged.rhs.insert(merged.rhs.end(), alt.rhs.begin() + 1, alt.rhs.end());
+            addAll(merged.origins, alt.origins);
+            addAlternative(next, merged);
+        }
+    }
+    rules[A] = next;
+
+    detail = B + " substituted into " + A;
+    return {A};
+}
+
+// ===================================================
+// ε-productions: every nullable occurrence becomes
+// optional, A → ε goes away; a nullable start symbol
+// gets a new start S' → S | ε
+// ===================================================
+set<string> GrammarRewriter::removeEpsilon(string &detail) {
+    set<string> changed(order.begin(), order.end());
+    size_t removed = 0;
+
+    for (const auto &A : order) {
+        vector<Alternative> next;
+
+        for (const auto &alt : rules[A]) {
+            if (alt.rhs.empty()) {
+                removed++;
+                continue;
+            }
+
+            vector<size_t> optional;
+            for (size_t k = 0; k < alt.rhs.size(); ++k)
+                if (isNonTerminal(alt.rhs[k]) && nullable.at(alt.rhs[k]) && optional.size() < MAX_OPTIONAL)
+                    optional.push_back(k);
+
+            for (size_t mask = 0; mask < (size_t(1) << optional.size()); ++mask) {
+                Alternative variant{{}, alt.origins};
+                size_t o = 0;
+                for (size_t k = 0; k < alt.rhs.size(); ++k) {
+                    bool skip = o < optional.size() && optional[o] == k && ((mask >> o) & 1);
+                    if (o < optional.size() && optional[o] == k) o++;
+                    if (!skip) variant.rhs.push_back(alt.rhs[k]);
+                }
+                if (!variant.rhs.empty()) addAlternative(next, variant);
+            }
+        }
+        rules[A] = next;
+    }
+
+    // Non-terminals that only derived ε disappear
+    bool pruned = true;
+    while (pruned) {
+        pruned = false;
+        for (auto it = order.begin(); it != order.end();) {
+            if (*it != start && rules[*it].empty()) {
+                rules.erase(*it);
+                it = order.erase(it);
+                pruned = true;
+            } else {
+                ++it;
+            }
+        }
+        for (const auto &A : order) {
+            auto &alts = rules[A];
+            alts.erase(remove_if(alts.begin(), alts.end(), [&](const Alternative &alt) {
+                           for (const auto &sym : alt.rhs)
+                               if (!isNonTerminal(sym) && !terminals.count(sym)) return true;
+                           return false;
+                       }),
+                       alts.end());
+        }
+    }
+
+    detail = to_string(removed) + " ε-alternatives removed";
+
+    if (nullable.at(start)) {
+        string newStart = freshName(start);
+        rules[newStart] = {Alternative{{start}, {}}, Alternative{{}, {}}};
+        order.insert(order.begin(), newStart);
+        changed.insert(newStart);
+        detail += ", new start " + newStart + " -> " + start + " | ε";
+        start = newStart;
+    }
+    return changed;
+}
+
+// Rules no longer reachable from the start symbol (e.g. the
+// last user of a non-terminal was substituted away)
+set<string> GrammarRewriter::removeUnreachable() {
+    set<string> reached = {start};
+    deque<string> work = {start};
+    while (!work.empty()) {
+        string A = work.front();
+        work.pop_front();
+        for (const auto &alt : rules[A])
+            for (const auto &sym : alt.rhs)
+                if (isNonTerminal(sym) && reached.insert(sym).second) work.push_back(sym);
+    }
+
+    set<string> removed;
+    for (auto it = order.begin(); it != order.end();) {
+        if (!reached.count(*it)) {
+            removed.insert(*it);
+            rules.erase(*it);
+            it = order.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return removed;
+}
+
+// ===================================================
+// Rewrite loop
+// ===================================================
+RewriteResult GrammarRewriter::rewriteToLL1(size_t maxSteps) {
+    PhaseTimer timer("rewrite");
+    RewriteResult result;
+    result.initialConflicts = totalConflicts();
+    set<string> giveUp;
+
+    set<string> unused = removeUnreachable();
+    if (!unused.empty()) reanalyze(unused);
+    result.unreachable.assign(unused.begin(), unused.end());
+
+    while (true) {
+        vector<string> cycle;
+        bool hidden = false;
+        bool leftRecursive = findLeftRecursion(cycle, hidden);
+
+        if (totalConflicts() == 0 && !leftRecursive)
+            break;
+        if (result.steps.size() >= maxSteps) {
+            result.budgetExhausted = true;
+            break;
+        }
+
+        RewriteStep step;
+        set<string> changed;
+
+        if (leftRecursive) {
+            if (hidden) {
+                step.kind = "ε-removal";
+                changed = removeEpsilon(step.detail);
+            } else {
+                step.kind = "left recursion";
+                changed = eliminateIndirect(cycle, step.detail);
+            }
+            if (changed.empty()) {
+                result.unresolved = cycle;      // e.g. A → A α with no base case
+                break;
+            }
+        } else {
+            string A;
+            for (const auto &nt : order)
+                if (conflictsOf[nt] > 0 && !giveUp.count(nt)) {
+                    A = nt;
+                    break;
+                }
+            if (A.empty())
+                break;
+
+            step.kind = "left factoring";
+            changed = leftFactor(A, step.detail);
+            if (changed.empty()) {
+                step.kind = "substitution";
+                changed = expandLeading(A, step.detail);
+            }
+            if (changed.empty()) {
+                giveUp.insert(A);               // FIRST/FOLLOW clash no rewrite here fixes
+                continue;
+            }
+        }
+
+        unused = removeUnreachable();
+        addAll(changed, unused);
+        result.unreachable.insert(result.unreachable.end(), unused.begin(), unused.end());
+
+        auto t0 = chrono::steady_clock::now();
+        reanalyze(changed);
+        step.recheckMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        step.rechecked = lastRechecked;
+        step.nonTerminals = rules.size();
+        step.conflictsAfter = totalConflicts();
+        result.steps.push_back(step);
+    }
+
+    result.finalConflicts = totalConflicts();
+    result.conflictFree = result.finalConflicts == 0 && result.unresolved.empty();
+    if (result.unresolved.empty())
+        for (const auto &A : order)
+            if (conflictsOf[A] > 0) result.unresolved.push_back(A);
+
+    result.grammar = toGrammar();
+    for (const auto &A : order)
+        for (const auto &alt : rules[A]) {
+            ProductionOrigin origin;
+            origin.production = A + " -> " + altText(alt.rhs);
+            for (int o : alt.origins) origin.origins.push_back(originals[o]);
+            result.mapping.push_back(origin);
+        }
+    return result;
+}
+
+// Start symbol first, so Grammar::apply makes it the start
+Grammar GrammarRewriter::toGrammar() const {
+    Grammar g;
+    vector<string> lhsOrder = {start};
+    for (const auto &A : order)
+        if (A != start) lhsOrder.push_back(A);
+
+    for (const auto &A : lhsOrder)
+        for (const auto &alt : rules.at(A))
+            g.apply({GrammarEdit::ADD, A, alt.rhs, ""});
+    return g;
+}
+
+// ===================================================
+// Report
+// ===================================================
+
+// setw counts bytes; "ε" is two of them but one column
+static size_t columns(const string &s) {
+    size_t n = 0;
+    for (unsigned char c : s)
+        if ((c & 0xC0) != 0x80) n++;
+    return n;
+}
+
+static string padRight(const string &s, size_t width) {
+    size_t n = columns(s);
+    return n < width ? s + string(width - n, ' ') : s;
+}
+
+template <typename Log>
+void GrammarRewriter::display(const RewriteResult &result) {
+    reportAt<Log>(Verbosity::DETAIL, [&](ReportStream &report) {
+        std::ostringstream out;
+
+        out << "\n===== Grammar Rewriting (LL(1)) =====\n";
+        out << "Initial LL(1) conflicts : " << result.initialConflicts << "\n";
+
+        if (!result.steps.empty()) {
+            out << "\n #  " << left << setw(17) << "Step" << setw(11) << "Conflicts"
+                << setw(14) << "Re-checked" << "Time (ms)   Detail\n";
+            for (size_t i = 0; i < result.steps.size(); ++i) {
+                const RewriteStep &s = result.steps[i];
+                report.emit(ReportEvent("rewrite_step")
+                                .add("kind", s.kind)
+                                .add("conflicts", s.conflictsAfter)
+                                .add("rechecked", s.rechecked)
+                                .add("nonterminals", s.nonTerminals)
+                                .add("micros", static_cast<int64_t>(s.recheckMs * 1000))
+                                .add("detail", s.detail));
+                out << " " << setw(3) << i + 1 << padRight(s.kind, 17) << setw(11) << s.conflictsAfter
+                    << setw(14) << (to_string(s.rechecked) + " / " + to_string(s.nonTerminals))
+                    << setw(12) << fixed << setprecision(3) << s.recheckMs << s.detail << "\n";
+            }
+        }
+
+        out << "\nRewritten grammar (⟵ original productions):\n";
+        size_t width = 0;
+        for (const auto &m : result.mapping) width = max(width, columns(m.production));
+        for (const auto &m : result.mapping) {
+            report.emit(ReportEvent("rewrite_origin").add("production", m.production).add("origins", m.origins));
+            out << "   " << padRight(m.production, width + 2) << "⟵ ";
+            if (m.origins.empty()) out << "(added)";
+            for (size_t k = 0; k < m.origins.size(); ++k)
+                out << (k ? ", " : "") << m.origins[k];
+            out << "\n";
+        }
+
+        if (!result.unreachable.empty()) {
+            out << "\nDropped unreachable:";
+            for (const auto &A : result.unreachable) out << " " << A;
+            out << "\n";
+        }
+
+        out << "\n";
+        if (result.conflictFree) {
+            out << "✅ LL(1) after " << result.steps.size() << " rewrite steps\n";
+        } else {
+            out << "⚠️  " << result.finalConflicts << " LL(1) conflicts remain";
+            if (result.budgetExhausted) out << " (step budget exhausted)";
+            if (!result.unresolved.empty()) {
+                out << "; unresolved:";
+                for (const auto &A : result.unresolved) out << " " << A;
+            }
+            out << "\n";
+        }
+        out << "=====================================\n";
+
+        report.emit(ReportEvent("rewrite_result")
+                        .add("initial_conflicts", result.initialConflicts)
+                        .add("final_conflicts", result.finalConflicts)
+                        .add("steps", result.steps.size())
+                        .add("budget_exhausted", static_cast<int>(result.budgetExhausted))
+                        .add("unresolved", result.unresolved)
+                        .add("unreachable", result.unreachable));
+        report.emit(ReportEvent("message").add("text", out.str()));
+    });
+}
+
+#ifndef GRAMRESOLVE_NO_REPORT
+template void GrammarRewriter::display<ReportLog>(const RewriteResult &);
+#endif
+template void GrammarRewriter::display<SilentLog>(const RewriteResult &);
@@ -0,0 +1,126 @@
+// ===============================================================
+// File: GrammarRewriter.h
+// Description: Grammar transformations for LL(1): left-recursion
+//              elimination (direct and indirect), left factoring and
+//              ε-production removal. rewriteToLL1() applies them one
+//              step at a time and re-checks the LL(1) conflicts after
+//              each step, recomputing FIRST/FOLLOW only for the
+//              non-terminals the step can have affected.
+// ===============================================================
+
+#ifndef GRAMMAR_REWRITER_H
+#define GRAMMAR_REWRITER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <cstdint>
+#include "../grammar/Grammar.h"
+#include "../report/ReportPolicy.h"
+
+using namespace std;
+
+// ===============================================================
+// Struct: RewriteStep
+// ===============================================================
+struct RewriteStep {
+    string kind;                    // "left recursion", "left factoring", ...
+    string detail;
+    size_t conflictsAfter = 0;
+    size_t rechecked = 0;           // non-terminals whose sets were recomputed
+    size_t nonTerminals = 0;
+    double recheckMs = 0.0;
+};
+
+// ===============================================================
+// Struct: ProductionOrigin
+// A production of the rewritten grammar and the original
+// productions it was derived from ("E -> E + T")
+// ===============================================================
+struct ProductionOrigin {
+    string production;
+    vector<string> origins;
+};
+
+// ===============================================================
+// Struct: RewriteResult
+// ===============================================================
+struct RewriteResult {
+    Grammar grammar;
+    vector<RewriteStep> steps;
+    vector<ProductionOrigin> mapping;
+    size_t initialConflicts = 0;
+    size_t finalConflicts = 0;
+    bool conflictFree = false;
+    bool budgetExhausted = false;
+    vector<string> unresolved;      // non-terminals no rewrite could fix
+    vector<string> unreachable;     // rules dropped, no longer used from the start
+};
+
+// ===============================================================
+// Class: GrammarRewriter
+// ===============================================================
+class GrammarRewriter {
+private:
+    typedef vector<uint64_t> Bits;
+
+    struct Alternative {
+        vector<string> rhs;         // empty = ε
+        set<int> origins;           // indices into `originals`
+    };
+
+    string start;
+    vector<string> order;                           // non-terminals, in creation order
+    map<string, vector<Alternative>> rules;
+    set<string> terminals;
+    vector<string> originals;                       // original productions
+
+    // 🔹 Incremental LL(1) analysis
+    map<string, int> terminalIndex;                 // terminals, then "$"
+    vector<string> terminalNames;
+    size_t words = 0;
+    map<string, Bits> first;
+    map<string, bool> nullable;
+    map<string, Bits> follow;
+    map<string, set<string>> uses;                  // A → non-terminals in A's rules
+    map<string, set<string>> usedBy;                // B → non-terminals using B
+    map<string, size_t> conflictsOf;                // A → conflict records
+    size_t lastRechecked = 0;
+
+    bool isNonTerminal(const string &sym) const { return rules.count(sym) != 0; }
+    string freshName(const string &base) const;
+    static string altText(const vector<string> &rhs);
+
+    Bits firstOf(const vector<string> &rhs, size_t from, bool &allNullable) const;
+    size_t countConflicts(const string &A) const;
+    void reanalyze(const set<string> &changed);
+    size_t totalConflicts() const;
+
+    // Left-corner graph: A → B when A ⇒ γ B … with γ nullable
+    bool findLeftRecursion(vector<string> &cycle, bool &hidden) const;
+
+    // Transformations; each returns the non-terminals it changed
+    set<string> eliminateDirect(const string &A, string &detail);
+    set<string> eliminateIndirect(const vector<string> &cycle, string &detail);
+    set<string> leftFactor(const string &A, string &detail);
+    set<string> expandLeading(const string &A, string &detail);
+    set<string> removeEpsilon(string &detail);
+    set<string> removeUnreachable();
+
+    Grammar toGrammar() const;
+
+public:
+    explicit GrammarRewriter(const Grammar &g);
+
+    // Run the transformations until the grammar is LL(1) or
+    // `maxSteps` rewrites have been made
+    RewriteResult rewriteToLL1(size_t maxSteps = 32);
+
+    // Steps, rewritten grammar and origin mapping: rewrite_step and
+    // rewrite_origin events, a rewrite_result event, the text block
+    template <typename Log = DefaultLog>
+    static void display(const RewriteResult &result);
+};
+
+#endif
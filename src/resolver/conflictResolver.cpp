@@ -23,7 +23,9 @@ void ConflictResolver::resolveConflicts(
     if (conflicts.empty()) {
         out << "✅ No conflicts to resolve.\n";
         cout << out.str();
+#ifndef GRAMRESOLVE_NO_REPORT
         ReportWriter::get() << out.str();
+#endif
         return;
     }
 
@@ -31,7 +33,9 @@ void ConflictResolver::resolveConflicts(
     out << string(80, '=') << "\n";
 
     cout << out.str();
+#ifndef GRAMRESOLVE_NO_REPORT
     ReportWriter::get() << out.str();
+#endif
     out.str("");
 
     for (const auto &c : conflicts) {
@@ -49,7 +53,9 @@ void ConflictResolver::resolveConflicts(
         block << string(80, '-') << "\n";
 
         cout << block.str();
+#ifndef GRAMRESOLVE_NO_REPORT
         ReportWriter::get() << block.str();
+#endif
     }
 }
 
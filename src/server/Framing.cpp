@@ -0,0 +1,63 @@
+#include "Framing.h"
+#include <cerrno>
+#include <unistd.h>
+
+using namespace std;
+
+bool FrameReader::fill() {
+    // Consumed bytes are dropped before the buffer grows
+    if (pos > 0) {
+        buffer.erase(0, pos);
+        pos = 0;
+    }
+
+    char chunk[64 * 1024];
+    while (true) {
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buffer.append(chunk, static_cast<size_t>(n));
+        return true;
+    }
+}
+
+bool FrameReader::readLine(string &line) {
+    size_t scanned = pos;
+    while (true) {
+        size_t nl = buffer.find('\n', scanned);
+        size_t length = (nl != string::npos ? nl : buffer.size()) - pos;
+        if (maxLine > 0 && length > maxLine) {
+            line.assign(buffer, pos, maxLine);
+            overlong = true;
+            return false;
+        }
+        if (nl != string::npos) {
+            size_t end = (nl > pos && buffer[nl - 1] == '\r') ? nl - 1 : nl;
+            line.assign(buffer, pos, end - pos);
+            pos = nl + 1;
+            return true;
+        }
+        scanned = buffer.size() - pos;      // offset survives the erase in fill()
+        if (!fill()) return false;
+        scanned += pos;
+    }
+}
+
+bool FrameReader::readBytes(size_t n, string &out) {
+    while (buffer.size() - pos < n)
+        if (!fill()) return false;
+    out.assign(buffer, pos, n);
+    pos += n;
+    return true;
+}
+
+bool writeAll(int fd, const string &data) {
+    size_t done = 0;
+    while (done < data.size()) {
+        ssize_t n = write(fd, data.data() + done, data.size() - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
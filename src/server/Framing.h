@@ -0,0 +1,44 @@
+// ===============================================================
+// File: Framing.h
+// Description: Buffered line/byte framing over a file descriptor,
+//              shared by the parse server and its client.
+// ===============================================================
+
+#ifndef FRAMING_H
+#define FRAMING_H
+
+#include <string>
+
+using namespace std;
+
+// ===============================================================
+// Class: FrameReader
+// ===============================================================
+class FrameReader {
+private:
+    int fd;
+    string buffer;
+    size_t pos = 0;
+    size_t maxLine;                 // 0 = unlimited
+    bool overlong = false;
+
+    // Append one read() worth of bytes; false on EOF or error
+    bool fill();
+
+public:
+    explicit FrameReader(int fd, size_t maxLine = 0) : fd(fd), maxLine(maxLine) {}
+
+    // Next line without its "\n" (or "\r\n"); false at EOF, or when
+    // the line runs past maxLine bytes: then `line` holds its first
+    // maxLine bytes, lineTooLong() is set and the stream is unusable
+    bool readLine(string &line);
+    bool lineTooLong() const { return overlong; }
+
+    // Exactly `n` raw bytes; false if the stream ends first
+    bool readBytes(size_t n, string &out);
+};
+
+// Write all of `data`; false when the peer is gone
+bool writeAll(int fd, const string &data);
+
+#endif
@@ -0,0 +1,112 @@
+#include "GrammarCache.h"
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+
+using namespace std;
+
+string GrammarCache::hashText(const string &text) {
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : text) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(h));
+    return hex;
+}
+
+GrammarCache::Entry GrammarCache::find(const string &hash) {
+    lock_guard<mutex> guard(lock);
+    auto it = index.find(hash);
+    if (it == index.end()) return nullptr;
+
+    recency.splice(recency.begin(), recency, it->second);
+    return *it->second;
+}
+
+GrammarCache::Position GrammarCache::lookup(const string &hash, const string &text) {
+    auto chain = chains.find(hash);
+    if (chain == chains.end()) return recency.end();
+    for (Position p : chain->second.entries)
+        if ((*p)->text == text) return p;
+    return recency.end();                   // same hash, other text
+}
+
+GrammarCache::Entry GrammarCache::obtain(const string &text, bool &compiled, string &error) {
+    compiled = false;
+    string hash = hashText(text);
+
+    {
+        lock_guard<mutex> guard(lock);
+        Position p = lookup(hash, text);
+        if (p != recency.end()) {
+            hits++;
+            recency.splice(recency.begin(), recency, p);
+            return *p;
+        }
+        misses++;
+    }
+
+    // Compile outside the lock; two requests racing on the same new
+    // text both compile and the second insert is dropped
+    Grammar grammar;
+    if (!grammar.loadFromText(text) || grammar.getProductions().empty()) {
+        error = "no productions in grammar text";
+        return nullptr;
+    }
+
+    auto t0 = chrono::steady_clock::now();
+    auto entry = make_shared<CompiledGrammar>();
+    entry->text = text;
+    entry->build = ParserBuilder::build(grammar);
+    entry->compileMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    entry->bytes = sizeof(CompiledGrammar) + text.size() + entry->build.table.memoryBytes();
+    compiled = true;
+
+    lock_guard<mutex> guard(lock);
+    Position p = lookup(hash, text);
+    if (p != recency.end()) {
+        recency.splice(recency.begin(), recency, p);
+        return *p;
+    }
+
+    Chain &chain = chains[hash];
+    size_t n = chain.next++;
+    entry->hash = n == 0 ? hash : hash + "-" + to_string(n);
+    entry->textHash = hash;
+    recency.push_front(entry);
+    index[entry->hash] = recency.begin();
+    chain.entries.push_back(recency.begin());
+    bytes += entry->bytes;
+    evict();
+    return entry;
+}
+
+void GrammarCache::evict() {
+    while (bytes > capacity && recency.size() > 1) {
+        const Entry &victim = recency.back();
+        bytes -= victim->bytes;
+        index.erase(victim->hash);
+
+        auto chain = chains.find(victim->textHash);
+        auto &entries = chain->second.entries;
+        entries.erase(std::find(entries.begin(), entries.end(), prev(recency.end())));
+        if (entries.empty()) chains.erase(chain);
+
+        recency.pop_back();             // in-flight parses keep their copy
+        evictions++;
+    }
+}
+
+CacheStats GrammarCache::stats() const {
+    lock_guard<mutex> guard(lock);
+    CacheStats s;
+    s.grammars = recency.size();
+    s.bytes = bytes;
+    s.capacity = capacity;
+    s.hits = hits;
+    s.misses = misses;
+    s.evictions = evictions;
+    return s;
+}
@@ -0,0 +1,101 @@
+// ===============================================================
+// File: GrammarCache.h
+// Description: Compiled grammars kept in memory by the parse
+//              server. Entries are keyed by a hash of the grammar
+//              text, so loading the same text twice compiles once;
+//              a hit is confirmed against the stored text, and a
+//              different text with the same hash gets the key
+//              "<hash>-1", "<hash>-2", ... All texts of one hash sit
+//              in one chain, so evicting one never hides another.
+//              Least recently used entries are evicted when the
+//              estimated footprint goes over the byte cap.
+// ===============================================================
+
+#ifndef GRAMMAR_CACHE_H
+#define GRAMMAR_CACHE_H
+
+#include <string>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "../parser/ParserBuilder.h"
+
+using namespace std;
+
+// ===============================================================
+// Struct: CompiledGrammar
+// Immutable once cached; parse requests share it without locking
+// ===============================================================
+struct CompiledGrammar {
+    string hash;                    // cache key: 16 hex digits [-n]
+    string textHash;                // hashText(text): the chain it belongs to
+    string text;                    // the grammar text it was compiled from
+    ParserBuild build;
+    size_t bytes = 0;               // estimated footprint
+    double compileMs = 0.0;
+};
+
+// ===============================================================
+// Struct: CacheStats
+// ===============================================================
+struct CacheStats {
+    size_t grammars = 0;
+    size_t bytes = 0;
+    size_t capacity = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+};
+
+// ===============================================================
+// Class: GrammarCache
+// ===============================================================
+class GrammarCache {
+private:
+    using Entry = shared_ptr<const CompiledGrammar>;
+
+    mutable mutex lock;
+    using Position = list<Entry>::iterator;
+
+    // Entries whose texts share one hash; `next` numbers the keys
+    // handed out while the chain lives
+    struct Chain {
+        vector<Position> entries;
+        size_t next = 0;
+    };
+
+    list<Entry> recency;                                // front = most recent
+    unordered_map<string, Position> index;              // key → entry
+    unordered_map<string, Chain> chains;                // text hash → entries
+    size_t capacity;
+    size_t bytes = 0;
+    size_t hits = 0, misses = 0, evictions = 0;
+
+    // Drop least recently used entries until under the cap; the
+    // newest entry always stays, even when it alone is over
+    void evict();
+
+    // Entry holding exactly `text` in the chain of `hash`, or
+    // recency.end()
+    Position lookup(const string &hash, const string &text);
+
+public:
+    explicit GrammarCache(size_t capacityBytes) : capacity(capacityBytes) {}
+
+    // FNV-1a 64 of the grammar text
+    static string hashText(const string &text);
+
+    // Cached grammar for `hash`, or nullptr (marks it most recent)
+    Entry find(const string &hash);
+
+    // Cached grammar for this text; compiled and inserted on a miss.
+    // nullptr and `error` set when the text is not a usable grammar.
+    // `compiled` tells whether this call did the compiling.
+    Entry obtain(const string &text, bool &compiled, string &error);
+
+    CacheStats stats() const;
+};
+
+#endif
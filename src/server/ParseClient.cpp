@@ -0,0 +1,128 @@
+#include "ParseClient.h"
+#include "Framing.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using namespace std;
+
+static int connectTo(const string &path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) return -1;
+    strcpy(addr.sun_path, path.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int ParseClient::run(const string &socketPath, const string &grammarPath,
+                     const string &inputPath, bool quiet) {
+    ifstream grammarFile(grammarPath);
+    if (!grammarFile.is_open()) {
+        cerr << "❌ Error: cannot open grammar file '" << grammarPath << "'\n";
+        return 1;
+    }
+    ostringstream grammarText;
+    grammarText << grammarFile.rdbuf();
+
+    vector<string> sentences;
+    if (!inputPath.empty()) {
+        ifstream file;
+        if (inputPath != "-") {
+            file.open(inputPath);
+            if (!file.is_open()) {
+                cerr << "❌ Error: cannot open input file " << inputPath << "\n";
+                return 1;
+            }
+        }
+        istream &in = inputPath == "-" ? cin : file;
+        string line;
+        while (getline(in, line))
+            if (line.find_first_not_of(" \t\r") != string::npos) sentences.push_back(line);
+    }
+
+    int fd = connectTo(socketPath);
+    if (fd < 0) {
+        cerr << "❌ Cannot connect to " << socketPath << ": " << strerror(errno) << "\n";
+        return 1;
+    }
+    FrameReader reader(fd);
+    string reply;
+
+    // 🔹 Grammar: the reply carries the hash PARSE requests refer to
+    string text = grammarText.str();
+    if (!writeAll(fd, "0 GRAMMAR " + to_string(text.size()) + "\n" + text) ||
+        !reader.readLine(reply)) {
+        cerr << "❌ Server closed the connection\n";
+        close(fd);
+        return 1;
+    }
+    istringstream header(reply);
+    string id, status, hash, algorithm;
+    header >> id >> status >> hash >> algorithm;
+    if (status != "OK") {
+        cerr << "❌ " << reply << "\n";
+        close(fd);
+        return 1;
+    }
+    if (!quiet) cout << "Grammar " << hash << " (" << algorithm << ")\n";
+
+    // 🔹 Sentences: requests are written while replies are read
+    auto t0 = chrono::steady_clock::now();
+    thread sender([&] {
+        string batch;
+        for (size_t k = 0; k < sentences.size(); ++k) {
+            batch += to_string(k + 1) + " PARSE " + hash + " " + sentences[k] + "\n";
+            if (batch.size() > 64 * 1024) {
+                if (!writeAll(fd, batch)) return;
+                batch.clear();
+            }
+        }
+        writeAll(fd, batch);
+    });
+
+    vector<string> results(sentences.size());
+    size_t received = 0;
+    while (received < sentences.size() && reader.readLine(reply)) {
+        istringstream ss(reply);
+        size_t k = 0;
+        ss >> k >> status;
+        if (k == 0 || k > sentences.size()) continue;
+        string rest;
+        getline(ss >> ws, rest);
+        results[k - 1] = status == "OK" ? rest : "error: " + rest;
+        received++;
+    }
+    sender.join();
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    close(fd);
+
+    size_t accepted = 0;
+    ostringstream out;
+    for (size_t k = 0; k < sentences.size(); ++k) {
+        bool ok = results[k] == "accept";
+        accepted += ok;
+        out << "#" << k + 1 << " " << (ok ? "✅" : "❌") << " "
+            << (results[k].empty() ? "no reply" : results[k]) << "   " << sentences[k] << "\n";
+    }
+    if (!quiet && !sentences.empty())
+        out << accepted << "/" << sentences.size() << " accepted in " << fixed
+            << setprecision(3) << ms << " ms\n";
+    cout << out.str();
+
+    return accepted == sentences.size() ? 0 : 3;
+}
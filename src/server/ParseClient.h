@@ -0,0 +1,26 @@
+// ===============================================================
+// File: ParseClient.h
+// Description: Local client for the parse server. Sends a grammar
+//              once, pipelines every sentence of a token file as a
+//              PARSE request and prints the results in input order.
+// ===============================================================
+
+#ifndef PARSE_CLIENT_H
+#define PARSE_CLIENT_H
+
+#include <string>
+
+using namespace std;
+
+// ===============================================================
+// Class: ParseClient
+// ===============================================================
+class ParseClient {
+public:
+    // Exit codes follow the command line: 0 all accepted, 1 server or
+    // file error, 3 some sentence rejected
+    static int run(const string &socketPath, const string &grammarPath,
+                   const string &inputPath, bool quiet);
+};
+
+#endif
@@ -0,0 +1,288 @@
+#include "ParseServer.h"
+#include "Framing.h"
+#include "../util/Parallel.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using namespace std;
+
+// ======================================
+// Connection — one client, replies serialized
+// ======================================
+struct ParseServer::Connection {
+    int inFd, outFd;
+    bool ownsFd;                    // sockets are closed, stdin/stdout are not
+    FrameReader reader;
+    mutex writeLock;
+    atomic<bool> done{false};
+
+    Connection(int in, int out, bool owns, size_t maxLine)
+        : inFd(in), outFd(out), ownsFd(owns), reader(in, maxLine) {}
+    ~Connection() {
+        if (ownsFd) close(inFd);
+    }
+
+    void reply(const string &line) {
+        lock_guard<mutex> guard(writeLock);
+        writeAll(outFd, line + "\n");     // a vanished client is not an error
+    }
+};
+
+ParseServer::ParseServer(const ServerOptions &options)
+    : options(options), cache(options.cacheBytes) {}
+
+ParseServer::~ParseServer() {
+    requestStop();
+    {
+        lock_guard<mutex> guard(jobLock);
+        draining = true;
+    }
+    jobReady.notify_all();
+    for (auto &t : readers) t.join();
+    for (auto &t : workers) t.join();
+}
+
+// ======================================
+// Worker pool
+// ======================================
+// A full queue blocks the reader, so a client that pipelines faster
+// than the workers parse stops being read instead of growing memory
+void ParseServer::submit(function<void()> job) {
+    {
+        unique_lock<mutex> guard(jobLock);
+        jobTaken.wait(guard, [&] { return jobs.size() < max<size_t>(options.maxQueuedJobs, 1); });
+        jobs.push_back(move(job));
+    }
+    jobReady.notify_one();
+}
+
+void ParseServer::workerLoop() {
+    while (true) {
+        function<void()> job;
+        {
+            unique_lock<mutex> guard(jobLock);
+            jobReady.wait(guard, [&] { return draining || !jobs.empty(); });
+            if (jobs.empty()) return;       // draining and nothing left
+            job = move(jobs.front());
+            jobs.pop_front();
+        }
+        jobTaken.notify_one();
+        job();
+    }
+}
+
+// ======================================
+// Requests
+// ======================================
+void ParseServer::serveConnection(shared_ptr<Connection> conn) {
+    string line;
+    while (!stopping && conn->reader.readLine(line)) {
+        istringstream ss(line);
+        string id, command, args;
+        if (!(ss >> id)) continue;          // blank line
+        ss >> command;
+        getline(ss >> ws, args);
+
+        // Grammar text follows its header as a length-prefixed block
+        string payload;
+        if (command == "GRAMMAR") {
+            size_t n;
+            try {
+                if (args.empty() || args.find_first_not_of("0123456789") != string::npos)
+                    throw invalid_argument(args);
+                n = stoul(args);
+            } catch (const exception &) {
+                conn->reply(id + " ERR GRAMMAR needs a byte count");
+                continue;
+            }
+            // The block cannot be skipped safely, so the connection ends
+            if (n > options.maxGrammarBytes) {
+                conn->reply(id + " ERR grammar larger than " + to_string(options.maxGrammarBytes) + " bytes");
+                break;
+            }
+            if (!conn->reader.readBytes(n, payload)) break;
+        }
+
+        requests++;
+        if (command == "SHUTDOWN") {
+            conn->reply(id + " OK");
+            requestStop();
+            break;
+        }
+
+        submit([this, conn, id, command, args, payload] {
+            conn->reply(id + " " + handle(command, args, payload));
+        });
+    }
+
+    // The rest of the line cannot be skipped safely either
+    if (conn->reader.lineTooLong()) {
+        istringstream ss(line);
+        string id;
+        if (!(ss >> id)) id = "0";
+        conn->reply(id + " ERR line longer than " + to_string(options.maxLineBytes) + " bytes");
+    }
+    conn->done = true;
+}
+
+string ParseServer::handle(const string &command, const string &args, const string &payload) {
+    if (command == "GRAMMAR")
+        return loadReply(payload);
+
+    if (command == "LOAD") {
+        ifstream file(args);
+        if (!file.is_open()) return "ERR cannot open " + args;
+        ostringstream text;
+        text << file.rdbuf();
+        return loadReply(text.str());
+    }
+
+    if (command == "PARSE") {
+        istringstream ss(args);
+        string hash, tok;
+        ss >> hash;
+        auto compiled = cache.find(hash);
+        if (!compiled) return "ERR unknown grammar " + hash;
+
+        vector<string> tokens;
+        while (ss >> tok) tokens.push_back(tok);
+        parses++;
+        return ParserBuilder::recognize(compiled->build, tokens) ? "OK accept" : "OK reject";
+    }
+
+    if (command == "STATS") {
+        CacheStats s = cache.stats();
+        return "OK grammars=" + to_string(s.grammars) + " bytes=" + to_string(s.bytes) +
+               " capacity=" + to_string(s.capacity) + " hits=" + to_string(s.hits) +
+               " misses=" + to_string(s.misses) + " evictions=" + to_string(s.evictions) +
+               " requests=" + to_string(requests.load()) + " parses=" + to_string(parses.load());
+    }
+
+    return "ERR unknown command " + command;
+}
+
+string ParseServer::loadReply(const string &text) {
+    bool compiled;
+    string error;
+    auto entry = cache.obtain(text, compiled, error);
+    if (!entry) return "ERR " + error;
+
+    char ms[32];
+    snprintf(ms, sizeof(ms), "%.3f", compiled ? entry->compileMs : 0.0);
+    return "OK " + entry->hash + " " + algorithmName(entry->build.algorithm) +
+           (compiled ? " compiled " : " cached ") + ms;
+}
+
+// ======================================
+// Lifecycle
+// ======================================
+void ParseServer::requestStop() {
+    stopping = true;
+    if (listenFd >= 0) shutdown(listenFd, SHUT_RDWR);     // wakes accept()
+
+    // Wake readers blocked on idle clients; queued work still runs
+    lock_guard<mutex> guard(connectionLock);
+    for (auto &weak : connections)
+        if (auto conn = weak.lock())
+            if (conn->ownsFd) shutdown(conn->inFd, SHUT_RD);
+}
+
+int ParseServer::run() {
+    signal(SIGPIPE, SIG_IGN);           // clients may leave mid-reply
+
+    unsigned n = resolveThreadCount(options.workers);
+    for (unsigned w = 0; w < n; ++w)
+        workers.emplace_back(&ParseServer::workerLoop, this);
+
+    // 🔹 stdin/stdout: a single client, done at EOF
+    if (options.socketPath == "-") {
+        cerr << "🛰️  Serving on stdin/stdout (" << n << " workers, cache "
+             << (options.cacheBytes >> 20) << " MiB)\n";
+        serveConnection(make_shared<Connection>(0, 1, false, options.maxLineBytes));
+    } else {
+        // 🔹 Unix domain socket: one reader thread per client
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (options.socketPath.size() >= sizeof(addr.sun_path)) {
+            cerr << "❌ Socket path too long: " << options.socketPath << "\n";
+            return 1;
+        }
+        strcpy(addr.sun_path, options.socketPath.c_str());
+
+        listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        unlink(options.socketPath.c_str());         // stale socket of a killed server
+        if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 ||
+            listen(listenFd, 128) < 0) {
+            cerr << "❌ Cannot listen on " << options.socketPath << ": " << strerror(errno) << "\n";
+            return 1;
+        }
+        cerr << "🛰️  Listening on " << options.socketPath << " (" << n << " workers, cache "
+             << (options.cacheBytes >> 20) << " MiB)\n";
+
+        while (!stopping) {
+            int fd = accept(listenFd, nullptr, nullptr);
+            if (fd < 0) {
+                if (errno == EINTR && !stopping) continue;
+                if (!stopping)
+                    cerr << "❌ accept failed: " << strerror(errno) << "\n";
+                break;
+            }
+
+            auto conn = make_shared<Connection>(fd, fd, true, options.maxLineBytes);
+            {
+                lock_guard<mutex> guard(connectionLock);
+                // Forget finished clients before adding the new one
+                size_t keep = 0;
+                for (size_t i = 0; i < readers.size(); ++i) {
+                    auto c = connections[i].lock();
+                    if (!c || c->done) {
+                        readers[i].join();
+                    } else {
+                        if (keep != i) {
+                            readers[keep] = move(readers[i]);
+                            connections[keep] = connections[i];
+                        }
+                        keep++;
+                    }
+                }
+                readers.resize(keep);
+                connections.resize(keep);
+
+                connections.push_back(conn);
+                readers.emplace_back(&ParseServer::serveConnection, this, conn);
+            }
+        }
+
+        close(listenFd);
+        listenFd = -1;
+        unlink(options.socketPath.c_str());
+    }
+
+    // Readers first (no new jobs), then let the workers drain the queue
+    requestStop();
+    for (auto &t : readers) t.join();
+    readers.clear();
+    {
+        lock_guard<mutex> guard(jobLock);
+        draining = true;
+    }
+    jobReady.notify_all();
+    for (auto &t : workers) t.join();
+    workers.clear();
+
+    CacheStats s = cache.stats();
+    cerr << "🛰️  Server stopped: " << requests << " requests, " << parses << " parses, "
+         << s.grammars << " grammars cached (" << s.hits << " hits, " << s.misses
+         << " misses, " << s.evictions << " evictions)\n";
+    return 0;
+}
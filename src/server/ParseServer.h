@@ -0,0 +1,101 @@
+// ===============================================================
+// File: ParseServer.h
+// Description: Long-running parse server. Grammars are compiled
+//              once into a GrammarCache and parse requests against
+//              them are served by a pool of worker threads, either
+//              on a Unix domain socket (many clients) or on
+//              stdin/stdout (one client, e.g. an editor plugin).
+//
+// Protocol: one request per line, "<id> <COMMAND> <args>"; every
+// reply is one line "<id> OK ..." or "<id> ERR <message>". Replies
+// come back in completion order, so clients match them by id.
+//   <id> GRAMMAR <n>            followed by n bytes of grammar text
+//                               → OK <hash> <algorithm> cached|compiled <ms>
+//                               (n over the cap: ERR, connection closed)
+//   <id> LOAD <path>            grammar file on the server's disk, same reply
+//   <id> PARSE <hash> <tokens>  → OK accept | OK reject
+//   <id> STATS                  → OK grammars=.. bytes=.. capacity=.. ...
+//   <id> SHUTDOWN               → OK, then the server stops
+// A request line longer than the line cap gets ERR and the connection
+// is closed, like an oversized GRAMMAR block.
+// A PARSE for a hash that was evicted gets "ERR unknown grammar";
+// the client sends the grammar again.
+// ===============================================================
+
+#ifndef PARSE_SERVER_H
+#define PARSE_SERVER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <condition_variable>
+#include "GrammarCache.h"
+
+using namespace std;
+
+// ===============================================================
+// Struct: ServerOptions
+// ===============================================================
+struct ServerOptions {
+    string socketPath;                      // "-" = stdin/stdout
+    unsigned workers = 0;                   // 0 = all hardware threads
+    size_t cacheBytes = 64u << 20;
+    size_t maxGrammarBytes = 4u << 20;      // GRAMMAR <n> larger than this is refused
+    size_t maxLineBytes = 1u << 20;         // longer request lines are refused
+    size_t maxQueuedJobs = 4096;            // readers wait while the queue is this deep
+};
+
+// ===============================================================
+// Class: ParseServer
+// ===============================================================
+class ParseServer {
+private:
+    struct Connection;
+
+    ServerOptions options;
+    GrammarCache cache;
+
+    // 🔹 Worker pool
+    vector<thread> workers;
+    deque<function<void()>> jobs;
+    mutex jobLock;
+    condition_variable jobReady;
+    condition_variable jobTaken;            // room in the queue again
+    bool draining = false;
+
+    // 🔹 Connections
+    int listenFd = -1;
+    atomic<bool> stopping{false};
+    mutex connectionLock;
+    vector<weak_ptr<Connection>> connections;
+    vector<thread> readers;
+
+    atomic<size_t> requests{0};
+    atomic<size_t> parses{0};
+
+    void submit(function<void()> job);
+    void workerLoop();
+
+    // Frame requests off one connection until EOF or shutdown
+    void serveConnection(shared_ptr<Connection> conn);
+
+    // Runs on a worker; returns the reply without the id
+    string handle(const string &command, const string &args, const string &payload);
+    string loadReply(const string &text);
+
+    void requestStop();
+
+public:
+    explicit ParseServer(const ServerOptions &options);
+    ~ParseServer();
+
+    // Serve until SHUTDOWN (or EOF on stdin); returns the exit code
+    int run();
+};
+
+#endif
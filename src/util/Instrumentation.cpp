@@ -0,0 +1,260 @@
+#include "Instrumentation.h"
+#include "../report/reportWriter.h"
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <cstdlib>
+#include <new>
+#include <sys/resource.h>
+
+using namespace std;
+
+namespace {
+
+constexpr size_t COUNTERS = static_cast<size_t>(Counter::COUNT);
+constexpr size_t MAX_EVENTS = 1 << 20;      // later phases are summed, not traced
+
+struct TraceEvent {
+    const char *name;
+    int64_t start;
+    int64_t duration;
+    unsigned thread;
+};
+
+struct PhaseTotal {
+    const char *name;
+    size_t calls = 0;
+    int64_t micros = 0;
+    int64_t longest = 0;
+};
+
+// Shared state; touched once per phase and once per thread exit
+struct Registry {
+    mutex lock;
+    uint64_t counters[COUNTERS] = {};
+    vector<PhaseTotal> phases;              // in order of first use
+    vector<TraceEvent> events;
+    size_t droppedEvents = 0;
+    chrono::steady_clock::time_point origin = chrono::steady_clock::now();
+    atomic<unsigned> nextThread{0};
+};
+
+Registry &registry() {
+    static Registry r;
+    return r;
+}
+
+// Counters of one thread, folded into the registry on publish()
+struct LocalCounters {
+    uint64_t values[COUNTERS] = {};
+    int thread = -1;
+
+    unsigned id() {
+        if (thread < 0) thread = static_cast<int>(registry().nextThread++);
+        return static_cast<unsigned>(thread);
+    }
+
+    // Caller holds the registry lock
+    void publishLocked(Registry &r) {
+        for (size_t k = 0; k < COUNTERS; ++k) {
+            r.counters[k] += values[k];
+            values[k] = 0;
+        }
+    }
+
+    ~LocalCounters() {
+        Registry &r = registry();
+        lock_guard<mutex> guard(r.lock);
+        publishLocked(r);
+    }
+};
+
+thread_local LocalCounters local;
+
+#ifndef GRAMRESOLVE_NO_STATS
+atomic<uint64_t> allocations(0);
+atomic<uint64_t> allocatedBytes(0);
+#endif
+
+string megabytes(uint64_t bytes) {
+    std::ostringstream out;
+    out << fixed << setprecision(1) << bytes / double(1 << 20) << " MiB";
+    return out.str();
+}
+
+} // namespace
+
+#ifndef GRAMRESOLVE_NO_STATS
+atomic<bool> Instrumentation::active(false);
+
+// ===================================================
+// Counting allocator: plain malloc/free, plus two relaxed
+// adds while instrumentation is on
+// ===================================================
+void *operator new(size_t size) {
+    if (Instrumentation::enabled()) {
+        allocations.fetch_add(1, memory_order_relaxed);
+        allocatedBytes.fetch_add(size, memory_order_relaxed);
+    }
+    if (size == 0) size = 1;
+    while (true) {
+        if (void *p = malloc(size)) return p;
+        new_handler handler = get_new_handler();
+        if (!handler) throw bad_alloc();
+        handler();
+    }
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+#endif
+
+bool Instrumentation::enable() {
+#ifdef GRAMRESOLVE_NO_STATS
+    return false;
+#else
+    Registry &r = registry();
+    r.origin = chrono::steady_clock::now();
+    local.id();                             // the enabling thread is tid 0
+    active.store(true, memory_order_relaxed);
+    return true;
+#endif
+}
+
+void Instrumentation::add(Counter counter, uint64_t amount) {
+    local.values[static_cast<size_t>(counter)] += amount;
+}
+
+int64_t Instrumentation::nowMicros() {
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - registry().origin)
+        .count();
+}
+
+void Instrumentation::recordPhase(const char *name, int64_t startMicros, int64_t endMicros) {
+    const int64_t duration = endMicros - startMicros;
+    const unsigned thread = local.id();
+
+    Registry &r = registry();
+    lock_guard<mutex> guard(r.lock);
+    local.publishLocked(r);
+
+    PhaseTotal *total = nullptr;
+    for (auto &p : r.phases)
+        if (string(p.name) == name) total = &p;
+    if (!total) {
+        r.phases.push_back({name});
+        total = &r.phases.back();
+    }
+    total->calls++;
+    total->micros += duration;
+    total->longest = max(total->longest, duration);
+
+    if (r.events.size() < MAX_EVENTS)
+        r.events.push_back({name, startMicros, duration, thread});
+    else
+        r.droppedEvents++;
+}
+
+const char *Instrumentation::counterName(Counter counter) {
+    switch (counter) {
+    case Counter::FIXPOINT_ITERATIONS: return "fixpoint_iterations";
+    case Counter::SET_INSERTS:         return "set_inserts";
+    case Counter::CLOSURE_CALLS:       return "closure_calls";
+    case Counter::GOTO_CALLS:          return "goto_calls";
+    case Counter::STATES_CREATED:      return "states_created";
+    case Counter::PARSE_STEPS:         return "parse_steps";
+    case Counter::SENTENCES:           return "sentences";
+    default:                           return "?";
+    }
+}
+
+uint64_t Instrumentation::peakRssBytes() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;    // Linux reports KiB
+}
+
+// ===================================================
+// 📈 --stats summary
+// ===================================================
+void Instrumentation::displaySummary(bool toStderr) {
+    Registry &r = registry();
+    std::ostringstream out;
+    {
+        lock_guard<mutex> guard(r.lock);
+        local.publishLocked(r);
+
+        out << "\n===== Instrumentation =====\n";
+        out << left << setw(20) << "Phase" << right << setw(8) << "Calls" << setw(14) << "Total (ms)"
+            << setw(12) << "Max (ms)" << "\n";
+        for (const auto &p : r.phases)
+            out << left << setw(20) << p.name << right << setw(8) << p.calls << fixed
+                << setprecision(3) << setw(14) << p.micros / 1000.0 << setw(12) << p.longest / 1000.0
+                << "\n";
+        if (r.phases.empty()) out << "  (no phase ran)\n";
+
+        out << "\n" << left << setw(22) << "Counter" << right << setw(14) << "Value" << "\n";
+        for (size_t k = 0; k < COUNTERS; ++k)
+            out << left << setw(22) << counterName(static_cast<Counter>(k)) << right << setw(14)
+                << r.counters[k] << "\n";
+    }
+
+#ifndef GRAMRESOLVE_NO_STATS
+    out << "\nAllocations : " << allocations.load() << " (" << megabytes(allocatedBytes.load())
+        << " requested)\n";
+#endif
+    out << "Peak RSS    : " << megabytes(peakRssBytes()) << "\n";
+    out << "(phase times include nested phases)\n";
+    out << "===========================\n";
+
+    (toStderr ? cerr : cout) << out.str();
+#ifndef GRAMRESOLVE_NO_REPORT
+    ReportWriter::get() << out.str();
+#endif
+}
+
+// ===================================================
+// 🧵 Chrome trace-event export
+// ===================================================
+bool Instrumentation::writeTrace(const string &path) {
+    ofstream file(path);
+    if (!file.is_open()) {
+        cerr << "❌ Failed to open " << path << " for writing.\n";
+        return false;
+    }
+
+    Registry &r = registry();
+    const int64_t end = nowMicros();
+    lock_guard<mutex> guard(r.lock);
+    local.publishLocked(r);
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"gramresolve\"}}";
+    for (unsigned t = 0; t < r.nextThread.load(); ++t)
+        file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+             << ",\"args\":{\"name\":\"" << (t == 0 ? string("main") : "worker " + to_string(t))
+             << "\"}}";
+
+    for (const auto &e : r.events)
+        file << ",\n{\"name\":\"" << e.name << "\",\"cat\":\"phase\",\"ph\":\"X\",\"ts\":" << e.start
+             << ",\"dur\":" << e.duration << ",\"pid\":1,\"tid\":" << e.thread << "}";
+
+    // Final counter values as one counter event at the end
+    file << ",\n{\"name\":\"counters\",\"ph\":\"C\",\"ts\":" << end << ",\"pid\":1,\"tid\":0,\"args\":{";
+    for (size_t k = 0; k < COUNTERS; ++k)
+        file << (k ? "," : "") << "\"" << counterName(static_cast<Counter>(k)) << "\":" << r.counters[k];
+    file << "}}\n],\n\"otherData\":{\"peak_rss_bytes\":" << peakRssBytes();
+#ifndef GRAMRESOLVE_NO_STATS
+    file << ",\"allocations\":" << allocations.load() << ",\"allocated_bytes\":" << allocatedBytes.load();
+#endif
+    file << ",\"dropped_events\":" << r.droppedEvents << "}}\n";
+
+    return file.good();
+}
@@ -0,0 +1,128 @@
+// ===============================================================
+// File: Instrumentation.h
+// Description: Phase timers, work counters, allocation counts and
+//              peak RSS for the whole pipeline (--stats, --trace).
+//              Everything is off until Instrumentation::enable();
+//              until then a timer or counter costs one relaxed load
+//              and a branch. make STATS=0 (GRAMRESOLVE_NO_STATS)
+//              turns enabled() into a constant false, so the calls
+//              are compiled out and operator new is not replaced.
+//
+//              Counters are kept per thread and published when the
+//              thread ends a phase, exits, or asks for the summary.
+// ===============================================================
+
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// ===============================================================
+// Enum: Counter
+// ===============================================================
+enum class Counter {
+    FIXPOINT_ITERATIONS,    // FIRST/FOLLOW work-list steps
+    SET_INSERTS,            // FIRST/FOLLOW sets grown, items added by closure
+    CLOSURE_CALLS,
+    GOTO_CALLS,
+    STATES_CREATED,         // LR(0) states of the canonical collection
+    PARSE_STEPS,            // LR shifts + reductions (GLR: deterministic part), LL(1) pops,
+                            // Earley items processed
+    SENTENCES,              // sentences given to a silent driver
+    COUNT
+};
+
+// ===============================================================
+// Class: Instrumentation
+// ===============================================================
+class Instrumentation {
+private:
+#ifndef GRAMRESOLVE_NO_STATS
+    static atomic<bool> active;
+#endif
+
+    static void add(Counter counter, uint64_t amount);
+
+public:
+#ifdef GRAMRESOLVE_NO_STATS
+    static constexpr bool enabled() { return false; }
+#else
+    static bool enabled() { return active.load(memory_order_relaxed); }
+#endif
+
+    // Start collecting; false when built with STATS=0
+    static bool enable();
+
+    static void count(Counter counter, uint64_t amount = 1) {
+        if (enabled()) add(counter, amount);
+    }
+
+    // Microseconds since enable()
+    static int64_t nowMicros();
+
+    // A finished phase on the calling thread (see PhaseTimer)
+    static void recordPhase(const char *name, int64_t startMicros, int64_t endMicros);
+
+    // Per-phase totals, counters, allocations and peak RSS; on
+    // stderr when stdout carries data (corpus or server output)
+    static void displaySummary(bool toStderr = false);
+
+    // Chrome trace-event JSON (chrome://tracing, Perfetto); false
+    // when the file cannot be written
+    static bool writeTrace(const string &path);
+
+    static const char *counterName(Counter counter);
+
+    // Peak resident set size of the process in bytes
+    static uint64_t peakRssBytes();
+};
+
+// ===============================================================
+// Class: PhaseTimer
+// Times the enclosing scope as one phase; nested timers show up
+// nested in the trace.
+// ===============================================================
+class PhaseTimer {
+private:
+    const char *name;
+    int64_t start = -1;
+
+public:
+    explicit PhaseTimer(const char *phase) : name(phase) {
+        if (Instrumentation::enabled()) start = Instrumentation::nowMicros();
+    }
+    ~PhaseTimer() { stop(); }
+
+    // End the phase before the scope does
+    void stop() {
+        if (start >= 0) Instrumentation::recordPhase(name, start, Instrumentation::nowMicros());
+        start = -1;
+    }
+
+    PhaseTimer(const PhaseTimer &) = delete;
+    PhaseTimer &operator=(const PhaseTimer &) = delete;
+};
+
+// ===============================================================
+// Class: CountOnExit
+// Adds a local tally to a counter when the scope ends, for hot
+// loops with several exits.
+// ===============================================================
+class CountOnExit {
+private:
+    Counter counter;
+    const size_t &value;
+
+public:
+    CountOnExit(Counter c, const size_t &tally) : counter(c), value(tally) {}
+    ~CountOnExit() { Instrumentation::count(counter, value); }
+
+    CountOnExit(const CountOnExit &) = delete;
+    CountOnExit &operator=(const CountOnExit &) = delete;
+};
+
+#endif
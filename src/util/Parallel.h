@@ -0,0 +1,51 @@
+// ===============================================================
+// File: Parallel.h
+// Description: Minimal fork/join helper shared by the analyses.
+//              Runs fn(0..n-1) on up to `threads` workers that pull
+//              indices from an atomic counter.
+// ===============================================================
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Resolve a requested worker count (0 = all hardware threads)
+inline unsigned resolveThreadCount(unsigned requested) {
+    if (requested != 0) return requested;
+    unsigned hw = thread::hardware_concurrency();
+    return hw ? hw : 1;
+}
+
+// Run fn(i) for every i in [0, n). Small batches and single-thread
+// requests run inline on the calling thread.
+inline void parallelFor(size_t n, unsigned threads, const function<void(size_t)> &fn,
+                        size_t minPerThread = 1) {
+    unsigned workers = resolveThreadCount(threads);
+    if (minPerThread == 0) minPerThread = 1;
+    if (workers > n / minPerThread) workers = static_cast<unsigned>(n / minPerThread);
+
+    if (workers <= 1) {
+        for (size_t i = 0; i < n; ++i) fn(i);
+        return;
+    }
+
+    atomic<size_t> nextIndex(0);
+    auto worker = [&]() {
+        for (size_t i = nextIndex++; i < n; i = nextIndex++)
+            fn(i);
+    };
+
+    vector<thread> pool;
+    for (unsigned w = 1; w < workers; ++w)
+        pool.emplace_back(worker);
+    worker();
+    for (auto &t : pool) t.join();
+}
+
+#endif
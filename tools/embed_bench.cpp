@@ -0,0 +1,139 @@
+// ===============================================================
+// File: embed_bench.cpp
+// Description: Per-call cost of libgramresolve against spawning the
+//              executable for the same job (make embed-bench).
+//
+//              One call = load the grammar, build the selected LR
+//              table and parse every sentence of the input file:
+//                in-process   Grammar::fromText + compile + parse
+//                parse only   parse on an already compiled Parser
+//                spawn        text.exe GRAMMAR -i INPUT -q -p select -e auto
+//                             (stdout to /dev/null, wait for exit)
+//
+// Usage: embed_bench GRAMMAR INPUT [EXE] [CALLS]
+// ===============================================================
+
+#include <gramresolve/gramresolve.h>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+extern char **environ;
+
+static bool readFile(const string &path, string &text) {
+    ifstream in(path);
+    if (!in.is_open()) return false;
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    text = buffer.str();
+    return true;
+}
+
+// Mean microseconds per call of `fn` over `calls` calls
+template <typename Fn>
+static double timePerCall(size_t calls, Fn fn) {
+    auto t0 = chrono::steady_clock::now();
+    for (size_t k = 0; k < calls; ++k) fn();
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count() / calls;
+}
+
+// One run of the executable; false when it cannot be started or fails
+static bool spawnOnce(const string &exe, const string &grammarPath, const string &inputPath) {
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+
+    vector<string> args = {exe, grammarPath, "-i", inputPath, "-q", "-p", "select", "-e", "auto"};
+    vector<char *> argv;
+    for (auto &a : args) argv.push_back(&a[0]);
+    argv.push_back(nullptr);
+
+    pid_t pid;
+    int rc = posix_spawn(&pid, exe.c_str(), &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (rc != 0) return false;
+
+    int status = 0;
+    if (waitpid(pid, &status, 0) < 0) return false;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " GRAMMAR INPUT [EXE] [CALLS]\n";
+        return 2;
+    }
+    const string grammarPath = argv[1], inputPath = argv[2];
+    const string exe = argc > 3 ? argv[3] : "./text.exe";
+    const size_t calls = argc > 4 ? stoul(argv[4]) : 200;
+    const size_t spawnCalls = max<size_t>(1, calls / 10);
+
+    string grammarText, inputText;
+    if (!readFile(grammarPath, grammarText) || !readFile(inputPath, inputText)) {
+        cerr << "❌ Cannot read " << grammarPath << " or " << inputPath << "\n";
+        return 1;
+    }
+    vector<string> sentences;
+    {
+        istringstream in(inputText);
+        for (string line; getline(in, line); )
+            if (line.find_first_not_of(" \t\r") != string::npos) sentences.push_back(line);
+    }
+
+    // 🔹 One correctness pass, so every mode does the same work
+    gramresolve::Grammar grammar;
+    gramresolve::Parser parser;
+    string error;
+    if (!gramresolve::Grammar::fromText(grammarText, grammar, &error) || !grammar.compile(parser, {}, &error)) {
+        cerr << "❌ " << grammarPath << ": " << error << "\n";
+        return 1;
+    }
+    size_t accepted = 0;
+    for (const auto &s : sentences) accepted += parser.parse(s).accepted;
+    if (!spawnOnce(exe, grammarPath, inputPath)) {
+        cerr << "❌ Cannot run " << exe << "\n";
+        return 1;
+    }
+
+    // 🔹 Timed modes
+    size_t sink = 0;
+    double fullMicros = timePerCall(calls, [&] {
+        gramresolve::Grammar g;
+        gramresolve::Parser p;
+        gramresolve::Grammar::fromText(grammarText, g);
+        g.compile(p);
+        for (const auto &s : sentences) sink += p.parse(s).accepted;
+    });
+    double parseMicros = timePerCall(calls, [&] {
+        for (const auto &s : sentences) sink += parser.parse(s).accepted;
+    });
+    double spawnMicros = timePerCall(spawnCalls, [&] { sink += spawnOnce(exe, grammarPath, inputPath); });
+
+    cout << "\n===== Embedding Overhead =====\n";
+    cout << "Grammar   : " << grammarPath << " (" << parser.algorithmName() << ", " << parser.stateCount()
+         << " states)\n";
+    cout << "Input     : " << inputPath << " (" << sentences.size() << " sentences, " << accepted
+         << " accepted)\n\n";
+    cout << left << setw(14) << "Mode" << right << setw(8) << "Calls" << setw(14) << "us/call" << setw(12)
+         << "vs spawn" << "\n";
+    auto row = [&](const string &mode, size_t n, double micros) {
+        cout << left << setw(14) << mode << right << setw(8) << n << setw(14) << fixed << setprecision(1)
+             << micros << setw(11) << setprecision(1) << spawnMicros / micros << "x\n";
+    };
+    row("in-process", calls, fullMicros);
+    row("parse only", calls, parseMicros);
+    row("spawn", spawnCalls, spawnMicros);
+    cout << "==============================\n";
+
+    return sink == 0 ? 1 : 0;       // keeps the timed work observable
+}